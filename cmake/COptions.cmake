@@ -1,4 +1,7 @@
 set(WARNINGS_AS_ERRORS OFF CACHE BOOL "Treat compiler warnings as errors")
+set(TOOLBOX_COUNT_ALLOCATIONS OFF CACHE BOOL "Count heap allocations through a replaced global operator new (test hook, always on with TOOLBOX_BUILD_TESTS)")
+set(TOOLBOX_BUILD_VISION ON CACHE BOOL "Build the vision module, it is skipped when OpenCV is not found")
+set(TOOLBOX_BUILD_TESTS OFF CACHE BOOL "Build the module tests and register them with ctest")
 
 function(apply_compiler_options target)
     if(MSVC)
@@ -21,6 +24,8 @@ function(apply_compiler_options target)
             -Wno-pedantic
             -Wno-unused-parameter
             -Wno-deprecated-declarations
+            # NOTE: Lets sqrt/div vectorize, nothing reads errno from math calls
+            -fno-math-errno
         )
         if(WARNINGS_AS_ERRORS)
             target_compile_options(${target} PRIVATE -Werror)
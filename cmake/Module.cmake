@@ -1,3 +1,5 @@
+include(GoogleTest)
+
 function(add_module name)
     set(multi_value_args SOURCES HEADERS DEPENDENCIES)
     cmake_parse_arguments(ARG "" "" "${multi_value_args}" ${ARGN})
@@ -42,3 +44,24 @@ function(add_module name)
         DESTINATION include
     )
 endfunction()
+
+# NOTE: One executable per module from its tests/**/*_test.cpp, every TEST is registered with ctest
+function(add_module_tests name)
+    if(NOT TOOLBOX_BUILD_TESTS)
+        return()
+    endif()
+
+    file(GLOB_RECURSE sources CONFIGURE_DEPENDS ${CMAKE_CURRENT_SOURCE_DIR}/tests/*_test.cpp)
+    if(NOT sources)
+        return()
+    endif()
+
+    set(target ${namespace}_${name}_tests)
+    add_executable(${target} ${sources})
+
+    target_include_directories(${target} PRIVATE ${CMAKE_CURRENT_SOURCE_DIR}/tests)
+    target_link_libraries(${target} PRIVATE ${namespace}::${name} GTest::gtest_main)
+    apply_compiler_options(${target})
+
+    gtest_discover_tests(${target} DISCOVERY_MODE PRE_TEST)
+endfunction()
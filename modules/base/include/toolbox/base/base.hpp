@@ -3,9 +3,15 @@
 
 // IWYU pragma: begin_exports
 #include "toolbox/base/types/types.hpp"
+#include "toolbox/base/types/function_ref.hpp"
+#include "toolbox/base/memory/allocations.hpp"
+#include "toolbox/base/memory/mapped_file.hpp"
 #include "toolbox/base/logger/logger.hpp"
 #include "toolbox/base/errors/errors.hpp"
 #include "toolbox/base/errors/result.hpp"
+#include "toolbox/base/thread/thread_pool.hpp"
+#include "toolbox/base/thread/triple_buffer.hpp"
+#include "toolbox/base/cpu/cpu.hpp"
 // IWYU pragma: end_exports
 
 
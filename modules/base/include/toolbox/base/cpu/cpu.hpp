@@ -0,0 +1,98 @@
+#pragma once
+
+#include "toolbox/base/types/types.hpp"
+#include "toolbox/base/errors/result.hpp"
+
+#include <string_view>
+
+// NOTE: Per-function instruction set selection. Kernels marked with these attributes are compiled
+// for the named ISA inside an otherwise baseline build and must only be called after checking
+// cpu::GetLevel(). Without GCC/Clang on x86 only the scalar entry of a KernelTable exists.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define TOOLBOX_CPU_DISPATCH 1
+#define TOOLBOX_TARGET_SSE42 __attribute__((target("sse4.2,popcnt")))
+#define TOOLBOX_TARGET_AVX2 __attribute__((target("avx2,fma,bmi,bmi2,popcnt")))
+#define TOOLBOX_TARGET_AVX512 \
+    __attribute__((target("avx512f,avx512bw,avx512vl,avx512dq,avx2,fma,bmi,bmi2,popcnt")))
+#endif
+
+// NOTE: Shared kernel bodies are force-inlined into each ISA clone so they compile for that ISA
+#if defined(_MSC_VER)
+#define TOOLBOX_FORCE_INLINE __forceinline
+#elif defined(__GNUC__) || defined(__clang__)
+#define TOOLBOX_FORCE_INLINE inline __attribute__((always_inline))
+#else
+#define TOOLBOX_FORCE_INLINE inline
+#endif
+
+namespace ct::cpu {
+
+// NOTE: Ordered, every level implies the ones below it
+enum class SimdLevel : u8 {
+    Scalar = 0,
+    SSE42,      // SSE4.2 + POPCNT
+    AVX2,       // AVX2 + FMA + BMI2
+    AVX512,     // AVX-512 F/BW/VL/DQ
+};
+
+struct Features {
+    bool sse2{false};
+    bool sse42{false};
+    bool popcnt{false};
+    bool avx{false};
+    bool avx2{false};
+    bool fma{false};
+    bool bmi2{false};
+    bool avx512f{false};
+    bool avx512bw{false};
+    bool avx512vl{false};
+    bool avx512dq{false};
+    bool avx512vpopcntdq{false};
+    bool neon{false};
+};
+
+// NOTE: Probed once on first use, AVX/AVX-512 also require the OS to save the wider registers
+[[nodiscard]] const Features& GetFeatures() noexcept;
+
+// NOTE: Highest level the hardware supports
+[[nodiscard]] SimdLevel GetDetectedLevel() noexcept;
+
+// NOTE: Level kernels dispatch on. Starts at the detected level, lowered by the TOOLBOX_SIMD
+// environment variable (scalar, sse4.2, avx2, avx512) or by SetLevel().
+[[nodiscard]] SimdLevel GetLevel() noexcept;
+
+// NOTE: Clamped to the detected level, returns the level that is now active
+SimdLevel SetLevel(SimdLevel level) noexcept;
+
+[[nodiscard]] std::string_view ToString(SimdLevel level) noexcept;
+[[nodiscard]] result<SimdLevel> ParseLevel(std::string_view name) noexcept;
+
+// NOTE: One function pointer per level, scalar is mandatory. Get() returns the best entry at or
+// below the active level, so a kernel only needs the variants that actually differ.
+template<typename Fn>
+struct KernelTable {
+    Fn scalar{nullptr};
+    Fn sse42{nullptr};
+    Fn avx2{nullptr};
+    Fn avx512{nullptr};
+
+    [[nodiscard]] Fn Get(SimdLevel level) const noexcept {
+        switch (level) {
+        case SimdLevel::AVX512:
+            if (avx512) return avx512;
+            [[fallthrough]];
+        case SimdLevel::AVX2:
+            if (avx2) return avx2;
+            [[fallthrough]];
+        case SimdLevel::SSE42:
+            if (sse42) return sse42;
+            [[fallthrough]];
+        default:
+            return scalar;
+        }
+    }
+
+    [[nodiscard]] Fn Get() const noexcept { return Get(GetLevel()); }
+};
+
+} // namespace ct::cpu
@@ -7,7 +7,7 @@
 
 namespace ct {
 
-enum class ErrorType : u8 { CORE = 0, FILE_SYSTEM, NETWORK, PARSE, VALIDATION, GRAPHICS };
+enum class ErrorType : u8 { CORE = 0, FILE_SYSTEM, NETWORK, PARSE, VALIDATION, GRAPHICS, MATH };
 
 enum class ErrorCode : u16 {
     SUCCESS = 0,
@@ -44,6 +44,11 @@ enum class ErrorCode : u16 {
     GRAPHICS_BUFFER_CREATION_FAILED,
     GRAPHICS_UNSUPPORTED_API,
 
+    MATH_SINGULAR_MATRIX = 600,
+    MATH_NOT_POSITIVE_DEFINITE,
+    MATH_RANK_DEFICIENT,
+    MATH_NON_FINITE,
+
     INVALID_ARGUMENT = 900,
     FAILED_TO_AQUIRE_RESOURCE,
 
@@ -66,6 +71,7 @@ public:
         if (code_val >= 300 && code_val < 400) return ErrorType::PARSE;
         if (code_val >= 400 && code_val < 500) return ErrorType::VALIDATION;
         if (code_val >= 500 && code_val < 600) return ErrorType::GRAPHICS;
+        if (code_val >= 600 && code_val < 700) return ErrorType::MATH;
         return ErrorType::CORE;
     }
 
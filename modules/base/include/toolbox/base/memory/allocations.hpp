@@ -0,0 +1,36 @@
+#pragma once
+
+#include "toolbox/base/types/types.hpp"
+
+namespace ct::memory {
+
+// NOTE: Builds configured with TOOLBOX_COUNT_ALLOCATIONS replace the global operator new and count
+// every heap allocation of every thread. It is a test hook to hold hot paths to zero allocations
+// after warm-up, other builds keep the standard allocator and all counts stay 0.
+[[nodiscard]] constexpr bool IsCountingAllocations() noexcept {
+#if defined(TOOLBOX_COUNT_ALLOCATIONS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// NOTE: Allocations since program start, across all threads
+[[nodiscard]] u64 GetAllocationCount() noexcept;
+
+// NOTE: Allocations made since construction, e.g.
+//   memory::AllocationScope scope;
+//   frontend.Estimate(image, ts);
+//   assert(scope.GetCount() == 0);
+// Other threads allocating meanwhile are counted too.
+class AllocationScope {
+public:
+    AllocationScope() noexcept : mStart(GetAllocationCount()) {}
+
+    [[nodiscard]] u64 GetCount() const noexcept { return GetAllocationCount() - mStart; }
+
+private:
+    u64 mStart;
+};
+
+} // namespace ct::memory
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "toolbox/base/types/types.hpp"
+#include "toolbox/base/errors/result.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace ct::memory {
+
+// NOTE: Read-only bytes of a whole file. Mapped where the platform has mmap, so opening is O(1) and
+// pages are only read when touched; elsewhere the file is read into one heap buffer. Either way the
+// bytes start on a 64-byte boundary and stay put when the MappedFile is moved.
+class MappedFile {
+public:
+    static constexpr std::size_t kAlignment = 64;
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] static result<MappedFile> Open(const std::filesystem::path& path);
+
+    [[nodiscard]] bool Empty() const noexcept { return mSize == 0; }
+    [[nodiscard]] std::size_t Size() const noexcept { return mSize; }
+    [[nodiscard]] std::span<const u8> Bytes() const noexcept { return {mData, mSize}; }
+
+private:
+    void Close() noexcept;
+
+    const u8* mData{nullptr};
+    std::size_t mSize{0};
+    bool mMapped{false};
+};
+
+} // namespace ct::memory
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "toolbox/base/types/types.hpp"
+#include "toolbox/base/errors/result.hpp"
+#include "toolbox/base/types/function_ref.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ct {
+
+namespace detail {
+struct ParallelForJob;
+}
+
+struct ThreadPoolInfo {
+    // NOTE: 0 picks std::thread::hardware_concurrency() - 1 workers, the caller is the extra lane
+    u32 workers{0};
+};
+
+class ThreadPool {
+public:
+    // NOTE: begin/end is a chunk of the index range, slot is unique per participating thread
+    // for the duration of one ParallelFor call and always < GetConcurrency(). A reference, the
+    // callable only has to live for the call.
+    using RangeFn = FunctionRef<void(std::size_t begin, std::size_t end, u32 slot)>;
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    [[nodiscard]] u32 GetWorkerCount() const noexcept { return static_cast<u32>(mWorkers.size()); }
+
+    // NOTE: Workers plus the calling thread, the number of per-thread accumulators callers need
+    [[nodiscard]] u32 GetConcurrency() const noexcept { return GetWorkerCount() + 1; }
+
+    void Submit(std::function<void()> task);
+
+    // NOTE: Splits [0, count) into chunks of at least `grain` indices. The calling thread works on
+    // chunks too and the call returns once every chunk has finished, so it is safe to nest. Nothing
+    // is allocated per call: the job lives on the caller's stack and workers pick it up from a list
+    // whose capacity is kept.
+    void ParallelFor(std::size_t count, std::size_t grain, const RangeFn& fn);
+
+    [[nodiscard]] static result<ref<ThreadPool>> Create(const ThreadPoolInfo& info = {}) noexcept;
+
+private:
+    ThreadPool() = default;
+    void WorkerLoop();
+    [[nodiscard]] detail::ParallelForJob* ClaimJob() noexcept;
+
+    std::vector<std::thread> mWorkers;
+    std::deque<std::function<void()>> mTasks;
+    std::vector<detail::ParallelForJob*> mJobs;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::condition_variable mJobReleased;
+    bool mStopping{false};
+};
+
+} // namespace ct
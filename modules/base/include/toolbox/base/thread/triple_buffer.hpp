@@ -0,0 +1,43 @@
+#pragma once
+
+#include "toolbox/base/types/types.hpp"
+
+#include <array>
+#include <atomic>
+
+namespace ct {
+
+// NOTE: Hands the latest value from one writer thread to one reader thread without either waiting
+// on the other. The writer fills Back() and publishes it, the reader picks up the newest published
+// value with Acquire(); values published in between are overwritten, never queued. The three slots
+// are reused forever, so a T that keeps its capacity on assignment stops allocating once warm.
+template<class T>
+class TripleBuffer {
+public:
+    // NOTE: Writer side
+    [[nodiscard]] T& Back() noexcept { return mSlots[mBack]; }
+    void Publish() noexcept {
+        mBack = static_cast<u8>(mMiddle.exchange(static_cast<u8>(mBack | kFresh), std::memory_order_acq_rel) & kIndex);
+    }
+
+    // NOTE: Reader side, true when a value newer than the current Front() was taken
+    bool Acquire() noexcept {
+        if (!(mMiddle.load(std::memory_order_relaxed) & kFresh)) return false;
+        mFront = static_cast<u8>(mMiddle.exchange(mFront, std::memory_order_acq_rel) & kIndex);
+        return true;
+    }
+    [[nodiscard]] T& Front() noexcept { return mSlots[mFront]; }
+    [[nodiscard]] const T& Front() const noexcept { return mSlots[mFront]; }
+
+private:
+    static constexpr u8 kIndex = 0x3;
+    static constexpr u8 kFresh = 0x4;
+
+    std::array<T, 3> mSlots{};
+    // NOTE: Index of the slot between the two sides, kFresh while the reader has not taken it
+    alignas(64) std::atomic<u8> mMiddle{1};
+    alignas(64) u8 mBack{0};
+    alignas(64) u8 mFront{2};
+};
+
+} // namespace ct
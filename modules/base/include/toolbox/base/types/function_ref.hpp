@@ -0,0 +1,34 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ct {
+
+template<typename Signature>
+class FunctionRef;
+
+// NOTE: Non-owning reference to a callable, two pointers wide. Unlike std::function it never
+// allocates whatever the callable captures, so the callable has to outlive every call through the
+// reference. Binding a lambda in an argument list is fine, the temporary lives until the call returns.
+template<typename R, typename... Args>
+class FunctionRef<R(Args...)> {
+public:
+    template<typename Fn>
+        requires(!std::is_same_v<std::remove_cvref_t<Fn>, FunctionRef> && std::is_invocable_r_v<R, Fn&, Args...>)
+    FunctionRef(Fn&& fn) noexcept
+        : mObject(const_cast<void*>(static_cast<const void*>(std::addressof(fn)))),
+          mCall([](void* object, Args... args) -> R {
+              return std::invoke(*static_cast<std::add_pointer_t<Fn>>(object), std::forward<Args>(args)...);
+          }) {}
+
+    R operator()(Args... args) const { return mCall(mObject, std::forward<Args>(args)...); }
+
+private:
+    void* mObject;
+    R (*mCall)(void*, Args...);
+};
+
+} // namespace ct
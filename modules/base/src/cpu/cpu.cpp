@@ -0,0 +1,186 @@
+#include "toolbox/base/cpu/cpu.hpp"
+#include "toolbox/base/logger/logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <string>
+
+#if defined(TOOLBOX_CPU_DISPATCH)
+#include <cpuid.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace ct::cpu {
+
+namespace {
+
+#if defined(TOOLBOX_CPU_DISPATCH) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+
+struct CpuidRegs {
+    u32 eax{0};
+    u32 ebx{0};
+    u32 ecx{0};
+    u32 edx{0};
+};
+
+CpuidRegs Cpuid(u32 leaf, u32 subleaf) noexcept {
+    CpuidRegs r;
+#if defined(TOOLBOX_CPU_DISPATCH)
+    __cpuid_count(leaf, subleaf, r.eax, r.ebx, r.ecx, r.edx);
+#else
+    int regs[4];
+    __cpuidex(regs, static_cast<int>(leaf), static_cast<int>(subleaf));
+    r.eax = static_cast<u32>(regs[0]);
+    r.ebx = static_cast<u32>(regs[1]);
+    r.ecx = static_cast<u32>(regs[2]);
+    r.edx = static_cast<u32>(regs[3]);
+#endif
+    return r;
+}
+
+u64 Xgetbv() noexcept {
+#if defined(TOOLBOX_CPU_DISPATCH)
+    u32 lo = 0;
+    u32 hi = 0;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<u64>(hi) << 32) | lo;
+#else
+    return _xgetbv(0);
+#endif
+}
+
+constexpr bool Bit(u32 reg, u32 bit) noexcept { return ((reg >> bit) & 1u) != 0; }
+
+Features Detect() noexcept {
+    Features f;
+    const u32 max_leaf = Cpuid(0, 0).eax;
+    if (max_leaf < 1) return f;
+
+    const CpuidRegs l1 = Cpuid(1, 0);
+    f.sse2 = Bit(l1.edx, 26);
+    f.sse42 = Bit(l1.ecx, 20);
+    f.popcnt = Bit(l1.ecx, 23);
+    f.fma = Bit(l1.ecx, 12);
+
+    // NOTE: The CPU may support AVX while the OS does not preserve YMM/ZMM state on context switch
+    const bool osxsave = Bit(l1.ecx, 27);
+    const u64 xcr0 = osxsave ? Xgetbv() : 0;
+    const bool os_avx = (xcr0 & 0x6) == 0x6;            // XMM | YMM
+    const bool os_avx512 = (xcr0 & 0xe6) == 0xe6;       // XMM | YMM | opmask | ZMM_Hi256 | Hi16_ZMM
+
+    f.avx = Bit(l1.ecx, 28) && os_avx;
+    f.fma = f.fma && f.avx;
+
+    if (max_leaf >= 7) {
+        const CpuidRegs l7 = Cpuid(7, 0);
+        f.avx2 = Bit(l7.ebx, 5) && f.avx;
+        f.bmi2 = Bit(l7.ebx, 8);
+        f.avx512f = Bit(l7.ebx, 16) && os_avx512;
+        f.avx512dq = Bit(l7.ebx, 17) && f.avx512f;
+        f.avx512bw = Bit(l7.ebx, 30) && f.avx512f;
+        f.avx512vl = Bit(l7.ebx, 31) && f.avx512f;
+        f.avx512vpopcntdq = Bit(l7.ecx, 14) && f.avx512f;
+    }
+    return f;
+}
+
+#else
+
+Features Detect() noexcept {
+    Features f;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+    f.neon = true;
+#endif
+    return f;
+}
+
+#endif
+
+SimdLevel LevelOf(const Features& f) noexcept {
+#if defined(TOOLBOX_CPU_DISPATCH)
+    if (f.avx512f && f.avx512bw && f.avx512vl && f.avx512dq && f.avx2 && f.fma && f.bmi2 && f.popcnt) {
+        return SimdLevel::AVX512;
+    }
+    if (f.avx2 && f.fma && f.bmi2 && f.popcnt) return SimdLevel::AVX2;
+    if (f.sse42 && f.popcnt) return SimdLevel::SSE42;
+#endif
+    return SimdLevel::Scalar;
+}
+
+// NOTE: Kernels compiled for a level only exist with TOOLBOX_CPU_DISPATCH, elsewhere everything
+// runs the scalar entries no matter what the hardware reports
+SimdLevel InitialLevel() noexcept {
+    const SimdLevel detected = GetDetectedLevel();
+    const char* env = std::getenv("TOOLBOX_SIMD");
+    if (!env || !*env) return detected;
+
+    auto requested = ParseLevel(env);
+    if (!requested) {
+        log::Warn("TOOLBOX_SIMD='{}' is not a SIMD level, using {}", env, ToString(detected));
+        return detected;
+    }
+    if (*requested > detected) {
+        log::Warn("TOOLBOX_SIMD={} is not supported by this CPU, using {}", env, ToString(detected));
+        return detected;
+    }
+    return *requested;
+}
+
+std::atomic<SimdLevel>& ActiveLevel() noexcept {
+    static std::atomic<SimdLevel> level{InitialLevel()};
+    return level;
+}
+
+} // namespace
+
+const Features& GetFeatures() noexcept {
+    static const Features features = Detect();
+    return features;
+}
+
+SimdLevel GetDetectedLevel() noexcept {
+    static const SimdLevel level = LevelOf(GetFeatures());
+    return level;
+}
+
+SimdLevel GetLevel() noexcept {
+    return ActiveLevel().load(std::memory_order_relaxed);
+}
+
+SimdLevel SetLevel(SimdLevel level) noexcept {
+    const SimdLevel clamped = std::min(level, GetDetectedLevel());
+    ActiveLevel().store(clamped, std::memory_order_relaxed);
+    return clamped;
+}
+
+std::string_view ToString(SimdLevel level) noexcept {
+    switch (level) {
+    case SimdLevel::SSE42:
+        return "sse4.2";
+    case SimdLevel::AVX2:
+        return "avx2";
+    case SimdLevel::AVX512:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
+
+result<SimdLevel> ParseLevel(std::string_view name) noexcept {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "scalar" || lower == "none") return SimdLevel::Scalar;
+    if (lower == "sse4.2" || lower == "sse42") return SimdLevel::SSE42;
+    if (lower == "avx2") return SimdLevel::AVX2;
+    if (lower == "avx512" || lower == "avx-512") return SimdLevel::AVX512;
+    if (lower == "native") return GetDetectedLevel();
+    return err(ErrorCode::INVALID_ARGUMENT, "Unknown SIMD level");
+}
+
+} // namespace ct::cpu
@@ -0,0 +1,76 @@
+#include "toolbox/base/memory/allocations.hpp"
+
+#include <atomic>
+
+#if defined(TOOLBOX_COUNT_ALLOCATIONS)
+#include <cstdlib>
+#include <new>
+#endif
+
+namespace ct::memory {
+
+namespace {
+
+std::atomic<u64> gAllocations{0};
+
+} // namespace
+
+u64 GetAllocationCount() noexcept {
+    return gAllocations.load(std::memory_order_relaxed);
+}
+
+#if defined(TOOLBOX_COUNT_ALLOCATIONS)
+
+namespace detail {
+
+void* Allocate(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void* AllocateAligned(std::size_t size, std::align_val_t alignment) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    // NOTE: aligned_alloc wants a size that is a multiple of the alignment
+    const std::size_t rounded = (size + align - 1) / align * align;
+    if (void* p = std::aligned_alloc(align, rounded == 0 ? align : rounded)) return p;
+    throw std::bad_alloc();
+}
+
+} // namespace detail
+
+#endif
+
+} // namespace ct::memory
+
+#if defined(TOOLBOX_COUNT_ALLOCATIONS)
+
+// NOTE: Only the two replaceable allocation functions everything else forwards to in libstdc++ and
+// libc++ (array and nothrow forms) count, the matching deallocation functions free. This object is
+// linked in whenever GetAllocationCount is referenced, i.e. whenever the hook is used.
+void* operator new(std::size_t size) {
+    return ct::memory::detail::Allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return ct::memory::detail::AllocateAligned(size, alignment);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+#endif
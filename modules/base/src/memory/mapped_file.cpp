@@ -0,0 +1,80 @@
+#include "toolbox/base/memory/mapped_file.hpp"
+
+#include <new>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TOOLBOX_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace ct::memory {
+
+MappedFile::~MappedFile() { Close(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mData(std::exchange(other.mData, nullptr)), mSize(std::exchange(other.mSize, 0)),
+      mMapped(std::exchange(other.mMapped, false)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        mData = std::exchange(other.mData, nullptr);
+        mSize = std::exchange(other.mSize, 0);
+        mMapped = std::exchange(other.mMapped, false);
+    }
+    return *this;
+}
+
+void MappedFile::Close() noexcept {
+    if (!mData) return;
+#if defined(TOOLBOX_HAS_MMAP)
+    if (mMapped) {
+        ::munmap(const_cast<u8*>(mData), mSize);
+        mData = nullptr;
+        mSize = 0;
+        return;
+    }
+#endif
+    ::operator delete(const_cast<u8*>(mData), std::align_val_t{kAlignment});
+    mData = nullptr;
+    mSize = 0;
+}
+
+result<MappedFile> MappedFile::Open(const std::filesystem::path& path) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec) return err(ErrorCode::FILE_NOT_FOUND, "Cannot open " + path.string() + ": " + ec.message());
+
+    MappedFile file;
+    if (size == 0) return ok(std::move(file));
+
+#if defined(TOOLBOX_HAS_MMAP)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return err(ErrorCode::FILE_ACCESS_DENIED, "Cannot open " + path.string());
+    void* data = ::mmap(nullptr, static_cast<std::size_t>(size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) return err(ErrorCode::FILE_READ_ERROR, "Cannot map " + path.string());
+
+    file.mData = static_cast<const u8*>(data);
+    file.mSize = static_cast<std::size_t>(size);
+    file.mMapped = true;
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return err(ErrorCode::FILE_ACCESS_DENIED, "Cannot open " + path.string());
+
+    auto* data = static_cast<u8*>(::operator new(static_cast<std::size_t>(size), std::align_val_t{kAlignment}));
+    file.mData = data;
+    file.mSize = static_cast<std::size_t>(size);
+    if (!in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(size))) {
+        return err(ErrorCode::FILE_READ_ERROR, "Cannot read " + path.string());
+    }
+#endif
+    return ok(std::move(file));
+}
+
+} // namespace ct::memory
@@ -0,0 +1,169 @@
+#include "toolbox/base/thread/thread_pool.hpp"
+#include "toolbox/base/logger/logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace ct {
+
+namespace detail {
+
+// NOTE: One ParallelFor call, it lives on the caller's stack. helpers (worker places still open)
+// and users (workers that took one and have not left RunChunks yet) are guarded by the pool mutex.
+// The caller unlists the job once it runs out of chunks and waits for users to drop to 0 before
+// the frame goes away, every claimed chunk is finished by then.
+struct ParallelForJob {
+    std::atomic<std::size_t> next{0};
+    std::atomic<u32> slots{0};
+    std::size_t count{0};
+    std::size_t chunk{0};
+    std::size_t chunks{0};
+    const ThreadPool::RangeFn* fn{nullptr};
+    std::size_t helpers{0};
+    std::size_t users{0};
+};
+
+void RunChunks(ParallelForJob& job) {
+    u32 slot = 0;
+    bool has_slot = false;
+    for (;;) {
+        const std::size_t c = job.next.fetch_add(1, std::memory_order_relaxed);
+        if (c >= job.chunks) break;
+        if (!has_slot) {
+            slot = job.slots.fetch_add(1, std::memory_order_relaxed);
+            has_slot = true;
+        }
+
+        const std::size_t begin = c * job.chunk;
+        const std::size_t end = std::min(job.count, begin + job.chunk);
+        (*job.fn)(begin, end, slot);
+    }
+}
+
+} // namespace detail
+
+result<ref<ThreadPool>> ThreadPool::Create(const ThreadPoolInfo& info) noexcept {
+    ref<ThreadPool> pool(new ThreadPool());
+
+    u32 workers = info.workers;
+    if (workers == 0) {
+        const u32 hw = std::thread::hardware_concurrency();
+        workers = hw > 1 ? hw - 1 : 0;
+    }
+
+    try {
+        pool->mWorkers.reserve(workers);
+        for (u32 i = 0; i < workers; ++i) {
+            pool->mWorkers.emplace_back([p = pool.get()] { p->WorkerLoop(); });
+        }
+    } catch (const std::system_error& e) {
+        log::Error("Failed to start worker thread: {}", e.what());
+        return err(ErrorCode::FAILED_TO_AQUIRE_RESOURCE, "Failed to start worker threads");
+    }
+
+    return pool;
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mMutex);
+        mStopping = true;
+    }
+    mCondition.notify_all();
+    for (auto& worker : mWorkers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    if (mWorkers.empty()) {
+        task();
+        return;
+    }
+    {
+        std::lock_guard lock(mMutex);
+        mTasks.push_back(std::move(task));
+    }
+    mCondition.notify_one();
+}
+
+void ThreadPool::ParallelFor(std::size_t count, std::size_t grain, const RangeFn& fn) {
+    if (count == 0) return;
+    grain = std::max<std::size_t>(grain, 1);
+
+    // NOTE: A few chunks per lane so uneven chunks still balance out
+    const std::size_t lanes = GetConcurrency();
+    const std::size_t chunk = std::max(grain, (count + lanes * 4 - 1) / (lanes * 4));
+    const std::size_t chunks = (count + chunk - 1) / chunk;
+    if (chunks <= 1 || mWorkers.empty()) {
+        fn(0, count, 0);
+        return;
+    }
+
+    detail::ParallelForJob job;
+    job.count = count;
+    job.chunk = chunk;
+    job.chunks = chunks;
+    job.fn = &fn;
+    job.helpers = std::min<std::size_t>(mWorkers.size(), chunks - 1);
+    {
+        std::lock_guard lock(mMutex);
+        mJobs.push_back(&job);
+    }
+    mCondition.notify_all();
+
+    detail::RunChunks(job);
+
+    std::unique_lock lock(mMutex);
+    std::erase(mJobs, &job);
+    mJobReleased.wait(lock, [&] { return job.users == 0; });
+}
+
+// NOTE: Newest job first, a nested ParallelFor is what its outer chunk is waiting on
+detail::ParallelForJob* ThreadPool::ClaimJob() noexcept {
+    for (auto it = mJobs.rbegin(); it != mJobs.rend(); ++it) {
+        detail::ParallelForJob* job = *it;
+        if (job->helpers == 0) continue;
+        if (job->next.load(std::memory_order_relaxed) >= job->chunks) {
+            job->helpers = 0;
+            continue;
+        }
+        --job->helpers;
+        ++job->users;
+        return job;
+    }
+    return nullptr;
+}
+
+void ThreadPool::WorkerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        detail::ParallelForJob* job = nullptr;
+        {
+            std::unique_lock lock(mMutex);
+            for (;;) {
+                job = ClaimJob();
+                if (job || mStopping || !mTasks.empty()) break;
+                mCondition.wait(lock);
+            }
+            if (!job) {
+                if (mTasks.empty()) return;
+                task = std::move(mTasks.front());
+                mTasks.pop_front();
+            }
+        }
+
+        if (job) {
+            detail::RunChunks(*job);
+            {
+                std::lock_guard lock(mMutex);
+                --job->users;
+            }
+            mJobReleased.notify_all();
+            continue;
+        }
+        task();
+    }
+}
+
+} // namespace ct
@@ -0,0 +1,105 @@
+#include "toolbox/base/cpu/cpu.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <string_view>
+#include <utility>
+
+namespace ct {
+namespace {
+
+constexpr std::array kLevels{cpu::SimdLevel::Scalar, cpu::SimdLevel::SSE42, cpu::SimdLevel::AVX2,
+                             cpu::SimdLevel::AVX512};
+
+// NOTE: Restores the active level so the order of the tests does not matter
+class Cpu : public ::testing::Test {
+protected:
+    void SetUp() override { mSaved = cpu::GetLevel(); }
+    void TearDown() override { cpu::SetLevel(mSaved); }
+
+private:
+    cpu::SimdLevel mSaved{cpu::SimdLevel::Scalar};
+};
+
+TEST_F(Cpu, ParsesLevelNames) {
+    const std::array<std::pair<std::string_view, cpu::SimdLevel>, 8> names{{
+        {"scalar", cpu::SimdLevel::Scalar},
+        {"none", cpu::SimdLevel::Scalar},
+        {"sse4.2", cpu::SimdLevel::SSE42},
+        {"sse42", cpu::SimdLevel::SSE42},
+        {"avx2", cpu::SimdLevel::AVX2},
+        {"avx512", cpu::SimdLevel::AVX512},
+        {"avx-512", cpu::SimdLevel::AVX512},
+        {"native", cpu::GetDetectedLevel()},
+    }};
+    for (const auto& [name, level] : names) {
+        auto parsed = cpu::ParseLevel(name);
+        ASSERT_TRUE(parsed) << name;
+        EXPECT_EQ(*parsed, level) << name;
+    }
+}
+
+TEST_F(Cpu, ParseIgnoresCase) {
+    auto sse = cpu::ParseLevel("SSE4.2");
+    ASSERT_TRUE(sse);
+    EXPECT_EQ(*sse, cpu::SimdLevel::SSE42);
+
+    auto avx = cpu::ParseLevel("AvX-512");
+    ASSERT_TRUE(avx);
+    EXPECT_EQ(*avx, cpu::SimdLevel::AVX512);
+}
+
+TEST_F(Cpu, ParseRejectsUnknownNames) {
+    for (std::string_view name : {"", "avx", "sse4", "avx2 ", "neon"}) {
+        auto parsed = cpu::ParseLevel(name);
+        ASSERT_FALSE(parsed) << name;
+        EXPECT_EQ(parsed.error().Code(), ErrorCode::INVALID_ARGUMENT);
+    }
+}
+
+TEST_F(Cpu, ToStringRoundTrips) {
+    for (cpu::SimdLevel level : kLevels) {
+        auto parsed = cpu::ParseLevel(cpu::ToString(level));
+        ASSERT_TRUE(parsed);
+        EXPECT_EQ(*parsed, level);
+    }
+}
+
+TEST_F(Cpu, DetectedLevelMatchesFeatures) {
+    const cpu::Features& f = cpu::GetFeatures();
+    const cpu::SimdLevel detected = cpu::GetDetectedLevel();
+    EXPECT_TRUE(detected < cpu::SimdLevel::SSE42 || (f.sse42 && f.popcnt));
+    EXPECT_TRUE(detected < cpu::SimdLevel::AVX2 || (f.avx2 && f.fma && f.bmi2));
+    EXPECT_TRUE(detected < cpu::SimdLevel::AVX512 || (f.avx512f && f.avx512bw && f.avx512vl && f.avx512dq));
+}
+
+TEST_F(Cpu, SetLevelClampsToDetected) {
+    const cpu::SimdLevel detected = cpu::GetDetectedLevel();
+    for (cpu::SimdLevel level : kLevels) {
+        const cpu::SimdLevel expected = level > detected ? detected : level;
+        EXPECT_EQ(cpu::SetLevel(level), expected);
+        EXPECT_EQ(cpu::GetLevel(), expected);
+    }
+}
+
+int Scalar() { return 0; }
+int Sse42() { return 1; }
+int Avx512() { return 3; }
+
+TEST_F(Cpu, KernelTableFallsBackToLowerEntries) {
+    const cpu::KernelTable<int (*)()> table{&Scalar, &Sse42, nullptr, &Avx512};
+    EXPECT_EQ(table.Get(cpu::SimdLevel::Scalar)(), 0);
+    EXPECT_EQ(table.Get(cpu::SimdLevel::SSE42)(), 1);
+    EXPECT_EQ(table.Get(cpu::SimdLevel::AVX2)(), 1);
+    EXPECT_EQ(table.Get(cpu::SimdLevel::AVX512)(), 3);
+
+    const cpu::KernelTable<int (*)()> scalar_only{&Scalar};
+    EXPECT_EQ(scalar_only.Get(cpu::SimdLevel::AVX512)(), 0);
+
+    cpu::SetLevel(cpu::SimdLevel::Scalar);
+    EXPECT_EQ(table.Get()(), 0);
+}
+
+} // namespace
+} // namespace ct
@@ -0,0 +1,76 @@
+#include "toolbox/base/base.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace ct {
+namespace {
+
+// NOTE: Test builds always define TOOLBOX_COUNT_ALLOCATIONS, see modules/base/CMakeLists.txt
+static_assert(memory::IsCountingAllocations());
+
+TEST(Allocations, ScopeCountsHeapAllocations) {
+    const memory::AllocationScope scope;
+    auto single = std::make_unique<int>(3);
+    auto array = std::make_unique<double[]>(16);
+    std::vector<int> grown;
+    grown.reserve(100);
+    EXPECT_EQ(scope.GetCount(), 3u);
+}
+
+TEST(Allocations, AlignedAllocationsCount) {
+    struct alignas(64) Line {
+        std::array<std::byte, 64> bytes;
+    };
+    const memory::AllocationScope scope;
+    auto line = std::make_unique<Line>();
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(line.get()) % 64, 0u);
+    EXPECT_EQ(scope.GetCount(), 1u);
+}
+
+TEST(Allocations, NothingIsCountedWithoutAllocating) {
+    std::vector<int> values(64, 1);
+    const memory::AllocationScope scope;
+    values.assign(32, 2);
+    values.resize(64);
+    EXPECT_EQ(scope.GetCount(), 0u);
+}
+
+TEST(FunctionRef, LargeCapturesDoNotAllocate) {
+    std::array<u64, 32> table{};
+    for (std::size_t i = 0; i < table.size(); ++i) table[i] = i * i;
+
+    const memory::AllocationScope scope;
+    const auto lookup = [table](std::size_t i) { return table[i]; };
+    const FunctionRef<u64(std::size_t)> ref = lookup;
+    EXPECT_EQ(ref(7), 49u);
+    EXPECT_EQ(scope.GetCount(), 0u);
+}
+
+TEST(ThreadPool, ParallelForDoesNotAllocateOnceWarm) {
+    auto pool = ThreadPool::Create({.workers = 3});
+    ASSERT_TRUE(pool);
+
+    std::vector<std::atomic<u32>> hits(1000);
+    const auto run = [&] {
+        (*pool)->ParallelFor(hits.size(), 16, [&](std::size_t begin, std::size_t end, u32) {
+            for (std::size_t i = begin; i < end; ++i) hits[i].fetch_add(1, std::memory_order_relaxed);
+        });
+    };
+    for (int i = 0; i < 4; ++i) run();
+
+    const memory::AllocationScope scope;
+    for (int i = 0; i < 100; ++i) run();
+    EXPECT_EQ(scope.GetCount(), 0u);
+
+    for (const auto& h : hits) ASSERT_EQ(h.load(), 104u);
+}
+
+} // namespace
+} // namespace ct
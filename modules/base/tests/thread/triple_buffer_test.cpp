@@ -0,0 +1,77 @@
+#include "toolbox/base/thread/triple_buffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <thread>
+
+namespace ct {
+namespace {
+
+TEST(TripleBuffer, ReaderSeesOnlyTheNewestValue) {
+    TripleBuffer<int> buffer;
+    EXPECT_FALSE(buffer.Acquire());
+
+    buffer.Back() = 1;
+    buffer.Publish();
+    ASSERT_TRUE(buffer.Acquire());
+    EXPECT_EQ(buffer.Front(), 1);
+    EXPECT_FALSE(buffer.Acquire());
+    EXPECT_EQ(buffer.Front(), 1);
+
+    // NOTE: Values published before the reader comes back are overwritten, not queued
+    buffer.Back() = 2;
+    buffer.Publish();
+    buffer.Back() = 3;
+    buffer.Publish();
+    ASSERT_TRUE(buffer.Acquire());
+    EXPECT_EQ(buffer.Front(), 3);
+    EXPECT_FALSE(buffer.Acquire());
+}
+
+TEST(TripleBuffer, WriterNeverTouchesTheReaderSlot) {
+    TripleBuffer<int> buffer;
+    buffer.Back() = 1;
+    buffer.Publish();
+    ASSERT_TRUE(buffer.Acquire());
+    const int* front = &buffer.Front();
+    for (int i = 2; i < 10; ++i) {
+        EXPECT_NE(&buffer.Back(), front);
+        buffer.Back() = i;
+        buffer.Publish();
+    }
+    EXPECT_EQ(buffer.Front(), 1);
+}
+
+// NOTE: Every slot of a value holds its sequence number, a torn read would mix two of them
+TEST(TripleBuffer, ConcurrentValuesArriveWholeAndInOrder) {
+    struct Value {
+        std::array<u64, 32> words{};
+    };
+    constexpr u64 kCount = 200000;
+    TripleBuffer<Value> buffer;
+
+    std::thread writer([&] {
+        for (u64 seq = 1; seq <= kCount; ++seq) {
+            buffer.Back().words.fill(seq);
+            buffer.Publish();
+        }
+    });
+
+    u64 last = 0, taken = 0;
+    while (last < kCount) {
+        if (!buffer.Acquire()) continue;
+        const Value& value = buffer.Front();
+        const u64 seq = value.words[0];
+        for (const u64 word : value.words) ASSERT_EQ(word, seq);
+        ASSERT_GT(seq, last);
+        last = seq;
+        ++taken;
+    }
+    writer.join();
+    EXPECT_EQ(last, kCount);
+    EXPECT_GT(taken, 0u);
+}
+
+} // namespace
+} // namespace ct
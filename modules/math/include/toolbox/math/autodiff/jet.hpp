@@ -0,0 +1,269 @@
+#pragma once
+
+#include "../detail/arithmetic.hpp"
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+//NOTE: Forward-mode automatic differentiation. jet<T, N> is a value a plus the gradient v with
+// respect to N seeded variables. Arithmetic follows the chain rule, so evaluating a residual
+// once on jets yields the value and the full N-column Jacobian row in the same pass. The
+// gradient loops have a fixed trip count and vectorize.
+//
+//   using J = jet<double, 6>;
+//   vec<6, J> x = ...; x[k] = J::variable(x0[k], k);
+//   J r = f(x);            // r.a = f(x0), r.v[k] = df/dx_k
+//
+// jet satisfies ct::floating_point, so vec/mat/quat/so3/se3 and interop/transform.hpp work on it.
+
+namespace ct {
+
+template<std::floating_point T, std::size_t N>
+struct jet {
+    using scalar_type = T;
+    static constexpr std::size_t size = N;
+
+    T a{};
+    std::array<T, N> v{};
+
+    constexpr jet() noexcept = default;
+
+    explicit constexpr jet(T value) noexcept : a(value) {}
+
+    template<arithmetic U>
+    requires (!std::same_as<U, T> && std::is_arithmetic_v<U>)
+    explicit constexpr jet(U value) noexcept : a(static_cast<T>(value)) {}
+
+    constexpr jet(T value, const std::array<T, N>& grad) noexcept : a(value), v(grad) {}
+
+    //NOTE: Seed for the k-th independent variable, d/dx_k = 1
+    [[nodiscard]] static constexpr jet variable(T value, std::size_t k) noexcept {
+        jet r(value);
+        r.v[k] = T{1};
+        return r;
+    }
+
+    constexpr jet& operator+=(const jet& o) noexcept {
+        a += o.a;
+        for (std::size_t i = 0; i < N; ++i) v[i] += o.v[i];
+        return *this;
+    }
+
+    constexpr jet& operator-=(const jet& o) noexcept {
+        a -= o.a;
+        for (std::size_t i = 0; i < N; ++i) v[i] -= o.v[i];
+        return *this;
+    }
+
+    constexpr jet& operator*=(const jet& o) noexcept {
+        for (std::size_t i = 0; i < N; ++i) v[i] = v[i] * o.a + a * o.v[i];
+        a *= o.a;
+        return *this;
+    }
+
+    constexpr jet& operator/=(const jet& o) noexcept {
+        const T inv = T{1} / o.a;
+        const T q = a * inv;
+        for (std::size_t i = 0; i < N; ++i) v[i] = (v[i] - q * o.v[i]) * inv;
+        a = q;
+        return *this;
+    }
+
+    constexpr jet& operator+=(T s) noexcept {
+        a += s;
+        return *this;
+    }
+
+    constexpr jet& operator-=(T s) noexcept {
+        a -= s;
+        return *this;
+    }
+
+    constexpr jet& operator*=(T s) noexcept {
+        a *= s;
+        for (std::size_t i = 0; i < N; ++i) v[i] *= s;
+        return *this;
+    }
+
+    constexpr jet& operator/=(T s) noexcept {
+        return *this *= T{1} / s;
+    }
+
+    [[nodiscard]] constexpr jet operator+() const noexcept { return *this; }
+
+    [[nodiscard]] constexpr jet operator-() const noexcept {
+        jet r;
+        r.a = -a;
+        for (std::size_t i = 0; i < N; ++i) r.v[i] = -v[i];
+        return r;
+    }
+
+    [[nodiscard]] friend constexpr jet operator+(jet x, const jet& y) noexcept { return x += y; }
+    [[nodiscard]] friend constexpr jet operator-(jet x, const jet& y) noexcept { return x -= y; }
+    [[nodiscard]] friend constexpr jet operator*(jet x, const jet& y) noexcept { return x *= y; }
+    [[nodiscard]] friend constexpr jet operator/(jet x, const jet& y) noexcept { return x /= y; }
+
+    [[nodiscard]] friend constexpr jet operator+(jet x, std::type_identity_t<T> s) noexcept { return x += s; }
+    [[nodiscard]] friend constexpr jet operator-(jet x, std::type_identity_t<T> s) noexcept { return x -= s; }
+    [[nodiscard]] friend constexpr jet operator*(jet x, std::type_identity_t<T> s) noexcept { return x *= s; }
+    [[nodiscard]] friend constexpr jet operator/(jet x, std::type_identity_t<T> s) noexcept { return x /= s; }
+
+    [[nodiscard]] friend constexpr jet operator+(std::type_identity_t<T> s, jet x) noexcept { return x += s; }
+    [[nodiscard]] friend constexpr jet operator*(std::type_identity_t<T> s, jet x) noexcept { return x *= s; }
+
+    [[nodiscard]] friend constexpr jet operator-(std::type_identity_t<T> s, const jet& x) noexcept {
+        jet r = -x;
+        r.a += s;
+        return r;
+    }
+
+    [[nodiscard]] friend constexpr jet operator/(std::type_identity_t<T> s, const jet& x) noexcept {
+        const T inv = T{1} / x.a;
+        const T d = -s * inv * inv;
+        jet r(s * inv);
+        for (std::size_t i = 0; i < N; ++i) r.v[i] = d * x.v[i];
+        return r;
+    }
+
+    //NOTE: Comparisons only look at the value, the derivative does not take part in branching
+    [[nodiscard]] friend constexpr bool operator==(const jet& x, const jet& y) noexcept { return x.a == y.a; }
+    [[nodiscard]] friend constexpr auto operator<=>(const jet& x, const jet& y) noexcept { return x.a <=> y.a; }
+    [[nodiscard]] friend constexpr bool operator==(const jet& x, std::type_identity_t<T> s) noexcept { return x.a == s; }
+    [[nodiscard]] friend constexpr auto operator<=>(const jet& x, std::type_identity_t<T> s) noexcept { return x.a <=> s; }
+};
+
+template<typename T, std::size_t N>
+struct is_dual_number<jet<T, N>> : std::true_type {};
+
+template<typename T, std::size_t N>
+struct scalar_type<jet<T, N>> {
+    using type = T;
+};
+
+namespace detail {
+
+//NOTE: f(a + v e) = f(a) + f'(a) v e
+template<typename T, std::size_t N>
+[[nodiscard]] constexpr jet<T, N> chain(const jet<T, N>& x, T fa, T dfa) noexcept {
+    jet<T, N> r(fa);
+    for (std::size_t i = 0; i < N; ++i) r.v[i] = dfa * x.v[i];
+    return r;
+}
+
+} // namespace detail
+
+template<typename T, std::size_t N>
+[[nodiscard]] inline jet<T, N> sqrt(const jet<T, N>& x) noexcept {
+    const T s = std::sqrt(x.a);
+    return detail::chain(x, s, T{0.5} / s);
+}
+
+template<typename T, std::size_t N>
+[[nodiscard]] constexpr jet<T, N> abs(const jet<T, N>& x) noexcept {
+    return x.a < T{0} ? -x : x;
+}
+
+template<typename T, std::size_t N>
+[[nodiscard]] constexpr jet<T, N> fabs(const jet<T, N>& x) noexcept {
+    return abs(x);
+}
+
+template<typename T, std::size_t N>
+[[nodiscard]] inline jet<T, N> exp(const jet<T, N>& x) noexcept {
+    const T e = std::exp(x.a);
+    return detail::chain(x, e, e);
+}
+
+//NOTE: Not called log, ct::log is the logging namespace of toolbox::base. Pairs with the scalar ln
+// of common/functions.hpp.
+template<typename T, std::size_t N>
+[[nodiscard]] inline jet<T, N> ln(const jet<T, N>& x) noexcept {
+    return detail::chain(x, std::log(x.a), T{1} / x.a);
+}
+
+template<typename T, std::size_t N>
+[[nodiscard]] inline jet<T, N> sin(const jet<T, N>& x) noexcept {
+    return detail::chain(x, std::sin(x.a), std::cos(x.a));
+}
+
+template<typename T, std::size_t N>
+[[nodiscard]] inline jet<T, N> cos(const jet<T, N>& x) noexcept {
+    return detail::chain(x, std::cos(x.a), -std::sin(x.a));
+}
+
+template<typename T, std::size_t N>
+[[nodiscard]] inline jet<T, N> tan(const jet<T, N>& x) noexcept {
+    const T t = std::tan(x.a);
+    return detail::chain(x, t, T{1} + t * t);
+}
+
+template<typename T, std::size_t N>
+[[nodiscard]] inline jet<T, N> asin(const jet<T, N>& x) noexcept {
+    return detail::chain(x, std::asin(x.a), T{1} / std::sqrt(T{1} - x.a * x.a));
+}
+
+template<typename T, std::size_t N>
+[[nodiscard]] inline jet<T, N> acos(const jet<T, N>& x) noexcept {
+    return detail::chain(x, std::acos(x.a), T{-1} / std::sqrt(T{1} - x.a * x.a));
+}
+
+template<typename T, std::size_t N>
+[[nodiscard]] inline jet<T, N> atan(const jet<T, N>& x) noexcept {
+    return detail::chain(x, std::atan(x.a), T{1} / (T{1} + x.a * x.a));
+}
+
+//NOTE: d atan2(y, x) = (x dy - y dx) / (x^2 + y^2)
+template<typename T, std::size_t N>
+[[nodiscard]] inline jet<T, N> atan2(const jet<T, N>& y, const jet<T, N>& x) noexcept {
+    const T inv = T{1} / (x.a * x.a + y.a * y.a);
+    jet<T, N> r(std::atan2(y.a, x.a));
+    for (std::size_t i = 0; i < N; ++i) r.v[i] = (x.a * y.v[i] - y.a * x.v[i]) * inv;
+    return r;
+}
+
+template<typename T, std::size_t N>
+[[nodiscard]] inline jet<T, N> pow(const jet<T, N>& x, std::type_identity_t<T> p) noexcept {
+    return detail::chain(x, std::pow(x.a, p), p * std::pow(x.a, p - T{1}));
+}
+
+template<typename T, std::size_t N>
+[[nodiscard]] inline bool isfinite(const jet<T, N>& x) noexcept {
+    if (!std::isfinite(x.a)) return false;
+    for (std::size_t i = 0; i < N; ++i) {
+        if (!std::isfinite(x.v[i])) return false;
+    }
+    return true;
+}
+
+template<typename T, std::size_t N>
+[[nodiscard]] inline bool isnan(const jet<T, N>& x) noexcept {
+    if (std::isnan(x.a)) return true;
+    for (std::size_t i = 0; i < N; ++i) {
+        if (std::isnan(x.v[i])) return true;
+    }
+    return false;
+}
+
+static_assert(std::is_trivially_copyable_v<jet<double, 6>>);
+
+} // namespace ct
+
+template<typename T, std::size_t N>
+class std::numeric_limits<ct::jet<T, N>> : public std::numeric_limits<T> {
+    using J = ct::jet<T, N>;
+
+public:
+    static constexpr J min() noexcept { return J(std::numeric_limits<T>::min()); }
+    static constexpr J max() noexcept { return J(std::numeric_limits<T>::max()); }
+    static constexpr J lowest() noexcept { return J(std::numeric_limits<T>::lowest()); }
+    static constexpr J epsilon() noexcept { return J(std::numeric_limits<T>::epsilon()); }
+    static constexpr J round_error() noexcept { return J(std::numeric_limits<T>::round_error()); }
+    static constexpr J infinity() noexcept { return J(std::numeric_limits<T>::infinity()); }
+    static constexpr J quiet_NaN() noexcept { return J(std::numeric_limits<T>::quiet_NaN()); }
+    static constexpr J signaling_NaN() noexcept { return J(std::numeric_limits<T>::signaling_NaN()); }
+    static constexpr J denorm_min() noexcept { return J(std::numeric_limits<T>::denorm_min()); }
+};
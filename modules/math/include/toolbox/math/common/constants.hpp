@@ -8,13 +8,13 @@
 namespace ct {
 
 template<floating_point T>
-inline constexpr T pi = std::numbers::pi_v<T>;
+inline constexpr T pi = T(std::numbers::pi_v<scalar_t<T>>);
 
 template<floating_point T>
-inline constexpr T two_pi = std::numbers::pi_v<T> * T{2};
+inline constexpr T two_pi = T(std::numbers::pi_v<scalar_t<T>> * 2);
 
 template<floating_point T>
-inline constexpr T half_pi = std::numbers::pi_v<T> / T{2};
+inline constexpr T half_pi = T(std::numbers::pi_v<scalar_t<T>> / 2);
 
 template<floating_point T>
 inline constexpr T epsilon = std::numeric_limits<T>::epsilon();
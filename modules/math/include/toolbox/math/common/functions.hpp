@@ -3,6 +3,7 @@
 #include "../detail/arithmetic.hpp"
 #include "./constants.hpp"
 #include <cmath>
+#include <limits>
 
 namespace ct {
 
@@ -30,7 +31,7 @@ template<arithmetic T>
 
 template<arithmetic T>
 [[nodiscard]] constexpr T abs(T value) noexcept {
-    if constexpr (floating_point<T>) {
+    if constexpr (std::floating_point<T>) {
         return std::fabs(value);
     } else {
         return value < T{0} ? -value : value;
@@ -52,11 +53,38 @@ template<arithmetic T>
     return min(max(value, lo), hi);
 }
 
+namespace detail {
+
+//NOTE: Newton iteration for constant evaluation only, runtime always goes through std::sqrt
+template<std::floating_point T>
+[[nodiscard]] consteval T sqrt_newton(T value) noexcept {
+    if (value < T{0} || value != value) return std::numeric_limits<T>::quiet_NaN();
+    if (value == T{0} || value == infinity<T>) return value;
+
+    T cur = value < T{1} ? T{1} : value;
+    T prev = T{0};
+    for (int i = 0; i < 4096 && cur != prev; ++i) {
+        const T next = T{0.5} * (cur + value / cur);
+        if (next == prev) break;    // 1 ulp oscillation
+        prev = cur;
+        cur = next;
+    }
+    return cur;
+}
+
+} // namespace detail
+
 template<arithmetic T>
-[[nodiscard]] inline T sqrt(T value) noexcept {
-    if constexpr (floating_point<T>) {
+[[nodiscard]] constexpr T sqrt(T value) noexcept {
+    if constexpr (std::floating_point<T>) {
+        if consteval {
+            return detail::sqrt_newton(value);
+        }
         return std::sqrt(value);
     } else {
+        if consteval {
+            return static_cast<T>(detail::sqrt_newton(static_cast<long double>(value)));
+        }
         return static_cast<T>(std::sqrt(static_cast<long double>(value)));
     }
 }
@@ -66,6 +94,13 @@ template<floating_point T>
     return abs(a - b) <= tolerance;
 }
 
+//NOTE: Natural logarithm. Not called log, ct::log is the logging namespace of toolbox::base. The jet
+// overload has the same name, so templated functors call ln(x) for built-in and jet scalars alike.
+template<floating_point T>
+[[nodiscard]] inline T ln(T value) noexcept {
+    return std::log(value);
+}
+
 using std::sin;
 using std::cos;
 using std::tan;
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+namespace ct {
+
+//NOTE: Over-aligned allocator so SoA buffers start on a cache line / full vector register
+template<typename T, std::size_t Align = 64>
+requires (Align >= alignof(T) && (Align & (Align - 1)) == 0)
+class aligned_allocator {
+public:
+    using value_type = T;
+    static constexpr std::size_t alignment = Align;
+
+    template<typename U>
+    struct rebind {
+        using other = aligned_allocator<U, Align>;
+    };
+
+    constexpr aligned_allocator() noexcept = default;
+
+    template<typename U>
+    constexpr aligned_allocator(const aligned_allocator<U, Align>&) noexcept {}
+
+    [[nodiscard]] T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Align}));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t{Align});
+    }
+
+    template<typename U>
+    [[nodiscard]] friend constexpr bool operator==(const aligned_allocator&,
+                                                   const aligned_allocator<U, Align>&) noexcept {
+        return true;
+    }
+};
+
+} // namespace ct
@@ -2,14 +2,32 @@
 
 #include <cstdint>
 #include <concepts>
+#include <type_traits>
 
 namespace ct {
 
+//NOTE: Dual-number scalars (autodiff/jet.hpp) specialize this to true. They behave like
+// floating point values in vec/mat/quat and carry their derivatives along.
+template<typename T>
+struct is_dual_number : std::false_type {};
+
+template<typename T>
+inline constexpr bool is_dual_number_v = is_dual_number<T>::value;
+
+//NOTE: Underlying built-in type, double for jet<double, N>
+template<typename T>
+struct scalar_type {
+    using type = T;
+};
+
+template<typename T>
+using scalar_t = typename scalar_type<T>::type;
+
 template<typename T>
 concept integral = std::integral<T>;
 
 template<typename T>
-concept floating_point = std::floating_point<T>;
+concept floating_point = std::floating_point<T> || is_dual_number_v<T>;
 
 template<typename T>
 concept arithmetic = integral<T> || floating_point<T>;
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "toolbox/base/cpu/cpu.hpp"
+
+//NOTE: Runtime ISA dispatch for batch kernels. A kernel body is written once as a plain loop and
+// force-inlined into clones compiled for AVX2 and AVX-512, so the same source is vectorized with
+// the wider registers. cpu::GetLevel() picks the clone per call, TOOLBOX_SIMD overrides it.
+//
+//   detail::dispatch<&detail::my_body<float>>(args...);
+//
+// Bodies are marked TOOLBOX_FORCE_INLINE. Without TOOLBOX_CPU_DISPATCH (MSVC, non-x86) the body is
+// called directly.
+
+namespace ct::detail {
+
+#if defined(TOOLBOX_CPU_DISPATCH)
+
+template<auto Body, typename... Args>
+void run_scalar(Args... args) noexcept {
+    Body(args...);
+}
+
+template<auto Body, typename... Args>
+TOOLBOX_TARGET_AVX2 void run_avx2(Args... args) noexcept {
+    Body(args...);
+}
+
+template<auto Body, typename... Args>
+TOOLBOX_TARGET_AVX512 void run_avx512(Args... args) noexcept {
+    Body(args...);
+}
+
+#endif
+
+template<auto Body, typename... Args>
+void dispatch(Args... args) noexcept {
+#if defined(TOOLBOX_CPU_DISPATCH)
+    static constexpr cpu::KernelTable<void (*)(Args...) noexcept> table{
+        &run_scalar<Body, Args...>, nullptr, &run_avx2<Body, Args...>, &run_avx512<Body, Args...>};
+    table.Get()(args...);
+#else
+    Body(args...);
+#endif
+}
+
+} // namespace ct::detail
@@ -0,0 +1,447 @@
+#pragma once
+
+#include <type_traits>
+
+//NOTE: Compile-time SIMD selection for the hand-written 4-wide kernels used by
+// mat<4,4,T> and vec<4,T>. Define CT_MATH_NO_SIMD to force the scalar code paths.
+#if !defined(CT_MATH_NO_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CT_MATH_SSE2 1
+#endif
+#if defined(CT_MATH_SSE2) && defined(__AVX__)
+#define CT_MATH_AVX 1
+#endif
+#if defined(CT_MATH_SSE2) && defined(__FMA__)
+#define CT_MATH_FMA 1
+#endif
+#if !defined(CT_MATH_SSE2) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define CT_MATH_NEON 1
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define CT_MATH_NEON64 1
+#endif
+#endif
+#endif
+
+#if defined(_MSC_VER) || defined(__GNUC__) || defined(__clang__)
+#define CT_MATH_RESTRICT __restrict
+#else
+#define CT_MATH_RESTRICT
+#endif
+
+#if defined(CT_MATH_SSE2)
+#include <immintrin.h>
+#elif defined(CT_MATH_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace ct::detail::simd {
+
+template<typename T>
+inline constexpr bool enabled =
+#if defined(CT_MATH_SSE2) || defined(CT_MATH_NEON64)
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+#elif defined(CT_MATH_NEON)
+    std::is_same_v<T, float>;
+#else
+    false;
+#endif
+
+//NOTE: Only the float SSE path has a vectorized 4x4 inverse, the others use the cofactor expansion
+template<typename T>
+inline constexpr bool has_inverse =
+#if defined(CT_MATH_SSE2)
+    std::is_same_v<T, float>;
+#else
+    false;
+#endif
+
+#if defined(CT_MATH_SSE2)
+
+[[nodiscard]] inline __m128 fmadd(__m128 a, __m128 b, __m128 c) noexcept {
+#if defined(CT_MATH_FMA)
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+[[nodiscard]] inline __m128 hsum(__m128 v) noexcept {
+    __m128 t = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_add_ps(t, _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+inline void add4(const float* a, const float* b, float* r) noexcept {
+    _mm_storeu_ps(r, _mm_add_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+}
+
+inline void sub4(const float* a, const float* b, float* r) noexcept {
+    _mm_storeu_ps(r, _mm_sub_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+}
+
+inline void mul4(const float* a, const float* b, float* r) noexcept {
+    _mm_storeu_ps(r, _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+}
+
+inline void scale4(const float* a, float s, float* r) noexcept {
+    _mm_storeu_ps(r, _mm_mul_ps(_mm_loadu_ps(a), _mm_set1_ps(s)));
+}
+
+[[nodiscard]] inline float dot4(const float* a, const float* b) noexcept {
+    return _mm_cvtss_f32(hsum(_mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b))));
+}
+
+inline void mat4_mul_vec4(const float* m, const float* v, float* r) noexcept {
+    __m128 acc = _mm_mul_ps(_mm_loadu_ps(m), _mm_set1_ps(v[0]));
+    acc = fmadd(_mm_loadu_ps(m + 4), _mm_set1_ps(v[1]), acc);
+    acc = fmadd(_mm_loadu_ps(m + 8), _mm_set1_ps(v[2]), acc);
+    acc = fmadd(_mm_loadu_ps(m + 12), _mm_set1_ps(v[3]), acc);
+    _mm_storeu_ps(r, acc);
+}
+
+inline void mat4_mul(const float* a, const float* b, float* r) noexcept {
+    const __m128 a0 = _mm_loadu_ps(a);
+    const __m128 a1 = _mm_loadu_ps(a + 4);
+    const __m128 a2 = _mm_loadu_ps(a + 8);
+    const __m128 a3 = _mm_loadu_ps(a + 12);
+    for (int j = 0; j < 4; ++j) {
+        const float* bj = b + 4 * j;
+        __m128 acc = _mm_mul_ps(a0, _mm_set1_ps(bj[0]));
+        acc = fmadd(a1, _mm_set1_ps(bj[1]), acc);
+        acc = fmadd(a2, _mm_set1_ps(bj[2]), acc);
+        acc = fmadd(a3, _mm_set1_ps(bj[3]), acc);
+        _mm_storeu_ps(r + 4 * j, acc);
+    }
+}
+
+//NOTE: Block-wise 2x2 adjugate inverse. The kernel is written for row-major input, feeding it
+// column-major data inverts the transpose, which is the transpose of the inverse, so the
+// output is again the column-major inverse.
+#define CT_SIMD_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+#define CT_SIMD_SWIZZLE(v, x, y, z, w) CT_SIMD_SHUFFLE(v, v, x, y, z, w)
+
+[[nodiscard]] inline __m128 mat2_mul(__m128 a, __m128 b) noexcept {
+    return _mm_add_ps(_mm_mul_ps(a, CT_SIMD_SWIZZLE(b, 0, 3, 0, 3)),
+        _mm_mul_ps(CT_SIMD_SWIZZLE(a, 1, 0, 3, 2), CT_SIMD_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+[[nodiscard]] inline __m128 mat2_adj_mul(__m128 a, __m128 b) noexcept {
+    return _mm_sub_ps(_mm_mul_ps(CT_SIMD_SWIZZLE(a, 3, 3, 0, 0), b),
+        _mm_mul_ps(CT_SIMD_SWIZZLE(a, 1, 1, 2, 2), CT_SIMD_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+[[nodiscard]] inline __m128 mat2_mul_adj(__m128 a, __m128 b) noexcept {
+    return _mm_sub_ps(_mm_mul_ps(a, CT_SIMD_SWIZZLE(b, 3, 0, 3, 0)),
+        _mm_mul_ps(CT_SIMD_SWIZZLE(a, 1, 0, 3, 2), CT_SIMD_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+[[nodiscard]] inline bool mat4_inverse(const float* m, float* r, float eps) noexcept {
+    const __m128 r0 = _mm_loadu_ps(m);
+    const __m128 r1 = _mm_loadu_ps(m + 4);
+    const __m128 r2 = _mm_loadu_ps(m + 8);
+    const __m128 r3 = _mm_loadu_ps(m + 12);
+
+    const __m128 a = _mm_movelh_ps(r0, r1);
+    const __m128 b = _mm_movehl_ps(r1, r0);
+    const __m128 c = _mm_movelh_ps(r2, r3);
+    const __m128 d = _mm_movehl_ps(r3, r2);
+
+    // (|A| |B| |C| |D|)
+    const __m128 det_sub = _mm_sub_ps(
+        _mm_mul_ps(CT_SIMD_SHUFFLE(r0, r2, 0, 2, 0, 2), CT_SIMD_SHUFFLE(r1, r3, 1, 3, 1, 3)),
+        _mm_mul_ps(CT_SIMD_SHUFFLE(r0, r2, 1, 3, 1, 3), CT_SIMD_SHUFFLE(r1, r3, 0, 2, 0, 2)));
+    const __m128 det_a = CT_SIMD_SWIZZLE(det_sub, 0, 0, 0, 0);
+    const __m128 det_b = CT_SIMD_SWIZZLE(det_sub, 1, 1, 1, 1);
+    const __m128 det_c = CT_SIMD_SWIZZLE(det_sub, 2, 2, 2, 2);
+    const __m128 det_d = CT_SIMD_SWIZZLE(det_sub, 3, 3, 3, 3);
+
+    const __m128 d_c = mat2_adj_mul(d, c);
+    const __m128 a_b = mat2_adj_mul(a, b);
+    __m128 x = _mm_sub_ps(_mm_mul_ps(det_d, a), mat2_mul(b, d_c));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(det_a, d), mat2_mul(c, a_b));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(det_b, c), mat2_mul_adj(d, a_b));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(det_c, b), mat2_mul_adj(a, d_c));
+
+    __m128 det_m = _mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c));
+    det_m = _mm_sub_ps(det_m, hsum(_mm_mul_ps(a_b, CT_SIMD_SWIZZLE(d_c, 0, 2, 1, 3))));
+
+    const float det = _mm_cvtss_f32(det_m);
+    if (!(det > eps || det < -eps)) {
+        return false;
+    }
+
+    const __m128 rdet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det_m);
+    x = _mm_mul_ps(x, rdet);
+    y = _mm_mul_ps(y, rdet);
+    z = _mm_mul_ps(z, rdet);
+    w = _mm_mul_ps(w, rdet);
+
+    _mm_storeu_ps(r, CT_SIMD_SHUFFLE(x, y, 3, 1, 3, 1));
+    _mm_storeu_ps(r + 4, CT_SIMD_SHUFFLE(x, y, 2, 0, 2, 0));
+    _mm_storeu_ps(r + 8, CT_SIMD_SHUFFLE(z, w, 3, 1, 3, 1));
+    _mm_storeu_ps(r + 12, CT_SIMD_SHUFFLE(z, w, 2, 0, 2, 0));
+    return true;
+}
+
+#undef CT_SIMD_SWIZZLE
+#undef CT_SIMD_SHUFFLE
+
+#if defined(CT_MATH_AVX)
+
+[[nodiscard]] inline __m256d fmadd(__m256d a, __m256d b, __m256d c) noexcept {
+#if defined(CT_MATH_FMA)
+    return _mm256_fmadd_pd(a, b, c);
+#else
+    return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+}
+
+inline void add4(const double* a, const double* b, double* r) noexcept {
+    _mm256_storeu_pd(r, _mm256_add_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b)));
+}
+
+inline void sub4(const double* a, const double* b, double* r) noexcept {
+    _mm256_storeu_pd(r, _mm256_sub_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b)));
+}
+
+inline void mul4(const double* a, const double* b, double* r) noexcept {
+    _mm256_storeu_pd(r, _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b)));
+}
+
+inline void scale4(const double* a, double s, double* r) noexcept {
+    _mm256_storeu_pd(r, _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_set1_pd(s)));
+}
+
+[[nodiscard]] inline double dot4(const double* a, const double* b) noexcept {
+    const __m256d p = _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b));
+    const __m128d s = _mm_add_pd(_mm256_castpd256_pd128(p), _mm256_extractf128_pd(p, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+inline void mat4_mul_vec4(const double* m, const double* v, double* r) noexcept {
+    __m256d acc = _mm256_mul_pd(_mm256_loadu_pd(m), _mm256_set1_pd(v[0]));
+    acc = fmadd(_mm256_loadu_pd(m + 4), _mm256_set1_pd(v[1]), acc);
+    acc = fmadd(_mm256_loadu_pd(m + 8), _mm256_set1_pd(v[2]), acc);
+    acc = fmadd(_mm256_loadu_pd(m + 12), _mm256_set1_pd(v[3]), acc);
+    _mm256_storeu_pd(r, acc);
+}
+
+inline void mat4_mul(const double* a, const double* b, double* r) noexcept {
+    const __m256d a0 = _mm256_loadu_pd(a);
+    const __m256d a1 = _mm256_loadu_pd(a + 4);
+    const __m256d a2 = _mm256_loadu_pd(a + 8);
+    const __m256d a3 = _mm256_loadu_pd(a + 12);
+    for (int j = 0; j < 4; ++j) {
+        const double* bj = b + 4 * j;
+        __m256d acc = _mm256_mul_pd(a0, _mm256_set1_pd(bj[0]));
+        acc = fmadd(a1, _mm256_set1_pd(bj[1]), acc);
+        acc = fmadd(a2, _mm256_set1_pd(bj[2]), acc);
+        acc = fmadd(a3, _mm256_set1_pd(bj[3]), acc);
+        _mm256_storeu_pd(r + 4 * j, acc);
+    }
+}
+
+#else
+
+//NOTE: SSE2 only has 2-wide doubles, each column is handled as a lo/hi pair
+inline void add4(const double* a, const double* b, double* r) noexcept {
+    _mm_storeu_pd(r, _mm_add_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)));
+    _mm_storeu_pd(r + 2, _mm_add_pd(_mm_loadu_pd(a + 2), _mm_loadu_pd(b + 2)));
+}
+
+inline void sub4(const double* a, const double* b, double* r) noexcept {
+    _mm_storeu_pd(r, _mm_sub_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)));
+    _mm_storeu_pd(r + 2, _mm_sub_pd(_mm_loadu_pd(a + 2), _mm_loadu_pd(b + 2)));
+}
+
+inline void mul4(const double* a, const double* b, double* r) noexcept {
+    _mm_storeu_pd(r, _mm_mul_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)));
+    _mm_storeu_pd(r + 2, _mm_mul_pd(_mm_loadu_pd(a + 2), _mm_loadu_pd(b + 2)));
+}
+
+inline void scale4(const double* a, double s, double* r) noexcept {
+    const __m128d vs = _mm_set1_pd(s);
+    _mm_storeu_pd(r, _mm_mul_pd(_mm_loadu_pd(a), vs));
+    _mm_storeu_pd(r + 2, _mm_mul_pd(_mm_loadu_pd(a + 2), vs));
+}
+
+[[nodiscard]] inline double dot4(const double* a, const double* b) noexcept {
+    const __m128d s = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)),
+        _mm_mul_pd(_mm_loadu_pd(a + 2), _mm_loadu_pd(b + 2)));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+inline void mat4_mul_vec4(const double* m, const double* v, double* r) noexcept {
+    __m128d lo = _mm_setzero_pd();
+    __m128d hi = _mm_setzero_pd();
+    for (int k = 0; k < 4; ++k) {
+        const __m128d vk = _mm_set1_pd(v[k]);
+        lo = _mm_add_pd(lo, _mm_mul_pd(_mm_loadu_pd(m + 4 * k), vk));
+        hi = _mm_add_pd(hi, _mm_mul_pd(_mm_loadu_pd(m + 4 * k + 2), vk));
+    }
+    _mm_storeu_pd(r, lo);
+    _mm_storeu_pd(r + 2, hi);
+}
+
+inline void mat4_mul(const double* a, const double* b, double* r) noexcept {
+    for (int j = 0; j < 4; ++j) {
+        mat4_mul_vec4(a, b + 4 * j, r + 4 * j);
+    }
+}
+
+#endif // CT_MATH_AVX
+
+#elif defined(CT_MATH_NEON)
+
+[[nodiscard]] inline float32x4_t fmadd(float32x4_t a, float32x4_t b, float32x4_t c) noexcept {
+#if defined(CT_MATH_NEON64)
+    return vfmaq_f32(c, a, b);
+#else
+    return vmlaq_f32(c, a, b);
+#endif
+}
+
+inline void add4(const float* a, const float* b, float* r) noexcept {
+    vst1q_f32(r, vaddq_f32(vld1q_f32(a), vld1q_f32(b)));
+}
+
+inline void sub4(const float* a, const float* b, float* r) noexcept {
+    vst1q_f32(r, vsubq_f32(vld1q_f32(a), vld1q_f32(b)));
+}
+
+inline void mul4(const float* a, const float* b, float* r) noexcept {
+    vst1q_f32(r, vmulq_f32(vld1q_f32(a), vld1q_f32(b)));
+}
+
+inline void scale4(const float* a, float s, float* r) noexcept {
+    vst1q_f32(r, vmulq_n_f32(vld1q_f32(a), s));
+}
+
+[[nodiscard]] inline float dot4(const float* a, const float* b) noexcept {
+    const float32x4_t p = vmulq_f32(vld1q_f32(a), vld1q_f32(b));
+#if defined(CT_MATH_NEON64)
+    return vaddvq_f32(p);
+#else
+    const float32x2_t s = vadd_f32(vget_low_f32(p), vget_high_f32(p));
+    return vget_lane_f32(vpadd_f32(s, s), 0);
+#endif
+}
+
+inline void mat4_mul_vec4(const float* m, const float* v, float* r) noexcept {
+    float32x4_t acc = vmulq_n_f32(vld1q_f32(m), v[0]);
+    acc = fmadd(vld1q_f32(m + 4), vdupq_n_f32(v[1]), acc);
+    acc = fmadd(vld1q_f32(m + 8), vdupq_n_f32(v[2]), acc);
+    acc = fmadd(vld1q_f32(m + 12), vdupq_n_f32(v[3]), acc);
+    vst1q_f32(r, acc);
+}
+
+inline void mat4_mul(const float* a, const float* b, float* r) noexcept {
+    const float32x4_t a0 = vld1q_f32(a);
+    const float32x4_t a1 = vld1q_f32(a + 4);
+    const float32x4_t a2 = vld1q_f32(a + 8);
+    const float32x4_t a3 = vld1q_f32(a + 12);
+    for (int j = 0; j < 4; ++j) {
+        const float* bj = b + 4 * j;
+        float32x4_t acc = vmulq_n_f32(a0, bj[0]);
+        acc = fmadd(a1, vdupq_n_f32(bj[1]), acc);
+        acc = fmadd(a2, vdupq_n_f32(bj[2]), acc);
+        acc = fmadd(a3, vdupq_n_f32(bj[3]), acc);
+        vst1q_f32(r + 4 * j, acc);
+    }
+}
+
+#if defined(CT_MATH_NEON64)
+
+inline void add4(const double* a, const double* b, double* r) noexcept {
+    vst1q_f64(r, vaddq_f64(vld1q_f64(a), vld1q_f64(b)));
+    vst1q_f64(r + 2, vaddq_f64(vld1q_f64(a + 2), vld1q_f64(b + 2)));
+}
+
+inline void sub4(const double* a, const double* b, double* r) noexcept {
+    vst1q_f64(r, vsubq_f64(vld1q_f64(a), vld1q_f64(b)));
+    vst1q_f64(r + 2, vsubq_f64(vld1q_f64(a + 2), vld1q_f64(b + 2)));
+}
+
+inline void mul4(const double* a, const double* b, double* r) noexcept {
+    vst1q_f64(r, vmulq_f64(vld1q_f64(a), vld1q_f64(b)));
+    vst1q_f64(r + 2, vmulq_f64(vld1q_f64(a + 2), vld1q_f64(b + 2)));
+}
+
+inline void scale4(const double* a, double s, double* r) noexcept {
+    vst1q_f64(r, vmulq_n_f64(vld1q_f64(a), s));
+    vst1q_f64(r + 2, vmulq_n_f64(vld1q_f64(a + 2), s));
+}
+
+[[nodiscard]] inline double dot4(const double* a, const double* b) noexcept {
+    const float64x2_t s = vfmaq_f64(vmulq_f64(vld1q_f64(a), vld1q_f64(b)),
+        vld1q_f64(a + 2), vld1q_f64(b + 2));
+    return vaddvq_f64(s);
+}
+
+inline void mat4_mul_vec4(const double* m, const double* v, double* r) noexcept {
+    float64x2_t lo = vdupq_n_f64(0.0);
+    float64x2_t hi = vdupq_n_f64(0.0);
+    for (int k = 0; k < 4; ++k) {
+        const float64x2_t vk = vdupq_n_f64(v[k]);
+        lo = vfmaq_f64(lo, vld1q_f64(m + 4 * k), vk);
+        hi = vfmaq_f64(hi, vld1q_f64(m + 4 * k + 2), vk);
+    }
+    vst1q_f64(r, lo);
+    vst1q_f64(r + 2, hi);
+}
+
+inline void mat4_mul(const double* a, const double* b, double* r) noexcept {
+    for (int j = 0; j < 4; ++j) {
+        mat4_mul_vec4(a, b + 4 * j, r + 4 * j);
+    }
+}
+
+#endif // CT_MATH_NEON64
+
+#endif
+
+//NOTE: Scalar fallbacks, the overloads above win whenever enabled<T> holds. They keep the
+// call sites well-formed on targets without a matching instruction set.
+template<typename T>
+inline void add4(const T* a, const T* b, T* r) noexcept {
+    for (int i = 0; i < 4; ++i) r[i] = a[i] + b[i];
+}
+
+template<typename T>
+inline void sub4(const T* a, const T* b, T* r) noexcept {
+    for (int i = 0; i < 4; ++i) r[i] = a[i] - b[i];
+}
+
+template<typename T>
+inline void mul4(const T* a, const T* b, T* r) noexcept {
+    for (int i = 0; i < 4; ++i) r[i] = a[i] * b[i];
+}
+
+template<typename T>
+inline void scale4(const T* a, T s, T* r) noexcept {
+    for (int i = 0; i < 4; ++i) r[i] = a[i] * s;
+}
+
+template<typename T>
+[[nodiscard]] inline T dot4(const T* a, const T* b) noexcept {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+}
+
+template<typename T>
+inline void mat4_mul_vec4(const T* m, const T* v, T* r) noexcept {
+    for (int i = 0; i < 4; ++i) {
+        r[i] = m[i] * v[0] + m[4 + i] * v[1] + m[8 + i] * v[2] + m[12 + i] * v[3];
+    }
+}
+
+template<typename T>
+inline void mat4_mul(const T* a, const T* b, T* r) noexcept {
+    for (int j = 0; j < 4; ++j) mat4_mul_vec4(a, b + 4 * j, r + 4 * j);
+}
+
+//NOTE: Never selected when has_inverse<T> is false
+template<typename T>
+[[nodiscard]] inline bool mat4_inverse(const T*, T*, T) noexcept {
+    return false;
+}
+
+} // namespace ct::detail::simd
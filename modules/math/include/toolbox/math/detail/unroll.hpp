@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+//NOTE: Compile-time loop helpers. The body receives std::integral_constant<std::size_t, I>, so
+// `decltype(i)::value` is usable as a template argument (e.g. m.template at<I, J>()).
+// Everything expands into straight-line code, no loop counters or runtime indices survive.
+
+namespace ct::detail {
+
+template<std::size_t I>
+using index_c = std::integral_constant<std::size_t, I>;
+
+template<std::size_t N, typename F>
+constexpr void unroll(F&& f) {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (f(index_c<I>{}), ...);
+    }(std::make_index_sequence<N>{});
+}
+
+//NOTE: Left fold, ((f(0) + f(1)) + f(2)) ..., same association as the scalar loop it replaces
+template<std::size_t N, typename F>
+requires (N > 0)
+[[nodiscard]] constexpr auto unroll_sum(F&& f) {
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+        return (... + f(index_c<I>{}));
+    }(std::make_index_sequence<N>{});
+}
+
+template<std::size_t N, typename F>
+[[nodiscard]] constexpr bool unroll_all(F&& f) {
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+        return (true && ... && static_cast<bool>(f(index_c<I>{})));
+    }(std::make_index_sequence<N>{});
+}
+
+} // namespace ct::detail
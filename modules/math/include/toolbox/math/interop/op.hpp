@@ -3,6 +3,8 @@
 #include "../mat/fwd.hpp"
 #include "../vec/fwd.hpp"
 #include "../detail/arithmetic.hpp"
+#include "../detail/simd.hpp"
+#include "../detail/unroll.hpp"
 #include <cstddef>
 
 namespace ct {
@@ -10,22 +12,32 @@ namespace ct {
 template<std::size_t Rows, std::size_t Cols, arithmetic T>
 [[nodiscard]] constexpr vec<Rows, T> operator*(const mat<Rows, Cols, T>& m, const vec<Cols, T>& v) noexcept {
     vec<Rows, T> result{};
-    for (std::size_t i = 0; i < Rows; ++i) {
-        T sum{};
-        for (std::size_t j = 0; j < Cols; ++j) sum += m(i, j) * v[j];
-        result[i] = sum;
+    if constexpr (Rows == 4 && Cols == 4 && detail::simd::enabled<T>) {
+        if !consteval {
+            detail::simd::mat4_mul_vec4(m.data(), v.data(), result.data());
+            return result;
+        }
     }
+    detail::unroll<Rows>([&](auto i) {
+        constexpr std::size_t row = decltype(i)::value;
+        result[row] = detail::unroll_sum<Cols>([&](auto j) {
+            constexpr std::size_t col = decltype(j)::value;
+            return m.template at<row, col>() * v[col];
+        });
+    });
     return result;
 }
 
 template<std::size_t Rows, std::size_t Cols, arithmetic T>
 [[nodiscard]] constexpr vec<Cols, T> operator*(const vec<Rows, T>& v, const mat<Rows, Cols, T>& m) noexcept {
     vec<Cols, T> result{};
-    for (std::size_t j = 0; j < Cols; ++j) {
-        T sum{};
-        for (std::size_t i = 0; i < Rows; ++i) sum += v[i] * m(i, j);
-        result[j] = sum;
-    }
+    detail::unroll<Cols>([&](auto j) {
+        constexpr std::size_t col = decltype(j)::value;
+        result[col] = detail::unroll_sum<Rows>([&](auto i) {
+            constexpr std::size_t row = decltype(i)::value;
+            return v[row] * m.template at<row, col>();
+        });
+    });
     return result;
 }
 
@@ -37,8 +37,8 @@ template<floating_point T>
 
 template<floating_point T>
 [[nodiscard]] inline mat<4, 4, T> rotate_x(T angle) noexcept {
-    const T c = std::cos(angle);
-    const T s = std::sin(angle);
+    const T c = cos(angle);
+    const T s = sin(angle);
     return mat<4, 4, T>(layout::rowm,
                         T{1}, T{0}, T{0}, T{0},
                         T{0}, c,    -s,   T{0},
@@ -48,8 +48,8 @@ template<floating_point T>
 
 template<floating_point T>
 [[nodiscard]] inline mat<4, 4, T> rotate_y(T angle) noexcept {
-    const T c = std::cos(angle);
-    const T s = std::sin(angle);
+    const T c = cos(angle);
+    const T s = sin(angle);
     return mat<4, 4, T>(layout::rowm,
                         c,    T{0}, s,    T{0},
                         T{0}, T{1}, T{0}, T{0},
@@ -59,8 +59,8 @@ template<floating_point T>
 
 template<floating_point T>
 [[nodiscard]] inline mat<4, 4, T> rotate_z(T angle) noexcept {
-    const T c = std::cos(angle);
-    const T s = std::sin(angle);
+    const T c = cos(angle);
+    const T s = sin(angle);
     return mat<4, 4, T>(layout::rowm,
                         c,    -s,   T{0}, T{0},
                         s,     c,   T{0}, T{0},
@@ -71,8 +71,8 @@ template<floating_point T>
 template<floating_point T>
 [[nodiscard]] inline mat<4, 4, T> rotate(T angle, const vec<3, T>& axis) noexcept {
     const vec<3, T> a = axis. normalized();
-    const T c = std::cos(angle);
-    const T s = std::sin(angle);
+    const T c = cos(angle);
+    const T s = sin(angle);
     const T t = T{1} - c;
 
     return mat<4, 4, T>(layout::rowm,
@@ -105,7 +105,7 @@ template<floating_point T>
 template<floating_point T>
 [[nodiscard]] inline mat<4, 4, T> perspective(T fovy, T aspect, T z_near, T z_far) noexcept {
     const T half = fovy / T{2};
-    const T tan_half = std::tan(half);
+    const T tan_half = tan(half);
 
     return mat<4, 4, T>(layout::rowm,
                         T{1} / (aspect * tan_half), T{0},            T{0},                                    T{0},
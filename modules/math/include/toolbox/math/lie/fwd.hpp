@@ -0,0 +1,13 @@
+#pragma once
+
+#include "../detail/arithmetic.hpp"
+
+namespace ct {
+
+template<floating_point T>
+class so3;
+
+template<floating_point T>
+class se3;
+
+} // namespace ct
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "./fwd.hpp"
+#include "../quat/quat.hpp"
+#include "../vec/vec3.hpp"
+#include "../mat/mat3.hpp"
+#include "../detail/arithmetic.hpp"
+#include "../common/functions.hpp"
+#include "../common/constants.hpp"
+
+#include <limits>
+#include <type_traits>
+
+//NOTE: Rotation group stored as a unit quaternion (4 scalars). The tangent vector w is the
+// rotation vector (axis * angle). Perturbations are left-multiplied: R' = exp(dw) * R.
+
+namespace ct {
+
+namespace detail {
+
+//NOTE: Squared angle below which the closed forms lose precision and the Taylor series take over.
+// Compared against theta^2 so no sqrt is taken at zero, which keeps jet derivatives finite there.
+template<floating_point T>
+inline constexpr scalar_t<T> lie_small_angle_sq = std::numeric_limits<scalar_t<T>>::epsilon();
+
+} // namespace detail
+
+template<floating_point T>
+class so3 {
+public:
+    using value_type = T;
+    using tangent_type = vec<3, T>;
+
+    constexpr so3() noexcept = default;
+
+    explicit so3(const quat<T>& q) noexcept : q_(q.normalized()) {}
+
+    [[nodiscard]] static constexpr so3 identity() noexcept { return so3{}; }
+
+    [[nodiscard]] static so3 exp(const vec<3, T>& w) noexcept {
+        const T theta2 = w.length_squared();
+        T real;
+        T imag;
+        if (theta2 < detail::lie_small_angle_sq<T>) {
+            real = T{1} - theta2 / T{8};
+            imag = T{0.5} - theta2 / T{48};
+        } else {
+            const T theta = sqrt(theta2);
+            const T half = theta * T{0.5};
+            real = cos(half);
+            imag = sin(half) / theta;
+        }
+        return from_unit(quat<T>(w.x * imag, w.y * imag, w.z * imag, real));
+    }
+
+    //NOTE: Shepperd's method, picks the largest diagonal term to stay away from small divisors
+    [[nodiscard]] static so3 from_matrix(const mat<3, 3, T>& r) noexcept {
+        const T m00 = r(0, 0), m11 = r(1, 1), m22 = r(2, 2);
+        const T tr = m00 + m11 + m22;
+        quat<T> q;
+        if (tr > m00 && tr > m11 && tr > m22) {
+            const T s = sqrt(tr + T{1}) * T{2};
+            q = quat<T>((r(2, 1) - r(1, 2)) / s, (r(0, 2) - r(2, 0)) / s, (r(1, 0) - r(0, 1)) / s, s / T{4});
+        } else if (m00 > m11 && m00 > m22) {
+            const T s = sqrt(T{1} + m00 - m11 - m22) * T{2};
+            q = quat<T>(s / T{4}, (r(0, 1) + r(1, 0)) / s, (r(0, 2) + r(2, 0)) / s, (r(2, 1) - r(1, 2)) / s);
+        } else if (m11 > m22) {
+            const T s = sqrt(T{1} + m11 - m00 - m22) * T{2};
+            q = quat<T>((r(0, 1) + r(1, 0)) / s, s / T{4}, (r(1, 2) + r(2, 1)) / s, (r(0, 2) - r(2, 0)) / s);
+        } else {
+            const T s = sqrt(T{1} + m22 - m00 - m11) * T{2};
+            q = quat<T>((r(0, 2) + r(2, 0)) / s, (r(1, 2) + r(2, 1)) / s, s / T{4}, (r(1, 0) - r(0, 1)) / s);
+        }
+        return so3(q);
+    }
+
+    //NOTE: Trusts the caller that q is unit length, skips the sqrt of the normalizing constructor
+    [[nodiscard]] static constexpr so3 from_unit(const quat<T>& q) noexcept {
+        so3 r;
+        r.q_ = q;
+        return r;
+    }
+
+    [[nodiscard]] vec<3, T> log() const noexcept {
+        // q and -q are the same rotation, pick w >= 0 so the angle lands in [0, pi]
+        const T s = q_.w < T{0} ? T{-1} : T{1};
+        const vec<3, T> v(q_.x * s, q_.y * s, q_.z * s);
+        const T w = q_.w * s;
+        const T n2 = v.length_squared();
+
+        T f;
+        if (n2 < detail::lie_small_angle_sq<T>) {
+            f = T{2} / w - T{2} * n2 / (T{3} * w * w * w);
+        } else {
+            const T n = sqrt(n2);
+            f = T{2} * atan2(n, w) / n;
+        }
+        return v * f;
+    }
+
+    [[nodiscard]] constexpr const quat<T>& quaternion() const noexcept { return q_; }
+
+    [[nodiscard]] constexpr so3 inverse() const noexcept { return from_unit(q_.conjugate()); }
+
+    //NOTE: One Newton step towards |q| = 1 per compose, keeps long chains from drifting without a sqrt
+    [[nodiscard]] friend constexpr so3 operator*(const so3& a, const so3& b) noexcept {
+        quat<T> q = a.q_ * b.q_;
+        q *= (T{3} - q.length_squared()) * T{0.5};
+        return from_unit(q);
+    }
+
+    constexpr so3& operator*=(const so3& rhs) noexcept {
+        *this = *this * rhs;
+        return *this;
+    }
+
+    //NOTE: v' = v + w t + u x t with t = 2 u x v, cheaper than the sandwich product
+    [[nodiscard]] constexpr vec<3, T> act(const vec<3, T>& v) const noexcept {
+        const vec<3, T> u(q_.x, q_.y, q_.z);
+        const vec<3, T> t = u.cross(v) * T{2};
+        return v + t * q_.w + u.cross(t);
+    }
+
+    [[nodiscard]] friend constexpr vec<3, T> operator*(const so3& r, const vec<3, T>& v) noexcept {
+        return r.act(v);
+    }
+
+    [[nodiscard]] constexpr mat<3, 3, T> matrix() const noexcept {
+        const T x = q_.x, y = q_.y, z = q_.z, w = q_.w;
+        const T xx = x * x, yy = y * y, zz = z * z;
+        const T xy = x * y, xz = x * z, yz = y * z;
+        const T wx = w * x, wy = w * y, wz = w * z;
+        return mat<3, 3, T>(layout::rowm,
+                            T{1} - T{2} * (yy + zz), T{2} * (xy - wz),       T{2} * (xz + wy),
+                            T{2} * (xy + wz),       T{1} - T{2} * (xx + zz), T{2} * (yz - wx),
+                            T{2} * (xz - wy),       T{2} * (yz + wx),       T{1} - T{2} * (xx + yy));
+    }
+
+    //NOTE: Ad(R) = R for the rotation group
+    [[nodiscard]] constexpr mat<3, 3, T> adjoint() const noexcept { return matrix(); }
+
+    constexpr so3& normalize() noexcept {
+        q_.normalize();
+        return *this;
+    }
+
+    [[nodiscard]] static constexpr mat<3, 3, T> hat(const vec<3, T>& w) noexcept {
+        return mat<3, 3, T>(layout::rowm,
+                            T{0}, -w.z,  w.y,
+                             w.z, T{0}, -w.x,
+                            -w.y,  w.x, T{0});
+    }
+
+    [[nodiscard]] static constexpr vec<3, T> vee(const mat<3, 3, T>& m) noexcept {
+        return vec<3, T>(m(2, 1), m(0, 2), m(1, 0));
+    }
+
+    //NOTE: J_l(w) = I + (1 - cos t) / t^2 W + (t - sin t) / t^3 W^2, W = hat(w)
+    // Maps tangent increments to the left perturbation: exp(w + dw) ~ exp(J_l(w) dw) exp(w)
+    [[nodiscard]] static mat<3, 3, T> left_jacobian(const vec<3, T>& w) noexcept {
+        const T theta2 = w.length_squared();
+        const mat<3, 3, T> W = hat(w);
+        T a;
+        T b;
+        if (theta2 < detail::lie_small_angle_sq<T>) {
+            a = T{0.5} - theta2 / T{24};
+            b = T{1} / T{6} - theta2 / T{120};
+        } else {
+            const T theta = sqrt(theta2);
+            a = (T{1} - cos(theta)) / theta2;
+            b = (theta - sin(theta)) / (theta2 * theta);
+        }
+        return mat<3, 3, T>::identity() + W * a + (W * W) * b;
+    }
+
+    [[nodiscard]] static mat<3, 3, T> left_jacobian_inverse(const vec<3, T>& w) noexcept {
+        const T theta2 = w.length_squared();
+        const mat<3, 3, T> W = hat(w);
+        T b;
+        if (theta2 < detail::lie_small_angle_sq<T>) {
+            b = T{1} / T{12} + theta2 / T{720};
+        } else {
+            const T theta = sqrt(theta2);
+            b = T{1} / theta2 - (T{1} + cos(theta)) / (T{2} * theta * sin(theta));
+        }
+        return mat<3, 3, T>::identity() - W * T{0.5} + (W * W) * b;
+    }
+
+    [[nodiscard]] static mat<3, 3, T> right_jacobian(const vec<3, T>& w) noexcept {
+        return left_jacobian(-w);
+    }
+
+    [[nodiscard]] static mat<3, 3, T> right_jacobian_inverse(const vec<3, T>& w) noexcept {
+        return left_jacobian_inverse(-w);
+    }
+
+private:
+    quat<T> q_{};
+};
+
+static_assert(std::is_trivially_copyable_v<so3<float>>);
+static_assert(std::is_trivially_copyable_v<so3<double>>);
+
+} // namespace ct
@@ -1,16 +1,20 @@
 #pragma once
 
 #include "../detail/arithmetic.hpp"
+#include "../detail/unroll.hpp"
 #include "../common/functions.hpp"
 #include "../common/constants.hpp"
 
 #include <array>
 #include <cassert>
 #include <cstddef>
+#include <utility>
 
 namespace ct {
 
 //NOTE: Column-major storage: data_[col][row]
+// Arithmetic is unrolled at compile time over the fixed shape (detail/unroll.hpp), so small
+// sizes like 2x6 or 6x6 compile to straight-line multiply-adds without index bookkeeping.
 template<std::size_t Rows, std::size_t Cols, arithmetic T>
 class mat {
 public:
@@ -126,40 +130,49 @@ public:
         return &data_[0][0];
     }
 
+    //NOTE: Compile-time checked element access, used by the unrolled kernels
+    template<std::size_t R, std::size_t C>
+    [[nodiscard]] constexpr T& at() noexcept {
+        static_assert(R < Rows && C < Cols, "mat::at index out of range");
+        return data_[C][R];
+    }
+
+    template<std::size_t R, std::size_t C>
+    [[nodiscard]] constexpr const T& at() const noexcept {
+        static_assert(R < Rows && C < Cols, "mat::at index out of range");
+        return data_[C][R];
+    }
+
     constexpr mat& operator+=(const mat& rhs) noexcept {
-        for (std::size_t j = 0; j < Cols; ++j) {
-            for (std::size_t i = 0; i < Rows; ++i) {
-                data_[j][i] += rhs.data_[j][i];
-            }
-        }
+        detail::unroll<Rows * Cols>([&](auto k) {
+            constexpr std::size_t idx = decltype(k)::value;
+            data_[idx / Rows][idx % Rows] += rhs.data_[idx / Rows][idx % Rows];
+        });
         return *this;
     }
 
     constexpr mat& operator-=(const mat& rhs) noexcept {
-        for (std::size_t j = 0; j < Cols; ++j) {
-            for (std::size_t i = 0; i < Rows; ++i) {
-                data_[j][i] -= rhs.data_[j][i];
-            }
-        }
+        detail::unroll<Rows * Cols>([&](auto k) {
+            constexpr std::size_t idx = decltype(k)::value;
+            data_[idx / Rows][idx % Rows] -= rhs.data_[idx / Rows][idx % Rows];
+        });
         return *this;
     }
 
     constexpr mat& operator*=(T s) noexcept {
-        for (auto& c : data_) {
-            for (auto& v : c) {
-                v *= s;
-            }
-        }
+        detail::unroll<Rows * Cols>([&](auto k) {
+            constexpr std::size_t idx = decltype(k)::value;
+            data_[idx / Rows][idx % Rows] *= s;
+        });
         return *this;
     }
 
     constexpr mat& operator/=(T s) noexcept {
         assert(s != T{});
-        for (auto& c : data_) {
-            for (auto& v : c) {
-                v /= s;
-            }
-        }
+        detail::unroll<Rows * Cols>([&](auto k) {
+            constexpr std::size_t idx = decltype(k)::value;
+            data_[idx / Rows][idx % Rows] /= s;
+        });
         return *this;
     }
 
@@ -190,33 +203,76 @@ public:
 
     [[nodiscard]] constexpr mat<Cols, Rows, T> transpose() const noexcept {
         mat<Cols, Rows, T> r{};
-        for (std::size_t i = 0; i < Rows; ++i) {
-            for (std::size_t j = 0; j < Cols; ++j) {
-                r(j, i) = (*this)(i, j);
-            }
-        }
+        detail::unroll<Rows * Cols>([&](auto k) {
+            constexpr std::size_t idx = decltype(k)::value;
+            r.template at<idx / Rows, idx % Rows>() = data_[idx / Rows][idx % Rows];
+        });
         return r;
     }
 
     [[nodiscard]] friend constexpr bool operator==(const mat& a, const mat& b) noexcept {
-        for (std::size_t j = 0; j < Cols; ++j) {
+        return detail::unroll_all<Rows * Cols>([&](auto k) {
+            constexpr std::size_t idx = decltype(k)::value;
+            if constexpr (floating_point<T>) {
+                return approx_equal(a.data_[idx / Rows][idx % Rows], b.data_[idx / Rows][idx % Rows]);
+            } else {
+                return a.data_[idx / Rows][idx % Rows] == b.data_[idx / Rows][idx % Rows];
+            }
+        });
+    }
+
+    [[nodiscard]] constexpr bool operator!=(const mat& other) const noexcept {
+        return !(*this == other);
+    }
+
+    //NOTE: Closed form up to 2x2, partial-pivot LU on a local copy otherwise
+    [[nodiscard]] constexpr T det() const noexcept requires (Rows == Cols) {
+        if constexpr (Rows == 1) {
+            return data_[0][0];
+        } else if constexpr (Rows == 2) {
+            return data_[0][0] * data_[1][1] - data_[1][0] * data_[0][1];
+        } else {
+            T a[Rows][Rows]{};
+            for (std::size_t j = 0; j < Rows; ++j) {
+                for (std::size_t i = 0; i < Rows; ++i) {
+                    a[i][j] = data_[j][i];
+                }
+            }
+
+            T d = T{1};
             for (std::size_t i = 0; i < Rows; ++i) {
-                if constexpr (floating_point<T>) {
-                    if (!approx_equal(a.data_[j][i], b.data_[j][i])) {
-                        return false;
+                std::size_t pivot = i;
+                T maxv = abs(a[i][i]);
+                for (std::size_t r = i + 1; r < Rows; ++r) {
+                    const T v = abs(a[r][i]);
+                    if (v > maxv) {
+                        maxv = v;
+                        pivot = r;
                     }
-                } else {
-                    if (a.data_[j][i] != b.data_[j][i]) {
-                        return false;
+                }
+
+                if (maxv == T{}) {
+                    return T{0};
+                }
+
+                if (pivot != i) {
+                    for (std::size_t c = 0; c < Rows; ++c) {
+                        std::swap(a[i][c], a[pivot][c]);
+                    }
+                    d = -d;
+                }
+
+                const T piv = a[i][i];
+                d *= piv;
+                for (std::size_t r = i + 1; r < Rows; ++r) {
+                    const T f = a[r][i] / piv;
+                    for (std::size_t c = i; c < Rows; ++c) {
+                        a[r][c] -= f * a[i][c];
                     }
                 }
             }
+            return d;
         }
-        return true;
-    }
-
-    [[nodiscard]] constexpr bool operator!=(const mat& other) const noexcept {
-        return !(*this == other);
     }
 
 private:
@@ -226,110 +282,96 @@ private:
 template<std::size_t R, std::size_t C, std::size_t K, arithmetic T>
 [[nodiscard]] constexpr mat<R, K, T> operator*(const mat<R, C, T>& a, const mat<C, K, T>& b) noexcept {
     mat<R, K, T> r{};
-    for (std::size_t i = 0; i < R; ++i) {
-        for (std::size_t k = 0; k < K; ++k) {
-            T acc{};
-            for (std::size_t j = 0; j < C; ++j) {
-                acc += a(i, j) * b(j, k);
-            }
-            r(i, k) = acc;
-        }
-    }
+    detail::unroll<R * K>([&](auto e) {
+        constexpr std::size_t row = decltype(e)::value % R;
+        constexpr std::size_t col = decltype(e)::value / R;
+        r.template at<row, col>() = detail::unroll_sum<C>([&](auto k) {
+            constexpr std::size_t inner = decltype(k)::value;
+            return a.template at<row, inner>() * b.template at<inner, col>();
+        });
+    });
     return r;
 }
 
 template<std::size_t N, arithmetic T>
 [[nodiscard]] constexpr T det(const mat<N, N, T>& m) noexcept {
-    mat<N, N, T> a(m);
-    T d = T{1};
-    int sign = 1;
-
-    for (std::size_t i = 0; i < N; ++i) {
-        std::size_t pivot = i;
-        T maxv = abs(a(i, i));
-        for (std::size_t r = i + 1; r < N; ++r) {
-            const T v = abs(a(r, i));
-            if (v > maxv) {
-                maxv = v;
-                pivot = r;
-            }
-        }
+    return m.det();
+}
 
-        if (maxv == T{}) {
-            return T{0};
+//NOTE: 2x2 closed form, mat3/mat4 use their specialized inverse(). Larger sizes run Gauss-Jordan
+// with partial pivoting on local row-major arrays. Singular input returns identity, like mat3/mat4.
+template<std::size_t N, floating_point T>
+[[nodiscard]] inline mat<N, N, T> inverse(const mat<N, N, T>& m) noexcept {
+    if constexpr (N == 2) {
+        const T d = m.det();
+        if (abs(d) <= epsilon<T>) {
+            return mat<N, N, T>::identity();
         }
-
-        if (pivot != i) {
-            for (std::size_t c = 0; c < N; ++c) {
-                const T tmp = a(i, c);
-                a(i, c) = a(pivot, c);
-                a(pivot, c) = tmp;
+        const T inv_det = T{1} / d;
+        mat<N, N, T> r{};
+        r.template at<0, 0>() =  m.template at<1, 1>() * inv_det;
+        r.template at<0, 1>() = -m.template at<0, 1>() * inv_det;
+        r.template at<1, 0>() = -m.template at<1, 0>() * inv_det;
+        r.template at<1, 1>() =  m.template at<0, 0>() * inv_det;
+        return r;
+    } else if constexpr (N == 3 || N == 4) {
+        return m.inverse();
+    } else {
+        T a[N][N]{};
+        T inv[N][N]{};
+        for (std::size_t i = 0; i < N; ++i) {
+            for (std::size_t j = 0; j < N; ++j) {
+                a[i][j] = m(i, j);
             }
-            sign = -sign;
+            inv[i][i] = T{1};
         }
 
-        d *= a(i, i);
-        const T piv = a(i, i);
-        for (std::size_t r = i + 1; r < N; ++r) {
-            const T f = a(r, i) / piv;
-            for (std::size_t c = i; c < N; ++c) {
-                a(r, c) -= f * a(i, c);
+        for (std::size_t i = 0; i < N; ++i) {
+            std::size_t pivot = i;
+            T maxv = abs(a[i][i]);
+            for (std::size_t r = i + 1; r < N; ++r) {
+                const T v = abs(a[r][i]);
+                if (v > maxv) {
+                    maxv = v;
+                    pivot = r;
+                }
             }
-        }
-    }
-
-    return sign == 1 ? d : -d;
-}
 
-template<std::size_t N, floating_point T>
-[[nodiscard]] inline mat<N, N, T> inverse(const mat<N, N, T>& m) noexcept {
-    mat<N, N, T> a(m);
-    mat<N, N, T> inv = mat<N, N, T>::identity();
-
-    for (std::size_t i = 0; i < N; ++i) {
-        std::size_t pivot = i;
-        T maxv = abs(a(i, i));
-        for (std::size_t r = i + 1; r < N; ++r) {
-            const T v = abs(a(r, i));
-            if (v > maxv) {
-                maxv = v;
-                pivot = r;
+            if (maxv <= epsilon<T>) {
+                return mat<N, N, T>::identity();
             }
-        }
 
-        if (maxv <= epsilon<T>) {
-            return inv;
-        }
+            if (pivot != i) {
+                for (std::size_t c = 0; c < N; ++c) {
+                    std::swap(a[i][c], a[pivot][c]);
+                    std::swap(inv[i][c], inv[pivot][c]);
+                }
+            }
 
-        if (pivot != i) {
+            const T rp = T{1} / a[i][i];
             for (std::size_t c = 0; c < N; ++c) {
-                const T tmp_a = a(i, c);
-                a(i, c) = a(pivot, c);
-                a(pivot, c) = tmp_a;
-
-                const T tmp_inv = inv(i, c);
-                inv(i, c) = inv(pivot, c);
-                inv(pivot, c) = tmp_inv;
+                a[i][c] *= rp;
+                inv[i][c] *= rp;
             }
-        }
 
-        const T piv = a(i, i);
-        for (std::size_t c = 0; c < N; ++c) {
-            a(i, c) /= piv;
-            inv(i, c) /= piv;
+            for (std::size_t r = 0; r < N; ++r) {
+                if (r == i) continue;
+                const T f = a[r][i];
+                for (std::size_t c = 0; c < N; ++c) {
+                    a[r][c] -= f * a[i][c];
+                    inv[r][c] -= f * inv[i][c];
+                }
+            }
         }
 
-        for (std::size_t r = 0; r < N; ++r) {
-            if (r == i) continue;
-            const T f = a(r, i);
-            for (std::size_t c = 0; c < N; ++c) {
-                a(r, c) -= f * a(i, c);
-                inv(r, c) -= f * inv(i, c);
+        mat<N, N, T> r{};
+        for (std::size_t j = 0; j < N; ++j) {
+            for (std::size_t i = 0; i < N; ++i) {
+                r[j][i] = inv[i][j];
             }
         }
+        return r;
     }
-
-    return inv;
 }
 
 } // namespace cc
@@ -78,6 +78,18 @@ public:
         return data_[c][r];
     }
 
+    template<std::size_t R, std::size_t C>
+    [[nodiscard]] constexpr T& at() noexcept {
+        static_assert(R < 3 && C < 3, "mat::at index out of range");
+        return data_[C][R];
+    }
+
+    template<std::size_t R, std::size_t C>
+    [[nodiscard]] constexpr const T& at() const noexcept {
+        static_assert(R < 3 && C < 3, "mat::at index out of range");
+        return data_[C][R];
+    }
+
     [[nodiscard]] constexpr col_type& operator[](std::size_t col) noexcept {
         assert(col < 3);
         return data_[col];
@@ -166,7 +178,7 @@ public:
     }
 
     [[nodiscard]] constexpr mat transpose() const noexcept {
-        return mat(layout::colm,
+        return mat(layout::rowm,
                    m00, m10, m20,
                    m01, m11, m21,
                    m02, m12, m22);
@@ -3,6 +3,7 @@
 #include "fwd.hpp"
 #include "../detail/arithmetic.hpp"
 #include "../common/functions.hpp"
+#include "../detail/simd.hpp"
 
 #include <array>
 #include <cassert>
@@ -85,6 +86,18 @@ public:
         return data_[c][r];
     }
 
+    template<std::size_t R, std::size_t C>
+    [[nodiscard]] constexpr T& at() noexcept {
+        static_assert(R < 4 && C < 4, "mat::at index out of range");
+        return data_[C][R];
+    }
+
+    template<std::size_t R, std::size_t C>
+    [[nodiscard]] constexpr const T& at() const noexcept {
+        static_assert(R < 4 && C < 4, "mat::at index out of range");
+        return data_[C][R];
+    }
+
     [[nodiscard]] constexpr col_type& operator[](std::size_t col) noexcept {
         assert(col < 4);
         return data_[col];
@@ -104,26 +117,47 @@ public:
     }
 
     constexpr mat& operator+=(const mat& rhs) noexcept {
-        m00 += rhs.m00; m01 += rhs.m01; m02 += rhs.m02; m03 += rhs.m03;
-        m10 += rhs.m10; m11 += rhs.m11; m12 += rhs.m12; m13 += rhs.m13;
-        m20 += rhs.m20; m21 += rhs.m21; m22 += rhs.m22; m23 += rhs.m23;
-        m30 += rhs.m30; m31 += rhs.m31; m32 += rhs.m32; m33 += rhs.m33;
+        if constexpr (detail::simd::enabled<T>) {
+            if !consteval {
+                for (std::size_t j = 0; j < 4; ++j) {
+                    detail::simd::add4(data_[j].data(), rhs.data_[j].data(), data_[j].data());
+                }
+                return *this;
+            }
+        }
+        for (std::size_t j = 0; j < 4; ++j) {
+            for (std::size_t i = 0; i < 4; ++i) data_[j][i] += rhs.data_[j][i];
+        }
         return *this;
     }
 
     constexpr mat& operator-=(const mat& rhs) noexcept {
-        m00 -= rhs.m00; m01 -= rhs.m01; m02 -= rhs.m02; m03 -= rhs.m03;
-        m10 -= rhs.m10; m11 -= rhs.m11; m12 -= rhs.m12; m13 -= rhs.m13;
-        m20 -= rhs.m20; m21 -= rhs.m21; m22 -= rhs.m22; m23 -= rhs.m23;
-        m30 -= rhs.m30; m31 -= rhs.m31; m32 -= rhs.m32; m33 -= rhs.m33;
+        if constexpr (detail::simd::enabled<T>) {
+            if !consteval {
+                for (std::size_t j = 0; j < 4; ++j) {
+                    detail::simd::sub4(data_[j].data(), rhs.data_[j].data(), data_[j].data());
+                }
+                return *this;
+            }
+        }
+        for (std::size_t j = 0; j < 4; ++j) {
+            for (std::size_t i = 0; i < 4; ++i) data_[j][i] -= rhs.data_[j][i];
+        }
         return *this;
     }
 
     constexpr mat& operator*=(T s) noexcept {
-        m00 *= s; m01 *= s; m02 *= s; m03 *= s;
-        m10 *= s; m11 *= s; m12 *= s; m13 *= s;
-        m20 *= s; m21 *= s; m22 *= s; m23 *= s;
-        m30 *= s; m31 *= s; m32 *= s; m33 *= s;
+        if constexpr (detail::simd::enabled<T>) {
+            if !consteval {
+                for (std::size_t j = 0; j < 4; ++j) {
+                    detail::simd::scale4(data_[j].data(), s, data_[j].data());
+                }
+                return *this;
+            }
+        }
+        for (auto& c : data_) {
+            for (auto& v : c) v *= s;
+        }
         return *this;
     }
 
@@ -162,30 +196,25 @@ public:
     }
 
     [[nodiscard]] friend constexpr mat operator*(const mat& a, const mat& b) noexcept {
-        return mat(layout::rowm,
-                   a.m00 * b.m00 + a.m01 * b.m10 + a.m02 * b.m20 + a.m03 * b.m30,
-                   a.m00 * b.m01 + a.m01 * b.m11 + a.m02 * b.m21 + a.m03 * b.m31,
-                   a.m00 * b.m02 + a.m01 * b.m12 + a.m02 * b.m22 + a.m03 * b.m32,
-                   a.m00 * b.m03 + a.m01 * b.m13 + a.m02 * b.m23 + a.m03 * b.m33,
-
-                   a.m10 * b.m00 + a.m11 * b.m10 + a.m12 * b.m20 + a.m13 * b.m30,
-                   a.m10 * b.m01 + a.m11 * b.m11 + a.m12 * b.m21 + a.m13 * b.m31,
-                   a.m10 * b.m02 + a.m11 * b.m12 + a.m12 * b.m22 + a.m13 * b.m32,
-                   a.m10 * b.m03 + a.m11 * b.m13 + a.m12 * b.m23 + a.m13 * b.m33,
-
-                   a.m20 * b.m00 + a.m21 * b.m10 + a.m22 * b.m20 + a.m23 * b.m30,
-                   a.m20 * b.m01 + a.m21 * b.m11 + a.m22 * b.m21 + a.m23 * b.m31,
-                   a.m20 * b.m02 + a.m21 * b.m12 + a.m22 * b.m22 + a.m23 * b.m32,
-                   a.m20 * b.m03 + a.m21 * b.m13 + a.m22 * b.m23 + a.m23 * b.m33,
-
-                   a.m30 * b.m00 + a.m31 * b.m10 + a.m32 * b.m20 + a.m33 * b.m30,
-                   a.m30 * b.m01 + a.m31 * b.m11 + a.m32 * b.m21 + a.m33 * b.m31,
-                   a.m30 * b.m02 + a.m31 * b.m12 + a.m32 * b.m22 + a.m33 * b.m32,
-                   a.m30 * b.m03 + a.m31 * b.m13 + a.m32 * b.m23 + a.m33 * b.m33);
+        if constexpr (detail::simd::enabled<T>) {
+            if !consteval {
+                mat r;
+                detail::simd::mat4_mul(a.data(), b.data(), r.data());
+                return r;
+            }
+        }
+        mat r;
+        for (std::size_t j = 0; j < 4; ++j) {
+            for (std::size_t i = 0; i < 4; ++i) {
+                r.data_[j][i] = a.data_[0][i] * b.data_[j][0] + a.data_[1][i] * b.data_[j][1] +
+                                a.data_[2][i] * b.data_[j][2] + a.data_[3][i] * b.data_[j][3];
+            }
+        }
+        return r;
     }
 
     [[nodiscard]] constexpr mat transpose() const noexcept {
-        return mat(layout::colm,
+        return mat(layout::rowm,
                    m00, m10, m20, m30,
                    m01, m11, m21, m31,
                    m02, m12, m22, m32,
@@ -232,6 +261,14 @@ public:
     }
 
     [[nodiscard]] mat inverse() const noexcept requires floating_point<T> {
+        if constexpr (detail::simd::has_inverse<T>) {
+            mat r;
+            if (!detail::simd::mat4_inverse(data(), r.data(), epsilon<T>)) {
+                return identity();
+            }
+            return r;
+        }
+
         const T a0 = m00 * m11 - m01 * m10;
         const T a1 = m00 * m12 - m02 * m10;
         const T a2 = m00 * m13 - m03 * m10;
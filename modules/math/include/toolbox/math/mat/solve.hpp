@@ -0,0 +1,309 @@
+#pragma once
+
+#include "./fwd.hpp"
+#include "./base.hpp"
+#include "./mat3.hpp"       // IWYU pragma: keep
+#include "./mat4.hpp"       // IWYU pragma: keep
+#include "../vec/base.hpp"
+#include "../vec/vec2.hpp"  // IWYU pragma: keep
+#include "../vec/vec3.hpp"  // IWYU pragma: keep
+#include "../vec/vec4.hpp"  // IWYU pragma: keep
+#include "../detail/arithmetic.hpp"
+#include "../common/functions.hpp"
+#include "../common/constants.hpp"
+
+#include "toolbox/base/errors/result.hpp"
+
+#include <cstddef>
+#include <utility>
+
+//NOTE: Fixed-size dense factorizations. Everything works on stack arrays of the static size,
+// nothing allocates, and the success paths are constexpr. Failures are reported through result<>
+// instead of falling back to identity like inverse() does:
+//   - cholesky(A)  A = L L^T, A symmetric positive definite (normal equations, J^T J + lambda I)
+//   - ldlt(A)      A = L D L^T, A symmetric, no square roots, D may be indefinite but there is no
+//                  pivoting, so every leading pivot must be nonzero (fails on [[0 1] [1 0]])
+//   - qr(A)        Householder A = Q R, R >= C, least squares solve for overdetermined systems
+//   - solve(A, b)  LU with partial pivoting, never forms A^-1
+// Only the lower triangle of A is read by cholesky() and ldlt().
+
+namespace ct {
+
+namespace detail {
+
+//NOTE: Pivots below N * eps * scale are treated as zero, scale is the largest magnitude involved
+template<std::size_t N, floating_point T>
+[[nodiscard]] constexpr T pivot_tolerance(T scale) noexcept {
+    return static_cast<T>(N) * epsilon<T> * scale;
+}
+
+} // namespace detail
+
+template<std::size_t N, floating_point T>
+requires (N >= 2)
+struct cholesky_factor {
+    mat<N, N, T> l{};   // lower triangular, strict upper part is zero
+
+    [[nodiscard]] constexpr vec<N, T> solve(const vec<N, T>& b) const noexcept {
+        vec<N, T> x{};
+        for (std::size_t i = 0; i < N; ++i) {
+            T s = b[i];
+            for (std::size_t k = 0; k < i; ++k) s -= l(i, k) * x[k];
+            x[i] = s / l(i, i);
+        }
+        for (std::size_t i = N; i-- > 0;) {
+            T s = x[i];
+            for (std::size_t k = i + 1; k < N; ++k) s -= l(k, i) * x[k];
+            x[i] = s / l(i, i);
+        }
+        return x;
+    }
+
+    [[nodiscard]] constexpr T det() const noexcept {
+        T d = T{1};
+        for (std::size_t i = 0; i < N; ++i) d *= l(i, i) * l(i, i);
+        return d;
+    }
+};
+
+template<std::size_t N, floating_point T>
+requires (N >= 2)
+struct ldlt_factor {
+    mat<N, N, T> l{};   // unit lower triangular
+    vec<N, T> d{};
+
+    [[nodiscard]] constexpr vec<N, T> solve(const vec<N, T>& b) const noexcept {
+        vec<N, T> x{};
+        for (std::size_t i = 0; i < N; ++i) {
+            T s = b[i];
+            for (std::size_t k = 0; k < i; ++k) s -= l(i, k) * x[k];
+            x[i] = s;
+        }
+        for (std::size_t i = 0; i < N; ++i) x[i] /= d[i];
+        for (std::size_t i = N; i-- > 0;) {
+            T s = x[i];
+            for (std::size_t k = i + 1; k < N; ++k) s -= l(k, i) * x[k];
+            x[i] = s;
+        }
+        return x;
+    }
+
+    [[nodiscard]] constexpr T det() const noexcept {
+        T r = T{1};
+        for (std::size_t i = 0; i < N; ++i) r *= d[i];
+        return r;
+    }
+};
+
+//NOTE: Compact LAPACK-style storage. R sits on and above the diagonal of qr, the Householder
+// vectors below it with an implicit leading 1, H_k = I - tau_k v_k v_k^T and Q = H_0 ... H_{C-1}.
+template<std::size_t R, std::size_t C, floating_point T>
+requires (R >= C && C >= 2)
+struct qr_factor {
+    mat<R, C, T> qr{};
+    vec<C, T> tau{};
+
+    //NOTE: Least squares solution of min |A x - b|, exact when R == C
+    [[nodiscard]] constexpr vec<C, T> solve(const vec<R, T>& b) const noexcept {
+        T y[R]{};
+        for (std::size_t i = 0; i < R; ++i) y[i] = b[i];
+
+        for (std::size_t k = 0; k < C; ++k) {
+            T w = y[k];
+            for (std::size_t i = k + 1; i < R; ++i) w += qr(i, k) * y[i];
+            w *= tau[k];
+            y[k] -= w;
+            for (std::size_t i = k + 1; i < R; ++i) y[i] -= qr(i, k) * w;
+        }
+
+        vec<C, T> x{};
+        for (std::size_t i = C; i-- > 0;) {
+            T s = y[i];
+            for (std::size_t k = i + 1; k < C; ++k) s -= qr(i, k) * x[k];
+            x[i] = s / qr(i, i);
+        }
+        return x;
+    }
+
+    [[nodiscard]] constexpr mat<C, C, T> r() const noexcept {
+        mat<C, C, T> out{};
+        for (std::size_t j = 0; j < C; ++j) {
+            for (std::size_t i = 0; i <= j; ++i) out(i, j) = qr(i, j);
+        }
+        return out;
+    }
+};
+
+template<std::size_t N, floating_point T>
+requires (N >= 2)
+[[nodiscard]] constexpr result<cholesky_factor<N, T>> cholesky(const mat<N, N, T>& m) noexcept {
+    T a[N][N]{};
+    T scale{};
+    for (std::size_t j = 0; j < N; ++j) {
+        for (std::size_t i = j; i < N; ++i) a[i][j] = m(i, j);
+        scale = max(scale, abs(a[j][j]));
+    }
+    const T tol = detail::pivot_tolerance<N>(scale);
+
+    for (std::size_t j = 0; j < N; ++j) {
+        T d = a[j][j];
+        for (std::size_t k = 0; k < j; ++k) d -= a[j][k] * a[j][k];
+        if (!(d > tol)) {
+            return err(ErrorCode::MATH_NOT_POSITIVE_DEFINITE, "Matrix is not positive definite");
+        }
+
+        const T ljj = sqrt(d);
+        const T inv = T{1} / ljj;
+        a[j][j] = ljj;
+        for (std::size_t i = j + 1; i < N; ++i) {
+            T s = a[i][j];
+            for (std::size_t k = 0; k < j; ++k) s -= a[i][k] * a[j][k];
+            a[i][j] = s * inv;
+        }
+    }
+
+    cholesky_factor<N, T> f{};
+    for (std::size_t j = 0; j < N; ++j) {
+        for (std::size_t i = j; i < N; ++i) f.l(i, j) = a[i][j];
+    }
+    return f;
+}
+
+template<std::size_t N, floating_point T>
+requires (N >= 2)
+[[nodiscard]] constexpr result<ldlt_factor<N, T>> ldlt(const mat<N, N, T>& m) noexcept {
+    T a[N][N]{};
+    T d[N]{};
+    T scale{};
+    for (std::size_t j = 0; j < N; ++j) {
+        for (std::size_t i = j; i < N; ++i) a[i][j] = m(i, j);
+        scale = max(scale, abs(a[j][j]));
+    }
+    const T tol = detail::pivot_tolerance<N>(scale);
+
+    for (std::size_t j = 0; j < N; ++j) {
+        T dj = a[j][j];
+        for (std::size_t k = 0; k < j; ++k) dj -= a[j][k] * a[j][k] * d[k];
+        if (!(abs(dj) > tol)) {
+            return err(ErrorCode::MATH_RANK_DEFICIENT, "Matrix is rank deficient");
+        }
+        d[j] = dj;
+
+        const T inv = T{1} / dj;
+        for (std::size_t i = j + 1; i < N; ++i) {
+            T s = a[i][j];
+            for (std::size_t k = 0; k < j; ++k) s -= a[i][k] * a[j][k] * d[k];
+            a[i][j] = s * inv;
+        }
+    }
+
+    ldlt_factor<N, T> f{};
+    for (std::size_t j = 0; j < N; ++j) {
+        f.l(j, j) = T{1};
+        f.d[j] = d[j];
+        for (std::size_t i = j + 1; i < N; ++i) f.l(i, j) = a[i][j];
+    }
+    return f;
+}
+
+template<std::size_t R, std::size_t C, floating_point T>
+requires (R >= C && C >= 2)
+[[nodiscard]] constexpr result<qr_factor<R, C, T>> qr(const mat<R, C, T>& m) noexcept {
+    T a[R][C]{};
+    for (std::size_t i = 0; i < R; ++i) {
+        for (std::size_t j = 0; j < C; ++j) a[i][j] = m(i, j);
+    }
+
+    qr_factor<R, C, T> f{};
+    T scale{};
+    for (std::size_t k = 0; k < C; ++k) {
+        T norm2{};
+        for (std::size_t i = k; i < R; ++i) norm2 += a[i][k] * a[i][k];
+        if (norm2 == T{}) {
+            f.tau[k] = T{};
+            continue;
+        }
+
+        const T alpha = a[k][k];
+        const T beta = alpha >= T{} ? -sqrt(norm2) : sqrt(norm2);
+        const T inv = T{1} / (alpha - beta);
+        for (std::size_t i = k + 1; i < R; ++i) a[i][k] *= inv;
+        f.tau[k] = (beta - alpha) / beta;
+        a[k][k] = beta;
+        scale = max(scale, abs(beta));
+
+        for (std::size_t j = k + 1; j < C; ++j) {
+            T w = a[k][j];
+            for (std::size_t i = k + 1; i < R; ++i) w += a[i][k] * a[i][j];
+            w *= f.tau[k];
+            a[k][j] -= w;
+            for (std::size_t i = k + 1; i < R; ++i) a[i][j] -= a[i][k] * w;
+        }
+    }
+
+    const T tol = detail::pivot_tolerance<R>(scale);
+    for (std::size_t k = 0; k < C; ++k) {
+        if (!(abs(a[k][k]) > tol)) {
+            return err(ErrorCode::MATH_RANK_DEFICIENT, "Matrix is rank deficient");
+        }
+    }
+
+    for (std::size_t i = 0; i < R; ++i) {
+        for (std::size_t j = 0; j < C; ++j) f.qr(i, j) = a[i][j];
+    }
+    return f;
+}
+
+template<std::size_t N, floating_point T>
+requires (N >= 2)
+[[nodiscard]] constexpr result<vec<N, T>> solve(const mat<N, N, T>& m, const vec<N, T>& b) noexcept {
+    T a[N][N]{};
+    T x[N]{};
+    T scale{};
+    for (std::size_t i = 0; i < N; ++i) {
+        for (std::size_t j = 0; j < N; ++j) {
+            a[i][j] = m(i, j);
+            scale = max(scale, abs(a[i][j]));
+        }
+        x[i] = b[i];
+    }
+    const T tol = detail::pivot_tolerance<N>(scale);
+
+    for (std::size_t k = 0; k < N; ++k) {
+        std::size_t pivot = k;
+        T maxv = abs(a[k][k]);
+        for (std::size_t r = k + 1; r < N; ++r) {
+            const T v = abs(a[r][k]);
+            if (v > maxv) {
+                maxv = v;
+                pivot = r;
+            }
+        }
+
+        if (!(maxv > tol)) {
+            return err(ErrorCode::MATH_SINGULAR_MATRIX, "Matrix is singular");
+        }
+
+        if (pivot != k) {
+            for (std::size_t c = k; c < N; ++c) std::swap(a[k][c], a[pivot][c]);
+            std::swap(x[k], x[pivot]);
+        }
+
+        const T inv = T{1} / a[k][k];
+        for (std::size_t r = k + 1; r < N; ++r) {
+            const T f = a[r][k] * inv;
+            for (std::size_t c = k + 1; c < N; ++c) a[r][c] -= f * a[k][c];
+            x[r] -= f * x[k];
+        }
+    }
+
+    vec<N, T> out{};
+    for (std::size_t i = N; i-- > 0;) {
+        T s = x[i];
+        for (std::size_t k = i + 1; k < N; ++k) s -= a[i][k] * out[k];
+        out[i] = s / a[i][i];
+    }
+    return out;
+}
+
+} // namespace ct
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "./fwd.hpp"
+#include "./mat3.hpp"
+#include "../vec/vec3.hpp"
+#include "../detail/arithmetic.hpp"
+#include "../common/functions.hpp"
+#include "../common/constants.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <span>
+
+//NOTE: Closed-form 3x3 decompositions without heap or iteration-count branches:
+//   - eigen_symmetric(S)  cyclic Jacobi with a fixed sweep count, values sorted descending
+//   - svd(A)              Jacobi eigen of A^T A for V, then Givens QR of A V for U and sigma
+//   - orthonormalize(R)   nearest rotation U V^T, for re-projecting drifted rotations
+// U and V are always proper rotations (det +1). To keep that, sigma[2] carries the sign of
+// det(A), which is what essential matrix decomposition wants. Take abs() for the classic SVD.
+
+namespace ct {
+
+template<floating_point T>
+struct eigen3_result {
+    vec<3, T> values{};         // descending
+    mat<3, 3, T> vectors{};     // column i belongs to values[i], det = +1
+};
+
+template<floating_point T>
+struct svd3_result {
+    mat<3, 3, T> u{};
+    vec<3, T> s{};              // s[0] >= s[1] >= |s[2]|
+    mat<3, 3, T> v{};
+};
+
+namespace detail {
+
+//NOTE: Cyclic Jacobi converges quadratically on 3x3, these counts reach round-off from any start
+template<floating_point T>
+inline constexpr int jacobi_sweeps = sizeof(T) > 4 ? 6 : 4;
+
+template<floating_point T>
+inline void jacobi_rotate(T (&a)[3][3], T (&v)[3][3], std::size_t p, std::size_t q) noexcept {
+    const T apq = a[p][q];
+    if (apq == T{}) return;
+
+    const T theta = (a[q][q] - a[p][p]) / (T{2} * apq);
+    const T t = (theta >= T{} ? T{1} : T{-1}) / (abs(theta) + sqrt(theta * theta + T{1}));
+    const T c = T{1} / sqrt(t * t + T{1});
+    const T s = t * c;
+
+    a[p][p] -= t * apq;
+    a[q][q] += t * apq;
+    a[p][q] = a[q][p] = T{};
+
+    const std::size_t r = 3 - p - q;
+    const T arp = a[r][p];
+    const T arq = a[r][q];
+    a[r][p] = a[p][r] = c * arp - s * arq;
+    a[r][q] = a[q][r] = s * arp + c * arq;
+
+    for (std::size_t k = 0; k < 3; ++k) {
+        const T vkp = v[k][p];
+        const T vkq = v[k][q];
+        v[k][p] = c * vkp - s * vkq;
+        v[k][q] = s * vkp + c * vkq;
+    }
+}
+
+//NOTE: Swapping two columns flips det(V), negating one of them restores a proper rotation
+template<floating_point T>
+inline void sort_swap(T (&d)[3], T (&v)[3][3], std::size_t i, std::size_t j) noexcept {
+    if (d[i] >= d[j]) return;
+    const T td = d[i];
+    d[i] = d[j];
+    d[j] = td;
+    for (std::size_t k = 0; k < 3; ++k) {
+        const T tv = v[k][i];
+        v[k][i] = v[k][j];
+        v[k][j] = -tv;
+    }
+}
+
+template<floating_point T>
+inline void eigen_symmetric(T (&a)[3][3], T (&d)[3], T (&v)[3][3]) noexcept {
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) v[i][j] = i == j ? T{1} : T{0};
+    }
+
+    for (int sweep = 0; sweep < jacobi_sweeps<T>; ++sweep) {
+        jacobi_rotate(a, v, 0, 1);
+        jacobi_rotate(a, v, 0, 2);
+        jacobi_rotate(a, v, 1, 2);
+    }
+
+    d[0] = a[0][0];
+    d[1] = a[1][1];
+    d[2] = a[2][2];
+    sort_swap(d, v, 0, 1);
+    sort_swap(d, v, 0, 2);
+    sort_swap(d, v, 1, 2);
+}
+
+//NOTE: Rotates rows p, q of b so that b[q][k] becomes zero and accumulates U = U * G^T.
+// A zero column leaves everything untouched through the select instead of a branch.
+template<floating_point T>
+inline void givens_qr_step(T (&b)[3][3], T (&u)[3][3], std::size_t p, std::size_t q, std::size_t k) noexcept {
+    const T x = b[p][k];
+    const T y = b[q][k];
+    const T r2 = x * x + y * y;
+    const bool valid = r2 > std::numeric_limits<T>::min();
+    const T rinv = T{1} / sqrt(valid ? r2 : T{1});
+    const T c = valid ? x * rinv : T{1};
+    const T s = valid ? y * rinv : T{0};
+
+    for (std::size_t j = 0; j < 3; ++j) {
+        const T bp = b[p][j];
+        const T bq = b[q][j];
+        b[p][j] = c * bp + s * bq;
+        b[q][j] = c * bq - s * bp;
+    }
+    for (std::size_t i = 0; i < 3; ++i) {
+        const T up = u[i][p];
+        const T uq = u[i][q];
+        u[i][p] = c * up + s * uq;
+        u[i][q] = c * uq - s * up;
+    }
+}
+
+template<floating_point T>
+[[nodiscard]] inline mat<3, 3, T> from_rows(const T (&a)[3][3]) noexcept {
+    return mat<3, 3, T>(layout::rowm,
+                        a[0][0], a[0][1], a[0][2],
+                        a[1][0], a[1][1], a[1][2],
+                        a[2][0], a[2][1], a[2][2]);
+}
+
+} // namespace detail
+
+//NOTE: Only the lower triangle of s is read
+template<floating_point T>
+[[nodiscard]] inline eigen3_result<T> eigen_symmetric(const mat<3, 3, T>& s) noexcept {
+    T a[3][3] = {
+        {s(0, 0), s(1, 0), s(2, 0)},
+        {s(1, 0), s(1, 1), s(2, 1)},
+        {s(2, 0), s(2, 1), s(2, 2)},
+    };
+    T d[3];
+    T v[3][3];
+    detail::eigen_symmetric(a, d, v);
+    return eigen3_result<T>{vec<3, T>(d[0], d[1], d[2]), detail::from_rows(v)};
+}
+
+template<floating_point T>
+[[nodiscard]] inline svd3_result<T> svd(const mat<3, 3, T>& m) noexcept {
+    T a[3][3];
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) a[i][j] = m(i, j);
+    }
+
+    T ata[3][3];
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = i; j < 3; ++j) {
+            ata[i][j] = ata[j][i] = a[0][i] * a[0][j] + a[1][i] * a[1][j] + a[2][i] * a[2][j];
+        }
+    }
+
+    T d[3];
+    T v[3][3];
+    detail::eigen_symmetric(ata, d, v);
+
+    T b[3][3];
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            b[i][j] = a[i][0] * v[0][j] + a[i][1] * v[1][j] + a[i][2] * v[2][j];
+        }
+    }
+
+    T u[3][3] = {{T{1}, T{0}, T{0}}, {T{0}, T{1}, T{0}}, {T{0}, T{0}, T{1}}};
+    detail::givens_qr_step(b, u, 0, 1, 0);
+    detail::givens_qr_step(b, u, 0, 2, 0);
+    detail::givens_qr_step(b, u, 1, 2, 1);
+
+    return svd3_result<T>{detail::from_rows(u), vec<3, T>(b[0][0], b[1][1], b[2][2]), detail::from_rows(v)};
+}
+
+//NOTE: Closest rotation in the Frobenius norm
+template<floating_point T>
+[[nodiscard]] inline mat<3, 3, T> orthonormalize(const mat<3, 3, T>& m) noexcept {
+    const svd3_result<T> r = svd(m);
+    return r.u * r.v.transpose();
+}
+
+//NOTE: Batched variants, out must hold at least in.size() elements
+template<floating_point T>
+void eigen_symmetric(std::span<const mat<3, 3, T>> in, std::span<eigen3_result<T>> out) noexcept {
+    assert(out.size() >= in.size());
+    for (std::size_t i = 0; i < in.size(); ++i) out[i] = eigen_symmetric(in[i]);
+}
+
+template<floating_point T>
+void svd(std::span<const mat<3, 3, T>> in, std::span<svd3_result<T>> out) noexcept {
+    assert(out.size() >= in.size());
+    for (std::size_t i = 0; i < in.size(); ++i) out[i] = svd(in[i]);
+}
+
+template<floating_point T>
+void orthonormalize(std::span<mat<3, 3, T>> inout) noexcept {
+    for (mat<3, 3, T>& m : inout) m = orthonormalize(m);
+}
+
+} // namespace ct
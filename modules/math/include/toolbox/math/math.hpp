@@ -4,6 +4,7 @@
 #include "detail/arithmetic.hpp"
 #include "common/constants.hpp"
 #include "common/functions.hpp"
+#include "autodiff/jet.hpp"
 
 #include "vec/fwd.hpp"
 #include "vec/base.hpp"
@@ -19,13 +20,29 @@
 #include "mat/mat4.hpp"
 #include "mat/functions.hpp"
 #include "mat/format.hpp"
+#include "mat/solve.hpp"
+#include "mat/svd.hpp"
 
 #include "quat/fwd.hpp"
 #include "quat/quat.hpp"
 
+#include "lie/fwd.hpp"
+#include "lie/so3.hpp"
+#include "lie/se3.hpp"
+
+#include "sparse/block_sparse.hpp"
+
+#include "optim/loss.hpp"
+#include "optim/manifold.hpp"
+#include "optim/levenberg_marquardt.hpp"
+#include "optim/bundle_adjustment.hpp"
+
 #include "interop/op.hpp"
 #include "interop/transform.hpp"
 
+#include "soa/vec_soa.hpp"
+#include "soa/functions.hpp"
+
 #include "types.hpp"
 // IWYU pragma: end_exports
 
@@ -0,0 +1,791 @@
+#pragma once
+
+#include "./loss.hpp"
+#include "./manifold.hpp"
+#include "./levenberg_marquardt.hpp"
+#include "../sparse/block_sparse.hpp"
+#include "../autodiff/jet.hpp"
+#include "../lie/se3.hpp"
+#include "../mat/base.hpp"
+#include "../mat/solve.hpp"
+#include "../vec/base.hpp"
+#include "../vec/vec3.hpp"
+#include "../detail/arithmetic.hpp"
+#include "../common/functions.hpp"
+
+#include "toolbox/base/errors/result.hpp"
+#include "toolbox/base/thread/thread_pool.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+//NOTE: Sparse Levenberg-Marquardt for bundle adjustment over se3 poses and 3D points. Every
+// residual block links one pose and one point, its functor is evaluated on jet<T, 9>:
+//
+//   template<class S>
+//   bool operator()(const se3<S>& Tcw, const vec<3, S>& pw, std::array<S, R>& r) const;
+//
+// The normal equations [U W; W^T V] are kept as 6x6 pose blocks U, 3x3 point blocks V and a
+// block-sparse 6x3 W. Points are eliminated with the Schur complement S = U - W V^-1 W^T, the
+// reduced camera system is solved with block-Jacobi preconditioned conjugate gradients and the
+// point steps follow by back-substitution. Every pass is partitioned so that each thread owns
+// the blocks it writes (observations, camera rows or points), nothing is locked.
+//
+// Fix at least one pose (or add a prior residual) to remove the gauge freedom.
+
+namespace ct {
+
+template<floating_point T>
+class bundle_adjustment {
+public:
+    using value_type = T;
+    using pose_type = se3<T>;
+    using point_type = vec<3, T>;
+    static constexpr std::size_t pose_dim = 6;
+    static constexpr std::size_t point_dim = 3;
+    using jet_type = jet<T, pose_dim + point_dim>;
+
+    struct options {
+        u32 max_iterations{20};
+        T initial_lambda{T(1e-4)};
+        T gradient_tolerance{T(1e-10)};
+        T step_tolerance{T(1e-10)};
+        T cost_tolerance{T(1e-12)};         // relative
+        u32 max_linear_iterations{100};
+        T linear_tolerance{T(1e-6)};        // relative PCG residual
+        ThreadPool* pool{nullptr};          // nullptr runs on the calling thread
+        std::size_t grain{128};             // items per parallel chunk
+    };
+
+    struct summary {
+        u32 iterations{0};
+        u32 linear_iterations{0};
+        T initial_cost{};
+        T final_cost{};
+        lm_termination termination{lm_termination::max_iterations};
+        bool converged{false};
+    };
+
+    bundle_adjustment() = default;
+    explicit bundle_adjustment(const options& opts) : options_(opts) {}
+
+    template<std::size_t R, typename F, typename L = trivial_loss<T>>
+    requires (R > 0)
+    void add_residual(std::size_t pose, std::size_t point, F f, L loss = {}) {
+        using group_type = residual_group<R, F, L>;
+        group_type* typed = nullptr;
+        for (const std::unique_ptr<group_base>& g : groups_) {
+            if ((typed = dynamic_cast<group_type*>(g.get()))) break;
+        }
+        if (!typed) {
+            auto group = std::make_unique<group_type>();
+            typed = group.get();
+            groups_.push_back(std::move(group));
+        }
+        typed->blocks.emplace_back(std::move(f), std::move(loss));
+        typed->poses.push_back(pose);
+        typed->points.push_back(point);
+        ++count_;
+    }
+
+    //NOTE: Fixed poses keep their value, their Jacobian columns are never seeded
+    void set_pose_fixed(std::size_t pose, bool fixed = true) {
+        if (fixed_.size() <= pose) fixed_.resize(pose + 1, false);
+        fixed_[pose] = fixed;
+    }
+
+    [[nodiscard]] std::size_t residual_count() const noexcept { return count_; }
+
+    void clear() noexcept {
+        groups_.clear();
+        fixed_.clear();
+        count_ = 0;
+    }
+
+    [[nodiscard]] options& settings() noexcept { return options_; }
+    [[nodiscard]] const options& settings() const noexcept { return options_; }
+
+    //NOTE: Refines poses and points in place. All buffers are sized once here, the iterations
+    // themselves do not allocate.
+    [[nodiscard]] result<summary> solve(std::span<pose_type> poses, std::span<point_type> points) const {
+        if (count_ == 0) {
+            return err(ErrorCode::INVALID_ARGUMENT, "Bundle adjustment problem has no residuals");
+        }
+        for (const std::unique_ptr<group_base>& g : groups_) {
+            for (std::size_t b = 0; b < g->size(); ++b) {
+                if (g->poses[b] >= poses.size() || g->points[b] >= points.size()) {
+                    return err(ErrorCode::INVALID_ARGUMENT, "Residual references a missing pose or point");
+                }
+            }
+        }
+
+        workspace ws(*this, poses.size(), points.size());
+
+        if (!linearize(ws, poses, points)) {
+            return err(ErrorCode::MATH_NON_FINITE, "Residual evaluation failed at the initial estimate");
+        }
+
+        summary s{};
+        s.initial_cost = ws.cost;
+        s.final_cost = ws.cost;
+
+        T lambda = options_.initial_lambda;
+        T nu{2};
+
+        while (true) {
+            if (max_gradient(ws) <= options_.gradient_tolerance) {
+                s.termination = lm_termination::gradient_tolerance;
+                s.converged = true;
+                break;
+            }
+            if (s.iterations >= options_.max_iterations) {
+                s.termination = lm_termination::max_iterations;
+                break;
+            }
+            if (lambda > lambda_max) {
+                s.termination = lm_termination::no_progress;
+                break;
+            }
+            ++s.iterations;
+
+            u32 cg = 0;
+            if (!compute_step(ws, lambda, cg)) {
+                lambda *= nu;
+                nu *= T{2};
+                continue;
+            }
+            s.linear_iterations += cg;
+
+            T step2{};
+            T predicted{};
+            for (std::size_t i = 0; i < ws.nc; ++i) {
+                for (std::size_t k = 0; k < pose_dim; ++k) {
+                    const T d = ws.dc[i * pose_dim + k];
+                    step2 += d * d;
+                    predicted += d * (ws.dc_diag[i][k] * d - ws.gc[i][k]);
+                }
+            }
+            for (std::size_t j = 0; j < ws.np; ++j) {
+                for (std::size_t k = 0; k < point_dim; ++k) {
+                    const T d = ws.dp[j][k];
+                    step2 += d * d;
+                    predicted += d * (ws.dp_diag[j][k] * d - ws.gp[j][k]);
+                }
+            }
+            predicted *= T{0.5};
+
+            if (sqrt(step2) <= options_.step_tolerance) {
+                s.termination = lm_termination::step_tolerance;
+                s.converged = true;
+                break;
+            }
+
+            parallel_for(ws.nc, [&](std::size_t begin, std::size_t end, u32) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    vec<pose_dim, T> d{};
+                    for (std::size_t k = 0; k < pose_dim; ++k) d[k] = ws.dc[i * pose_dim + k];
+                    ws.candidate_poses[i] = is_fixed(i) ? poses[i] : manifold<pose_type>::plus(poses[i], d);
+                }
+            });
+            for (std::size_t j = 0; j < ws.np; ++j) ws.candidate_points[j] = points[j] + ws.dp[j];
+
+            const T cost = evaluate(ws, ws.candidate_poses, ws.candidate_points);
+            const T actual = ws.cost - cost;
+            const T gain = predicted > T{} ? actual / predicted : T{-1};
+
+            if (std::isfinite(cost) && gain > T{}) {
+                const T previous = ws.cost;
+                if (!linearize(ws, ws.candidate_poses, ws.candidate_points)) {
+                    // The old linearization was overwritten, rebuild it before trying a smaller step
+                    if (!linearize(ws, poses, points)) {
+                        return err(ErrorCode::MATH_NON_FINITE, "Residual evaluation failed");
+                    }
+                    lambda *= nu;
+                    nu *= T{2};
+                    continue;
+                }
+                std::copy(ws.candidate_poses.begin(), ws.candidate_poses.end(), poses.begin());
+                std::copy(ws.candidate_points.begin(), ws.candidate_points.end(), points.begin());
+                s.final_cost = ws.cost;
+
+                const T t = T{2} * gain - T{1};
+                lambda *= max(T{1} / T{3}, T{1} - t * t * t);
+                nu = T{2};
+
+                if (abs(previous - ws.cost) <= options_.cost_tolerance * ws.cost) {
+                    s.termination = lm_termination::cost_tolerance;
+                    s.converged = true;
+                    break;
+                }
+            } else {
+                lambda *= nu;
+                nu *= T{2};
+            }
+        }
+
+        return s;
+    }
+
+private:
+    static constexpr T diagonal_min = T(1e-6);
+    static constexpr T diagonal_max = T(1e32);
+    static constexpr T lambda_max = T(1e32);
+
+    using jet_pose = se3<jet_type>;
+    using jet_point = vec<3, jet_type>;
+
+    //NOTE: One residual row scaled by sqrt(rho'), so that J^T J and J^T r are the IRLS terms.
+    // Columns 0-5 are the pose, 6-8 the point.
+    struct jacobian_row {
+        std::array<T, pose_dim + point_dim> j{};
+        T r{};
+    };
+
+    struct lane {
+        T cost{};
+        bool valid{true};
+    };
+
+    struct group_base {
+        std::vector<std::size_t> poses;
+        std::vector<std::size_t> points;
+
+        virtual ~group_base() = default;
+        [[nodiscard]] virtual std::size_t size() const noexcept = 0;
+        [[nodiscard]] virtual std::size_t residual_size() const noexcept = 0;
+        virtual void linearize(std::span<const jet_pose> x, std::span<const jet_point> p,
+                               std::size_t begin, std::size_t end, jacobian_row* rows, lane& acc) const = 0;
+        virtual void evaluate(std::span<const pose_type> x, std::span<const point_type> p,
+                              std::size_t begin, std::size_t end, lane& acc) const = 0;
+    };
+
+    template<std::size_t R, typename F, typename L>
+    struct residual_group final : group_base {
+        std::vector<std::pair<F, L>> blocks;
+
+        [[nodiscard]] std::size_t size() const noexcept override { return blocks.size(); }
+        [[nodiscard]] std::size_t residual_size() const noexcept override { return R; }
+
+        //NOTE: rows points at the first row of this group, block b owns rows [b R, b R + R)
+        void linearize(std::span<const jet_pose> x, std::span<const jet_point> p,
+                       std::size_t begin, std::size_t end, jacobian_row* rows, lane& acc) const override {
+            for (std::size_t b = begin; b < end; ++b) {
+                std::array<jet_type, R> r{};
+                if (!blocks[b].first(x[this->poses[b]], p[this->points[b]], r)) {
+                    acc.valid = false;
+                    return;
+                }
+
+                T s2{};
+                for (std::size_t i = 0; i < R; ++i) s2 += r[i].a * r[i].a;
+                const loss_eval<T> l = blocks[b].second(s2);
+                acc.cost += T{0.5} * l.rho;
+
+                const T w = sqrt(l.weight);
+                jacobian_row* out = rows + b * R;
+                for (std::size_t i = 0; i < R; ++i) {
+                    for (std::size_t k = 0; k < pose_dim + point_dim; ++k) out[i].j[k] = w * r[i].v[k];
+                    out[i].r = w * r[i].a;
+                }
+            }
+        }
+
+        void evaluate(std::span<const pose_type> x, std::span<const point_type> p,
+                      std::size_t begin, std::size_t end, lane& acc) const override {
+            for (std::size_t b = begin; b < end; ++b) {
+                std::array<T, R> r{};
+                if (!blocks[b].first(x[this->poses[b]], p[this->points[b]], r)) {
+                    acc.valid = false;
+                    return;
+                }
+
+                T s2{};
+                for (std::size_t i = 0; i < R; ++i) s2 += r[i] * r[i];
+                acc.cost += T{0.5} * blocks[b].second(s2).rho;
+            }
+        }
+    };
+
+    //NOTE: Problem structure and every per-iteration buffer. Observations are numbered group by
+    // group, cam_obs / pt_obs list them per camera and per point (CSR), obs_w maps each one to
+    // its W block. Observations of the same (pose, point) pair share a W block.
+    struct workspace {
+        std::size_t nc{0};
+        std::size_t np{0};
+        std::size_t nobs{0};
+        T cost{};
+
+        std::vector<std::size_t> group_obs;         // first observation of each group
+        std::vector<std::size_t> obs_pose;
+        std::vector<std::size_t> obs_point;
+        std::vector<std::size_t> obs_row;           // nobs + 1 prefix offsets into rows
+        std::vector<std::size_t> obs_w;
+        std::vector<jacobian_row> rows;
+
+        std::vector<std::size_t> cam_offsets;
+        std::vector<std::size_t> cam_obs;
+        std::vector<std::size_t> pt_offsets;
+        std::vector<std::size_t> pt_obs;
+        std::vector<std::size_t> wcol_offsets;      // W blocks per point, i.e. per block column
+        std::vector<std::size_t> wcol_blocks;
+        std::vector<std::size_t> wcol_cams;
+        std::vector<std::size_t> schur_offsets;     // per W block, into schur_blocks
+        std::vector<std::size_t> schur_blocks;      // S block hit by each (W block, camera of its point)
+        std::vector<std::size_t> s_diag;
+        std::vector<std::size_t> s_mirror;          // storage index of block (c, r) for block (r, c)
+
+        block_sparse<pose_dim, point_dim, T> w;
+        block_sparse<pose_dim, pose_dim, T> s;
+
+        std::vector<mat<pose_dim, pose_dim, T>> u;
+        std::vector<vec<pose_dim, T>> gc;
+        std::vector<vec<pose_dim, T>> dc_diag;
+        std::vector<mat<point_dim, point_dim, T>> v;
+        std::vector<mat<point_dim, point_dim, T>> vinv;
+        std::vector<vec<point_dim, T>> gp;
+        std::vector<vec<point_dim, T>> q;
+        std::vector<vec<point_dim, T>> dp;
+        std::vector<vec<point_dim, T>> dp_diag;
+        std::vector<cholesky_factor<pose_dim, T>> precond;
+        std::vector<char> fixed;
+
+        std::vector<T> b, dc, r, z, p, ap;
+
+        std::vector<jet_pose> jposes;
+        std::vector<jet_point> jpoints;
+        std::vector<pose_type> candidate_poses;
+        std::vector<point_type> candidate_points;
+        std::vector<lane> lanes;
+
+        workspace(const bundle_adjustment& ba, std::size_t cameras, std::size_t pts) : nc(cameras), np(pts) {
+            nobs = ba.count_;
+            obs_pose.reserve(nobs);
+            obs_point.reserve(nobs);
+            obs_row.reserve(nobs + 1);
+            obs_row.push_back(0);
+            for (const std::unique_ptr<group_base>& g : ba.groups_) {
+                group_obs.push_back(obs_pose.size());
+                for (std::size_t k = 0; k < g->size(); ++k) {
+                    obs_pose.push_back(g->poses[k]);
+                    obs_point.push_back(g->points[k]);
+                    obs_row.push_back(obs_row.back() + g->residual_size());
+                }
+            }
+            rows.resize(obs_row.back());
+
+            bucket(obs_pose, nc, cam_offsets, cam_obs);
+            bucket(obs_point, np, pt_offsets, pt_obs);
+
+            std::vector<std::pair<std::size_t, std::size_t>> entries(nobs);
+            for (std::size_t o = 0; o < nobs; ++o) entries[o] = {obs_pose[o], obs_point[o]};
+            w = block_sparse<pose_dim, point_dim, T>(nc, np, std::move(entries));
+            obs_w.resize(nobs);
+            for (std::size_t o = 0; o < nobs; ++o) obs_w[o] = w.find(obs_pose[o], obs_point[o]);
+
+            // Transpose of the W pattern, the cameras that see each point
+            std::vector<std::size_t> block_col(w.nonzero_blocks());
+            std::vector<std::size_t> block_row(w.nonzero_blocks());
+            for (std::size_t i = 0; i < nc; ++i) {
+                for (std::size_t k = w.row_begin(i); k < w.row_end(i); ++k) {
+                    block_col[k] = w.col_index(k);
+                    block_row[k] = i;
+                }
+            }
+            bucket(block_col, np, wcol_offsets, wcol_blocks);
+            wcol_cams.resize(wcol_blocks.size());
+            for (std::size_t k = 0; k < wcol_blocks.size(); ++k) wcol_cams[k] = block_row[wcol_blocks[k]];
+
+            // S couples two cameras when they share a point, the marker keeps each pair once
+            std::vector<std::pair<std::size_t, std::size_t>> pairs;
+            std::vector<std::size_t> marker(nc, std::numeric_limits<std::size_t>::max());
+            for (std::size_t i = 0; i < nc; ++i) {
+                pairs.emplace_back(i, i);
+                marker[i] = i;
+                for (std::size_t k = w.row_begin(i); k < w.row_end(i); ++k) {
+                    const std::size_t j = w.col_index(k);
+                    for (std::size_t m = wcol_offsets[j]; m < wcol_offsets[j + 1]; ++m) {
+                        const std::size_t c = wcol_cams[m];
+                        if (marker[c] != i) {
+                            marker[c] = i;
+                            pairs.emplace_back(i, c);
+                        }
+                    }
+                }
+            }
+            s = block_sparse<pose_dim, pose_dim, T>(nc, nc, std::move(pairs));
+
+            // Resolve the S block of every update up front, the Schur pass then does no lookups
+            // S is symmetric, only the upper block triangle is formed and then mirrored. Cameras
+            // of a point are sorted, so the updates of row i start at the first camera >= i.
+            s_diag.resize(nc);
+            schur_offsets.assign(w.nonzero_blocks() + 1, 0);
+            for (std::size_t i = 0; i < nc; ++i) {
+                s_diag[i] = s.find(i, i);
+                for (std::size_t k = w.row_begin(i); k < w.row_end(i); ++k) {
+                    const std::size_t j = w.col_index(k);
+                    for (std::size_t m = wcol_offsets[j]; m < wcol_offsets[j + 1]; ++m) {
+                        if (wcol_cams[m] >= i) schur_blocks.push_back(s.find(i, wcol_cams[m]));
+                    }
+                    schur_offsets[k + 1] = schur_blocks.size();
+                }
+            }
+            s_mirror.resize(s.nonzero_blocks());
+            for (std::size_t i = 0; i < nc; ++i) {
+                for (std::size_t k = s.row_begin(i); k < s.row_end(i); ++k) s_mirror[k] = s.find(s.col_index(k), i);
+            }
+
+            u.resize(nc);
+            gc.resize(nc);
+            dc_diag.resize(nc);
+            precond.resize(nc);
+            fixed.assign(nc, 0);
+            for (std::size_t i = 0; i < std::min(nc, ba.fixed_.size()); ++i) fixed[i] = ba.fixed_[i] ? 1 : 0;
+            v.resize(np);
+            vinv.resize(np);
+            gp.resize(np);
+            q.resize(np);
+            dp.resize(np);
+            dp_diag.resize(np);
+
+            const std::size_t n = nc * pose_dim;
+            b.resize(n);
+            dc.resize(n);
+            r.resize(n);
+            z.resize(n);
+            p.resize(n);
+            ap.resize(n);
+
+            jposes.resize(nc);
+            jpoints.resize(np);
+            candidate_poses.resize(nc);
+            candidate_points.resize(np);
+            lanes.resize(ba.options_.pool ? ba.options_.pool->GetConcurrency() : 1u);
+        }
+
+        static void bucket(const std::vector<std::size_t>& keys, std::size_t n,
+                           std::vector<std::size_t>& offsets, std::vector<std::size_t>& items) {
+            offsets.assign(n + 1, 0);
+            for (std::size_t key : keys) ++offsets[key + 1];
+            for (std::size_t i = 0; i < n; ++i) offsets[i + 1] += offsets[i];
+            items.resize(keys.size());
+            std::vector<std::size_t> fill(offsets.begin(), offsets.end() - 1);
+            for (std::size_t k = 0; k < keys.size(); ++k) items[fill[keys[k]]++] = k;
+        }
+
+        void reset_lanes() noexcept {
+            for (lane& l : lanes) l = lane{};
+        }
+
+        [[nodiscard]] bool reduce_lanes(T& total) const noexcept {
+            total = T{};
+            for (const lane& l : lanes) {
+                if (!l.valid) return false;
+                total += l.cost;
+            }
+            return std::isfinite(total);
+        }
+    };
+
+    [[nodiscard]] bool is_fixed(std::size_t pose) const noexcept {
+        return pose < fixed_.size() && fixed_[pose];
+    }
+
+    template<typename Fn>
+    void parallel_for(std::size_t count, Fn&& fn) const {
+        if (!options_.pool) {
+            fn(std::size_t{0}, count, u32{0});
+            return;
+        }
+        options_.pool->ParallelFor(count, options_.grain, fn);
+    }
+
+    //NOTE: Lifts every pose and point onto jets once, evaluates all residuals into the row
+    // buffer, then accumulates U, W and g per camera and V and g per point
+    bool linearize(workspace& ws, std::span<const pose_type> poses, std::span<const point_type> points) const {
+        parallel_for(ws.nc, [&](std::size_t begin, std::size_t end, u32) {
+            vec<pose_dim, jet_type> seed{};
+            for (std::size_t k = 0; k < pose_dim; ++k) seed[k] = jet_type::variable(T{}, k);
+            for (std::size_t i = begin; i < end; ++i) {
+                ws.jposes[i] = ws.fixed[i] ? manifold<pose_type>::template lift<jet_type>(poses[i])
+                                           : manifold<pose_type>::plus(poses[i], seed);
+            }
+        });
+        for (std::size_t j = 0; j < ws.np; ++j) {
+            ws.jpoints[j] = jet_point(jet_type::variable(points[j].x, pose_dim),
+                                      jet_type::variable(points[j].y, pose_dim + 1),
+                                      jet_type::variable(points[j].z, pose_dim + 2));
+        }
+
+        ws.reset_lanes();
+        for (std::size_t g = 0; g < groups_.size(); ++g) {
+            const group_base& group = *groups_[g];
+            jacobian_row* rows = ws.rows.data() + ws.obs_row[ws.group_obs[g]];
+            parallel_for(group.size(), [&](std::size_t begin, std::size_t end, u32 slot) {
+                group.linearize(ws.jposes, ws.jpoints, begin, end, rows, ws.lanes[slot]);
+            });
+        }
+        if (!ws.reduce_lanes(ws.cost)) return false;
+
+        parallel_for(ws.nc, [&](std::size_t begin, std::size_t end, u32) {
+            for (std::size_t i = begin; i < end; ++i) {
+                mat<pose_dim, pose_dim, T>& u = ws.u[i];
+                vec<pose_dim, T>& g = ws.gc[i];
+                u = {};
+                g = {};
+                for (std::size_t k = ws.w.row_begin(i); k < ws.w.row_end(i); ++k) ws.w.block(k) = {};
+
+                for (std::size_t m = ws.cam_offsets[i]; m < ws.cam_offsets[i + 1]; ++m) {
+                    const std::size_t o = ws.cam_obs[m];
+                    mat<pose_dim, point_dim, T>& wb = ws.w.block(ws.obs_w[o]);
+                    for (std::size_t row = ws.obs_row[o]; row < ws.obs_row[o + 1]; ++row) {
+                        const jacobian_row& jr = ws.rows[row];
+                        for (std::size_t a = 0; a < pose_dim; ++a) {
+                            g[a] += jr.j[a] * jr.r;
+                            for (std::size_t c = 0; c <= a; ++c) u(a, c) += jr.j[a] * jr.j[c];
+                            for (std::size_t c = 0; c < point_dim; ++c) wb(a, c) += jr.j[a] * jr.j[pose_dim + c];
+                        }
+                    }
+                }
+                for (std::size_t a = 0; a < pose_dim; ++a) {
+                    for (std::size_t c = a + 1; c < pose_dim; ++c) u(a, c) = u(c, a);
+                }
+            }
+        });
+
+        parallel_for(ws.np, [&](std::size_t begin, std::size_t end, u32) {
+            for (std::size_t j = begin; j < end; ++j) {
+                mat<point_dim, point_dim, T>& v = ws.v[j];
+                vec<point_dim, T>& g = ws.gp[j];
+                v = {};
+                g = {};
+                for (std::size_t m = ws.pt_offsets[j]; m < ws.pt_offsets[j + 1]; ++m) {
+                    const std::size_t o = ws.pt_obs[m];
+                    for (std::size_t row = ws.obs_row[o]; row < ws.obs_row[o + 1]; ++row) {
+                        const jacobian_row& jr = ws.rows[row];
+                        for (std::size_t a = 0; a < point_dim; ++a) {
+                            g[a] += jr.j[pose_dim + a] * jr.r;
+                            for (std::size_t c = 0; c < point_dim; ++c) v(a, c) += jr.j[pose_dim + a] * jr.j[pose_dim + c];
+                        }
+                    }
+                }
+            }
+        });
+
+        for (std::size_t i = 0; i < ws.nc; ++i) {
+            for (std::size_t k = 0; k < pose_dim; ++k) {
+                if (!std::isfinite(ws.gc[i][k])) return false;
+            }
+        }
+        for (std::size_t j = 0; j < ws.np; ++j) {
+            for (std::size_t k = 0; k < point_dim; ++k) {
+                if (!std::isfinite(ws.gp[j][k])) return false;
+            }
+        }
+        return true;
+    }
+
+    T evaluate(workspace& ws, std::span<const pose_type> poses, std::span<const point_type> points) const {
+        ws.reset_lanes();
+        for (const std::unique_ptr<group_base>& g : groups_) {
+            parallel_for(g->size(), [&](std::size_t begin, std::size_t end, u32 slot) {
+                g->evaluate(poses, points, begin, end, ws.lanes[slot]);
+            });
+        }
+        T cost{};
+        return ws.reduce_lanes(cost) ? cost : std::numeric_limits<T>::infinity();
+    }
+
+    //NOTE: Damps U and V by lambda * clamp(diag), eliminates the points into S dc = b, solves
+    // that with PCG and back-substitutes the point steps. false when a block is not positive
+    // definite, the caller then raises lambda.
+    bool compute_step(workspace& ws, T lambda, u32& cg_iterations) const {
+        std::vector<lane>& flags = ws.lanes;
+        ws.reset_lanes();
+
+        parallel_for(ws.np, [&](std::size_t begin, std::size_t end, u32 slot) {
+            for (std::size_t j = begin; j < end; ++j) {
+                mat<point_dim, point_dim, T> v = ws.v[j];
+                for (std::size_t k = 0; k < point_dim; ++k) {
+                    ws.dp_diag[j][k] = lambda * clamp(v(k, k), diagonal_min, diagonal_max);
+                    v(k, k) += ws.dp_diag[j][k];
+                }
+                auto f = cholesky(v);
+                if (!f) {
+                    flags[slot].valid = false;
+                    return;
+                }
+                for (std::size_t c = 0; c < point_dim; ++c) {
+                    vec<point_dim, T> e{};
+                    e[c] = T{1};
+                    const vec<point_dim, T> col = f->solve(e);
+                    for (std::size_t r = 0; r < point_dim; ++r) ws.vinv[j](r, c) = col[r];
+                }
+                ws.q[j] = ws.vinv[j] * ws.gp[j];
+            }
+        });
+        for (const lane& l : flags) {
+            if (!l.valid) return false;
+        }
+
+        parallel_for(ws.nc, [&](std::size_t begin, std::size_t end, u32 slot) {
+            for (std::size_t i = begin; i < end; ++i) {
+                for (std::size_t k = ws.s.row_begin(i); k < ws.s.row_end(i); ++k) ws.s.block(k) = {};
+                mat<pose_dim, pose_dim, T>& sii = ws.s.block(ws.s_diag[i]);
+                T* bi = ws.b.data() + i * pose_dim;
+
+                if (ws.fixed[i]) {
+                    sii = mat<pose_dim, pose_dim, T>::identity();
+                    for (std::size_t k = 0; k < pose_dim; ++k) {
+                        bi[k] = T{};
+                        ws.dc_diag[i][k] = T{};
+                    }
+                    ws.precond[i] = *cholesky(sii);
+                    continue;
+                }
+
+                sii = ws.u[i];
+                for (std::size_t k = 0; k < pose_dim; ++k) {
+                    ws.dc_diag[i][k] = lambda * clamp(ws.u[i](k, k), diagonal_min, diagonal_max);
+                    sii(k, k) += ws.dc_diag[i][k];
+                    bi[k] = -ws.gc[i][k];
+                }
+
+                for (std::size_t k = ws.w.row_begin(i); k < ws.w.row_end(i); ++k) {
+                    const std::size_t j = ws.w.col_index(k);
+                    const mat<pose_dim, point_dim, T> a = ws.w.block(k) * ws.vinv[j];
+                    const vec<pose_dim, T> aq = ws.w.block(k) * ws.q[j];
+                    for (std::size_t c = 0; c < pose_dim; ++c) bi[c] += aq[c];
+
+                    // S_ik -= (W_ij V_j^-1) W_kj^T for k >= i, column by column so the inner loop is contiguous
+                    const std::size_t last = ws.wcol_offsets[j + 1];
+                    const std::size_t first = last - (ws.schur_offsets[k + 1] - ws.schur_offsets[k]);
+                    for (std::size_t m = first; m < last; ++m) {
+                        const mat<pose_dim, point_dim, T>& wk = ws.w.block(ws.wcol_blocks[m]);
+                        mat<pose_dim, pose_dim, T>& sik = ws.s.block(ws.schur_blocks[ws.schur_offsets[k] + m - first]);
+                        for (std::size_t c = 0; c < pose_dim; ++c) {
+                            for (std::size_t t = 0; t < point_dim; ++t) {
+                                const T f = wk(c, t);
+                                for (std::size_t r = 0; r < pose_dim; ++r) sik(r, c) -= a(r, t) * f;
+                            }
+                        }
+                    }
+                }
+
+                auto f = cholesky(sii);
+                if (!f) {
+                    flags[slot].valid = false;
+                    return;
+                }
+                ws.precond[i] = *f;
+            }
+        });
+        for (const lane& l : flags) {
+            if (!l.valid) return false;
+        }
+
+        parallel_for(ws.nc, [&](std::size_t begin, std::size_t end, u32) {
+            for (std::size_t i = begin; i < end; ++i) {
+                for (std::size_t k = ws.s.row_begin(i); k < ws.s.row_end(i) && ws.s.col_index(k) < i; ++k) {
+                    ws.s.block(k) = ws.s.block(ws.s_mirror[k]).transpose();
+                }
+            }
+        });
+
+        cg_iterations = conjugate_gradient(ws);
+
+        parallel_for(ws.np, [&](std::size_t begin, std::size_t end, u32) {
+            for (std::size_t j = begin; j < end; ++j) {
+                vec<point_dim, T> wtd{};
+                for (std::size_t m = ws.wcol_offsets[j]; m < ws.wcol_offsets[j + 1]; ++m) {
+                    const mat<pose_dim, point_dim, T>& wk = ws.w.block(ws.wcol_blocks[m]);
+                    const T* d = ws.dc.data() + ws.wcol_cams[m] * pose_dim;
+                    for (std::size_t c = 0; c < point_dim; ++c) {
+                        for (std::size_t r = 0; r < pose_dim; ++r) wtd[c] += wk(r, c) * d[r];
+                    }
+                }
+                ws.dp[j] = -ws.q[j] - ws.vinv[j] * wtd;
+            }
+        });
+
+        for (std::size_t k = 0; k < ws.dc.size(); ++k) {
+            if (!std::isfinite(ws.dc[k])) return false;
+        }
+        return true;
+    }
+
+    //NOTE: Block-Jacobi preconditioned CG on S dc = b, S is symmetric positive definite here
+    u32 conjugate_gradient(workspace& ws) const {
+        const std::size_t n = ws.b.size();
+        auto dot = [n](const std::vector<T>& x, const std::vector<T>& y) {
+            T s{};
+            for (std::size_t k = 0; k < n; ++k) s += x[k] * y[k];
+            return s;
+        };
+        auto precondition = [&ws]() {
+            for (std::size_t i = 0; i < ws.nc; ++i) {
+                vec<pose_dim, T> ri{};
+                for (std::size_t k = 0; k < pose_dim; ++k) ri[k] = ws.r[i * pose_dim + k];
+                const vec<pose_dim, T> zi = ws.precond[i].solve(ri);
+                for (std::size_t k = 0; k < pose_dim; ++k) ws.z[i * pose_dim + k] = zi[k];
+            }
+        };
+
+        std::fill(ws.dc.begin(), ws.dc.end(), T{});
+        ws.r = ws.b;
+        const T target = options_.linear_tolerance * sqrt(dot(ws.b, ws.b));
+        if (sqrt(dot(ws.r, ws.r)) <= target) return 0;
+
+        precondition();
+        ws.p = ws.z;
+        T rz = dot(ws.r, ws.z);
+
+        u32 it = 0;
+        while (it < options_.max_linear_iterations) {
+            ++it;
+            parallel_for(ws.nc, [&](std::size_t begin, std::size_t end, u32) {
+                ws.s.multiply_rows(ws.p, ws.ap, begin, end);
+            });
+            const T pap = dot(ws.p, ws.ap);
+            if (!(pap > T{})) break;
+
+            const T alpha = rz / pap;
+            for (std::size_t k = 0; k < n; ++k) {
+                ws.dc[k] += alpha * ws.p[k];
+                ws.r[k] -= alpha * ws.ap[k];
+            }
+            if (sqrt(dot(ws.r, ws.r)) <= target) break;
+
+            precondition();
+            const T rz_next = dot(ws.r, ws.z);
+            const T beta = rz_next / rz;
+            rz = rz_next;
+            for (std::size_t k = 0; k < n; ++k) ws.p[k] = ws.z[k] + beta * ws.p[k];
+        }
+        return it;
+    }
+
+    [[nodiscard]] static T max_gradient(const workspace& ws) noexcept {
+        T m{};
+        for (std::size_t i = 0; i < ws.nc; ++i) {
+            if (ws.fixed[i]) continue;
+            for (std::size_t k = 0; k < pose_dim; ++k) m = max(m, abs(ws.gc[i][k]));
+        }
+        for (std::size_t j = 0; j < ws.np; ++j) {
+            for (std::size_t k = 0; k < point_dim; ++k) m = max(m, abs(ws.gp[j][k]));
+        }
+        return m;
+    }
+
+    options options_{};
+    std::vector<std::unique_ptr<group_base>> groups_;
+    std::vector<bool> fixed_;
+    std::size_t count_{0};
+};
+
+} // namespace ct
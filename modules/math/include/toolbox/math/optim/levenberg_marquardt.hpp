@@ -0,0 +1,364 @@
+#pragma once
+
+#include "./loss.hpp"
+#include "./manifold.hpp"
+#include "../autodiff/jet.hpp"
+#include "../mat/base.hpp"
+#include "../mat/solve.hpp"
+#include "../vec/base.hpp"
+#include "../detail/arithmetic.hpp"
+#include "../common/functions.hpp"
+
+#include "toolbox/base/errors/result.hpp"
+#include "toolbox/base/thread/thread_pool.hpp"
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//NOTE: Levenberg-Marquardt over one parameter block P (vec<N>, so3, se3, see manifold.hpp) and
+// any number of residual blocks with compile-time size R. A residual functor is evaluated on jets,
+// so Jacobians come from autodiff and never have to be written by hand:
+//
+//   struct reprojection {
+//       vec3d p; vec2d uv;
+//       template<class S>
+//       bool operator()(const se3<S>& pose, std::array<S, 2>& r) const { ... }
+//   };
+//   levenberg_marquardt<se3d> lm;
+//   for (...) lm.add_residual<2>(reprojection{p, uv}, huber_loss<double>{2.0});
+//   auto summary = lm.solve(pose);
+//
+// Blocks are grouped by (functor, loss, R) so the inner loops are monomorphic. Robust losses are
+// applied by iteratively reweighted least squares. Normal equations go into one accumulator per
+// thread and are reduced afterwards, so the parallel linearization takes no locks.
+
+namespace ct {
+
+enum class lm_termination {
+    gradient_tolerance,
+    step_tolerance,
+    cost_tolerance,
+    max_iterations,
+    no_progress,
+};
+
+template<manifold_type P>
+class levenberg_marquardt {
+public:
+    using traits = manifold<P>;
+    using value_type = typename traits::scalar_type;
+    static constexpr std::size_t dim = traits::dim;
+    using jet_type = jet<value_type, dim>;
+
+    static_assert(std::same_as<typename traits::template rebind<value_type>, P>);
+
+    struct options {
+        u32 max_iterations{50};
+        value_type initial_lambda{value_type(1e-4)};
+        value_type gradient_tolerance{value_type(1e-10)};
+        value_type step_tolerance{value_type(1e-10)};
+        value_type cost_tolerance{value_type(1e-12)};   // relative
+        ThreadPool* pool{nullptr};                      // nullptr runs on the calling thread
+        std::size_t grain{64};                          // residual blocks per parallel chunk
+    };
+
+    struct summary {
+        u32 iterations{0};
+        value_type initial_cost{};
+        value_type final_cost{};
+        lm_termination termination{lm_termination::max_iterations};
+        bool converged{false};
+    };
+
+    levenberg_marquardt() = default;
+    explicit levenberg_marquardt(const options& opts) : options_(opts) {}
+
+    //NOTE: f(x, r) with x the parameter rebound to the evaluation scalar, returns false when the
+    // residual is undefined at x (point behind the camera, ...)
+    template<std::size_t R, typename F, typename L = trivial_loss<value_type>>
+    requires (R > 0)
+    void add_residual(F f, L loss = {}) {
+        using group_type = residual_group<R, F, L>;
+        for (const std::unique_ptr<group_base>& g : groups_) {
+            if (auto* typed = dynamic_cast<group_type*>(g.get())) {
+                typed->blocks.emplace_back(std::move(f), std::move(loss));
+                ++count_;
+                return;
+            }
+        }
+        auto group = std::make_unique<group_type>();
+        group->blocks.emplace_back(std::move(f), std::move(loss));
+        groups_.push_back(std::move(group));
+        ++count_;
+    }
+
+    [[nodiscard]] std::size_t residual_count() const noexcept { return count_; }
+
+    //NOTE: Drops the residual blocks but keeps the groups and their capacity, so a solver refilled
+    // for every problem stops allocating once it has seen the largest one
+    void clear() noexcept {
+        for (const std::unique_ptr<group_base>& g : groups_) g->clear();
+        count_ = 0;
+    }
+
+    [[nodiscard]] options& settings() noexcept { return options_; }
+    [[nodiscard]] const options& settings() const noexcept { return options_; }
+
+    //NOTE: Refines x in place. x is only written with accepted steps, it is left untouched on error.
+    // The per-thread accumulators are members reused across calls, which is why solve() is not const.
+    [[nodiscard]] result<summary> solve(P& x) {
+        if (count_ == 0) {
+            return err(ErrorCode::INVALID_ARGUMENT, "Least-squares problem has no residuals");
+        }
+
+        const u32 lanes = options_.pool ? options_.pool->GetConcurrency() : 1u;
+        std::vector<normal_equations>& partial = partial_;
+        partial.resize(lanes);
+
+        normal_equations system{};
+        if (!linearize(x, partial, system)) {
+            return err(ErrorCode::MATH_NON_FINITE, "Residual evaluation failed at the initial estimate");
+        }
+
+        summary s{};
+        s.initial_cost = system.cost;
+        s.final_cost = system.cost;
+
+        value_type lambda = options_.initial_lambda;
+        value_type nu{2};
+
+        while (true) {
+            if (max_abs(system.g) <= options_.gradient_tolerance) {
+                s.termination = lm_termination::gradient_tolerance;
+                s.converged = true;
+                break;
+            }
+            if (s.iterations >= options_.max_iterations) {
+                s.termination = lm_termination::max_iterations;
+                break;
+            }
+            if (lambda > lambda_max) {
+                s.termination = lm_termination::no_progress;
+                break;
+            }
+            ++s.iterations;
+
+            // Marquardt scaling, clamped so unobserved directions still get damped
+            mat<dim, dim, value_type> damped = system.h;
+            vec<dim, value_type> diag{};
+            for (std::size_t i = 0; i < dim; ++i) {
+                diag[i] = lambda * clamp(system.h(i, i), diagonal_min, diagonal_max);
+                damped(i, i) += diag[i];
+            }
+
+            auto factor = cholesky(damped);
+            if (!factor) {
+                lambda *= nu;
+                nu *= value_type{2};
+                continue;
+            }
+            const vec<dim, value_type> delta = factor->solve(-system.g);
+
+            value_type step2{};
+            value_type predicted{};
+            for (std::size_t i = 0; i < dim; ++i) {
+                step2 += delta[i] * delta[i];
+                predicted += delta[i] * (diag[i] * delta[i] - system.g[i]);
+            }
+            predicted *= value_type{0.5};
+
+            if (sqrt(step2) <= options_.step_tolerance) {
+                s.termination = lm_termination::step_tolerance;
+                s.converged = true;
+                break;
+            }
+
+            const P candidate = traits::plus(x, delta);
+            const value_type cost = evaluate(candidate, partial);
+            const value_type actual = system.cost - cost;
+            const value_type gain = predicted > value_type{} ? actual / predicted : value_type{-1};
+
+            if (std::isfinite(cost) && gain > value_type{}) {
+                normal_equations next{};
+                if (!linearize(candidate, partial, next)) {
+                    lambda *= nu;
+                    nu *= value_type{2};
+                    continue;
+                }
+                x = candidate;
+                system = next;
+                s.final_cost = system.cost;
+
+                // Nielsen update, shrink lambda smoothly with the quality of the quadratic model
+                const value_type t = value_type{2} * gain - value_type{1};
+                lambda *= max(value_type{1} / value_type{3}, value_type{1} - t * t * t);
+                nu = value_type{2};
+
+                if (abs(actual) <= options_.cost_tolerance * system.cost) {
+                    s.termination = lm_termination::cost_tolerance;
+                    s.converged = true;
+                    break;
+                }
+            } else {
+                lambda *= nu;
+                nu *= value_type{2};
+            }
+        }
+
+        return s;
+    }
+
+private:
+    static constexpr value_type diagonal_min = value_type(1e-6);
+    static constexpr value_type diagonal_max = value_type(1e32);
+    static constexpr value_type lambda_max = value_type(1e32);
+
+    //NOTE: 1/2 sum rho(|r|^2) and the IRLS normal equations H = sum w J^T J, g = sum w J^T r.
+    // Only the lower triangle of h is accumulated, cholesky() does not read the rest.
+    struct normal_equations {
+        mat<dim, dim, value_type> h{};
+        vec<dim, value_type> g{};
+        value_type cost{};
+        bool valid{true};
+
+        void reset() noexcept { *this = normal_equations{}; }
+
+        void merge(const normal_equations& o) noexcept {
+            for (std::size_t j = 0; j < dim; ++j) {
+                for (std::size_t i = j; i < dim; ++i) h(i, j) += o.h(i, j);
+                g[j] += o.g[j];
+            }
+            cost += o.cost;
+            valid = valid && o.valid;
+        }
+    };
+
+    using jet_param = typename traits::template rebind<jet_type>;
+
+    struct group_base {
+        virtual ~group_base() = default;
+        [[nodiscard]] virtual std::size_t size() const noexcept = 0;
+        virtual void clear() noexcept = 0;
+        virtual void linearize(const jet_param& x, std::size_t begin, std::size_t end, normal_equations& acc) const = 0;
+        virtual void evaluate(const P& x, std::size_t begin, std::size_t end, normal_equations& acc) const = 0;
+    };
+
+    template<std::size_t R, typename F, typename L>
+    struct residual_group final : group_base {
+        std::vector<std::pair<F, L>> blocks;
+
+        [[nodiscard]] std::size_t size() const noexcept override { return blocks.size(); }
+        void clear() noexcept override { blocks.clear(); }
+
+        void linearize(const jet_param& x, std::size_t begin, std::size_t end, normal_equations& acc) const override {
+            for (std::size_t b = begin; b < end; ++b) {
+                std::array<jet_type, R> r{};
+                if (!blocks[b].first(x, r)) {
+                    acc.valid = false;
+                    return;
+                }
+
+                value_type s2{};
+                for (std::size_t i = 0; i < R; ++i) s2 += r[i].a * r[i].a;
+                const loss_eval<value_type> l = blocks[b].second(s2);
+                acc.cost += value_type{0.5} * l.rho;
+
+                for (std::size_t i = 0; i < R; ++i) {
+                    const value_type wr = l.weight * r[i].a;
+                    for (std::size_t j = 0; j < dim; ++j) {
+                        const value_type wj = l.weight * r[i].v[j];
+                        acc.g[j] += r[i].v[j] * wr;
+                        for (std::size_t k = j; k < dim; ++k) acc.h(k, j) += wj * r[i].v[k];
+                    }
+                }
+            }
+        }
+
+        void evaluate(const P& x, std::size_t begin, std::size_t end, normal_equations& acc) const override {
+            for (std::size_t b = begin; b < end; ++b) {
+                std::array<value_type, R> r{};
+                if (!blocks[b].first(x, r)) {
+                    acc.valid = false;
+                    return;
+                }
+
+                value_type s2{};
+                for (std::size_t i = 0; i < R; ++i) s2 += r[i] * r[i];
+                acc.cost += value_type{0.5} * blocks[b].second(s2).rho;
+            }
+        }
+    };
+
+    template<typename Fn>
+    void for_each_chunk(const group_base& g, std::vector<normal_equations>& partial, Fn&& fn) const {
+        if (!options_.pool) {
+            fn(std::size_t{0}, g.size(), partial[0]);
+            return;
+        }
+        options_.pool->ParallelFor(g.size(), options_.grain, [&](std::size_t begin, std::size_t end, u32 slot) {
+            fn(begin, end, partial[slot]);
+        });
+    }
+
+    //NOTE: The parameter is lifted onto jets once with every tangent direction seeded, all blocks
+    // then share it read-only instead of each one redoing the retraction
+    bool linearize(const P& x, std::vector<normal_equations>& partial, normal_equations& out) const {
+        vec<dim, jet_type> seed{};
+        for (std::size_t k = 0; k < dim; ++k) seed[k] = jet_type::variable(value_type{}, k);
+        const jet_param xj = traits::plus(x, seed);
+
+        for (normal_equations& p : partial) p.reset();
+        for (const std::unique_ptr<group_base>& g : groups_) {
+            for_each_chunk(*g, partial, [&](std::size_t begin, std::size_t end, normal_equations& acc) {
+                g->linearize(xj, begin, end, acc);
+            });
+        }
+
+        out.reset();
+        for (const normal_equations& p : partial) out.merge(p);
+        if (!out.valid || !std::isfinite(out.cost)) return false;
+
+        for (std::size_t j = 0; j < dim; ++j) {
+            if (!std::isfinite(out.g[j])) return false;
+            for (std::size_t i = j + 1; i < dim; ++i) out.h(j, i) = out.h(i, j);
+        }
+        return true;
+    }
+
+    //NOTE: Cost only, failures and non-finite values come back as +inf so the step is rejected
+    value_type evaluate(const P& x, std::vector<normal_equations>& partial) const {
+        for (normal_equations& p : partial) p.reset();
+        for (const std::unique_ptr<group_base>& g : groups_) {
+            for_each_chunk(*g, partial, [&](std::size_t begin, std::size_t end, normal_equations& acc) {
+                g->evaluate(x, begin, end, acc);
+            });
+        }
+
+        value_type cost{};
+        for (const normal_equations& p : partial) {
+            if (!p.valid) return std::numeric_limits<value_type>::infinity();
+            cost += p.cost;
+        }
+        return std::isfinite(cost) ? cost : std::numeric_limits<value_type>::infinity();
+    }
+
+    [[nodiscard]] static value_type max_abs(const vec<dim, value_type>& v) noexcept {
+        value_type m{};
+        for (std::size_t i = 0; i < dim; ++i) m = max(m, abs(v[i]));
+        return m;
+    }
+
+    options options_{};
+    std::vector<std::unique_ptr<group_base>> groups_;
+    std::size_t count_{0};
+    std::vector<normal_equations> partial_;
+};
+
+} // namespace ct
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../detail/arithmetic.hpp"
+#include "../common/functions.hpp"
+
+#include <cmath>
+
+//NOTE: Robust losses on the squared residual norm s = |r|^2, Ceres convention. The solver uses
+// rho(s) for the cost and rho'(s) as the iteratively reweighted least squares weight.
+
+namespace ct {
+
+template<floating_point T>
+struct loss_eval {
+    T rho{};
+    T weight{};     // rho'(s)
+};
+
+template<floating_point T = double>
+struct trivial_loss {
+    [[nodiscard]] constexpr loss_eval<T> operator()(T s) const noexcept {
+        return {s, T{1}};
+    }
+};
+
+//NOTE: Quadratic up to |r| = delta, linear beyond
+template<floating_point T = double>
+struct huber_loss {
+    T delta{T{1}};
+
+    [[nodiscard]] loss_eval<T> operator()(T s) const noexcept {
+        const T d2 = delta * delta;
+        if (s <= d2) return {s, T{1}};
+        const T r = sqrt(s);
+        return {T{2} * delta * r - d2, delta / r};
+    }
+};
+
+//NOTE: rho = c^2 log(1 + s / c^2), down-weights outliers more aggressively than Huber
+template<floating_point T = double>
+struct cauchy_loss {
+    T scale{T{1}};
+
+    [[nodiscard]] loss_eval<T> operator()(T s) const noexcept {
+        const T c2 = scale * scale;
+        const T x = T{1} + s / c2;
+        return {c2 * std::log(x), T{1} / x};
+    }
+};
+
+} // namespace ct
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "../detail/arithmetic.hpp"
+#include "../vec/base.hpp"
+#include "../vec/vec2.hpp"     // IWYU pragma: keep
+#include "../vec/vec3.hpp"     // IWYU pragma: keep
+#include "../vec/vec4.hpp"     // IWYU pragma: keep
+#include "../lie/so3.hpp"
+#include "../lie/se3.hpp"
+
+#include <cstddef>
+
+//NOTE: Parameter types the optimizers can work on. A specialization provides the tangent
+// dimension, the same type with another scalar (rebind, used to evaluate residuals on jets)
+// and plus(x, delta), the retraction that maps a tangent step back onto the parameter.
+
+namespace ct {
+
+template<typename P>
+struct manifold;
+
+template<std::size_t N, floating_point T>
+struct manifold<vec<N, T>> {
+    using scalar_type = T;
+    static constexpr std::size_t dim = N;
+
+    template<floating_point S>
+    using rebind = vec<N, S>;
+
+    template<floating_point S>
+    [[nodiscard]] static constexpr vec<N, S> plus(const vec<N, T>& x, const vec<N, S>& delta) noexcept {
+        vec<N, S> r{};
+        for (std::size_t i = 0; i < N; ++i) r[i] = S(x[i]) + delta[i];
+        return r;
+    }
+};
+
+//NOTE: Left perturbation R' = exp(delta) * R, matches so3::left_jacobian
+template<floating_point T>
+struct manifold<so3<T>> {
+    using scalar_type = T;
+    static constexpr std::size_t dim = 3;
+
+    template<floating_point S>
+    using rebind = so3<S>;
+
+    template<floating_point S>
+    [[nodiscard]] static so3<S> plus(const so3<T>& x, const vec<3, S>& delta) noexcept {
+        return so3<S>::exp(delta) * lift<S>(x);
+    }
+
+    template<floating_point S>
+    [[nodiscard]] static constexpr so3<S> lift(const so3<T>& x) noexcept {
+        const quat<T>& q = x.quaternion();
+        return so3<S>::from_unit(quat<S>(S(q.x), S(q.y), S(q.z), S(q.w)));
+    }
+};
+
+//NOTE: Left perturbation T' = exp(delta) * T with delta = (rho, phi), matches se3::point_jacobian
+template<floating_point T>
+struct manifold<se3<T>> {
+    using scalar_type = T;
+    static constexpr std::size_t dim = 6;
+
+    template<floating_point S>
+    using rebind = se3<S>;
+
+    template<floating_point S>
+    [[nodiscard]] static se3<S> plus(const se3<T>& x, const vec<6, S>& delta) noexcept {
+        return se3<S>::exp(delta) * lift<S>(x);
+    }
+
+    template<floating_point S>
+    [[nodiscard]] static constexpr se3<S> lift(const se3<T>& x) noexcept {
+        const vec<3, T>& t = x.translation();
+        return se3<S>(manifold<so3<T>>::template lift<S>(x.rotation()), vec<3, S>(S(t.x), S(t.y), S(t.z)));
+    }
+};
+
+template<typename P>
+concept manifold_type = requires {
+    typename manifold<P>::scalar_type;
+    { manifold<P>::dim } -> std::convertible_to<std::size_t>;
+};
+
+} // namespace ct
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "./vec_soa.hpp"
+#include "../detail/arithmetic.hpp"
+#include "../detail/simd.hpp"
+#include "../detail/dispatch.hpp"
+#include "../common/functions.hpp"
+#include "../vec/vec3.hpp"
+#include "../mat/mat3.hpp"      // IWYU pragma: keep
+#include "../mat/mat4.hpp"      // IWYU pragma: keep
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <span>
+
+//NOTE: Batched kernels over SoA point sets. The inner loops are plain unit-stride element loops
+// over restrict pointers with every coefficient hoisted into registers, so the compiler
+// vectorizes them. transform and project run through detail::dispatch, so the same loops are
+// also built for AVX2 and AVX-512 and picked at runtime. `out` may be the same container as `in`,
+// that case takes the in-place kernel.
+
+namespace ct {
+
+namespace detail {
+
+template<arithmetic T>
+struct affine3 {
+    T m00, m01, m02, m03;
+    T m10, m11, m12, m13;
+    T m20, m21, m22, m23;
+};
+
+template<arithmetic T>
+TOOLBOX_FORCE_INLINE void transform_body(const affine3<T>& m, const T* CT_MATH_RESTRICT xs,
+                                         const T* CT_MATH_RESTRICT ys, const T* CT_MATH_RESTRICT zs,
+                                         T* CT_MATH_RESTRICT ox, T* CT_MATH_RESTRICT oy, T* CT_MATH_RESTRICT oz,
+                                         std::size_t n) noexcept {
+    const affine3<T> a = m;
+    for (std::size_t i = 0; i < n; ++i) {
+        const T x = xs[i], y = ys[i], z = zs[i];
+        ox[i] = a.m00 * x + a.m01 * y + a.m02 * z + a.m03;
+        oy[i] = a.m10 * x + a.m11 * y + a.m12 * z + a.m13;
+        oz[i] = a.m20 * x + a.m21 * y + a.m22 * z + a.m23;
+    }
+}
+
+template<arithmetic T>
+TOOLBOX_FORCE_INLINE void transform_inplace_body(const affine3<T>& m, T* CT_MATH_RESTRICT xs, T* CT_MATH_RESTRICT ys,
+                                                 T* CT_MATH_RESTRICT zs, std::size_t n) noexcept {
+    const affine3<T> a = m;
+    for (std::size_t i = 0; i < n; ++i) {
+        const T x = xs[i], y = ys[i], z = zs[i];
+        xs[i] = a.m00 * x + a.m01 * y + a.m02 * z + a.m03;
+        ys[i] = a.m10 * x + a.m11 * y + a.m12 * z + a.m13;
+        zs[i] = a.m20 * x + a.m21 * y + a.m22 * z + a.m23;
+    }
+}
+
+template<floating_point T>
+TOOLBOX_FORCE_INLINE void project_body(T fx, T fy, T cx, T cy, const T* CT_MATH_RESTRICT xs,
+                                       const T* CT_MATH_RESTRICT ys, const T* CT_MATH_RESTRICT zs,
+                                       T* CT_MATH_RESTRICT ou, T* CT_MATH_RESTRICT ov, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+        const T iz = T{1} / zs[i];
+        ou[i] = fx * xs[i] * iz + cx;
+        ov[i] = fy * ys[i] * iz + cy;
+    }
+}
+
+template<arithmetic T>
+void transform_kernel(const affine3<T>& m, const T* xs, const T* ys, const T* zs,
+                      T* ox, T* oy, T* oz, std::size_t n) noexcept {
+    dispatch<&transform_body<T>>(m, xs, ys, zs, ox, oy, oz, n);
+}
+
+template<arithmetic T>
+void transform_kernel(const affine3<T>& m, T* xs, T* ys, T* zs, std::size_t n) noexcept {
+    dispatch<&transform_inplace_body<T>>(m, xs, ys, zs, n);
+}
+
+template<arithmetic T>
+void transform(const affine3<T>& m, const vec3_soa<T>& in, vec3_soa<T>& out) {
+    if (&in == &out) {
+        transform_kernel(m, out.x(), out.y(), out.z(), out.size());
+        return;
+    }
+    out.resize(in.size());
+    transform_kernel(m, in.x(), in.y(), in.z(), out.x(), out.y(), out.z(), in.size());
+}
+
+} // namespace detail
+
+template<arithmetic T>
+void transform(const mat<3, 3, T>& m, const vec3_soa<T>& in, vec3_soa<T>& out) {
+    detail::transform(detail::affine3<T>{m(0, 0), m(0, 1), m(0, 2), T{0},
+                                         m(1, 0), m(1, 1), m(1, 2), T{0},
+                                         m(2, 0), m(2, 1), m(2, 2), T{0}},
+                      in, out);
+}
+
+//NOTE: Rigid transform p' = R * p + t
+template<arithmetic T>
+void transform(const mat<3, 3, T>& r, const vec<3, T>& t, const vec3_soa<T>& in, vec3_soa<T>& out) {
+    detail::transform(detail::affine3<T>{r(0, 0), r(0, 1), r(0, 2), t[0],
+                                         r(1, 0), r(1, 1), r(1, 2), t[1],
+                                         r(2, 0), r(2, 1), r(2, 2), t[2]},
+                      in, out);
+}
+
+//NOTE: Affine point transform, points are treated as (x, y, z, 1) and the last row is ignored
+template<arithmetic T>
+void transform(const mat<4, 4, T>& m, const vec3_soa<T>& in, vec3_soa<T>& out) {
+    detail::transform(detail::affine3<T>{m(0, 0), m(0, 1), m(0, 2), m(0, 3),
+                                         m(1, 0), m(1, 1), m(1, 2), m(1, 3),
+                                         m(2, 0), m(2, 1), m(2, 2), m(2, 3)},
+                      in, out);
+}
+
+//NOTE: Pinhole projection u = fx * x / z + cx, v = fy * y / z + cy. Points with z == 0 are
+// not filtered, callers are expected to reject them from the depth values.
+template<floating_point T>
+void project(T fx, T fy, T cx, T cy, const vec3_soa<T>& in, vec2_soa<T>& out) {
+    out.resize(in.size());
+    detail::dispatch<&detail::project_body<T>>(fx, fy, cx, cy, in.x(), in.y(), in.z(), out.x(), out.y(), in.size());
+}
+
+//NOTE: Branch-free, the smallest normal bias keeps zero vectors at zero without a select
+template<floating_point T>
+void normalize(vec3_soa<T>& v) noexcept {
+    T* CT_MATH_RESTRICT xs = v.x();
+    T* CT_MATH_RESTRICT ys = v.y();
+    T* CT_MATH_RESTRICT zs = v.z();
+
+    const std::size_t n = v.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        const T l2 = xs[i] * xs[i] + ys[i] * ys[i] + zs[i] * zs[i];
+        const T s = T{1} / sqrt(l2 + std::numeric_limits<T>::min());
+        xs[i] *= s;
+        ys[i] *= s;
+        zs[i] *= s;
+    }
+}
+
+template<arithmetic T>
+void dot(const vec3_soa<T>& a, const vec3_soa<T>& b, std::span<T> out) noexcept {
+    assert(a.size() == b.size() && out.size() >= a.size());
+    const T* ax = a.x();
+    const T* ay = a.y();
+    const T* az = a.z();
+    const T* bx = b.x();
+    const T* by = b.y();
+    const T* bz = b.z();
+    T* CT_MATH_RESTRICT o = out.data();
+
+    const std::size_t n = a.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        o[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i];
+    }
+}
+
+template<arithmetic T>
+void cross(const vec3_soa<T>& a, const vec3_soa<T>& b, vec3_soa<T>& out) {
+    assert(a.size() == b.size());
+    assert(&out != &a && &out != &b);
+    out.resize(a.size());
+    const T* ax = a.x();
+    const T* ay = a.y();
+    const T* az = a.z();
+    const T* bx = b.x();
+    const T* by = b.y();
+    const T* bz = b.z();
+    T* CT_MATH_RESTRICT ox = out.x();
+    T* CT_MATH_RESTRICT oy = out.y();
+    T* CT_MATH_RESTRICT oz = out.z();
+
+    const std::size_t n = a.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        ox[i] = ay[i] * bz[i] - az[i] * by[i];
+        oy[i] = az[i] * bx[i] - ax[i] * bz[i];
+        oz[i] = ax[i] * by[i] - ay[i] * bx[i];
+    }
+}
+
+} // namespace ct
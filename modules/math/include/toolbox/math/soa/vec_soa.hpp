@@ -0,0 +1,126 @@
+#pragma once
+
+#include "../detail/arithmetic.hpp"
+#include "../detail/aligned_allocator.hpp"
+#include "../vec/vec2.hpp"
+#include "../vec/vec3.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace ct {
+
+//NOTE: Structure-of-arrays point sets. Each component lives in its own 64-byte aligned array so
+// batched kernels stream through memory with unit stride and can vectorize across points.
+template<arithmetic T>
+class vec2_soa {
+public:
+    using value_type = T;
+    using storage_type = std::vector<T, aligned_allocator<T>>;
+
+    vec2_soa() = default;
+
+    explicit vec2_soa(std::size_t n) : x_(n), y_(n) {}
+
+    explicit vec2_soa(std::span<const vec<2, T>> points) : x_(points.size()), y_(points.size()) {
+        for (std::size_t i = 0; i < points.size(); ++i) set(i, points[i]);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return x_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return x_.empty(); }
+
+    void resize(std::size_t n) { x_.resize(n); y_.resize(n); }
+    void reserve(std::size_t n) { x_.reserve(n); y_.reserve(n); }
+    void clear() noexcept { x_.clear(); y_.clear(); }
+
+    void push_back(const vec<2, T>& p) { x_.push_back(p.x); y_.push_back(p.y); }
+
+    [[nodiscard]] vec<2, T> operator[](std::size_t i) const noexcept {
+        assert(i < size());
+        return vec<2, T>(x_[i], y_[i]);
+    }
+
+    void set(std::size_t i, const vec<2, T>& p) noexcept {
+        assert(i < size());
+        x_[i] = p.x;
+        y_[i] = p.y;
+    }
+
+    [[nodiscard]] T* x() noexcept { return x_.data(); }
+    [[nodiscard]] T* y() noexcept { return y_.data(); }
+    [[nodiscard]] const T* x() const noexcept { return x_.data(); }
+    [[nodiscard]] const T* y() const noexcept { return y_.data(); }
+
+    [[nodiscard]] std::vector<vec<2, T>> to_aos() const {
+        std::vector<vec<2, T>> out(size());
+        for (std::size_t i = 0; i < size(); ++i) out[i] = (*this)[i];
+        return out;
+    }
+
+private:
+    storage_type x_;
+    storage_type y_;
+};
+
+template<arithmetic T>
+class vec3_soa {
+public:
+    using value_type = T;
+    using storage_type = std::vector<T, aligned_allocator<T>>;
+
+    vec3_soa() = default;
+
+    explicit vec3_soa(std::size_t n) : x_(n), y_(n), z_(n) {}
+
+    explicit vec3_soa(std::span<const vec<3, T>> points)
+        : x_(points.size()), y_(points.size()), z_(points.size()) {
+        for (std::size_t i = 0; i < points.size(); ++i) set(i, points[i]);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return x_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return x_.empty(); }
+
+    void resize(std::size_t n) { x_.resize(n); y_.resize(n); z_.resize(n); }
+    void reserve(std::size_t n) { x_.reserve(n); y_.reserve(n); z_.reserve(n); }
+    void clear() noexcept { x_.clear(); y_.clear(); z_.clear(); }
+
+    void push_back(const vec<3, T>& p) {
+        x_.push_back(p.x);
+        y_.push_back(p.y);
+        z_.push_back(p.z);
+    }
+
+    [[nodiscard]] vec<3, T> operator[](std::size_t i) const noexcept {
+        assert(i < size());
+        return vec<3, T>(x_[i], y_[i], z_[i]);
+    }
+
+    void set(std::size_t i, const vec<3, T>& p) noexcept {
+        assert(i < size());
+        x_[i] = p.x;
+        y_[i] = p.y;
+        z_[i] = p.z;
+    }
+
+    [[nodiscard]] T* x() noexcept { return x_.data(); }
+    [[nodiscard]] T* y() noexcept { return y_.data(); }
+    [[nodiscard]] T* z() noexcept { return z_.data(); }
+    [[nodiscard]] const T* x() const noexcept { return x_.data(); }
+    [[nodiscard]] const T* y() const noexcept { return y_.data(); }
+    [[nodiscard]] const T* z() const noexcept { return z_.data(); }
+
+    [[nodiscard]] std::vector<vec<3, T>> to_aos() const {
+        std::vector<vec<3, T>> out(size());
+        for (std::size_t i = 0; i < size(); ++i) out[i] = (*this)[i];
+        return out;
+    }
+
+private:
+    storage_type x_;
+    storage_type y_;
+    storage_type z_;
+};
+
+} // namespace ct
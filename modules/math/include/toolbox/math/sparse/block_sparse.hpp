@@ -0,0 +1,118 @@
+#pragma once
+
+#include "../mat/base.hpp"
+#include "../detail/arithmetic.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+//NOTE: Block compressed sparse row matrix with compile-time block size BR x BC. The sparsity
+// pattern is fixed at construction, afterwards only block values change, so the normal equations
+// of an iterative solver are refilled in place without allocating. Blocks of one block row are
+// contiguous and sorted by block column.
+
+namespace ct {
+
+template<std::size_t BR, std::size_t BC, floating_point T>
+class block_sparse {
+public:
+    using value_type = T;
+    using block_type = mat<BR, BC, T>;
+    static constexpr std::size_t block_rows = BR;
+    static constexpr std::size_t block_cols = BC;
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    block_sparse() = default;
+
+    //NOTE: entries are (block row, block column) pairs in any order, duplicates are merged
+    block_sparse(std::size_t rows, std::size_t cols, std::vector<std::pair<std::size_t, std::size_t>> entries)
+        : rows_(rows), cols_(cols) {
+        std::sort(entries.begin(), entries.end());
+        entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+        row_offsets_.assign(rows + 1, 0);
+        col_indices_.reserve(entries.size());
+        for (const auto& [r, c] : entries) {
+            assert(r < rows && c < cols);
+            ++row_offsets_[r + 1];
+            col_indices_.push_back(c);
+        }
+        for (std::size_t r = 0; r < rows; ++r) row_offsets_[r + 1] += row_offsets_[r];
+        blocks_.resize(entries.size());
+    }
+
+    [[nodiscard]] std::size_t rows() const noexcept { return rows_; }
+    [[nodiscard]] std::size_t cols() const noexcept { return cols_; }
+    [[nodiscard]] std::size_t scalar_rows() const noexcept { return rows_ * BR; }
+    [[nodiscard]] std::size_t scalar_cols() const noexcept { return cols_ * BC; }
+    [[nodiscard]] std::size_t nonzero_blocks() const noexcept { return blocks_.size(); }
+
+    [[nodiscard]] std::size_t row_begin(std::size_t r) const noexcept { return row_offsets_[r]; }
+    [[nodiscard]] std::size_t row_end(std::size_t r) const noexcept { return row_offsets_[r + 1]; }
+    [[nodiscard]] std::size_t col_index(std::size_t k) const noexcept { return col_indices_[k]; }
+
+    [[nodiscard]] block_type& block(std::size_t k) noexcept { return blocks_[k]; }
+    [[nodiscard]] const block_type& block(std::size_t k) const noexcept { return blocks_[k]; }
+
+    //NOTE: Storage index of block (r, c) or npos when it is not part of the pattern, O(log nnz(row))
+    [[nodiscard]] std::size_t find(std::size_t r, std::size_t c) const noexcept {
+        const auto first = col_indices_.begin() + static_cast<std::ptrdiff_t>(row_offsets_[r]);
+        const auto last = col_indices_.begin() + static_cast<std::ptrdiff_t>(row_offsets_[r + 1]);
+        const auto it = std::lower_bound(first, last, c);
+        return it != last && *it == c ? static_cast<std::size_t>(it - col_indices_.begin()) : npos;
+    }
+
+    void set_zero() noexcept { std::fill(blocks_.begin(), blocks_.end(), block_type{}); }
+
+    //NOTE: y[rows] = A[rows] x for the block rows [begin, end), disjoint ranges can run in parallel
+    void multiply_rows(std::span<const T> x, std::span<T> y, std::size_t begin, std::size_t end) const noexcept {
+        assert(x.size() >= scalar_cols() && y.size() >= scalar_rows());
+        for (std::size_t r = begin; r < end; ++r) {
+            T acc[BR]{};
+            for (std::size_t k = row_offsets_[r]; k < row_offsets_[r + 1]; ++k) {
+                const block_type& b = blocks_[k];
+                const T* xc = x.data() + col_indices_[k] * BC;
+                for (std::size_t j = 0; j < BC; ++j) {
+                    for (std::size_t i = 0; i < BR; ++i) acc[i] += b(i, j) * xc[j];
+                }
+            }
+            for (std::size_t i = 0; i < BR; ++i) y[r * BR + i] = acc[i];
+        }
+    }
+
+    void multiply(std::span<const T> x, std::span<T> y) const noexcept {
+        multiply_rows(x, y, 0, rows_);
+    }
+
+    //NOTE: y = A^T x, scatters into y so it stays serial
+    void multiply_transpose(std::span<const T> x, std::span<T> y) const noexcept {
+        assert(x.size() >= scalar_rows() && y.size() >= scalar_cols());
+        std::fill(y.begin(), y.begin() + static_cast<std::ptrdiff_t>(scalar_cols()), T{});
+        for (std::size_t r = 0; r < rows_; ++r) {
+            const T* xr = x.data() + r * BR;
+            for (std::size_t k = row_offsets_[r]; k < row_offsets_[r + 1]; ++k) {
+                const block_type& b = blocks_[k];
+                T* yc = y.data() + col_indices_[k] * BC;
+                for (std::size_t j = 0; j < BC; ++j) {
+                    T s{};
+                    for (std::size_t i = 0; i < BR; ++i) s += b(i, j) * xr[i];
+                    yc[j] += s;
+                }
+            }
+        }
+    }
+
+private:
+    std::size_t rows_{0};
+    std::size_t cols_{0};
+    std::vector<std::size_t> row_offsets_{0};
+    std::vector<std::size_t> col_indices_;
+    std::vector<block_type> blocks_;
+};
+
+} // namespace ct
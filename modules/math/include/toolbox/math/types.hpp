@@ -3,6 +3,8 @@
 #include "vec/fwd.hpp"
 #include "mat/fwd.hpp"
 #include "quat/fwd.hpp"
+#include "lie/fwd.hpp"
+#include "soa/vec_soa.hpp"
 #include "detail/arithmetic.hpp"
 
 #include <cstdint>
@@ -50,4 +52,16 @@ using mat4d = mat4_t<double>;
 using quatf = quat<float>;
 using quatd = quat<double>;
 
+using so3f = so3<float>;
+using so3d = so3<double>;
+
+using se3f = se3<float>;
+using se3d = se3<double>;
+
+using vec2f_soa = vec2_soa<float>;
+using vec3f_soa = vec3_soa<float>;
+
+using vec2d_soa = vec2_soa<double>;
+using vec3d_soa = vec3_soa<double>;
+
 } // namespace cc
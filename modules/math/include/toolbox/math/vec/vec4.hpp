@@ -5,6 +5,7 @@
 #include "./vec3.hpp"
 #include "../detail/arithmetic.hpp"
 #include "../common/functions.hpp"
+#include "../detail/simd.hpp"
 
 #include <array>
 #include <cassert>
@@ -41,10 +42,37 @@ public:
     [[nodiscard]] constexpr T* data() noexcept { return data_.data(); }
     [[nodiscard]] constexpr const T* data() const noexcept { return data_.data(); }
 
-    constexpr vec& operator+=(const vec& o) noexcept { x += o.x; y += o.y; z += o.z; w += o.w; return *this; }
-    constexpr vec& operator-=(const vec& o) noexcept { x -= o.x; y -= o.y; z -= o.z; w -= o. w; return *this; }
-    constexpr vec& operator*=(const vec& o) noexcept { x *= o.x; y *= o.y; z *= o.z; w *= o.w; return *this; }
-    constexpr vec& operator*=(T s) noexcept { x *= s; y *= s; z *= s; w *= s; return *this; }
+    constexpr vec& operator+=(const vec& o) noexcept {
+        if constexpr (detail::simd::enabled<T>) {
+            if !consteval { detail::simd::add4(data(), o.data(), data()); return *this; }
+        }
+        for (std::size_t i = 0; i < 4; ++i) data_[i] += o.data_[i];
+        return *this;
+    }
+
+    constexpr vec& operator-=(const vec& o) noexcept {
+        if constexpr (detail::simd::enabled<T>) {
+            if !consteval { detail::simd::sub4(data(), o.data(), data()); return *this; }
+        }
+        for (std::size_t i = 0; i < 4; ++i) data_[i] -= o.data_[i];
+        return *this;
+    }
+
+    constexpr vec& operator*=(const vec& o) noexcept {
+        if constexpr (detail::simd::enabled<T>) {
+            if !consteval { detail::simd::mul4(data(), o.data(), data()); return *this; }
+        }
+        for (std::size_t i = 0; i < 4; ++i) data_[i] *= o.data_[i];
+        return *this;
+    }
+
+    constexpr vec& operator*=(T s) noexcept {
+        if constexpr (detail::simd::enabled<T>) {
+            if !consteval { detail::simd::scale4(data(), s, data()); return *this; }
+        }
+        for (std::size_t i = 0; i < 4; ++i) data_[i] *= s;
+        return *this;
+    }
 
     constexpr vec& operator/=(const vec& o) noexcept {
         assert(o.x != T{} && o.y != T{} && o.z != T{} && o.w != T{});
@@ -77,7 +105,12 @@ public:
 
     [[nodiscard]] constexpr bool operator!=(const vec& o) const noexcept { return !(*this == o); }
 
-    [[nodiscard]] constexpr T dot(const vec& o) const noexcept { return x * o.x + y * o. y + z * o.z + w * o.w; }
+    [[nodiscard]] constexpr T dot(const vec& o) const noexcept {
+        if constexpr (detail::simd::enabled<T>) {
+            if !consteval { return detail::simd::dot4(data(), o.data()); }
+        }
+        return data_[0] * o.data_[0] + data_[1] * o.data_[1] + data_[2] * o.data_[2] + data_[3] * o.data_[3];
+    }
     [[nodiscard]] constexpr T length_squared() const noexcept { return dot(*this); }
     [[nodiscard]] T length() const noexcept { return sqrt(length_squared()); }
 
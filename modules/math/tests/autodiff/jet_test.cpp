@@ -0,0 +1,82 @@
+#include "toolbox/math/math.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace ct {
+namespace {
+
+using J3 = jet<double, 3>;
+
+// NOTE: Templated on the scalar like a residual functor, so it runs on double and on jets
+template<typename T>
+T Function(const vec<3, T>& x) {
+    using std::atan2;
+    using std::exp;
+    using std::pow;
+    using std::sin;
+    return sqrt(x[0] * x[0] + T(1)) * exp(x[1] / T(3)) + ln(x[2] + T(2)) * sin(x[0]) +
+           atan2(x[1], x[2] + T(4)) + pow(x[2] + T(2), 1.5) / (x[0] + T(3));
+}
+
+vec<3, J3> Seed(const vec3d& x) {
+    vec<3, J3> r;
+    for (std::size_t k = 0; k < 3; ++k) r[k] = J3::variable(x[k], k);
+    return r;
+}
+
+TEST(Jet, GradientMatchesFiniteDifferences) {
+    const vec3d x0(0.7, -0.4, 1.3);
+    const J3 r = Function(Seed(x0));
+    EXPECT_DOUBLE_EQ(r.a, Function(x0));
+
+    constexpr double h = 1e-6;
+    for (std::size_t k = 0; k < 3; ++k) {
+        vec3d plus = x0, minus = x0;
+        plus[k] += h;
+        minus[k] -= h;
+        EXPECT_NEAR(r.v[k], (Function(plus) - Function(minus)) / (2.0 * h), 1e-8) << "variable " << k;
+    }
+}
+
+TEST(Jet, ArithmeticFollowsTheChainRule) {
+    const J3 x = J3::variable(2.0, 0);
+    const J3 y = J3::variable(3.0, 1);
+
+    const J3 product = x * y;
+    EXPECT_EQ(product.a, 6.0);
+    EXPECT_EQ(product.v[0], 3.0);
+    EXPECT_EQ(product.v[1], 2.0);
+    EXPECT_EQ(product.v[2], 0.0);
+
+    const J3 quotient = x / y;
+    EXPECT_DOUBLE_EQ(quotient.v[0], 1.0 / 3.0);
+    EXPECT_DOUBLE_EQ(quotient.v[1], -2.0 / 9.0);
+
+    EXPECT_TRUE(x < y);
+    EXPECT_EQ(std::numeric_limits<J3>::epsilon().a, std::numeric_limits<double>::epsilon());
+}
+
+// NOTE: d(exp(w) p) / dw at w = 0 is -hat(p)
+TEST(Jet, So3ExpDerivativeAtIdentity) {
+    const vec<3, J3> w = Seed(vec3d(0.0, 0.0, 0.0));
+    const vec3d p(1.0, -2.0, 0.5);
+    const vec<3, J3> q = so3<J3>::exp(w) * vec<3, J3>(J3(p.x), J3(p.y), J3(p.z));
+
+    const mat3d expected = so3d::hat(p) * -1.0;
+    for (std::size_t i = 0; i < 3; ++i) {
+        EXPECT_DOUBLE_EQ(q[i].a, p[i]);
+        for (std::size_t k = 0; k < 3; ++k) EXPECT_NEAR(q[i].v[k], expected(i, k), 1e-12) << i << ", " << k;
+    }
+}
+
+TEST(Jet, ConstantsAreScalars) {
+    EXPECT_EQ(pi<J3>.a, pi<double>);
+    for (double g : pi<J3>.v) EXPECT_EQ(g, 0.0);
+}
+
+} // namespace
+} // namespace ct
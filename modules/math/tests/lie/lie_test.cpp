@@ -0,0 +1,125 @@
+#include "toolbox/math/math.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace ct {
+namespace {
+
+template<std::size_t N>
+void ExpectNear(const vec<N, double>& a, const vec<N, double>& b, double tolerance) {
+    for (std::size_t i = 0; i < N; ++i) EXPECT_NEAR(a[i], b[i], tolerance) << "element " << i;
+}
+
+template<std::size_t R, std::size_t C>
+void ExpectNear(const mat<R, C, double>& a, const mat<R, C, double>& b, double tolerance) {
+    for (std::size_t i = 0; i < R; ++i) {
+        for (std::size_t j = 0; j < C; ++j) EXPECT_NEAR(a(i, j), b(i, j), tolerance) << i << ", " << j;
+    }
+}
+
+// NOTE: Zero, the small-angle series, a generic angle and one just short of pi
+const std::vector<vec3d> kRotations{
+    vec3d(0.0, 0.0, 0.0),
+    vec3d(1e-9, -2e-9, 5e-10),
+    vec3d(0.3, -0.2, 0.5),
+    vec3d(0.0, 3.1, 0.2).normalized() * 3.1,
+};
+
+const se3d kPose(so3d::exp(vec3d(0.1, -0.4, 0.25)), vec3d(1.0, -2.0, 0.5));
+
+TEST(So3, ExpLogRoundTrip) {
+    for (const vec3d& w : kRotations) {
+        ExpectNear(so3d::exp(w).log(), w, 1e-12);
+        const so3d r = so3d::exp(w);
+        ExpectNear(so3d::from_matrix(r.matrix()).matrix(), r.matrix(), 1e-12);
+    }
+}
+
+TEST(So3, MatrixIsRodrigues) {
+    const vec3d w(0.3, -0.2, 0.5);
+    const double theta = w.length();
+    const mat3d k = so3d::hat(w / theta);
+    const mat3d rodrigues = mat3d::identity() + k * std::sin(theta) + k * k * (1.0 - std::cos(theta));
+
+    const so3d r = so3d::exp(w);
+    ExpectNear(r.matrix(), rodrigues, 1e-12);
+
+    const vec3d v(1.0, 2.0, -3.0);
+    ExpectNear(r * v, rodrigues * v, 1e-12);
+    ExpectNear(so3d::vee(so3d::hat(v)), v, 0.0);
+}
+
+TEST(So3, JacobiansAreInverses) {
+    for (const vec3d& w : kRotations) {
+        ExpectNear(so3d::left_jacobian(w) * so3d::left_jacobian_inverse(w), mat3d::identity(), 1e-9);
+        ExpectNear(so3d::right_jacobian(w) * so3d::right_jacobian_inverse(w), mat3d::identity(), 1e-9);
+    }
+}
+
+TEST(Se3, ExpLogRoundTrip) {
+    for (const vec3d& w : kRotations) {
+        const vec<6, double> xi(0.4, -1.0, 2.0, w.x, w.y, w.z);
+        ExpectNear(se3d::exp(xi).log(), xi, 1e-9);
+    }
+    const se3d back = se3d::exp(kPose.log());
+    ExpectNear(back.matrix(), kPose.matrix(), 1e-12);
+}
+
+TEST(Se3, ComposeInverseAndAct) {
+    const se3d other(so3d::exp(vec3d(-0.3, 0.1, 0.0)), vec3d(0.0, 0.5, -1.0));
+    const vec3d p(0.5, -1.5, 4.0);
+
+    ExpectNear((kPose * other) * p, kPose * (other * p), 1e-12);
+    ExpectNear((kPose.inverse() * kPose).matrix(), mat4d::identity(), 1e-12);
+    ExpectNear(kPose * p, kPose.rotation().matrix() * p + kPose.translation(), 1e-12);
+}
+
+// NOTE: T exp(xi) T^-1 == exp(Ad_T xi)
+TEST(Se3, AdjointMovesTangentsAcrossTheGroup) {
+    const vec<6, double> xi(0.1, -0.2, 0.3, 0.05, 0.02, -0.04);
+    const se3d lhs = kPose * se3d::exp(xi) * kPose.inverse();
+    const se3d rhs = se3d::exp(kPose.adjoint() * xi);
+    ExpectNear(lhs.matrix(), rhs.matrix(), 1e-12);
+}
+
+TEST(Se3, PointJacobianMatchesFiniteDifferences) {
+    const vec3d p(0.5, -1.5, 4.0);
+    const mat<3, 6, double> j = kPose.point_jacobian(p);
+    constexpr double h = 1e-6;
+
+    for (std::size_t k = 0; k < 6; ++k) {
+        vec<6, double> step{};
+        step[k] = h;
+        const vec3d plus = se3d::exp(step) * kPose * p;
+        step[k] = -h;
+        const vec3d minus = se3d::exp(step) * kPose * p;
+        const vec3d column = (plus - minus) / (2.0 * h);
+        for (std::size_t i = 0; i < 3; ++i) EXPECT_NEAR(j(i, k), column[i], 1e-8) << i << ", " << k;
+    }
+}
+
+TEST(Se3, BatchedTransformMatchesAct) {
+    std::vector<vec3d> points;
+    for (std::size_t i = 0; i < 13; ++i) {
+        const double s = static_cast<double>(i);
+        points.emplace_back(std::sin(s), std::cos(s), 2.0 + s);
+    }
+    const se3d other(so3d::exp(vec3d(-0.3, 0.1, 0.0)), vec3d(0.0, 0.5, -1.0));
+
+    const vec3d_soa in{std::span<const vec3d>(points)};
+    vec3d_soa single, fused;
+    transform(kPose, in, single);
+    transform(kPose, other, in, fused);
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        ExpectNear(single[i], kPose * points[i], 1e-12);
+        ExpectNear(fused[i], kPose * (other * points[i]), 1e-12);
+    }
+}
+
+} // namespace
+} // namespace ct
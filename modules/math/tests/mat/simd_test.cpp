@@ -0,0 +1,100 @@
+#include "toolbox/math/math.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+
+namespace ct {
+namespace {
+
+template<typename T>
+class Simd4 : public ::testing::Test {};
+
+using Scalars = ::testing::Types<float, double>;
+TYPED_TEST_SUITE(Simd4, Scalars);
+
+// NOTE: Small integers, every product and sum is exact so the vector and scalar paths must agree
+// bit for bit
+template<typename T>
+constexpr mat<4, 4, T> kA(layout::rowm,
+                          T{1}, T{2}, T{3}, T{4},
+                          T{-5}, T{6}, T{7}, T{8},
+                          T{9}, T{-10}, T{11}, T{12},
+                          T{13}, T{14}, T{-15}, T{16});
+template<typename T>
+constexpr mat<4, 4, T> kB(layout::rowm,
+                          T{2}, T{0}, T{-1}, T{3},
+                          T{1}, T{4}, T{0}, T{-2},
+                          T{0}, T{-3}, T{5}, T{1},
+                          T{6}, T{1}, T{2}, T{0});
+template<typename T>
+constexpr vec<4, T> kV{T{1}, T{-2}, T{3}, T{4}};
+
+// NOTE: Constant evaluation takes the scalar path, the same expression at runtime the vector one
+TYPED_TEST(Simd4, RuntimeMatchesConstantEvaluation) {
+    using T = TypeParam;
+    constexpr mat<4, 4, T> product = kA<T> * kB<T>;
+    constexpr mat<4, 4, T> sum = kA<T> + kB<T>;
+    constexpr mat<4, 4, T> difference = kA<T> - kB<T>;
+    constexpr mat<4, 4, T> scaled = kA<T> * T{3};
+    constexpr vec<4, T> transformed = kA<T> * kV<T>;
+    constexpr T dot = kV<T>.dot(vec<4, T>{T{2}, T{1}, T{0}, T{-1}});
+
+    const mat<4, 4, T> a = kA<T>;
+    const mat<4, 4, T> b = kB<T>;
+    const vec<4, T> v = kV<T>;
+
+    EXPECT_EQ(a * b, product);
+    EXPECT_EQ(a + b, sum);
+    EXPECT_EQ(a - b, difference);
+    EXPECT_EQ(a * T{3}, scaled);
+    EXPECT_EQ(a * v, transformed);
+    EXPECT_EQ(v.dot(vec<4, T>{T{2}, T{1}, T{0}, T{-1}}), dot);
+}
+
+TYPED_TEST(Simd4, ProductMatchesDefinition) {
+    using T = TypeParam;
+    const mat<4, 4, T> a = kA<T>;
+    const mat<4, 4, T> b = kB<T>;
+    const mat<4, 4, T> r = a * b;
+
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < 4; ++j) {
+            T expected{};
+            for (std::size_t k = 0; k < 4; ++k) expected += a(i, k) * b(k, j);
+            EXPECT_EQ(r(i, j), expected) << i << ", " << j;
+        }
+    }
+}
+
+TYPED_TEST(Simd4, VectorArithmetic) {
+    using T = TypeParam;
+    const vec<4, T> a{T{1}, T{2}, T{3}, T{4}};
+    const vec<4, T> b{T{5}, T{-6}, T{7}, T{-8}};
+
+    EXPECT_EQ(a + b, (vec<4, T>{T{6}, T{-4}, T{10}, T{-4}}));
+    EXPECT_EQ(a - b, (vec<4, T>{T{-4}, T{8}, T{-4}, T{12}}));
+    EXPECT_EQ(a * b, (vec<4, T>{T{5}, T{-12}, T{21}, T{-32}}));
+    EXPECT_EQ(a * T{2}, (vec<4, T>{T{2}, T{4}, T{6}, T{8}}));
+    EXPECT_EQ(a.dot(b), T{-18});
+}
+
+TYPED_TEST(Simd4, InverseTimesMatrixIsIdentity) {
+    using T = TypeParam;
+    const mat<4, 4, T> a = kA<T>;
+    const mat<4, 4, T> r = a * a.inverse();
+    const mat<4, 4, T> identity = mat<4, 4, T>::identity();
+
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < 4; ++j) EXPECT_NEAR(r(i, j), identity(i, j), 1e-4) << i << ", " << j;
+    }
+}
+
+TYPED_TEST(Simd4, SingularInverseIsIdentity) {
+    using T = TypeParam;
+    const mat<4, 4, T> singular(T{1});
+    EXPECT_EQ(singular.inverse(), (mat<4, 4, T>::identity()));
+}
+
+} // namespace
+} // namespace ct
@@ -0,0 +1,136 @@
+#include "toolbox/math/math.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+
+namespace ct {
+namespace {
+
+template<std::size_t R, std::size_t C>
+mat<R, C, double> MakeMatrix(double seed) {
+    mat<R, C, double> m{};
+    for (std::size_t i = 0; i < R; ++i) {
+        for (std::size_t j = 0; j < C; ++j) {
+            const double x = static_cast<double>(i), y = static_cast<double>(j);
+            m(i, j) = std::sin(seed + 1.3 * x + 0.7 * y * y + 0.4 * x * y);
+        }
+    }
+    return m;
+}
+
+// NOTE: A^T A + I, symmetric positive definite
+mat<4, 4, double> MakeSpd() {
+    const mat<4, 4, double> m = MakeMatrix<4, 4>(0.5);
+    mat<4, 4, double> a = mat<4, 4, double>::identity();
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < 4; ++j) {
+            for (std::size_t k = 0; k < 4; ++k) a(i, j) += m(k, i) * m(k, j);
+        }
+    }
+    return a;
+}
+
+const vec<4, double> kB{1.0, -2.0, 0.5, 3.0};
+
+template<std::size_t N>
+double Residual(const mat<N, N, double>& a, const vec<N, double>& x, const vec<N, double>& b) {
+    const vec<N, double> r = a * x - b;
+    return std::sqrt(r.dot(r));
+}
+
+// NOTE: The success paths are constexpr
+static_assert([] {
+    const auto x = solve(mat<2, 2, double>(layout::rowm, 0.0, 2.0, 4.0, 0.0), vec<2, double>{2.0, 8.0});
+    return x && (*x)[0] == 2.0 && (*x)[1] == 1.0;
+}());
+
+TEST(Solve, CholeskyReconstructsAndSolves) {
+    const mat<4, 4, double> a = MakeSpd();
+    const auto llt = cholesky(a);
+    ASSERT_TRUE(llt);
+
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < 4; ++j) {
+            double product = 0.0;
+            for (std::size_t k = 0; k < 4; ++k) product += llt->l(i, k) * llt->l(j, k);
+            EXPECT_NEAR(product, a(i, j), 1e-12) << i << ", " << j;
+        }
+    }
+    EXPECT_LT(Residual(a, llt->solve(kB), kB), 1e-12);
+    EXPECT_NEAR(llt->det(), a.det(), 1e-10);
+}
+
+TEST(Solve, CholeskyRejectsIndefinite) {
+    const mat<3, 3, double> a(layout::rowm,
+                              2.0, 1.0, 0.0,
+                              1.0, -3.0, 1.0,
+                              0.0, 1.0, 4.0);
+    const auto llt = cholesky(a);
+    ASSERT_FALSE(llt);
+    EXPECT_EQ(llt.error().Code(), ErrorCode::MATH_NOT_POSITIVE_DEFINITE);
+}
+
+TEST(Solve, LdltSolvesIndefinite) {
+    const mat<3, 3, double> a(layout::rowm,
+                              2.0, 1.0, 0.0,
+                              1.0, -3.0, 1.0,
+                              0.0, 1.0, 4.0);
+    const vec<3, double> b{1.0, 2.0, 3.0};
+    const auto f = ldlt(a);
+    ASSERT_TRUE(f);
+
+    EXPECT_LT(Residual(a, f->solve(b), b), 1e-12);
+    EXPECT_NEAR(f->det(), a.det(), 1e-12);
+}
+
+// NOTE: No pivoting, a zero leading pivot fails even though the matrix is invertible
+TEST(Solve, LdltFailsOnZeroLeadingPivot) {
+    const auto f = ldlt(mat<2, 2, double>(layout::rowm, 0.0, 1.0, 1.0, 0.0));
+    ASSERT_FALSE(f);
+    EXPECT_EQ(f.error().Code(), ErrorCode::MATH_RANK_DEFICIENT);
+}
+
+TEST(Solve, QrSolvesLeastSquares) {
+    const mat<6, 3, double> a = MakeMatrix<6, 3>(0.2);
+    const vec<6, double> b{1.0, 0.0, -1.0, 2.0, 0.5, -0.5};
+    const auto f = qr(a);
+    ASSERT_TRUE(f);
+
+    // NOTE: The least squares residual is orthogonal to the columns of A
+    const vec<3, double> x = f->solve(b);
+    const vec<3, double> normal = a.transpose() * (a * x - b);
+    EXPECT_LT(std::sqrt(normal.dot(normal)), 1e-12);
+
+    const vec<3, double> exact{0.5, -1.0, 2.0};
+    const vec<3, double> recovered = f->solve(a * exact);
+    for (std::size_t i = 0; i < 3; ++i) EXPECT_NEAR(recovered[i], exact[i], 1e-12);
+}
+
+TEST(Solve, QrRejectsRankDeficient) {
+    mat<4, 2, double> a = MakeMatrix<4, 2>(0.1);
+    for (std::size_t i = 0; i < 4; ++i) a(i, 1) = 2.0 * a(i, 0);
+    const auto f = qr(a);
+    ASSERT_FALSE(f);
+    EXPECT_EQ(f.error().Code(), ErrorCode::MATH_RANK_DEFICIENT);
+}
+
+TEST(Solve, LuPivotsAndSolves) {
+    mat<4, 4, double> a = MakeMatrix<4, 4>(1.1);
+    a(0, 0) = 0.0;
+    const auto x = solve(a, kB);
+    ASSERT_TRUE(x);
+    EXPECT_LT(Residual(a, *x, kB), 1e-12);
+}
+
+TEST(Solve, LuRejectsSingular) {
+    mat<3, 3, double> a = MakeMatrix<3, 3>(0.3);
+    for (std::size_t j = 0; j < 3; ++j) a(2, j) = a(0, j) + a(1, j);
+    const auto x = solve(a, vec<3, double>{1.0, 2.0, 3.0});
+    ASSERT_FALSE(x);
+    EXPECT_EQ(x.error().Code(), ErrorCode::MATH_SINGULAR_MATRIX);
+}
+
+} // namespace
+} // namespace ct
@@ -0,0 +1,114 @@
+#include "toolbox/math/math.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace ct {
+namespace {
+
+mat3d Diagonal(const vec3d& s) {
+    return mat3d(layout::rowm,
+                 s[0], 0.0, 0.0,
+                 0.0, s[1], 0.0,
+                 0.0, 0.0, s[2]);
+}
+
+void ExpectNear(const mat3d& a, const mat3d& b, double tolerance) {
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) EXPECT_NEAR(a(i, j), b(i, j), tolerance) << i << ", " << j;
+    }
+}
+
+void ExpectRotation(const mat3d& r) {
+    ExpectNear(r.transpose() * r, mat3d::identity(), 1e-12);
+    EXPECT_NEAR(r.det(), 1.0, 1e-12);
+}
+
+// NOTE: Generic, rank 2 like an essential matrix, rank 1, negative determinant, repeated values
+std::vector<mat3d> Inputs() {
+    return {
+        mat3d(layout::rowm, 0.8, -0.3, 1.2, 0.1, 2.0, -0.7, -1.1, 0.4, 0.6),
+        mat3d(layout::rowm, 0.0, -0.5, 0.2, 0.5, 0.0, -1.0, -0.2, 1.0, 0.0),
+        mat3d(layout::rowm, 1.0, 2.0, 3.0, 2.0, 4.0, 6.0, -1.0, -2.0, -3.0),
+        mat3d(layout::rowm, 0.0, 1.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0),
+        mat3d(layout::rowm, 2.0, 0.0, 0.0, 0.0, 2.0, 0.0, 0.0, 0.0, 2.0),
+    };
+}
+
+TEST(Mat3, TransposeSwapsIndices) {
+    const mat3d a = Inputs()[0];
+    const mat3d t = a.transpose();
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) EXPECT_EQ(t(i, j), a(j, i));
+    }
+
+    mat4d b = mat4d::identity();
+    b(0, 3) = 5.0;
+    EXPECT_EQ(b.transpose()(3, 0), 5.0);
+    EXPECT_EQ(b.transpose()(0, 3), 0.0);
+}
+
+TEST(Svd, ReconstructsWithProperRotations) {
+    for (const mat3d& a : Inputs()) {
+        const svd3_result<double> d = svd(a);
+
+        ExpectNear(d.u * Diagonal(d.s) * d.v.transpose(), a, 1e-12);
+        ExpectRotation(d.u);
+        ExpectRotation(d.v);
+
+        EXPECT_GE(d.s[0], d.s[1] - 1e-12);
+        EXPECT_GE(d.s[1], std::abs(d.s[2]) - 1e-12);
+        EXPECT_NEAR(d.s[0] * d.s[1] * d.s[2], a.det(), 1e-12);
+    }
+}
+
+TEST(Svd, EssentialMatrixHasTwoEqualValues) {
+    const svd3_result<double> d = svd(Inputs()[1]);
+    EXPECT_NEAR(d.s[0], d.s[1], 1e-12);
+    EXPECT_NEAR(d.s[2], 0.0, 1e-12);
+}
+
+TEST(Svd, EigenSymmetricSolvesSv) {
+    for (const mat3d& a : Inputs()) {
+        const mat3d s = a.transpose() * a;
+        const eigen3_result<double> e = eigen_symmetric(s);
+
+        ExpectRotation(e.vectors);
+        EXPECT_GE(e.values[0], e.values[1] - 1e-12);
+        EXPECT_GE(e.values[1], e.values[2] - 1e-12);
+        ExpectNear(s * e.vectors, e.vectors * Diagonal(e.values), 1e-12);
+    }
+}
+
+TEST(Svd, OrthonormalizeRecoversRotation) {
+    const mat3d r(layout::rowm,
+                  0.36, 0.48, -0.8,
+                  -0.8, 0.6, 0.0,
+                  0.48, 0.64, 0.6);
+    mat3d drifted = r;
+    drifted(0, 1) += 1e-4;
+    drifted(2, 0) -= 2e-4;
+
+    const mat3d fixed = orthonormalize(drifted);
+    ExpectRotation(fixed);
+    ExpectNear(fixed, r, 1e-3);
+    ExpectNear(orthonormalize(r), r, 1e-12);
+}
+
+TEST(Svd, BatchedMatchesSingle) {
+    const std::vector<mat3d> inputs = Inputs();
+    std::vector<svd3_result<double>> out(inputs.size());
+    svd(std::span<const mat3d>(inputs), std::span<svd3_result<double>>(out));
+
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        const svd3_result<double> d = svd(inputs[i]);
+        ExpectNear(out[i].u, d.u, 0.0);
+        ExpectNear(out[i].v, d.v, 0.0);
+    }
+}
+
+} // namespace
+} // namespace ct
@@ -0,0 +1,84 @@
+#include "toolbox/math/math.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+
+namespace ct {
+namespace {
+
+using mat23d = mat<2, 3, double>;
+
+constexpr mat23d kA(layout::rowm,
+                               1.0, -2.0, 3.0,
+                               4.0, 5.0, -6.0);
+constexpr mat<3, 4, double> kB(layout::rowm,
+                               2.0, 0.0, 1.0, -1.0,
+                               -3.0, 1.0, 0.0, 2.0,
+                               1.0, 4.0, -2.0, 0.5);
+
+// NOTE: The unrolled kernels are constexpr, so the known values are checked at compile time too
+constexpr mat<2, 4, double> kAB(layout::rowm,
+                                11.0, 10.0, -5.0, -3.5,
+                                -13.0, -19.0, 16.0, 3.0);
+static_assert(kA * kB == kAB);
+static_assert(kA.transpose().transpose() == kA);
+static_assert(kA.at<1, 2>() == -6.0);
+static_assert(mat<5, 5, double>::identity().det() == 1.0);
+
+TEST(MatUnroll, ProductMatchesDefinition) {
+    const mat23d a = kA;
+    const mat<3, 4, double> b = kB;
+    const mat<2, 4, double> r = a * b;
+
+    for (std::size_t i = 0; i < 2; ++i) {
+        for (std::size_t j = 0; j < 4; ++j) {
+            double expected = 0.0;
+            for (std::size_t k = 0; k < 3; ++k) expected += a(i, k) * b(k, j);
+            EXPECT_EQ(r(i, j), expected) << i << ", " << j;
+        }
+    }
+}
+
+TEST(MatUnroll, ElementWiseOperators) {
+    mat23d a = kA;
+    const mat23d b(2.0);
+
+    EXPECT_EQ(a + b, mat23d(layout::rowm, 3.0, 0.0, 5.0, 6.0, 7.0, -4.0));
+    EXPECT_EQ(a - b, mat23d(layout::rowm, -1.0, -4.0, 1.0, 2.0, 3.0, -8.0));
+    EXPECT_EQ(a * 2.0, mat23d(layout::rowm, 2.0, -4.0, 6.0, 8.0, 10.0, -12.0));
+    EXPECT_EQ(a / 2.0, mat23d(layout::rowm, 0.5, -1.0, 1.5, 2.0, 2.5, -3.0));
+
+    a += b;
+    a -= b;
+    EXPECT_EQ(a, kA);
+    EXPECT_NE(a, a * 2.0);
+}
+
+TEST(MatUnroll, TransposeSwapsIndices) {
+    const mat<3, 2, double> t = kA.transpose();
+    for (std::size_t i = 0; i < 2; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) EXPECT_EQ(t(j, i), kA(i, j));
+    }
+}
+
+TEST(MatUnroll, DeterminantAndInverse) {
+    const mat<5, 5, double> m(layout::rowm,
+                              4.0, 1.0, 0.0, 0.0, 2.0,
+                              1.0, 5.0, 1.0, 0.0, 0.0,
+                              0.0, 1.0, 6.0, 1.0, 0.0,
+                              0.0, 0.0, 1.0, 7.0, 1.0,
+                              2.0, 0.0, 0.0, 1.0, 8.0);
+
+    const mat<5, 5, double> r = m * inverse(m);
+    const mat<5, 5, double> identity = mat<5, 5, double>::identity();
+    for (std::size_t i = 0; i < 5; ++i) {
+        for (std::size_t j = 0; j < 5; ++j) EXPECT_NEAR(r(i, j), identity(i, j), 1e-12) << i << ", " << j;
+    }
+
+    EXPECT_NEAR(m.det() * inverse(m).det(), 1.0, 1e-12);
+    EXPECT_EQ(mat2<double>(layout::rowm, 3.0, 1.0, 2.0, 4.0).det(), 10.0);
+}
+
+} // namespace
+} // namespace ct
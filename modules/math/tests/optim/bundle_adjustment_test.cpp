@@ -0,0 +1,130 @@
+#include "toolbox/math/math.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace ct {
+namespace {
+
+struct reprojection {
+    vec2d uv;
+
+    template<class S>
+    bool operator()(const se3<S>& pose, const vec<3, S>& pw, std::array<S, 2>& r) const {
+        const vec<3, S> pc = pose * pw;
+        if (pc.z <= S(0)) return false;
+        r[0] = S(500.0) * pc.x / pc.z + S(320.0) - S(uv.x);
+        r[1] = S(500.0) * pc.y / pc.z + S(240.0) - S(uv.y);
+        return true;
+    }
+};
+
+// NOTE: Five cameras sliding along x and looking down +z at a cloud in front of them
+struct Scene {
+    std::vector<se3d> poses;
+    std::vector<vec3d> points;
+
+    Scene() {
+        for (std::size_t i = 0; i < 5; ++i) {
+            const double s = static_cast<double>(i);
+            poses.emplace_back(so3d::exp(vec3d(0.01 * s, -0.02 * s, 0.0)), vec3d(-0.3 * s, 0.05 * s, 0.0));
+        }
+        for (std::size_t i = 0; i < 40; ++i) {
+            const double s = static_cast<double>(i);
+            points.emplace_back(std::sin(1.3 * s) * 2.0, std::cos(0.7 * s) * 1.5, 6.0 + std::sin(0.4 * s) * 2.0);
+        }
+    }
+
+    void Fill(bundle_adjustment<double>& ba) const {
+        for (std::size_t c = 0; c < poses.size(); ++c) {
+            for (std::size_t p = 0; p < points.size(); ++p) {
+                const vec3d pc = poses[c] * points[p];
+                ba.add_residual<2>(c, p, reprojection{vec2d(500.0 * pc.x / pc.z + 320.0, 500.0 * pc.y / pc.z + 240.0)});
+            }
+        }
+        // NOTE: Two fixed cameras pin the gauge, scale included
+        ba.set_pose_fixed(0);
+        ba.set_pose_fixed(1);
+    }
+
+    void Perturb(std::vector<se3d>& p, std::vector<vec3d>& x) const {
+        p = poses;
+        x = points;
+        for (std::size_t c = 2; c < p.size(); ++c) {
+            const double s = static_cast<double>(c);
+            p[c] = se3d::exp(vec<6, double>(0.02 * s, -0.01, 0.015, 0.005, -0.004 * s, 0.003)) * p[c];
+        }
+        for (std::size_t i = 0; i < x.size(); ++i) x[i] += vec3d(0.05, -0.03, 0.08) * std::sin(static_cast<double>(i));
+    }
+};
+
+double MaxError(const Scene& scene, const std::vector<se3d>& poses, const std::vector<vec3d>& points) {
+    double e = 0.0;
+    for (std::size_t c = 0; c < poses.size(); ++c) {
+        const vec<6, double> d = (poses[c] * scene.poses[c].inverse()).log();
+        e = std::max(e, std::sqrt(d.dot(d)));
+    }
+    for (std::size_t i = 0; i < points.size(); ++i) e = std::max(e, (points[i] - scene.points[i]).length());
+    return e;
+}
+
+TEST(BundleAdjustment, RecoversTheScene) {
+    const Scene scene;
+    bundle_adjustment<double> ba;
+    scene.Fill(ba);
+
+    std::vector<se3d> poses;
+    std::vector<vec3d> points;
+    scene.Perturb(poses, points);
+    ASSERT_GT(MaxError(scene, poses, points), 1e-2);
+
+    const auto s = ba.solve(std::span(poses), std::span(points));
+    ASSERT_TRUE(s);
+    EXPECT_TRUE(s->converged);
+    EXPECT_LT(s->final_cost, 1e-12);
+    EXPECT_LT(MaxError(scene, poses, points), 1e-6);
+
+    // NOTE: Fixed poses keep their exact value
+    EXPECT_EQ(poses[0].translation(), scene.poses[0].translation());
+    EXPECT_EQ(poses[1].translation(), scene.poses[1].translation());
+}
+
+TEST(BundleAdjustment, PoolMatchesSerial) {
+    const Scene scene;
+    const auto pool = ThreadPool::Create({.workers = 3});
+    ASSERT_TRUE(pool);
+
+    bundle_adjustment<double> serial;
+    bundle_adjustment<double> parallel({.pool = pool->get(), .grain = 16});
+    scene.Fill(serial);
+    scene.Fill(parallel);
+
+    std::vector<se3d> a, b;
+    std::vector<vec3d> pa, pb;
+    scene.Perturb(a, pa);
+    scene.Perturb(b, pb);
+
+    ASSERT_TRUE(serial.solve(std::span(a), std::span(pa)));
+    ASSERT_TRUE(parallel.solve(std::span(b), std::span(pb)));
+    EXPECT_LT(MaxError(scene, a, pa), 1e-6);
+    EXPECT_LT(MaxError(scene, b, pb), 1e-6);
+}
+
+TEST(BundleAdjustment, RejectsMissingBlocks) {
+    const Scene scene;
+    bundle_adjustment<double> ba;
+    scene.Fill(ba);
+
+    std::vector<se3d> poses = scene.poses;
+    std::vector<vec3d> points(scene.points.begin(), scene.points.begin() + 10);
+    const auto s = ba.solve(std::span(poses), std::span(points));
+    ASSERT_FALSE(s);
+    EXPECT_EQ(s.error().Code(), ErrorCode::INVALID_ARGUMENT);
+}
+
+} // namespace
+} // namespace ct
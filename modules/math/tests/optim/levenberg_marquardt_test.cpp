@@ -0,0 +1,146 @@
+#include "toolbox/math/math.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace ct {
+namespace {
+
+// NOTE: y = exp(a x) + b, two parameters
+struct curve {
+    double x, y;
+
+    template<class S>
+    bool operator()(const vec<2, S>& p, std::array<S, 1>& r) const {
+        using std::exp;
+        r[0] = exp(p[0] * S(x)) + p[1] - S(y);
+        return true;
+    }
+};
+
+struct reprojection {
+    vec3d pw;
+    vec2d uv;
+
+    template<class S>
+    bool operator()(const se3<S>& pose, std::array<S, 2>& r) const {
+        const vec<3, S> pc = pose * vec<3, S>(S(pw.x), S(pw.y), S(pw.z));
+        if (pc.z <= S(0)) return false;
+        r[0] = S(500.0) * pc.x / pc.z + S(320.0) - S(uv.x);
+        r[1] = S(500.0) * pc.y / pc.z + S(240.0) - S(uv.y);
+        return true;
+    }
+};
+
+const se3d kPose(so3d::exp(vec3d(0.05, -0.1, 0.02)), vec3d(0.2, -0.1, 0.3));
+
+std::vector<reprojection> MakeObservations(std::size_t n, double outlierShift) {
+    std::vector<reprojection> out;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double s = static_cast<double>(i);
+        const vec3d pw(std::sin(1.7 * s) * 2.0, std::cos(1.1 * s) * 1.5, 5.0 + std::sin(0.3 * s) * 2.0);
+        const vec3d pc = kPose * pw;
+        vec2d uv(500.0 * pc.x / pc.z + 320.0, 500.0 * pc.y / pc.z + 240.0);
+        if (i % 6 == 0) uv.x += outlierShift;
+        out.push_back({pw, uv});
+    }
+    return out;
+}
+
+double PoseError(const se3d& a, const se3d& b) {
+    const vec<6, double> d = (a * b.inverse()).log();
+    return std::sqrt(d.dot(d));
+}
+
+TEST(LevenbergMarquardt, FitsACurve) {
+    levenberg_marquardt<vec<2, double>> lm;
+    for (std::size_t i = 0; i < 20; ++i) {
+        const double x = 0.1 * static_cast<double>(i);
+        lm.add_residual<1>(curve{x, std::exp(0.8 * x) - 0.5});
+    }
+
+    vec<2, double> p{0.0, 0.0};
+    const auto s = lm.solve(p);
+    ASSERT_TRUE(s);
+    EXPECT_TRUE(s->converged);
+    EXPECT_LT(s->final_cost, 1e-20);
+    EXPECT_NEAR(p[0], 0.8, 1e-9);
+    EXPECT_NEAR(p[1], -0.5, 1e-9);
+}
+
+TEST(LevenbergMarquardt, RefinesAPose) {
+    levenberg_marquardt<se3d> lm;
+    for (const reprojection& r : MakeObservations(60, 0.0)) lm.add_residual<2>(r);
+
+    se3d pose = se3d::exp(vec<6, double>(0.05, -0.03, 0.1, 0.02, -0.03, 0.01)) * kPose;
+    const auto s = lm.solve(pose);
+    ASSERT_TRUE(s);
+    EXPECT_TRUE(s->converged);
+    EXPECT_LT(s->final_cost, s->initial_cost);
+    EXPECT_LT(PoseError(pose, kPose), 1e-9);
+}
+
+// NOTE: Every sixth point is 40 px off, the Cauchy loss keeps them from pulling the pose
+TEST(LevenbergMarquardt, RobustLossDownweightsOutliers) {
+    levenberg_marquardt<se3d> lm;
+    for (const reprojection& r : MakeObservations(60, 40.0)) lm.add_residual<2>(r, cauchy_loss<double>{1.0});
+
+    se3d pose = se3d::exp(vec<6, double>(0.02, -0.01, 0.03, 0.01, -0.01, 0.0)) * kPose;
+    ASSERT_TRUE(lm.solve(pose));
+    EXPECT_LT(PoseError(pose, kPose), 1e-3);
+}
+
+TEST(LevenbergMarquardt, PoolMatchesSerial) {
+    const auto pool = ThreadPool::Create({.workers = 3});
+    ASSERT_TRUE(pool);
+
+    levenberg_marquardt<se3d> serial;
+    levenberg_marquardt<se3d> parallel({.pool = pool->get(), .grain = 8});
+    for (const reprojection& r : MakeObservations(200, 0.0)) {
+        serial.add_residual<2>(r);
+        parallel.add_residual<2>(r);
+    }
+
+    const se3d start = se3d::exp(vec<6, double>(0.05, -0.03, 0.1, 0.02, -0.03, 0.01)) * kPose;
+    se3d a = start, b = start;
+    ASSERT_TRUE(serial.solve(a));
+    ASSERT_TRUE(parallel.solve(b));
+    EXPECT_LT(PoseError(a, kPose), 1e-9);
+    EXPECT_LT(PoseError(b, kPose), 1e-9);
+}
+
+TEST(LevenbergMarquardt, ClearKeepsTheSolverReusable) {
+    levenberg_marquardt<se3d> lm;
+    for (const reprojection& r : MakeObservations(30, 0.0)) lm.add_residual<2>(r);
+    EXPECT_EQ(lm.residual_count(), 30u);
+
+    lm.clear();
+    EXPECT_EQ(lm.residual_count(), 0u);
+    se3d pose = kPose;
+    const auto empty = lm.solve(pose);
+    ASSERT_FALSE(empty);
+    EXPECT_EQ(empty.error().Code(), ErrorCode::INVALID_ARGUMENT);
+
+    for (const reprojection& r : MakeObservations(30, 0.0)) lm.add_residual<2>(r);
+    pose = se3d::exp(vec<6, double>(0.01, 0.0, 0.0, 0.0, 0.01, 0.0)) * kPose;
+    ASSERT_TRUE(lm.solve(pose));
+    EXPECT_LT(PoseError(pose, kPose), 1e-9);
+}
+
+TEST(LevenbergMarquardt, FailsWhenUndefinedAtTheStart) {
+    levenberg_marquardt<se3d> lm;
+    for (const reprojection& r : MakeObservations(10, 0.0)) lm.add_residual<2>(r);
+
+    // NOTE: Turned around, every point is behind the camera
+    se3d pose = se3d(so3d::exp(vec3d(0.0, 3.14159, 0.0)), vec3d(0.0, 0.0, 0.0)) * kPose;
+    const auto s = lm.solve(pose);
+    ASSERT_FALSE(s);
+    EXPECT_EQ(s.error().Code(), ErrorCode::MATH_NON_FINITE);
+}
+
+} // namespace
+} // namespace ct
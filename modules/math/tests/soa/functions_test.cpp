@@ -0,0 +1,158 @@
+#include "toolbox/math/math.hpp"
+#include "toolbox/math/soa/functions.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ct {
+namespace {
+
+// NOTE: An odd count so the vectorized loops also run their scalar tail
+std::vector<vec3d> MakeCloud(std::size_t n = 37) {
+    std::vector<vec3d> cloud(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const double s = static_cast<double>(i);
+        cloud[i] = vec3d(std::sin(s) * 2.0, std::cos(0.7 * s) - 0.5, 3.0 + 0.1 * s);
+    }
+    return cloud;
+}
+
+const mat3d kR(layout::rowm,
+               0.36, 0.48, -0.8,
+               -0.8, 0.6, 0.0,
+               0.48, 0.64, 0.6);
+const vec3d kT(0.5, -1.0, 2.0);
+
+void ExpectNear(const vec3d& a, const vec3d& b, std::size_t i) {
+    EXPECT_NEAR(a.x, b.x, 1e-12) << "point " << i;
+    EXPECT_NEAR(a.y, b.y, 1e-12) << "point " << i;
+    EXPECT_NEAR(a.z, b.z, 1e-12) << "point " << i;
+}
+
+TEST(Soa, ComponentsAreAligned) {
+    const std::vector<vec3d> cloud = MakeCloud();
+    const vec3d_soa points{std::span<const vec3d>(cloud)};
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(points.x()) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(points.y()) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(points.z()) % 64, 0u);
+}
+
+TEST(Soa, RoundTripsThroughAos) {
+    const std::vector<vec3d> cloud = MakeCloud();
+    const vec3d_soa points{std::span<const vec3d>(cloud)};
+    EXPECT_EQ(points.to_aos(), cloud);
+}
+
+TEST(Soa, TransformsMatchPerPointProducts) {
+    const std::vector<vec3d> cloud = MakeCloud();
+    const vec3d_soa in{std::span<const vec3d>(cloud)};
+
+    mat4d affine = mat4d::identity();
+    for (std::size_t r = 0; r < 3; ++r) {
+        for (std::size_t c = 0; c < 3; ++c) affine(r, c) = kR(r, c);
+        affine(r, 3) = kT[r];
+    }
+
+    vec3d_soa rotated, rigid, viaMat4;
+    transform(kR, in, rotated);
+    transform(kR, kT, in, rigid);
+    transform(affine, in, viaMat4);
+
+    for (std::size_t i = 0; i < cloud.size(); ++i) {
+        const vec3d expected = kR * cloud[i];
+        ExpectNear(rotated[i], expected, i);
+        ExpectNear(rigid[i], expected + kT, i);
+        ExpectNear(viaMat4[i], expected + kT, i);
+    }
+}
+
+TEST(Soa, InPlaceTransformMatchesOutOfPlace) {
+    const std::vector<vec3d> cloud = MakeCloud();
+    vec3d_soa points{std::span<const vec3d>(cloud)};
+
+    vec3d_soa out;
+    transform(kR, kT, points, out);
+    transform(kR, kT, points, points);
+    EXPECT_EQ(points.to_aos(), out.to_aos());
+}
+
+TEST(Soa, ProjectIsPinhole) {
+    const std::vector<vec3d> cloud = MakeCloud();
+    const vec3d_soa points{std::span<const vec3d>(cloud)};
+
+    vec2d_soa uv;
+    project(500.0, 480.0, 320.0, 240.0, points, uv);
+    ASSERT_EQ(uv.size(), cloud.size());
+    for (std::size_t i = 0; i < cloud.size(); ++i) {
+        EXPECT_NEAR(uv[i].x, 500.0 * cloud[i].x / cloud[i].z + 320.0, 1e-9) << "point " << i;
+        EXPECT_NEAR(uv[i].y, 480.0 * cloud[i].y / cloud[i].z + 240.0, 1e-9) << "point " << i;
+    }
+}
+
+// NOTE: The dispatched kernels must agree with the scalar clone at every level the host runs
+TEST(Soa, DispatchLevelsAgree) {
+    const std::vector<vec3d> cloud = MakeCloud(101);
+    const vec3d_soa points{std::span<const vec3d>(cloud)};
+
+    const cpu::SimdLevel saved = cpu::GetLevel();
+    cpu::SetLevel(cpu::SimdLevel::Scalar);
+    vec3d_soa ref_rigid;
+    vec2d_soa ref_uv;
+    transform(kR, kT, points, ref_rigid);
+    project(500.0, 480.0, 320.0, 240.0, ref_rigid, ref_uv);
+
+    for (auto level : {cpu::SimdLevel::SSE42, cpu::SimdLevel::AVX2, cpu::SimdLevel::AVX512}) {
+        const cpu::SimdLevel active = cpu::SetLevel(level);
+        vec3d_soa rigid;
+        vec2d_soa uv;
+        transform(kR, kT, points, rigid);
+        project(500.0, 480.0, 320.0, 240.0, rigid, uv);
+        for (std::size_t i = 0; i < cloud.size(); ++i) {
+            ExpectNear(rigid[i], ref_rigid[i], i);
+            EXPECT_NEAR(uv[i].x, ref_uv[i].x, 1e-9) << cpu::ToString(active) << " point " << i;
+            EXPECT_NEAR(uv[i].y, ref_uv[i].y, 1e-9) << cpu::ToString(active) << " point " << i;
+        }
+    }
+    cpu::SetLevel(saved);
+}
+
+TEST(Soa, NormalizeKeepsZeroVectors) {
+    std::vector<vec3d> cloud = MakeCloud();
+    cloud[5] = vec3d(0.0, 0.0, 0.0);
+    vec3d_soa points{std::span<const vec3d>(cloud)};
+
+    normalize(points);
+    for (std::size_t i = 0; i < cloud.size(); ++i) {
+        if (i == 5) {
+            EXPECT_EQ(points[i], vec3d(0.0, 0.0, 0.0));
+            continue;
+        }
+        ExpectNear(points[i], cloud[i].normalized(), i);
+    }
+}
+
+TEST(Soa, DotAndCrossMatchPerPoint) {
+    const std::vector<vec3d> a = MakeCloud();
+    std::vector<vec3d> b = MakeCloud();
+    for (vec3d& p : b) p = kR * p;
+
+    const vec3d_soa sa{std::span<const vec3d>(a)};
+    const vec3d_soa sb{std::span<const vec3d>(b)};
+
+    std::vector<double> dots(a.size());
+    vec3d_soa crosses;
+    dot(sa, sb, std::span<double>(dots));
+    cross(sa, sb, crosses);
+
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        EXPECT_NEAR(dots[i], a[i].dot(b[i]), 1e-12) << "point " << i;
+        ExpectNear(crosses[i], a[i].cross(b[i]), i);
+    }
+}
+
+} // namespace
+} // namespace ct
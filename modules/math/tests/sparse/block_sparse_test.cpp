@@ -0,0 +1,70 @@
+#include "toolbox/math/math.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace ct {
+namespace {
+
+// NOTE: 3 x 4 block rows of 2 x 3 blocks, duplicates and out-of-order entries on purpose
+block_sparse<2, 3, double> MakeMatrix() {
+    block_sparse<2, 3, double> a(3, 4, {{2, 3}, {0, 1}, {1, 0}, {0, 1}, {2, 0}, {0, 3}});
+    for (std::size_t k = 0; k < a.nonzero_blocks(); ++k) {
+        for (std::size_t i = 0; i < 2; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) a.block(k)(i, j) = static_cast<double>(10 * k + 3 * i + j) - 7.0;
+        }
+    }
+    return a;
+}
+
+std::vector<double> Dense(const block_sparse<2, 3, double>& a) {
+    std::vector<double> d(a.scalar_rows() * a.scalar_cols(), 0.0);
+    for (std::size_t r = 0; r < a.rows(); ++r) {
+        for (std::size_t k = a.row_begin(r); k < a.row_end(r); ++k) {
+            for (std::size_t i = 0; i < 2; ++i) {
+                for (std::size_t j = 0; j < 3; ++j) d[(r * 2 + i) * a.scalar_cols() + a.col_index(k) * 3 + j] = a.block(k)(i, j);
+            }
+        }
+    }
+    return d;
+}
+
+TEST(BlockSparse, PatternIsSortedAndMerged) {
+    const block_sparse<2, 3, double> a = MakeMatrix();
+    EXPECT_EQ(a.nonzero_blocks(), 5u);
+    EXPECT_EQ(a.row_end(0) - a.row_begin(0), 2u);
+    EXPECT_EQ(a.col_index(a.row_begin(0)), 1u);
+    EXPECT_EQ(a.col_index(a.row_begin(0) + 1), 3u);
+
+    EXPECT_NE(a.find(2, 3), a.npos);
+    EXPECT_EQ(a.find(1, 3), a.npos);
+}
+
+TEST(BlockSparse, ProductsMatchDense) {
+    const block_sparse<2, 3, double> a = MakeMatrix();
+    const std::vector<double> d = Dense(a);
+    const std::size_t rows = a.scalar_rows(), cols = a.scalar_cols();
+
+    std::vector<double> x(cols), y(rows), xt(rows), yt(cols);
+    for (std::size_t j = 0; j < cols; ++j) x[j] = 0.5 * static_cast<double>(j) - 2.0;
+    for (std::size_t i = 0; i < rows; ++i) xt[i] = 1.0 - 0.25 * static_cast<double>(i);
+
+    a.multiply(x, y);
+    a.multiply_transpose(xt, yt);
+
+    for (std::size_t i = 0; i < rows; ++i) {
+        double expected = 0.0;
+        for (std::size_t j = 0; j < cols; ++j) expected += d[i * cols + j] * x[j];
+        EXPECT_DOUBLE_EQ(y[i], expected) << "row " << i;
+    }
+    for (std::size_t j = 0; j < cols; ++j) {
+        double expected = 0.0;
+        for (std::size_t i = 0; i < rows; ++i) expected += d[i * cols + j] * xt[i];
+        EXPECT_DOUBLE_EQ(yt[j], expected) << "column " << j;
+    }
+}
+
+} // namespace
+} // namespace ct
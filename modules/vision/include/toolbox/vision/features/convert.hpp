@@ -0,0 +1,26 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/vision/features/descriptor.hpp"
+#include "toolbox/vision/features/keypoints.hpp"
+
+#include <opencv2/core.hpp>
+
+#include <span>
+#include <vector>
+
+namespace ct {
+
+// NOTE: Interop with OpenCV feature types (cv::ORB, cv::drawKeypoints, ...). Keypoints keep angles
+// in radians in [-pi, pi], cv::KeyPoint in degrees in [0, 360) with -1 for "no orientation". Every
+// converter reuses the capacity of `out`.
+
+// NOTE: size is the cv::KeyPoint diameter, 31 is the ORB descriptor patch
+void ToKeyPoints(const Keypoints& kps, std::vector<cv::KeyPoint>& out, f32 size = 31.0f);
+void FromKeyPoints(std::span<const cv::KeyPoint> kps, Keypoints& out);
+
+// NOTE: N x 32 CV_8UC1 matrix, the layout cv::ORB produces and cv::BFMatcher consumes
+void ToMat(std::span<const Descriptor> des, cv::Mat& out);
+void PackDescriptors(const cv::Mat& des, Descriptors& out);
+
+} // namespace ct
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/vision/image/view.hpp"
+
+#include <span>
+
+namespace ct {
+
+// NOTE: Pixels the corner kernels may read around a tested pixel, callers keep this margin from
+// the image border (7x7 tensor window plus Sobel support, widened by the 8-lane SIMD loads)
+inline constexpr i32 kCornerMargin = 6;
+
+enum class CornerScore : u8 {
+    ShiTomasi,  // smaller eigenvalue of the structure tensor
+    Harris,     // det - k trace^2
+};
+
+// NOTE: FAST-9 segment test on row y for x in [x0, x1). A pixel is a corner when 9 contiguous
+// pixels of the radius 3 circle are all brighter than center + threshold or all darker than
+// center - threshold. Writes the corner columns in increasing order to xs (room for x1 - x0) and
+// returns how many were found.
+u32 DetectFastRow(GrayView image, i32 y, i32 x0, i32 x1, u8 threshold, i32* xs) noexcept;
+
+// NOTE: Structure tensor of 3x3 Sobel gradients summed over the 7x7 window around (xs[i], y)
+void ScoreCorners(GrayView image, i32 y, std::span<const i32> xs, CornerScore score, f32 harrisK,
+    f32* out) noexcept;
+
+} // namespace ct
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+
+#include <array>
+#include <bit>
+#include <span>
+#include <vector>
+
+namespace ct {
+
+// NOTE: 256-bit binary descriptor (ORB / rBRIEF) packed into four words, exactly one AVX2 register.
+// Aligned so kernels can use aligned loads on contiguous arrays of them.
+struct alignas(32) Descriptor {
+    static constexpr u32 kBytes = 32;
+    static constexpr u32 kBits = kBytes * 8;
+
+    std::array<u64, 4> words{};
+
+    [[nodiscard]] u32 Distance(const Descriptor& other) const noexcept {
+        return static_cast<u32>(std::popcount(words[0] ^ other.words[0]) +
+                                std::popcount(words[1] ^ other.words[1]) +
+                                std::popcount(words[2] ^ other.words[2]) +
+                                std::popcount(words[3] ^ other.words[3]));
+    }
+
+    bool operator==(const Descriptor&) const = default;
+};
+
+static_assert(sizeof(Descriptor) == Descriptor::kBytes);
+
+using Descriptors = std::vector<Descriptor>;
+
+// NOTE: Result of one brute-force pass, indexed by query (q) and train (t) descriptor. Distances
+// of missing neighbours are kNone, so a single train descriptor never passes a ratio test.
+struct HammingNeighbors {
+    static constexpr u32 kNone = 0xffffffffu;
+
+    std::vector<u32> queryBest;     // distance to the nearest train descriptor
+    std::vector<u32> querySecond;   // distance to the second nearest train descriptor
+    std::vector<u32> queryIndex;    // index of the nearest train descriptor
+    std::vector<u32> trainBest;     // distance to the nearest query descriptor
+    std::vector<u32> trainIndex;    // index of the nearest query descriptor
+};
+
+// NOTE: Exhaustive Hamming search in both directions at once, the query side feeds the ratio test
+// and the train side the mutual check without a second pass. Ties resolve to the lower index on
+// every SIMD level, so results do not depend on the CPU. Reuses the capacity of `out`.
+void FindNeighbors(std::span<const Descriptor> query, std::span<const Descriptor> train,
+    HammingNeighbors& out);
+
+} // namespace ct
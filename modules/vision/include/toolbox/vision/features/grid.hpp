@@ -0,0 +1,42 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/vision/features/keypoints.hpp"
+
+#include <vector>
+
+namespace ct {
+
+// NOTE: Uniform bucket grid over keypoint positions for radius queries. Cells are stored CSR style
+// (one offset per cell into a flat index array), so a rebuild per frame reuses its storage. The
+// positions are stored in cell order next to the indices, a query scans them contiguously.
+class FeatureGrid {
+public:
+    FeatureGrid() = default;
+
+    // NOTE: Extent is the bounding box of the keypoints, cells are cellSize pixels square and
+    // start at its top left corner
+    void Build(const Keypoints& kps, f32 cellSize);
+
+    // NOTE: Appends the indices of all keypoints within radius of (x, y), grouped by cell
+    void Query(f32 x, f32 y, f32 radius, std::vector<u32>& out) const;
+
+    [[nodiscard]] bool Empty() const noexcept { return mIndices.empty(); }
+    [[nodiscard]] u32 GetCols() const noexcept { return mCols; }
+    [[nodiscard]] u32 GetRows() const noexcept { return mRows; }
+
+private:
+    f32 mInvCell{0.0f};
+    f32 mMinX{0.0f};
+    f32 mMinY{0.0f};
+    u32 mCols{0};
+    u32 mRows{0};
+    std::vector<u32> mCellStart;
+    std::vector<u32> mIndices;
+    std::vector<u32> mCursor;
+    std::vector<u32> mCells;
+    std::vector<f32> mX;
+    std::vector<f32> mY;
+};
+
+} // namespace ct
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace ct {
+
+// NOTE: Structure of arrays, index i across all members is keypoint i. Detection and description
+// write the arrays directly, so per-frame extraction allocates nothing once capacity is reached.
+// Loops that only need positions (gridding, matching windows, projection) stream x and y alone
+// instead of striding over 28-byte cv::KeyPoint records, see features/convert.hpp for those.
+struct Keypoints {
+    std::vector<f32> x;
+    std::vector<f32> y;
+    std::vector<f32> angle;      // radians in [-pi, pi], intensity centroid direction
+    std::vector<f32> response;   // corner score, larger is stronger
+    std::vector<u8> octave;      // pyramid level the keypoint was detected on, 0 is full resolution
+
+    [[nodiscard]] std::size_t Size() const noexcept { return x.size(); }
+    [[nodiscard]] bool Empty() const noexcept { return x.empty(); }
+
+    void Clear() noexcept {
+        x.clear();
+        y.clear();
+        angle.clear();
+        response.clear();
+        octave.clear();
+    }
+
+    void Resize(std::size_t n) {
+        x.resize(n);
+        y.resize(n);
+        angle.resize(n);
+        response.resize(n);
+        octave.resize(n);
+    }
+
+    void Reserve(std::size_t n) {
+        x.reserve(n);
+        y.reserve(n);
+        angle.reserve(n);
+        response.reserve(n);
+        octave.reserve(n);
+    }
+
+    void Push(f32 px, f32 py, f32 a, f32 r, u8 level = 0) {
+        x.push_back(px);
+        y.push_back(py);
+        angle.push_back(a);
+        response.push_back(r);
+        octave.push_back(level);
+    }
+};
+
+} // namespace ct
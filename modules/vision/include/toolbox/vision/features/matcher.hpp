@@ -0,0 +1,49 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/vision/features/descriptor.hpp"
+#include "toolbox/vision/features/grid.hpp"
+#include "toolbox/vision/types.hpp"
+
+#include <opencv2/core/types.hpp>
+
+#include <span>
+
+namespace ct {
+
+struct HammingMatcherInfo {
+    f32 ratio{0.75f};                     // Lowe's test best < ratio * second, >= 1 disables it
+    u32 maxDistance{Descriptor::kBits};   // matches farther apart are dropped
+    bool crossCheck{false};               // keep only mutual nearest neighbours
+    u32 maxMatches{200};                  // strongest N survive, 0 keeps all
+};
+
+// NOTE: Brute-force matcher for 256-bit binary descriptors. One FindNeighbors pass yields the two
+// nearest neighbours of every query and the nearest query of every train descriptor, so the ratio
+// test and the cross-check need no second search. Only the kept matches are sorted.
+class HammingMatcher {
+public:
+    explicit HammingMatcher(const HammingMatcherInfo& info = {});
+
+    // NOTE: queryIdx / trainIdx index the spans, sorted by ascending distance
+    void Match(std::span<const Descriptor> query, std::span<const Descriptor> train, Matches& out);
+
+    // NOTE: Guided by a motion prior, train descriptor t is only compared with the query
+    // descriptors whose keypoints lie within radius pixels of predicted[t], and the ratio test
+    // runs over that window. Same output convention as Match.
+    void MatchGuided(std::span<const Descriptor> query, const FeatureGrid& queryGrid,
+        std::span<const Descriptor> train, std::span<const cv::Point2f> predicted, f32 radius,
+        Matches& out);
+
+    [[nodiscard]] const HammingMatcherInfo& GetInfo() const noexcept { return mInfo; }
+
+private:
+    [[nodiscard]] bool Accept(u32 best, u32 second) const noexcept;
+    void Select(Matches& out) const;
+
+    HammingMatcherInfo mInfo;
+    HammingNeighbors mNeighbors;
+    std::vector<u32> mCandidates;
+};
+
+} // namespace ct
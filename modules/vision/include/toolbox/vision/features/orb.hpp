@@ -0,0 +1,101 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/vision/features/corners.hpp"
+#include "toolbox/vision/features/descriptor.hpp"
+#include "toolbox/vision/features/keypoints.hpp"
+#include "toolbox/vision/image/kernels.hpp"
+#include "toolbox/vision/image/view.hpp"
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace ct {
+
+struct OrbExtractorInfo {
+    u32 maxFeatures{500};
+    u8 fastThreshold{20};                         // FAST-9 intensity difference
+    u8 minFastThreshold{7};                       // retried on tiles without any corner
+    CornerScore score{CornerScore::ShiTomasi};    // ranks FAST corners for suppression and selection
+    f32 harrisK{0.04f};
+    i32 tileSize{128};                            // detection tiles, the unit of parallel work
+    bool distribute{true};                        // quadtree spread instead of the global top N
+    ThreadPool* pool{nullptr};                    // tiles and descriptors run on it when set
+};
+
+// NOTE: Native ORB: FAST-9 corners ranked by a structure tensor score, 3x3 non-maximum
+// suppression, intensity centroid orientation and steered BRIEF on a blurred copy of the image.
+// Detection runs per tile, each tile also scores a one pixel ring around itself so suppression
+// at tile edges matches a whole-image pass, and the tiles are merged by a quadtree that keeps the
+// strongest corner of each leaf so keypoints spread over the image.
+// The sampling pattern is generated deterministically (Gaussian pairs in the 31 x 31 patch), it is
+// not bit compatible with cv::ORB, so only match descriptors from the same extractor. All buffers
+// are members and are reused across frames.
+class OrbExtractor {
+public:
+    static constexpr i32 kPatchRadius = 15;
+    static constexpr u32 kAngleBins = 30;
+    // NOTE: Keypoints keep this distance from the border so patch, blur and corner windows fit
+    static constexpr i32 kBorder = kPatchRadius + kCornerMargin;
+
+    explicit OrbExtractor(const OrbExtractorInfo& info = {});
+
+    // NOTE: Up to maxFeatures corners sorted by descending response, angles are left at 0
+    void Detect(GrayView gray, Keypoints& kps);
+
+    // NOTE: Fills the angle of every keypoint and writes one descriptor per keypoint
+    void Describe(GrayView gray, Keypoints& kps, Descriptors& des);
+
+    void Extract(GrayView gray, Keypoints& kps, Descriptors& des);
+
+    [[nodiscard]] const OrbExtractorInfo& GetInfo() const noexcept { return mInfo; }
+
+private:
+    struct Tile {
+        i32 x0, y0, x1, y1;
+    };
+
+    // NOTE: Per thread slot, candidate columns and dense scores of the last three rows, and the
+    // column sums of the blur
+    struct TileScratch {
+        std::array<std::vector<i32>, 3> rowX;
+        std::array<std::vector<f32>, 3> rowScore;
+        std::array<u32, 3> rowCount{};
+        std::vector<f32> scores;
+        std::vector<u16> blur;
+    };
+
+    struct Node {
+        f32 x0, y0, x1, y1;
+        u32 begin, end;
+    };
+
+    void DetectTile(GrayView gray, const Tile& tile, u8 threshold, TileScratch& scratch, Keypoints& out) const;
+    void SelectStrongest(Keypoints& kps);
+    void Distribute(GrayView gray, Keypoints& kps);
+    void DescribeRange(GrayView gray, Keypoints& kps, Descriptors& des, std::size_t begin, std::size_t end) const;
+    [[nodiscard]] f32 Orientation(GrayView gray, i32 x, i32 y) const noexcept;
+    void Smooth(GrayView gray);
+    void UpdateOffsets(std::ptrdiff_t stride);
+    void Run(std::size_t count, std::size_t grain, const ThreadPool::RangeFn& fn);
+
+    OrbExtractorInfo mInfo;
+    std::array<i32, kPatchRadius + 1> mUMax{};
+
+    // NOTE: Detection, one candidate list per tile merged in tile order
+    std::vector<TileScratch> mScratch;
+    std::vector<Keypoints> mTiles;
+    Keypoints mCandidates;
+    std::vector<u32> mOrder;
+    std::vector<Node> mNodes;
+    std::vector<u32> mHeap;
+    std::vector<u32> mLeaves;
+
+    // NOTE: Description, blurred image and the rotated pattern as offsets for its stride
+    std::vector<u8> mBlurred;
+    std::vector<std::ptrdiff_t> mOffsets;
+    std::ptrdiff_t mOffsetStride{0};
+};
+
+} // namespace ct
@@ -1,20 +1,58 @@
 #pragma once
 
 #include "toolbox/base/base.hpp"
+#include "toolbox/vision/features/matcher.hpp"
+#include "toolbox/vision/features/orb.hpp"
+#include "toolbox/vision/geometry/pnp.hpp"
+#include "toolbox/vision/geometry/relative_pose.hpp"
+#include "toolbox/vision/map/backend.hpp"
+#include "toolbox/vision/map/keyframes.hpp"
+#include "toolbox/vision/image/pyramid.hpp"
 #include "toolbox/vision/sensors/camera.hpp"
 #include "toolbox/vision/types.hpp"
 
 #include <opencv2/core/types.hpp>
 
-#include <opencv2/features2d.hpp>
+#include <memory>
+#include <optional>
+#include <vector>
+
 #include <opencv2/opencv.hpp>
 
 
 
 namespace ct {
 
+enum class TrackingMode : u8 {
+    FeatureMatching,    // detect, describe and match every frame
+    OpticalFlow,        // follow keypoints with pyramidal Lucas-Kanade, detect only to refill
+};
+
 struct FrontendInfo {
     ref<ct::Camera> camera;
+    ref<ThreadPool> pool{};         // parallel detection, description and pose RANSAC, null runs serially
+    TrackingMode mode{TrackingMode::FeatureMatching};
+    OrbExtractorInfo extractor{};   // maxFeatures also bounds the optical flow tracks
+
+    HammingMatcherInfo matcher{};
+    bool guidedMatching{true};      // search around keypoints predicted from the last motion
+    f32 searchRadius{24.0f};        // pixels around each prediction
+    u32 minGuidedMatches{40};       // fewer guided matches fall back to brute force
+
+    RelativePoseInfo relativePose{};  // prosac relies on the matcher's distance order, off for optical flow,
+                                      // budget bounds the pose latency
+
+    bool mapTracking{true};         // feature matching only: track against triangulated map points
+    PnpInfo pnp{};
+    KeyframeInfo keyframes{};       // when a frame becomes a keyframe, what the local map keeps
+    bool localBA{true};             // refine the newest keyframes and their points on a backend thread
+    MappingBackendInfo backend{};   // not given the frontend pool, it would compete with tracking
+    u32 minMapInliers{30};          // fewer PnP inliers drop the map and re-initialize it
+
+    u32 minTracks{200};             // optical flow re-detects below this many live tracks
+    f32 trackSpacing{10.0f};        // pixels around live tracks kept free of new detections
+    i32 flowWindow{21};             // Lucas-Kanade window side in pixels
+    i32 flowLevels{3};              // pyramid levels above the full resolution image
 };
 
 class Frontend {
@@ -22,19 +60,80 @@ public:
     explicit Frontend(const FrontendInfo& info);
     ~Frontend();
 
+    // NOTE: Relative motion of the frame against the previous one, X_prev = R X_curr + t. With map
+    // tracking the pose comes from PnP against the local map, so the translation keeps the scale
+    // of the map instead of being unit length every frame. Triangulation and culling only run on
+    // the frames that become keyframes, bundle adjustment on the backend thread, whose results
+    // are picked up at the start of a frame without waiting for them.
+    // Every buffer of the pipeline is a member reused from frame to frame and dropped keyframes are
+    // kept as spares, so once the buffers have grown to the frame size and feature count a tracked
+    // frame does not allocate in feature matching mode, keyframes included. A tracking loss still
+    // allocates its error message, OpenCV's optical flow and corner routines allocate internally and
+    // bundle adjustment allocates on the backend thread.
     [[nodiscard]] result<Pose> Estimate(const cv::Mat& image, Timestamp ts);
 
-    [[nodiscard]] Frame DetectFeatures(const cv::Mat& gray, Timestamp ts);
-    [[nodiscard]] Matches MatchFrames(const Frame& curr, const Frame& prev);
+    // NOTE: Extracts straight into `frame`, its keypoint and descriptor storage is reused
+    void DetectFeatures(const cv::Mat& gray, Timestamp ts, Frame& frame);
+    void MatchFrames(const Frame& curr, const Frame& prev, Matches& matches);
 
 
 private:
+    [[nodiscard]] result<Pose> EstimateMatching(Timestamp ts);
+    [[nodiscard]] result<Pose> EstimateFlow();
+    [[nodiscard]] result<Pose> RecoverPose(
+        const std::vector<cv::Point2f>& ptsCurr, const std::vector<cv::Point2f>& ptsPrev);
+
+    // NOTE: Map tracking, poses are camera from world
+    [[nodiscard]] result<Pose> TrackMap();
+    void InitializeMap(const Pose& motion);
+    void ResetMap();
+    void ApplyBackend();
+
+    void PredictKeypoints(const Frame& prev, const Pose& motion);
+    void RefillTracks();
+
     FrontendInfo mInfo;
+
+    // NOTE: The current frame is swapped into the previous one, the two keep their storage
+    Frame mFrame;
     Frame mPrevFrame;
 
-    cv::Mat mGray;
-    ref<cv::ORB> mOrb;
-    cv::BFMatcher mMatcher;
+    // NOTE: Gray frame as level 0 of the pyramid, built once per frame for detection and flow. The
+    // pyramid of a frame is kept as the previous one of the next.
+    ImagePyramid mPyramid;
+    ImagePyramid mPrevPyramid;
+    OrbExtractor mExtractor;
+    HammingMatcher mMatcher;
+    RelativePoseEstimator mRelativePose;
+    std::vector<u8> mInliers;
+
+    // NOTE: Relative motion of the last tracked frame pair, empty after tracking loss
+    std::optional<Pose> mMotion;
+    FeatureGrid mGrid;
+    std::vector<cv::Point2f> mPredicted;
+    Matches mMatches;
+    std::vector<cv::Point2f> mPtsCurr;
+    std::vector<cv::Point2f> mPtsPrev;
+
+    // NOTE: Map tracking state. The map is initialized from the first pair whose relative pose
+    // triangulates enough points, its scale is that pair's baseline. mTracked holds the map point
+    // each keypoint of the current frame tracked.
+    KeyframeManager mKeyframes;
+    PnpEstimator mPnp;
+    Pose mPose;
+    Pose mPrevPose;
+    u32 mFrameIndex{0};
+    std::vector<vec3d> mMapPoints;
+    std::vector<MapPointHandle> mTracked;
+    std::unique_ptr<MappingBackend> mBackend;
+
+    // NOTE: Optical flow state
+    std::vector<cv::Point2f> mTracks;
+    std::vector<cv::Point2f> mFlow;
+    std::vector<u8> mFlowStatus;
+    std::vector<f32> mFlowError;
+    std::vector<cv::Point2f> mCorners;
+    cv::Mat mDetectMask;
 };
 
 } // namespace fs
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/math/math.hpp"
+#include "toolbox/vision/types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace ct {
+
+// NOTE: Normalized image correspondences (K^-1 applied) as separate arrays, the layout the scoring
+// kernels stream. Index i across all members is correspondence i, 1 is the first view.
+struct Correspondences {
+    std::vector<f32> x1;
+    std::vector<f32> y1;
+    std::vector<f32> x2;
+    std::vector<f32> y2;
+
+    [[nodiscard]] std::size_t Size() const noexcept { return x1.size(); }
+
+    void Resize(std::size_t n) {
+        x1.resize(n);
+        y1.resize(n);
+        x2.resize(n);
+        y2.resize(n);
+    }
+};
+
+// NOTE: Counts the correspondences in [begin, end) whose squared Sampson distance to E is below
+// threshold2, the first-order approximation of the squared reprojection error. Scalar and AVX2
+// kernels, 8 correspondences per step.
+[[nodiscard]] u32 CountSampsonInliers(const mat3d& E, const Correspondences& c, std::size_t begin, std::size_t end,
+    f32 threshold2) noexcept;
+
+// NOTE: Same test over all correspondences, mask[i] is 1 for inliers. Returns the inlier count.
+u32 SampsonInlierMask(const mat3d& E, const Correspondences& c, f32 threshold2, std::span<u8> mask) noexcept;
+
+// NOTE: The four motions E factors into, X_2 = R X_1 + t with |t| = 1: (R1, t), (R1, -t), (R2, t),
+// (R2, -t). Only one of them puts the scene in front of both cameras.
+[[nodiscard]] std::array<Pose, 4> DecomposeEssential(const mat3d& E) noexcept;
+
+// NOTE: Depths of the two rays of a correspondence at their closest approach, false when the rays
+// are parallel. depth1 along (x1, y1, 1) in the first camera, depth2 in the second.
+[[nodiscard]] bool TriangulateDepths(const Pose& motion, f64 x1, f64 y1, f64 x2, f64 y2, f64& depth1,
+    f64& depth2) noexcept;
+
+} // namespace ct
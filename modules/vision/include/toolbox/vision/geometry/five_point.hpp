@@ -0,0 +1,22 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/math/math.hpp"
+
+#include <array>
+
+namespace ct {
+
+inline constexpr u32 kFivePointSample = 5;
+inline constexpr u32 kFivePointMaxSolutions = 10;
+
+// NOTE: Minimal relative pose solver of Nister / Stewenius. Writes every real essential matrix E with
+// x2^T E x1 = 0 for the five normalized image correspondences (unit Frobenius norm, sign arbitrary)
+// and returns their count, 0 for degenerate samples. The null space of the epipolar constraints
+// is parameterized as E = x X + y Y + z Z + W, the cubic trace and determinant constraints are
+// eliminated down to a 10x10 action matrix for x whose real eigenvectors carry the solutions.
+// Everything lives on the stack.
+u32 SolveFivePoint(const std::array<vec2d, kFivePointSample>& x1, const std::array<vec2d, kFivePointSample>& x2,
+    std::array<mat3d, kFivePointMaxSolutions>& out) noexcept;
+
+} // namespace ct
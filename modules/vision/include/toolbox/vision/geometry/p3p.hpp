@@ -0,0 +1,23 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/math/math.hpp"
+#include "toolbox/vision/types.hpp"
+
+#include <array>
+
+namespace ct {
+
+inline constexpr u32 kP3PSample = 3;
+inline constexpr u32 kP3PMaxSolutions = 4;
+
+// NOTE: Minimal absolute pose solver (Grunert's formulation). bearings are unit rays in the camera,
+// points the matching world points. Writes every camera pose X_c = R X_w + t that puts the three
+// points on their rays in front of the camera and returns their count, 0 for degenerate samples
+// (collinear points, coincident rays). The distance ratios along the rays are the real roots of
+// one quartic, each root gives three camera points that are aligned with the world triangle.
+// Everything lives on the stack.
+u32 SolveP3P(const std::array<vec3d, kP3PSample>& bearings, const std::array<vec3d, kP3PSample>& points,
+    std::array<Pose, kP3PMaxSolutions>& out) noexcept;
+
+} // namespace ct
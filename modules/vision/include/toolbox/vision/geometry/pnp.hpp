@@ -0,0 +1,78 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/math/math.hpp"
+#include "toolbox/vision/geometry/p3p.hpp"
+#include "toolbox/vision/geometry/ransac.hpp"
+#include "toolbox/vision/sensors/camera.hpp"
+#include "toolbox/vision/types.hpp"
+
+#include <opencv2/core/types.hpp>
+
+#include <random>
+#include <span>
+#include <vector>
+
+namespace ct {
+
+struct PnpInfo {
+    f64 threshold{2.0};         // pixels, reprojection error
+    f64 confidence{0.999};      // probability that an all-inlier sample was drawn
+    u32 maxIterations{300};     // samples, three-point samples need far fewer than five-point ones
+    bool refine{true};          // motion-only Levenberg-Marquardt over the inliers
+    u32 refineIterations{10};
+    u64 seed{0x9e3779b97f4a7c15ull};
+    ThreadPool* pool{nullptr};  // hypotheses are drawn and scored on every lane when set
+    f64 budget{0.0};            // milliseconds, stop sampling and keep the best model so far, 0 disables
+};
+
+struct AbsolutePose {
+    Pose pose;                  // camera from world, X_c = R X_w + t
+    u32 inliers{0};
+    u32 iterations{0};          // samples drawn
+    f64 confidence{0.0};        // probability that an all-inlier sample was among those drawn
+    bool timedOut{false};       // the budget ran out before the iteration bound was reached
+    bool refined{false};        // the refinement converged and was kept
+};
+
+// NOTE: Camera pose from 2D-3D correspondences:
+//  - P3P minimal solver, every solution is a hypothesis
+//  - uniform three-point samples drawn and scored on the lanes of a RansacSchedule, the same
+//    parallel search and wall-clock budget as RelativePoseEstimator
+//  - reprojection scoring in normalized coordinates over separate coordinate arrays
+//  - the best hypothesis is refined on its inliers with levenberg_marquardt<se3d> under a Huber
+//    loss, and the inliers are re-evaluated at the refined pose
+// Correspondence buffers and the refinement's residual blocks are members and reused, so a warm
+// estimator does not allocate.
+class PnpEstimator {
+public:
+    explicit PnpEstimator(const PnpInfo& info = {});
+
+    // NOTE: points[i] (world) <-> pixels[i], mask[i] is set to 1 for the final inliers
+    [[nodiscard]] result<AbsolutePose> Estimate(std::span<const vec3d> points, std::span<const cv::Point2f> pixels,
+        const CameraIntrinsics& intrinsics, std::vector<u8>& mask);
+
+    [[nodiscard]] const PnpInfo& GetInfo() const noexcept { return mInfo; }
+
+private:
+    // NOTE: What one thread owns during the search, a cache line apart from its neighbours
+    struct alignas(64) Lane {
+        std::mt19937_64 random;
+    };
+
+    void Search(Lane& lane, RansacSchedule& schedule, Pose& best) const;
+    [[nodiscard]] u32 Score(const Pose& pose) const noexcept;
+    u32 InlierMask(const Pose& pose, std::span<u8> mask) const noexcept;
+    [[nodiscard]] bool Refine(Pose& pose, std::span<const u8> mask, const CameraIntrinsics& intrinsics);
+
+    PnpInfo mInfo;
+    f64 mThreshold2{0.0};
+
+    // NOTE: World points and normalized image points (K^-1 applied) as separate arrays
+    std::vector<f64> mX, mY, mZ;
+    std::vector<f64> mU, mV;
+    std::vector<Lane> mLanes;
+    levenberg_marquardt<se3d> mRefiner;
+};
+
+} // namespace ct
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <span>
+
+namespace ct {
+
+// NOTE: Samples needed to draw at least one good sample with probability `confidence` when a
+// sample is good with probability `good` (all inliers, times whatever an early rejection test
+// keeps of those), clamped to [1, maxIterations]
+[[nodiscard]] u32 RansacIterationBound(f64 good, f64 confidence, u32 maxIterations) noexcept;
+
+// NOTE: 1 - (1 - good)^iterations, the probability that a good sample was among those drawn
+[[nodiscard]] f64 RansacConfidence(f64 good, u32 iterations) noexcept;
+
+// NOTE: Fills out with distinct indices from [0, range), range >= out.size(). Multiply-shift on the
+// raw generator output keeps the draw identical on every standard library.
+void DrawDistinct(std::mt19937_64& random, u32 range, std::span<u32> out) noexcept;
+
+// NOTE: Shared state of one RANSAC run whose hypotheses are drawn and scored by several threads:
+//  - iteration indices come from an atomic counter, so sample schedules that depend on the
+//    index (PROSAC) stay meaningful across threads
+//  - the best score is an atomic read on every hypothesis, the lock is only taken by one that
+//    beats it, and its winner lowers the shared iteration bound
+//  - an optional wall-clock budget stops claiming new iterations, the run then ends with the
+//    best model so far and the confidence the iterations actually run give it
+// Lives on the estimating thread's stack for one run, threads only hold it by reference.
+class RansacSchedule {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // NOTE: budget in milliseconds from construction, 0 runs until the bound
+    RansacSchedule(u32 maxIterations, f64 confidence, f64 budget) noexcept;
+
+    RansacSchedule(const RansacSchedule&) = delete;
+    RansacSchedule& operator=(const RansacSchedule&) = delete;
+
+    // NOTE: Next iteration index, false once the bound is reached or the budget is spent
+    [[nodiscard]] bool Claim(u32& iteration) noexcept;
+
+    [[nodiscard]] u32 GetBestScore() const noexcept { return mBestScore.load(std::memory_order_acquire); }
+
+    // NOTE: When score beats the best one, store() records the model under the lock and the bound
+    // drops to what a sample that is good with probability `good` needs. Returns whether it won.
+    template<typename Fn>
+    bool Improve(u32 score, f64 good, Fn&& store) {
+        if (score <= GetBestScore()) return false;
+
+        std::scoped_lock lock(mMutex);
+        if (score <= mBestScore.load(std::memory_order_relaxed)) return false;
+        store();
+        mGood = good;
+        mBestScore.store(score, std::memory_order_release);
+        // NOTE: Only winners write the bound and they hold the lock, Claim reads it lock free
+        const u32 bound = RansacIterationBound(good, mConfidence, mMaxIterations);
+        if (bound < mBound.load(std::memory_order_relaxed)) mBound.store(bound, std::memory_order_relaxed);
+        return true;
+    }
+
+    // NOTE: Iterations handed out, all of them have finished once the threads have returned
+    [[nodiscard]] u32 GetIterations() const noexcept { return mClaimed.load(std::memory_order_relaxed); }
+    [[nodiscard]] bool TimedOut() const noexcept { return mTimedOut.load(std::memory_order_relaxed); }
+
+    // NOTE: Confidence of the best model after GetIterations() samples, 0 without one
+    [[nodiscard]] f64 GetConfidence() const noexcept;
+
+private:
+    u32 mMaxIterations;
+    f64 mConfidence;
+    bool mHasDeadline;
+    Clock::time_point mDeadline;
+
+    alignas(64) std::atomic<u32> mNext{0};
+    std::atomic<u32> mClaimed{0};
+    std::atomic<u32> mBound;
+    std::atomic<bool> mTimedOut{false};
+
+    alignas(64) std::atomic<u32> mBestScore{0};
+    mutable std::mutex mMutex;
+    f64 mGood{0.0};
+};
+
+} // namespace ct
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/math/math.hpp"
+#include "toolbox/vision/geometry/essential.hpp"
+#include "toolbox/vision/geometry/five_point.hpp"
+#include "toolbox/vision/geometry/ransac.hpp"
+#include "toolbox/vision/sensors/camera.hpp"
+#include "toolbox/vision/types.hpp"
+
+#include <opencv2/core/types.hpp>
+
+#include <random>
+#include <span>
+#include <vector>
+
+namespace ct {
+
+struct RelativePoseInfo {
+    f64 threshold{1.0};         // pixels, Sampson distance (cv::findEssentialMat's threshold)
+    f64 confidence{0.999};      // probability that an all-inlier sample was drawn
+    u32 maxIterations{1000};    // samples, the adaptive bound usually stops far earlier
+    bool prosac{true};          // correspondences are ordered best first, sample from the top early
+    bool sprt{true};            // reject bad hypotheses after a few correspondences
+    f64 maxDepth{50.0};         // cheirality, farther points (in baseline units) carry no sign, like cv::recoverPose
+    u64 seed{0x9e3779b97f4a7c15ull};
+    ThreadPool* pool{nullptr};  // hypotheses are drawn and scored on every lane when set
+    f64 budget{0.0};            // milliseconds, stop sampling and keep the best model so far, 0 disables
+};
+
+struct RelativePose {
+    Pose motion;                // X_2 = R X_1 + t, |t| = 1
+    mat3d essential{};
+    u32 inliers{0};             // Sampson inliers in front of both cameras
+    u32 iterations{0};          // samples drawn
+    u32 models{0};              // hypotheses scored
+    f64 confidence{0.0};        // probability that an all-inlier sample was among those drawn
+    bool timedOut{false};       // the budget ran out before the iteration bound was reached
+};
+
+// NOTE: Essential matrix RANSAC replacing cv::findEssentialMat + cv::recoverPose:
+//  - five-point minimal solver, every real solution is a hypothesis
+//  - PROSAC: samples are drawn from a growing prefix of the (quality ordered) correspondences, and
+//    it turns into uniform sampling by the time the prefix covers everything
+//  - SPRT (Wald's sequential test as in Chum & Matas' optimal randomized RANSAC): a hypothesis is
+//    scored on randomly ordered blocks of correspondences and dropped as soon as the likelihood
+//    ratio says it is bad, the test parameters adapt to the data
+//  - Sampson scoring through the SIMD kernels of essential.hpp
+//  - adaptive iteration bound from the best inlier ratio, discounted by SPRT's false rejections
+//  - cheirality: hypotheses whose sample cannot lie in front of both cameras are skipped, and the
+//    final model is decomposed once, keeping the motion with the most inliers in front
+// With a pool every lane runs its own sampler and SPRT against a shared RansacSchedule, the result
+// then depends on thread timing. Serially a fixed seed reproduces it exactly.
+// All buffers are members, an estimator reused every frame does not allocate after warm-up.
+class RelativePoseEstimator {
+public:
+    explicit RelativePoseEstimator(const RelativePoseInfo& info = {});
+
+    // NOTE: points1[i] <-> points2[i] in pixels, mask[i] is set to 1 for the final inliers
+    [[nodiscard]] result<RelativePose> Estimate(std::span<const cv::Point2f> points1,
+        std::span<const cv::Point2f> points2, const CameraIntrinsics& intrinsics, std::vector<u8>& mask);
+
+    [[nodiscard]] const RelativePoseInfo& GetInfo() const noexcept { return mInfo; }
+
+private:
+    struct Sprt {
+        f64 epsilon{0.1};       // inlier ratio of a good model
+        f64 delta{0.01};        // chance of a correspondence agreeing with a bad model
+        f64 logThreshold{0.0};  // log A, reject once the log likelihood ratio exceeds it
+        f64 logAccept{0.0};     // log(delta / epsilon), per agreeing correspondence
+        f64 logReject{0.0};     // log((1 - delta) / (1 - epsilon)), per disagreeing one
+        f64 threshold{1.0};     // A
+        u64 tested{0};          // correspondences scored by rejected hypotheses
+        u64 agreed{0};          // of those, inliers
+    };
+
+    struct Prosac {
+        u32 n{0};               // prefix the samples are drawn from
+        f64 tn{0.0};            // T_n, expected samples from the first n
+        u32 tnPrime{1};         // T'_n, sample index at which the prefix grows
+    };
+
+    // NOTE: What one thread owns during the search, a cache line apart from its neighbours
+    struct alignas(64) Lane {
+        std::mt19937_64 random;
+        Sprt sprt;
+        Prosac prosac;
+        u32 best{0};            // shared best score this lane's SPRT was last tuned to
+        u32 models{0};
+    };
+
+    void Normalize(std::span<const cv::Point2f> points1, std::span<const cv::Point2f> points2,
+        const CameraIntrinsics& intrinsics);
+    void ResetLane(Lane& lane, u32 index) const;
+    void Search(Lane& lane, RansacSchedule& schedule, mat3d& best) const;
+    void DrawSample(Lane& lane, u32 iteration, std::array<u32, kFivePointSample>& sample) const;
+    [[nodiscard]] bool SampleInFront(const mat3d& E, const std::array<u32, kFivePointSample>& sample) const;
+
+    // NOTE: Inliers of E, or -1 when SPRT rejected it
+    [[nodiscard]] i64 Score(Lane& lane, const mat3d& E) const;
+    static void UpdateSprt(Sprt& sprt) noexcept;
+
+    // NOTE: Probability that a sample is all inliers and survives SPRT
+    [[nodiscard]] f64 GoodSample(const Lane& lane, u32 inliers) const;
+
+    RelativePoseInfo mInfo;
+    f32 mThreshold2{0.0f};
+    Correspondences mPoints;     // input order
+    Correspondences mShuffled;   // random order, what SPRT scores block by block
+    std::vector<u32> mOrder;
+    std::mt19937_64 mRandom;
+    std::vector<Lane> mLanes;
+};
+
+} // namespace ct
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/math/math.hpp"
+#include "toolbox/vision/sensors/camera.hpp"
+#include "toolbox/vision/types.hpp"
+
+namespace ct {
+
+// NOTE: Ray (x, y, 1) of pixel (u, v), K^-1 applied
+[[nodiscard]] vec3d Unproject(const CameraIntrinsics& intrinsics, f32 u, f32 v) noexcept;
+
+// NOTE: Squared pixel distance between the projection of the camera point pc and (u, v)
+[[nodiscard]] f64 ReprojectionError2(const CameraIntrinsics& intrinsics, const vec3d& pc, f32 u, f32 v) noexcept;
+
+// NOTE: Cosine of the parallax angle in degrees, the form TriangulatePoint compares against
+[[nodiscard]] f64 ParallaxCosine(f64 degrees) noexcept;
+
+// NOTE: Midpoint of the rays of pixel (u1, v1) in the current camera and (u2, v2) in a reference
+// camera, X_ref = R X_curr + t with refFromCurr, currFromRef its inverse. Written to out in current
+// camera coordinates. Rejects points behind either camera, rays closer than the parallax angle and
+// reprojection errors above maxError pixels in either view.
+[[nodiscard]] bool TriangulatePoint(const CameraIntrinsics& intrinsics, const Pose& refFromCurr, const Pose& currFromRef,
+    f32 u1, f32 v1, f32 u2, f32 v2, f64 minCos, f64 maxError, vec3d& out) noexcept;
+
+} // namespace ct
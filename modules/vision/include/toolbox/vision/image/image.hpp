@@ -0,0 +1,88 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/math/detail/aligned_allocator.hpp"
+#include "toolbox/vision/image/view.hpp"
+
+#include <opencv2/core.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace ct {
+
+// NOTE: Owning image with interleaved channels. Every row of the image itself starts on a 64-byte
+// boundary so SIMD kernels can use aligned loads at x = 0. That only holds for views of the whole
+// image, a Roi (pyramid levels sit behind their border) starts wherever its x offset puts it, so
+// kernels taking a view use unaligned loads. Resize keeps the storage when it is large enough so a
+// per-frame image stops allocating after the first frame. Mat() exposes the same pixels to OpenCV.
+template<typename T, i32 Channels = 1>
+class Image {
+public:
+    static constexpr std::size_t kAlignment = 64;
+    static constexpr i32 kChannels = Channels;
+    static_assert(kAlignment % sizeof(T) == 0);
+
+    using View = ImageView<T, Channels>;
+    using ConstView = ImageView<const T, Channels>;
+
+    Image() = default;
+    Image(i32 width, i32 height, std::ptrdiff_t stride = 0) { Resize(width, height, stride); }
+
+    // NOTE: stride is in elements and rounded up to keep rows aligned, 0 picks the tightest one.
+    // Pixels are left as they are, new storage is zeroed.
+    void Resize(i32 width, i32 height, std::ptrdiff_t stride = 0) {
+        assert(width >= 0 && height >= 0);
+        constexpr std::ptrdiff_t kStep = static_cast<std::ptrdiff_t>(kAlignment / sizeof(T));
+        const std::ptrdiff_t minimum = static_cast<std::ptrdiff_t>(width) * Channels;
+        assert(stride == 0 || stride >= minimum);
+        stride = std::max(stride, minimum);
+        stride = (stride + kStep - 1) / kStep * kStep;
+
+        const std::size_t size = static_cast<std::size_t>(stride) * static_cast<std::size_t>(height);
+        if (size > mData.size()) mData.resize(size);
+        mWidth = width;
+        mHeight = height;
+        mStride = stride;
+    }
+
+    // NOTE: Frees the storage, Resize after Clear allocates again
+    void Clear() noexcept {
+        mData = {};
+        mWidth = mHeight = 0;
+        mStride = 0;
+    }
+
+    [[nodiscard]] bool Empty() const noexcept { return mWidth == 0 || mHeight == 0; }
+    [[nodiscard]] i32 GetWidth() const noexcept { return mWidth; }
+    [[nodiscard]] i32 GetHeight() const noexcept { return mHeight; }
+    [[nodiscard]] std::ptrdiff_t GetStride() const noexcept { return mStride; }
+
+    [[nodiscard]] T* Data() noexcept { return mData.data(); }
+    [[nodiscard]] const T* Data() const noexcept { return mData.data(); }
+
+    [[nodiscard]] T* Row(i32 y) noexcept { return GetView().Row(y); }
+    [[nodiscard]] const T* Row(i32 y) const noexcept { return GetView().Row(y); }
+
+    [[nodiscard]] View GetView() noexcept { return {mData.data(), mWidth, mHeight, mStride}; }
+    [[nodiscard]] ConstView GetView() const noexcept { return {mData.data(), mWidth, mHeight, mStride}; }
+
+    [[nodiscard]] View Roi(i32 x, i32 y, i32 w, i32 h) noexcept { return GetView().Roi(x, y, w, h); }
+    [[nodiscard]] ConstView Roi(i32 x, i32 y, i32 w, i32 h) const noexcept { return GetView().Roi(x, y, w, h); }
+
+    // NOTE: cv::Mat header over this storage, valid until the next Resize that grows the image.
+    // OpenCV functions writing into it keep the buffer as long as size and type already match.
+    [[nodiscard]] cv::Mat Mat() const noexcept { return MatOf(GetView()); }
+
+private:
+    std::vector<T, aligned_allocator<T, kAlignment>> mData;
+    i32 mWidth{0};
+    i32 mHeight{0};
+    std::ptrdiff_t mStride{0};
+};
+
+using GrayImage = Image<u8>;
+
+} // namespace ct
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/vision/image/view.hpp"
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace ct {
+
+// NOTE: Image kernels with a scalar and an AVX2 row implementation each, picked through
+// cpu::KernelTable. Borders follow BORDER_REFLECT_101 (OpenCV's default), integer arithmetic is
+// exact so every level gives the same pixels. The std::vector arguments are caller owned scratch
+// that grows to one row and is reused, none of the kernels allocate once it has.
+
+// NOTE: BORDER_REFLECT_101 index, the edge pixel is not repeated (-1 -> 1, n -> n - 2)
+[[nodiscard]] constexpr i32 Reflect101(i32 i, i32 n) noexcept {
+    if (n == 1) return 0;
+    const i32 period = 2 * (n - 1);
+    i %= period;
+    if (i < 0) i += period;
+    return i < n ? i : period - i;
+}
+
+// NOTE: cv::COLOR_BGR2GRAY, 14-bit fixed point weights with rounding, same pixels as OpenCV
+void BgrToGray(ImageView<const u8, 3> src, ImageView<u8> dst) noexcept;
+
+// NOTE: cv::pyrDown: 5x5 binomial and every second pixel kept, dst must be
+// ((src.width + 1) / 2) x ((src.height + 1) / 2) and src at least 3 x 3
+void PyrDown(GrayView src, ImageView<u8> dst, std::vector<u16>& sums);
+
+// NOTE: BgrToGray and PyrDown of its result in one pass over the color image. A half resolution row
+// is produced as soon as its five gray rows exist, so they are still in cache.
+void BgrToGrayPyrDown(ImageView<const u8, 3> src, ImageView<u8> gray, ImageView<u8> half, std::vector<u16>& sums);
+
+// NOTE: Separable blur taps in 1/256 units, odd count, symmetric and summing to 256. The vertical
+// sums keep 4 fractional bits so the result is exact for taps that are multiples of 16.
+inline constexpr std::array<u16, 5> kBinomial5{16, 64, 96, 64, 16};
+inline constexpr std::size_t kMaxBlurTaps = 31;
+
+// NOTE: Sampled Gaussian with radius ceil(3 sigma) (at most kMaxBlurTaps taps) quantized to 1/256,
+// the rounding remainder goes to the center tap
+void GaussianTaps(f32 sigma, std::vector<u16>& taps);
+
+void GaussianBlur(GrayView src, ImageView<u8> dst, std::span<const u16> taps, std::vector<u16>& sums);
+
+// NOTE: Rows [y0, y1) of GaussianBlur, rows are independent so callers can split an image across
+// threads with one scratch vector each
+void GaussianBlurRows(GrayView src, ImageView<u8> dst, std::span<const u16> taps, i32 y0, i32 y1,
+    std::vector<u16>& sums);
+
+// NOTE: 3x3 Sobel (cv::Sobel ksize 3) of both directions in one pass, dx and dy have the size of src
+void Sobel(GrayView src, ImageView<i16> dx, ImageView<i16> dy, std::vector<i16>& sums);
+
+// NOTE: cv::integral, sum is (width + 1) x (height + 1) with a zero first row and column. u32 holds
+// up to 2^24 pixels of 255.
+void Integral(GrayView src, ImageView<u32> sum) noexcept;
+
+} // namespace ct
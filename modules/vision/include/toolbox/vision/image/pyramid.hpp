@@ -0,0 +1,71 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/vision/image/image.hpp"
+#include "toolbox/vision/image/kernels.hpp"
+#include "toolbox/vision/image/view.hpp"
+
+#include <opencv2/core.hpp>
+
+#include <vector>
+
+namespace ct {
+
+struct ImagePyramidInfo {
+    i32 levels{4};      // including the full resolution image
+    i32 border{0};      // pixels of reflected padding around every level, for windowed reads
+    i32 minSize{8};     // no level whose smaller side would drop below this
+};
+
+// NOTE: Gray pyramid, every level halves the one before with the 5x5 binomial of cv::pyrDown and
+// gives the same pixels. It is built once per frame and read by every consumer: detection on level
+// 0, optical flow on all levels through Mats(). Levels live in aligned images with `border` pixels
+// of BORDER_REFLECT_101 padding, which is what cv::calcOpticalFlowPyrLK requires of a prebuilt
+// pyramid when border >= the window size. Level rows are therefore only 64-byte aligned when border
+// is 0. Storage is reused as long as the frame size does not grow.
+class ImagePyramid {
+public:
+    explicit ImagePyramid(const ImagePyramidInfo& info = {});
+
+    // NOTE: Mats() points into the owned images, copies would alias the source pixels
+    ImagePyramid(const ImagePyramid&) = delete;
+    ImagePyramid& operator=(const ImagePyramid&) = delete;
+    ImagePyramid(ImagePyramid&&) noexcept = default;
+    ImagePyramid& operator=(ImagePyramid&&) noexcept = default;
+
+    // NOTE: Sizes every level for a width x height frame and returns level 0 for the caller to write
+    // the frame into (e.g. the output of a color conversion), Build() then derives the rest
+    [[nodiscard]] ImageView<u8> Prepare(i32 width, i32 height);
+    void Build();
+
+    // NOTE: Prepare, copy of the image into level 0 and Build
+    void Build(GrayView image);
+
+    // NOTE: Prepare and Build from a BGR frame, gray conversion and level 1 are a single fused pass
+    void Build(ImageView<const u8, 3> bgr);
+
+    [[nodiscard]] bool Empty() const noexcept { return mViews.empty(); }
+    [[nodiscard]] i32 GetLevels() const noexcept { return static_cast<i32>(mViews.size()); }
+    [[nodiscard]] GrayView Level(i32 level) const noexcept;
+
+    // NOTE: Level 0 pixels per level pixel, 2^level
+    [[nodiscard]] f32 GetScale(i32 level) const noexcept;
+
+    // NOTE: Level headers for OpenCV, each a ROI of its padded image so locateROI sees the border
+    [[nodiscard]] const cv::Mat& Mat(i32 level) const noexcept;
+    [[nodiscard]] const std::vector<cv::Mat>& Mats() const noexcept { return mMats; }
+
+    [[nodiscard]] const ImagePyramidInfo& GetInfo() const noexcept { return mInfo; }
+
+private:
+    void Downsample(i32 first);
+    void FillBorder(i32 level);
+
+    ImagePyramidInfo mInfo;
+    std::vector<GrayImage> mImages;
+    std::vector<ImageView<u8>> mViews;
+    std::vector<cv::Mat> mMats;
+    std::vector<u16> mColumnSums;
+};
+
+} // namespace ct
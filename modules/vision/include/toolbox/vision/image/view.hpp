@@ -0,0 +1,91 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+
+#include <opencv2/core.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+namespace ct {
+
+// NOTE: Non-owning 2D view, stride counts elements between row starts and channels are interleaved.
+// Kernels take views so they run on any pixel storage without cv::Mat in their signatures.
+template<typename T, i32 Channels = 1>
+struct ImageView {
+    static_assert(Channels >= 1 && Channels <= 4);
+    static constexpr i32 kChannels = Channels;
+
+    T* data{nullptr};
+    i32 width{0};
+    i32 height{0};
+    std::ptrdiff_t stride{0};
+
+    [[nodiscard]] bool Empty() const noexcept { return data == nullptr || width <= 0 || height <= 0; }
+
+    [[nodiscard]] T* Row(i32 y) const noexcept {
+        assert(y >= 0 && y < height);
+        return data + static_cast<std::ptrdiff_t>(y) * stride;
+    }
+
+    [[nodiscard]] T& operator()(i32 x, i32 y, i32 c = 0) const noexcept {
+        assert(x >= 0 && x < width && c >= 0 && c < Channels);
+        return Row(y)[static_cast<std::ptrdiff_t>(x) * Channels + c];
+    }
+
+    // NOTE: Rectangle of the same pixels, no copy
+    [[nodiscard]] ImageView Roi(i32 x, i32 y, i32 w, i32 h) const noexcept {
+        assert(x >= 0 && y >= 0 && w >= 0 && h >= 0 && x + w <= width && y + h <= height);
+        return {data + static_cast<std::ptrdiff_t>(y) * stride + static_cast<std::ptrdiff_t>(x) * Channels, w, h,
+            stride};
+    }
+
+    // NOTE: Read-only view of the same pixels
+    operator ImageView<const T, Channels>() const noexcept
+        requires(!std::is_const_v<T>)
+    {
+        return {data, width, height, stride};
+    }
+};
+
+using GrayView = ImageView<const u8>;
+
+// NOTE: OpenCV element type of a view, only the depths cv::Mat knows are accepted
+template<typename T, i32 Channels = 1>
+[[nodiscard]] consteval int CvType() noexcept {
+    using U = std::remove_const_t<T>;
+    if constexpr (std::is_same_v<U, u8>) return CV_MAKETYPE(CV_8U, Channels);
+    else if constexpr (std::is_same_v<U, i8>) return CV_MAKETYPE(CV_8S, Channels);
+    else if constexpr (std::is_same_v<U, u16>) return CV_MAKETYPE(CV_16U, Channels);
+    else if constexpr (std::is_same_v<U, i16>) return CV_MAKETYPE(CV_16S, Channels);
+    else if constexpr (std::is_same_v<U, i32>) return CV_MAKETYPE(CV_32S, Channels);
+    else if constexpr (std::is_same_v<U, f32>) return CV_MAKETYPE(CV_32F, Channels);
+    else if constexpr (std::is_same_v<U, f64>) return CV_MAKETYPE(CV_64F, Channels);
+    else static_assert(sizeof(U) == 0, "no OpenCV depth for this element type");
+}
+
+// NOTE: Zero-copy view of a cv::Mat, the element type and channel count must match the Mat
+template<typename T, i32 Channels = 1>
+[[nodiscard]] ImageView<T, Channels> ViewOf(const cv::Mat& mat) noexcept {
+    assert(mat.empty() || mat.type() == (CvType<T, Channels>()));
+    assert(mat.step[0] % sizeof(T) == 0);
+    return {const_cast<T*>(mat.ptr<std::remove_const_t<T>>()), mat.cols, mat.rows,
+        static_cast<std::ptrdiff_t>(mat.step[0] / sizeof(T))};
+}
+
+// NOTE: Zero-copy view of a single channel 8-bit cv::Mat
+[[nodiscard]] inline GrayView ViewOf(const cv::Mat& gray) noexcept {
+    return ViewOf<const u8>(gray);
+}
+
+// NOTE: cv::Mat header over the pixels of a view, no copy and no ownership. The view storage must
+// outlive the Mat and OpenCV must not write through it when T is const.
+template<typename T, i32 Channels>
+[[nodiscard]] cv::Mat MatOf(ImageView<T, Channels> view) noexcept {
+    if (view.Empty()) return {};
+    return cv::Mat(view.height, view.width, CvType<T, Channels>(),
+        const_cast<std::remove_const_t<T>*>(view.data), static_cast<std::size_t>(view.stride) * sizeof(T));
+}
+
+} // namespace ct
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/math/math.hpp"
+#include "toolbox/vision/map/keyframes.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace ct {
+
+struct MappingBackendInfo {
+    u32 window{7};                  // newest keyframes optimized together
+    u32 fixed{2};                   // oldest of them held constant, two pin the monocular scale
+    u32 iterations{10};
+    f64 huber{2.0};                 // pixels, reprojection errors beyond this count linearly
+    ThreadPool* pool{nullptr};      // for the linear algebra, null keeps the backend on its own thread
+};
+
+// NOTE: Sliding-window bundle adjustment on a thread of its own. The tracker submits a window at
+// each keyframe and picks up the latest refined one between frames; both directions go through a
+// TripleBuffer, so neither side ever waits for the other. A window submitted while the previous one
+// is still being optimized replaces any window still queued, only the newest is worth solving.
+class MappingBackend {
+public:
+    explicit MappingBackend(const MappingBackendInfo& info = {});
+    ~MappingBackend();
+
+    MappingBackend(const MappingBackend&) = delete;
+    MappingBackend& operator=(const MappingBackend&) = delete;
+
+    // NOTE: Tracking thread. Fill Request(), typically with KeyframeManager::ExportWindow, then Submit()
+    [[nodiscard]] MapWindow& Request() noexcept { return mRequests.Back(); }
+    void Submit() noexcept;
+
+    // NOTE: Tracking thread. True when a window newer than Latest() has been optimized since the last
+    // call, Latest() stays valid until the next Poll.
+    bool Poll() noexcept { return mResults.Acquire(); }
+    [[nodiscard]] const MapWindow& Latest() const noexcept { return mResults.Front(); }
+
+    [[nodiscard]] u64 GetOptimized() const noexcept { return mOptimized.load(std::memory_order_relaxed); }
+    [[nodiscard]] const MappingBackendInfo& GetInfo() const noexcept { return mInfo; }
+
+private:
+    void Run(std::stop_token stop);
+    [[nodiscard]] bool Optimize(MapWindow& window);
+
+    MappingBackendInfo mInfo;
+    TripleBuffer<MapWindow> mRequests;
+    TripleBuffer<MapWindow> mResults;
+    std::atomic<u64> mSubmitted{0};
+    std::atomic<u64> mOptimized{0};
+
+    // NOTE: Backend thread only
+    std::vector<se3d> mPoses;
+    std::vector<vec3d> mPoints;
+
+    // NOTE: Last, so it starts after everything it uses and is joined before any of it is destroyed
+    std::jthread mThread;
+};
+
+} // namespace ct
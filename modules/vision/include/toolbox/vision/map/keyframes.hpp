@@ -0,0 +1,168 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/math/math.hpp"
+#include "toolbox/vision/features/matcher.hpp"
+#include "toolbox/vision/map/map_points.hpp"
+#include "toolbox/vision/place/database.hpp"
+#include "toolbox/vision/place/vocabulary.hpp"
+#include "toolbox/vision/sensors/camera.hpp"
+#include "toolbox/vision/types.hpp"
+
+#include <span>
+#include <vector>
+
+namespace ct {
+
+struct KeyframeInfo {
+    // NOTE: A frame becomes a keyframe once any of these hold
+    f32 parallax{3.0f};             // degrees, median angle the tracked points moved by since the last keyframe
+    f32 trackedRatio{0.6f};         // tracked points below this share of what the last keyframe tracked
+    f64 maxInterval{1.0};           // seconds since the last keyframe
+    f64 minInterval{0.0};           // seconds, parallax and time alone wait at least this long
+
+    // NOTE: New points come from the keypoints of the new and the last keyframe without one
+    f32 minParallax{1.0f};          // degrees between the two rays of a new point
+    f64 maxError{2.0};              // pixels, reprojection error of a new point in both keyframes
+    HammingMatcherInfo matcher{.crossCheck = true, .maxMatches = 0};
+
+    u32 maxKeyframes{10};           // the oldest keyframe beyond this leaves the local map
+    f32 redundancy{0.9f};           // share of a keyframe's points seen by redundantObservers others that culls it
+    u32 redundantObservers{3};
+    f32 minFoundRatio{0.25f};       // points matched in fewer of the frames they projected into are culled
+    u32 pointGrace{2};              // keyframes after its creation a point has to be held by minObservers
+    u32 minObservers{3};
+
+    const Vocabulary* vocabulary{nullptr}; // keyframes are indexed for place recognition when set and not empty
+};
+
+// NOTE: points holds the map point of every keypoint, unset or stale where there is none
+struct Keyframe {
+    u32 id{0};
+    Frame frame;
+    Pose pose;                      // camera from world
+    std::vector<MapPointHandle> points;
+    u32 tracked{0};                 // map points tracked when it was inserted
+    BowVector bow;                  // empty without a vocabulary
+};
+
+// NOTE: What the place index keeps of a keyframe once it has left the local map, culled or reset
+// away. pose is camera from world in the map of `epoch`, as it was when the keyframe left.
+struct PlaceRecord {
+    u32 id{0};
+    u64 epoch{0};
+    Pose pose;
+    BowVector bow;
+};
+
+// NOTE: One observation of a window point by a window keyframe, both as indices into the window
+struct WindowObservation {
+    u32 keyframe{0};
+    u32 point{0};
+    f32 u{0.0f};
+    f32 v{0.0f};
+};
+
+// NOTE: The newest keyframes and the points they share, copied out of the map for optimization on
+// another thread and written back refined. epoch names the map it was taken from, a window of a
+// map that has been reset since is not applied.
+struct MapWindow {
+    u64 epoch{0};
+    u64 version{0};
+    CameraIntrinsics intrinsics;
+    u32 fixed{0};                   // the first fixed keyframes are held constant
+    std::vector<u32> keyframes;     // ids, oldest first
+    Poses poses;                    // camera from world
+    std::vector<MapPointHandle> handles;
+    std::vector<vec3d> points;
+    std::vector<WindowObservation> observations;
+};
+
+// NOTE: Owns the local map, a sliding set of keyframes and the points they hold. Tracking only
+// reads the store and reports what it matched; triangulation and culling run when Insert adds a
+// keyframe, so a frame that is not one costs a projection and the NeedKeyframe test.
+class KeyframeManager {
+public:
+    explicit KeyframeManager(const KeyframeInfo& info = {});
+
+    void Reset();
+    [[nodiscard]] bool Empty() const noexcept { return mKeyframes.empty(); }
+    [[nodiscard]] u32 Size() const noexcept { return static_cast<u32>(mKeyframes.size()); }
+
+    // NOTE: Starts the map from two frames. The first camera is the world frame, secondPose its
+    // camera from world, matches have queryIdx in second and trainIdx in first and only those with
+    // a set mask entry are triangulated. Returns the number of points created.
+    u32 Initialize(const Frame& first, const Frame& second, const Pose& secondPose, const Matches& matches,
+        std::span<const u8> mask, const CameraIntrinsics& intrinsics);
+
+    // NOTE: tracked holds the map point matched by each keypoint of frame, trackedCount how many are set
+    [[nodiscard]] bool NeedKeyframe(
+        const Frame& frame, const Pose& pose, std::span<const MapPointHandle> tracked, u32 trackedCount);
+
+    // NOTE: Adds the frame as a keyframe holding its tracked points, triangulates new points against
+    // the last keyframe and culls. Returns the number of points created.
+    u32 Insert(const Frame& frame, const Pose& pose, std::span<const MapPointHandle> tracked,
+        const CameraIntrinsics& intrinsics);
+
+    // NOTE: The newest `size` keyframes, the oldest `fixed` of them held constant, and the points at
+    // least two of them hold. Fills out in place, its buffers are reused.
+    void ExportWindow(u32 size, u32 fixed, MapWindow& out);
+
+    // NOTE: Writes refined poses and points back, skipping those removed since the export. What was
+    // created after it moves with the newest window keyframe; correction maps world coordinates
+    // after the update into those before, a pose kept elsewhere follows as Compose(pose, correction).
+    // False for a window of an earlier map.
+    bool Apply(const MapWindow& window, Pose& correction);
+
+    // NOTE: Keyframes that look most like the frame, best first. Empty without a vocabulary. The
+    // index outlives culling and Reset, a candidate is either a live keyframe or in the archive.
+    void QueryPlaces(const Frame& frame, u32 k, std::vector<PlaceCandidate>& out);
+    // NOTE: The archived keyframe of a candidate id, null for a live one
+    [[nodiscard]] const PlaceRecord* FindPlace(u32 id) const noexcept;
+    [[nodiscard]] std::span<const PlaceRecord> GetArchive() const noexcept { return mArchive; }
+    // NOTE: Forgets the archive, live keyframes stay indexed
+    void ClearArchive();
+
+    [[nodiscard]] u64 GetEpoch() const noexcept { return mEpoch; }
+    [[nodiscard]] MapPointStore& GetPoints() noexcept { return mPoints; }
+    [[nodiscard]] const MapPointStore& GetPoints() const noexcept { return mPoints; }
+    [[nodiscard]] std::span<const Keyframe> GetKeyframes() const noexcept { return mKeyframes; }
+    [[nodiscard]] const KeyframeInfo& GetInfo() const noexcept { return mInfo; }
+
+private:
+    [[nodiscard]] bool Indexing() const noexcept { return mInfo.vocabulary && !mInfo.vocabulary->Empty(); }
+    Keyframe& Push(const Frame& frame, const Pose& pose);
+    u32 Triangulate(Keyframe& curr, Keyframe& ref, const CameraIntrinsics& intrinsics);
+    void Link(Keyframe& keyframe, u32 keypoint, MapPointHandle handle);
+    void CullPoints(u32 keyframe);
+    void CullKeyframes();
+    void Drop(std::size_t index);
+    void Archive(const Keyframe& keyframe);
+
+    KeyframeInfo mInfo;
+    f64 mParallaxCos;
+    f64 mTriangulationCos;
+    MapPointStore mPoints;
+    std::vector<Keyframe> mKeyframes;
+    u32 mNextId{0};
+    u64 mEpoch{0};
+
+    // NOTE: Dropped keyframes keep their buffers for the next Insert
+    std::vector<Keyframe> mSpare;
+
+    HammingMatcher mMatcher;
+    Matches mMatches;
+    Descriptors mQuery;
+    Descriptors mTrain;
+    std::vector<u32> mQueryIndex;
+    std::vector<u32> mTrainIndex;
+    std::vector<f64> mCosines;
+    std::vector<u32> mWindowIndex;
+
+    PlaceDatabase mPlaces;
+    BowVector mBow;
+    std::vector<PlaceRecord> mArchive;
+    std::vector<u32> mArchiveSlot;  // archive index of every keyframe id, kNone while live
+};
+
+} // namespace ct
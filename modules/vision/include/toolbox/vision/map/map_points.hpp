@@ -0,0 +1,95 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/math/math.hpp"
+#include "toolbox/vision/features/descriptor.hpp"
+#include "toolbox/vision/sensors/camera.hpp"
+#include "toolbox/vision/types.hpp"
+
+#include <opencv2/core/types.hpp>
+
+#include <span>
+#include <vector>
+
+namespace ct {
+
+// NOTE: Names a map point for as long as it lives. The slot is reused once the point is removed,
+// the generation tells the new point from the old one, so a stale handle never aliases.
+struct MapPointHandle {
+    static constexpr u32 kNone = 0xffffffffu;
+
+    u32 slot{kNone};
+    u32 generation{0};
+
+    [[nodiscard]] bool IsSet() const noexcept { return slot != kNone; }
+    bool operator==(const MapPointHandle&) const = default;
+};
+
+// NOTE: Triangulated points in world coordinates, one dense array per attribute so tracking walks
+// positions and descriptors without touching the bookkeeping. Index i across the arrays is point
+// i. Removing a point moves the last one into its index, indices are only stable until the next
+// Remove, handles for good.
+class MapPointStore {
+public:
+    static constexpr u32 kNone = 0xffffffffu;
+
+    void Clear() noexcept;
+    [[nodiscard]] bool Empty() const noexcept { return mPositions.empty(); }
+    [[nodiscard]] u32 Size() const noexcept { return static_cast<u32>(mPositions.size()); }
+
+    // NOTE: keyframe is the id of the keyframe that created the point, it starts with no observers
+    MapPointHandle Add(const vec3d& position, const Descriptor& descriptor, u32 keyframe);
+    bool Remove(MapPointHandle handle);
+
+    [[nodiscard]] bool Contains(MapPointHandle handle) const noexcept;
+    // NOTE: Dense index of a live point, kNone for a removed one
+    [[nodiscard]] u32 IndexOf(MapPointHandle handle) const noexcept;
+    [[nodiscard]] MapPointHandle HandleAt(u32 index) const noexcept;
+
+    // NOTE: Tracking statistics. Visible counts the frames a point projected into, found the frames
+    // it was matched in, their ratio tells points that never match from ones just out of view.
+    void MarkVisible(u32 index) noexcept { ++mVisible[index]; }
+    void MarkFound(u32 index, u32 frame) noexcept;
+    [[nodiscard]] f32 FoundRatio(u32 index) const noexcept;
+
+    // NOTE: Observers are the keyframes holding the point, a point nobody holds any more is removed
+    // by whoever drops the last observation
+    void AddObserver(u32 index) noexcept { ++mObservers[index]; }
+    [[nodiscard]] u32 RemoveObserver(u32 index) noexcept { return --mObservers[index]; }
+    [[nodiscard]] u32 GetObservers(u32 index) const noexcept { return mObservers[index]; }
+    [[nodiscard]] u32 GetCreated(u32 index) const noexcept { return mCreated[index]; }
+    [[nodiscard]] u32 GetLastSeen(u32 index) const noexcept { return mLastSeen[index]; }
+
+    // NOTE: Pixel position of every point in the camera X_c = R X_w + t, kNowhere for points behind
+    // the camera or outside the image. Index aligned with the store, projected points count as
+    // visible.
+    void Project(const Pose& cameraFromWorld, const CameraIntrinsics& intrinsics, f32 width, f32 height,
+        std::vector<cv::Point2f>& out);
+
+    [[nodiscard]] std::span<const vec3d> GetPositions() const noexcept { return mPositions; }
+    [[nodiscard]] std::span<vec3d> GetPositions() noexcept { return mPositions; }
+    [[nodiscard]] std::span<const Descriptor> GetDescriptors() const noexcept { return mDescriptors; }
+
+    static inline const cv::Point2f kNowhere{-1e6f, -1e6f};
+
+private:
+    // NOTE: A live slot holds the dense index of its point, a free one the next free slot
+    struct Slot {
+        u32 index{kNone};
+        u32 generation{0};
+    };
+
+    std::vector<Slot> mSlots;
+    u32 mFree{kNone};
+
+    std::vector<vec3d> mPositions;
+    Descriptors mDescriptors;
+    std::vector<u32> mOwners;
+    std::vector<u32> mVisible;
+    std::vector<u32> mFound;
+    std::vector<u32> mObservers;
+    std::vector<u32> mCreated;
+    std::vector<u32> mLastSeen;
+};
+
+} // namespace ct
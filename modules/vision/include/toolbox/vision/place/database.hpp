@@ -0,0 +1,55 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/vision/place/vocabulary.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ct {
+
+struct PlaceCandidate {
+    u32 id{0};
+    f32 score{0.0f};                // L1 similarity, see Score
+};
+
+// NOTE: Inverted file over BowVectors. Every word lists the entries holding it with their weight,
+// a query only walks the lists of its own words and accumulates the L1 score of every entry it
+// meets, so its cost grows with the entries that share words with it, not with the database.
+// Entries are named by a caller id, e.g. a keyframe id.
+class PlaceDatabase {
+public:
+    void Clear();
+    [[nodiscard]] bool Empty() const noexcept { return mIds.empty(); }
+    [[nodiscard]] u32 Size() const noexcept { return static_cast<u32>(mIds.size()); }
+
+    // NOTE: Replaces the entry of an id that is already present
+    void Add(u32 id, const BowVector& bow);
+    bool Remove(u32 id);
+
+    // NOTE: The k entries scoring highest against bow and at least minScore, best first and the
+    // lower id on ties. Reuses the capacity of out and of the accumulators.
+    void Query(const BowVector& bow, u32 k, std::vector<PlaceCandidate>& out, f32 minScore = 0.0f);
+
+private:
+    struct Posting {
+        u32 entry;
+        f32 weight;
+    };
+
+    struct Entry {
+        u32 id{0};
+        std::vector<u32> words;     // empty for a free entry
+    };
+
+    std::vector<std::vector<Posting>> mPostings;
+    std::vector<Entry> mEntries;
+    std::vector<u32> mFree;
+    std::unordered_map<u32, u32> mIds;
+
+    // NOTE: Query scratch, mScores is zero outside of a query
+    std::vector<f32> mScores;
+    std::vector<u32> mTouched;
+};
+
+} // namespace ct
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/vision/features/descriptor.hpp"
+
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace ct {
+
+struct VocabularyInfo {
+    u32 branching{10};              // children per node, branching^depth words at most
+    u32 depth{6};
+    u32 iterations{10};             // k-majority rounds per node, fewer once no assignment changes
+    u64 seed{0};
+};
+
+// NOTE: Sparse tf-idf histogram of one image, words ascending and weights summing to one
+struct BowVector {
+    std::vector<u32> words;
+    std::vector<f32> weights;
+
+    [[nodiscard]] bool Empty() const noexcept { return words.empty(); }
+    [[nodiscard]] u32 Size() const noexcept { return static_cast<u32>(words.size()); }
+    void Clear() noexcept {
+        words.clear();
+        weights.clear();
+    }
+};
+
+// NOTE: L1 similarity of two BowVectors, 1 - |a - b| / 2, in [0, 1]. Both are L1-normalized, so
+// it reduces to the sum of min(a, b) over the words they share.
+[[nodiscard]] f32 Score(const BowVector& a, const BowVector& b) noexcept;
+
+// NOTE: Vocabulary tree over 256-bit binary descriptors. Every node holds the bitwise majority of
+// the descriptors clustered under it, a descriptor descends to the nearest child by Hamming distance
+// until it reaches a leaf, whose index is its word. The children of a node are contiguous, so one
+// descent step is a SIMD scan of a few adjacent descriptors.
+//
+// The tree is a flat image of the file it loads from, Load maps the file and only checks it, so a
+// vocabulary of a million words is ready in milliseconds. The file is
+//   header (32 bytes) | Descriptor center[nodes] | u32 first[nodes] | u32 count[nodes] | f32 idf[words]
+// in native byte order. first and count are the children of an inner node; a leaf has count 0 and
+// its word in first. Node 0 is the root, its center is unused.
+class Vocabulary {
+public:
+    Vocabulary() = default;
+    Vocabulary(Vocabulary&&) noexcept = default;
+    Vocabulary& operator=(Vocabulary&&) noexcept = default;
+    Vocabulary(const Vocabulary&) = delete;
+    Vocabulary& operator=(const Vocabulary&) = delete;
+
+    // NOTE: k-majority clustering of every descriptor of every image, top down. The idf weight of a
+    // word is log(images / images containing it), so the images should look like where it is used.
+    [[nodiscard]] static result<Vocabulary> Train(std::span<const Descriptors> images, const VocabularyInfo& info = {});
+
+    [[nodiscard]] static result<Vocabulary> Load(const std::filesystem::path& path);
+    [[nodiscard]] result<void> Save(const std::filesystem::path& path) const;
+
+    [[nodiscard]] bool Empty() const noexcept { return mWeights.empty(); }
+    [[nodiscard]] u32 GetWords() const noexcept { return static_cast<u32>(mWeights.size()); }
+    [[nodiscard]] u32 GetNodes() const noexcept { return static_cast<u32>(mCenters.size()); }
+    [[nodiscard]] u32 GetBranching() const noexcept { return mBranching; }
+    [[nodiscard]] u32 GetDepth() const noexcept { return mDepth; }
+    [[nodiscard]] f32 GetWeight(u32 word) const noexcept { return mWeights[word]; }
+
+    // NOTE: Word of every descriptor, out is sized to match
+    void Quantize(std::span<const Descriptor> descriptors, std::span<u32> out) const noexcept;
+
+    // NOTE: Reuses the capacity of out, so a per-frame BowVector stops allocating once warm. Words
+    // with no idf weight, those seen in every training image, are left out. An empty vocabulary
+    // gives an empty vector.
+    void Transform(std::span<const Descriptor> descriptors, BowVector& out) const;
+
+private:
+    u32 mBranching{0};
+    u32 mDepth{0};
+
+    // NOTE: Point into mFile for a loaded vocabulary and into the owned arrays for a trained one
+    std::span<const Descriptor> mCenters;
+    std::span<const u32> mFirst;
+    std::span<const u32> mCount;
+    std::span<const f32> mWeights;
+
+    memory::MappedFile mFile;
+    Descriptors mOwnedCenters;
+    std::vector<u32> mOwnedFirst;
+    std::vector<u32> mOwnedCount;
+    std::vector<f32> mOwnedWeights;
+};
+
+} // namespace ct
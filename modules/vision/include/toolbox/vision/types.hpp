@@ -1,5 +1,7 @@
 #pragma once
 #include "toolbox/math/math.hpp"
+#include "toolbox/vision/features/descriptor.hpp"
+#include "toolbox/vision/features/keypoints.hpp"
 #include <vector>
 
 #include <opencv2/core.hpp>
@@ -9,13 +11,15 @@ namespace ct {
 
 using Timestamp = double;
 
+// NOTE: Keypoints as separate arrays and one packed 256-bit descriptor per keypoint, contiguous and
+// 32-byte aligned. features/convert.hpp produces cv::KeyPoint / cv::Mat when OpenCV needs them.
 struct Frame {
     Timestamp timestamp{0.0};
-    std::vector<cv::KeyPoint> kps;
-    cv::Mat des;
+    Keypoints kps;
+    Descriptors des;
 
     bool valid() const {
-        return !des.empty() && !kps.empty() && des.rows == static_cast<int>(kps.size());
+        return !kps.Empty() && des.size() == kps.Size();
     }
 };
 
@@ -27,6 +31,19 @@ struct Pose {
     vec3d translation{0.0, 0.0, 0.0};
 };
 
+// NOTE: A Pose maps coordinates of one frame into another, X_b = R X_a + t. Compose(a, b) applies b
+// first, so Compose(T_cb, T_ba) = T_ca.
+[[nodiscard]] inline vec3d Transform(const Pose& pose, const vec3d& x) { return pose.rotation * x + pose.translation; }
+
+[[nodiscard]] inline Pose Inverse(const Pose& pose) {
+    const mat3d rt = pose.rotation.transpose();
+    return {rt, -(rt * pose.translation)};
+}
+
+[[nodiscard]] inline Pose Compose(const Pose& a, const Pose& b) {
+    return {a.rotation * b.rotation, a.rotation * b.translation + a.translation};
+}
+
 using Poses = std::vector<Pose>;
 
 } // namespace ct
@@ -8,6 +8,34 @@
 
 #include "sensors/camera.hpp"
 
+#include "image/view.hpp"
+#include "image/image.hpp"
+#include "image/kernels.hpp"
+#include "image/pyramid.hpp"
+
+#include "features/keypoints.hpp"
+#include "features/descriptor.hpp"
+#include "features/corners.hpp"
+#include "features/orb.hpp"
+#include "features/grid.hpp"
+#include "features/matcher.hpp"
+#include "features/convert.hpp"
+
+#include "geometry/five_point.hpp"
+#include "geometry/essential.hpp"
+#include "geometry/ransac.hpp"
+#include "geometry/relative_pose.hpp"
+#include "geometry/p3p.hpp"
+#include "geometry/pnp.hpp"
+#include "geometry/triangulation.hpp"
+
+#include "map/map_points.hpp"
+#include "map/keyframes.hpp"
+#include "map/backend.hpp"
+
+#include "place/vocabulary.hpp"
+#include "place/database.hpp"
+
 #include "frontend/frontend.hpp"
 
 // IWYU pragma: end_exports
@@ -0,0 +1,58 @@
+#include "toolbox/vision/features/convert.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <numbers>
+
+namespace ct {
+
+void ToKeyPoints(const Keypoints& kps, std::vector<cv::KeyPoint>& out, f32 size) {
+    constexpr f32 kToDegrees = 180.0f / std::numbers::pi_v<f32>;
+
+    out.clear();
+    out.reserve(kps.Size());
+    for (std::size_t i = 0; i < kps.Size(); ++i) {
+        f32 degrees = kps.angle[i] * kToDegrees;
+        if (degrees < 0.0f) degrees += 360.0f;
+        out.emplace_back(cv::Point2f(kps.x[i], kps.y[i]), size, degrees, kps.response[i],
+            static_cast<int>(kps.octave[i]));
+    }
+}
+
+void FromKeyPoints(std::span<const cv::KeyPoint> kps, Keypoints& out) {
+    constexpr f32 kToRadians = std::numbers::pi_v<f32> / 180.0f;
+
+    out.Clear();
+    out.Reserve(kps.size());
+    for (const cv::KeyPoint& kp : kps) {
+        // NOTE: Unoriented keypoints (-1) map to 0, the rest from [0, 360) to [-pi, pi]
+        f32 degrees = std::max(kp.angle, 0.0f);
+        if (degrees > 180.0f) degrees -= 360.0f;
+        out.Push(kp.pt.x, kp.pt.y, degrees * kToRadians, kp.response,
+            static_cast<u8>(std::clamp(kp.octave, 0, 255)));
+    }
+}
+
+void ToMat(std::span<const Descriptor> des, cv::Mat& out) {
+    const int rows = static_cast<int>(des.size());
+    out.create(rows, static_cast<int>(Descriptor::kBytes), CV_8UC1);
+    for (int r = 0; r < rows; ++r) {
+        std::memcpy(out.ptr<u8>(r), des[static_cast<std::size_t>(r)].words.data(), Descriptor::kBytes);
+    }
+}
+
+void PackDescriptors(const cv::Mat& des, Descriptors& out) {
+    out.clear();
+    if (des.empty()) return;
+
+    assert(des.type() == CV_8UC1);
+    assert(des.cols == static_cast<int>(Descriptor::kBytes));
+
+    out.resize(static_cast<std::size_t>(des.rows));
+    for (int r = 0; r < des.rows; ++r) {
+        std::memcpy(out[static_cast<std::size_t>(r)].words.data(), des.ptr<u8>(r), Descriptor::kBytes);
+    }
+}
+
+} // namespace ct
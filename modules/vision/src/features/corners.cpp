@@ -0,0 +1,240 @@
+#include "toolbox/vision/features/corners.hpp"
+
+#include <array>
+#include <bit>
+#include <cmath>
+
+#if defined(TOOLBOX_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
+
+namespace ct {
+
+namespace {
+
+using FastRowKernel = u32 (*)(GrayView, i32, i32, i32, u8, i32*) noexcept;
+using ScoreKernel = void (*)(GrayView, i32, std::span<const i32>, CornerScore, f32, f32*) noexcept;
+
+// NOTE: Bresenham circle of radius 3, clockwise from 12 o'clock
+constexpr std::array<std::array<i32, 2>, 16> kCircle{{{0, -3}, {1, -3}, {2, -2}, {3, -1}, {3, 0},
+    {3, 1}, {2, 2}, {1, 3}, {0, 3}, {-1, 3}, {-2, 2}, {-3, 1}, {-3, 0}, {-3, -1}, {-2, -2},
+    {-1, -3}}};
+
+TOOLBOX_FORCE_INLINE std::array<std::ptrdiff_t, 16> CircleOffsets(std::ptrdiff_t stride) noexcept {
+    std::array<std::ptrdiff_t, 16> off{};
+    for (std::size_t k = 0; k < 16; ++k) off[k] = kCircle[k][1] * stride + kCircle[k][0];
+    return off;
+}
+
+// NOTE: Bit k of the 16-bit mask is circle pixel k, doubling the mask makes the arc circular
+TOOLBOX_FORCE_INLINE bool HasArc9(u32 mask) noexcept {
+    const u32 m = mask | (mask << 16);
+    const u32 a2 = m & (m >> 1);
+    const u32 a4 = a2 & (a2 >> 2);
+    const u32 a8 = a4 & (a4 >> 4);
+    return (a8 & (m >> 8) & 0xffffu) != 0;
+}
+
+TOOLBOX_FORCE_INLINE u32 FastRowBody(const u8* row, const std::array<std::ptrdiff_t, 16>& off,
+    i32 x0, i32 x1, u8 threshold, i32* xs) noexcept {
+    u32 n = 0;
+    for (i32 x = x0; x < x1; ++x) {
+        const u8* p = row + x;
+        const i32 hi = p[0] + threshold;
+        const i32 lo = p[0] - threshold;
+
+        // NOTE: Any 9-arc covers two neighbouring compass pixels (0, 4, 8, 12)
+        const u32 cb = u32{p[off[0]] > hi} | u32{p[off[4]] > hi} << 1 | u32{p[off[8]] > hi} << 2 |
+                       u32{p[off[12]] > hi} << 3;
+        const u32 cd = u32{p[off[0]] < lo} | u32{p[off[4]] < lo} << 1 | u32{p[off[8]] < lo} << 2 |
+                       u32{p[off[12]] < lo} << 3;
+        const u32 rb = (cb >> 1) | ((cb & 1u) << 3);
+        const u32 rd = (cd >> 1) | ((cd & 1u) << 3);
+        if ((cb & rb) == 0 && (cd & rd) == 0) continue;
+
+        u32 bright = 0, dark = 0;
+        for (u32 k = 0; k < 16; ++k) {
+            const i32 v = p[off[k]];
+            bright |= u32{v > hi} << k;
+            dark |= u32{v < lo} << k;
+        }
+        if (HasArc9(bright) || HasArc9(dark)) xs[n++] = x;
+    }
+    return n;
+}
+
+u32 FastRowScalar(GrayView image, i32 y, i32 x0, i32 x1, u8 threshold, i32* xs) noexcept {
+    return FastRowBody(image.Row(y), CircleOffsets(image.stride), x0, x1, threshold, xs);
+}
+
+// NOTE: Integer structure tensor, exact in every variant so scores do not depend on the CPU
+struct Moments {
+    i32 xx{0};
+    i32 yy{0};
+    i32 xy{0};
+};
+
+TOOLBOX_FORCE_INLINE Moments MomentsBody(GrayView image, i32 x, i32 y) noexcept {
+    Moments m;
+    for (i32 dy = -3; dy <= 3; ++dy) {
+        const u8* r0 = image.Row(y + dy - 1);
+        const u8* r1 = image.Row(y + dy);
+        const u8* r2 = image.Row(y + dy + 1);
+        for (i32 c = x - 3; c <= x + 3; ++c) {
+            const i32 gx = (r0[c + 1] - r0[c - 1]) + 2 * (r1[c + 1] - r1[c - 1]) + (r2[c + 1] - r2[c - 1]);
+            const i32 gy = (r2[c - 1] + 2 * r2[c] + r2[c + 1]) - (r0[c - 1] + 2 * r0[c] + r0[c + 1]);
+            m.xx += gx * gx;
+            m.yy += gy * gy;
+            m.xy += gx * gy;
+        }
+    }
+    return m;
+}
+
+TOOLBOX_FORCE_INLINE f32 Score(const Moments& m, CornerScore score, f32 harrisK) noexcept {
+    const double a = m.xx, b = m.xy, c = m.yy;
+    if (score == CornerScore::Harris) return static_cast<f32>(a * c - b * b - harrisK * (a + c) * (a + c));
+    const double h = 0.5 * (a - c);
+    return static_cast<f32>(0.5 * (a + c) - std::sqrt(h * h + b * b));
+}
+
+void ScoreScalar(GrayView image, i32 y, std::span<const i32> xs, CornerScore score, f32 harrisK,
+    f32* out) noexcept {
+    for (std::size_t i = 0; i < xs.size(); ++i) out[i] = Score(MomentsBody(image, xs[i], y), score, harrisK);
+}
+
+#if defined(TOOLBOX_CPU_DISPATCH)
+
+TOOLBOX_TARGET_SSE42 TOOLBOX_FORCE_INLINE __m128i Load8(const u8* p) noexcept {
+    return _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+
+TOOLBOX_TARGET_SSE42 TOOLBOX_FORCE_INLINE i32 HorizontalSum(__m128i v) noexcept {
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+}
+
+// NOTE: One window row per step, lane i is column x - 3 + i in 16 bits, lane 7 is masked off.
+// pmaddwd squares and pairs the gradients straight into 32-bit accumulators.
+TOOLBOX_TARGET_SSE42 TOOLBOX_FORCE_INLINE Moments MomentsSse(GrayView image, i32 x, i32 y) noexcept {
+    const __m128i mask = _mm_setr_epi16(-1, -1, -1, -1, -1, -1, -1, 0);
+    __m128i xx = _mm_setzero_si128(), yy = _mm_setzero_si128(), xy = _mm_setzero_si128();
+    for (i32 dy = -3; dy <= 3; ++dy) {
+        const u8* r0 = image.Row(y + dy - 1) + x;
+        const u8* r1 = image.Row(y + dy) + x;
+        const u8* r2 = image.Row(y + dy + 1) + x;
+        const __m128i l0 = Load8(r0 - 4), m0 = Load8(r0 - 3), h0 = Load8(r0 - 2);
+        const __m128i l1 = Load8(r1 - 4), h1 = Load8(r1 - 2);
+        const __m128i l2 = Load8(r2 - 4), m2 = Load8(r2 - 3), h2 = Load8(r2 - 2);
+
+        __m128i gx = _mm_add_epi16(_mm_add_epi16(_mm_sub_epi16(h0, l0), _mm_sub_epi16(h2, l2)),
+            _mm_slli_epi16(_mm_sub_epi16(h1, l1), 1));
+        __m128i gy = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(l2, h2), _mm_slli_epi16(m2, 1)),
+            _mm_add_epi16(_mm_add_epi16(l0, h0), _mm_slli_epi16(m0, 1)));
+        gx = _mm_and_si128(gx, mask);
+        gy = _mm_and_si128(gy, mask);
+
+        xx = _mm_add_epi32(xx, _mm_madd_epi16(gx, gx));
+        yy = _mm_add_epi32(yy, _mm_madd_epi16(gy, gy));
+        xy = _mm_add_epi32(xy, _mm_madd_epi16(gx, gy));
+    }
+    return {HorizontalSum(xx), HorizontalSum(yy), HorizontalSum(xy)};
+}
+
+TOOLBOX_TARGET_SSE42 void ScoreSse42(GrayView image, i32 y, std::span<const i32> xs, CornerScore score,
+    f32 harrisK, f32* out) noexcept {
+    for (std::size_t i = 0; i < xs.size(); ++i) out[i] = Score(MomentsSse(image, xs[i], y), score, harrisK);
+}
+
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE __m256i LoadBiased(const u8* p, __m256i bias) noexcept {
+    return _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), bias);
+}
+
+// NOTE: Lane-wise "9 contiguous of 16" by doubling runs: 2 -> 4 -> 8 -> 8 + 1
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE __m256i AnyArc9(const __m256i (&m)[16]) noexcept {
+    __m256i a2[16], a4[16];
+    for (std::size_t k = 0; k < 16; ++k) a2[k] = _mm256_and_si256(m[k], m[(k + 1) & 15]);
+    for (std::size_t k = 0; k < 16; ++k) a4[k] = _mm256_and_si256(a2[k], a2[(k + 2) & 15]);
+    __m256i any = _mm256_setzero_si256();
+    for (std::size_t k = 0; k < 16; ++k) {
+        const __m256i a8 = _mm256_and_si256(a4[k], a4[(k + 4) & 15]);
+        any = _mm256_or_si256(any, _mm256_and_si256(a8, m[(k + 8) & 15]));
+    }
+    return any;
+}
+
+// NOTE: 32 pixels per step. Unsigned compares become signed ones after flipping the top bit and
+// saturating add/sub keeps center +- threshold in range, so results equal the scalar test.
+TOOLBOX_TARGET_AVX2 u32 FastRowAvx2(GrayView image, i32 y, i32 x0, i32 x1, u8 threshold, i32* xs) noexcept {
+    const u8* row = image.Row(y);
+    const std::array<std::ptrdiff_t, 16> off = CircleOffsets(image.stride);
+    const __m256i bias = _mm256_set1_epi8(static_cast<char>(0x80));
+    const __m256i t = _mm256_set1_epi8(static_cast<char>(threshold));
+
+    u32 n = 0;
+    i32 x = x0;
+    for (; x + 32 <= x1; x += 32) {
+        const u8* p = row + x;
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i hi = _mm256_xor_si256(_mm256_adds_epu8(c, t), bias);
+        const __m256i lo = _mm256_xor_si256(_mm256_subs_epu8(c, t), bias);
+
+        __m256i b[16], d[16];
+        for (std::size_t k = 0; k < 16; k += 4) {
+            const __m256i v = LoadBiased(p + off[k], bias);
+            b[k] = _mm256_cmpgt_epi8(v, hi);
+            d[k] = _mm256_cmpgt_epi8(lo, v);
+        }
+        const __m256i quick = _mm256_or_si256(
+            _mm256_or_si256(_mm256_and_si256(b[0], b[4]), _mm256_and_si256(b[4], b[8])),
+            _mm256_or_si256(_mm256_and_si256(b[8], b[12]), _mm256_and_si256(b[12], b[0])));
+        const __m256i quickDark = _mm256_or_si256(
+            _mm256_or_si256(_mm256_and_si256(d[0], d[4]), _mm256_and_si256(d[4], d[8])),
+            _mm256_or_si256(_mm256_and_si256(d[8], d[12]), _mm256_and_si256(d[12], d[0])));
+        const __m256i maybe = _mm256_or_si256(quick, quickDark);
+        if (_mm256_testz_si256(maybe, maybe)) continue;
+
+        for (std::size_t k = 0; k < 16; ++k) {
+            if ((k & 3) == 0) continue;
+            const __m256i v = LoadBiased(p + off[k], bias);
+            b[k] = _mm256_cmpgt_epi8(v, hi);
+            d[k] = _mm256_cmpgt_epi8(lo, v);
+        }
+        u32 bits = static_cast<u32>(_mm256_movemask_epi8(_mm256_or_si256(AnyArc9(b), AnyArc9(d))));
+        while (bits) {
+            xs[n++] = x + std::countr_zero(bits);
+            bits &= bits - 1;
+        }
+    }
+    return n + FastRowBody(row, off, x, x1, threshold, xs + n);
+}
+
+#endif
+
+constexpr cpu::KernelTable<FastRowKernel> kFastRowKernels{
+    .scalar = FastRowScalar,
+#if defined(TOOLBOX_CPU_DISPATCH)
+    .avx2 = FastRowAvx2,
+#endif
+};
+
+constexpr cpu::KernelTable<ScoreKernel> kScoreKernels{
+    .scalar = ScoreScalar,
+#if defined(TOOLBOX_CPU_DISPATCH)
+    .sse42 = ScoreSse42,
+#endif
+};
+
+} // namespace
+
+u32 DetectFastRow(GrayView image, i32 y, i32 x0, i32 x1, u8 threshold, i32* xs) noexcept {
+    return kFastRowKernels.Get()(image, y, x0, x1, threshold, xs);
+}
+
+void ScoreCorners(GrayView image, i32 y, std::span<const i32> xs, CornerScore score, f32 harrisK,
+    f32* out) noexcept {
+    kScoreKernels.Get()(image, y, xs, score, harrisK, out);
+}
+
+} // namespace ct
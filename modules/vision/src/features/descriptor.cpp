@@ -0,0 +1,289 @@
+#include "toolbox/vision/features/descriptor.hpp"
+
+#include <algorithm>
+
+#if defined(TOOLBOX_CPU_DISPATCH)
+#include <immintrin.h>
+
+#define TOOLBOX_TARGET_AVX512_VPOPCNT                                                              \
+    __attribute__((target("avx512vpopcntdq,avx512f,avx512bw,avx512vl,avx512dq,avx2,fma,bmi,bmi2,"  \
+                          "popcnt")))
+#endif
+
+namespace ct {
+
+namespace {
+
+constexpr u32 kNone = HammingNeighbors::kNone;
+
+using NeighborKernel = void (*)(std::span<const Descriptor>, std::span<const Descriptor>,
+    HammingNeighbors&) noexcept;
+
+// NOTE: Ties keep the lower index, SIMD lanes are merged out of order so the check is explicit
+TOOLBOX_FORCE_INLINE void Offer(u32 d, u32 idx, u32& best, u32& second, u32& index) noexcept {
+    if (d < best || (d == best && idx < index)) {
+        second = best;
+        best = d;
+        index = idx;
+    } else if (d < second) {
+        second = d;
+    }
+}
+
+// NOTE: Scalar scan of train[begin, end) for one query, also the tail of the SIMD kernels
+TOOLBOX_FORCE_INLINE void ScanRange(const Descriptor& q, u32 qi, const Descriptor* train,
+    std::size_t begin, std::size_t end, u32& best, u32& second, u32& index, u32* trainBest,
+    u32* trainIndex) noexcept {
+    for (std::size_t j = begin; j < end; ++j) {
+        const u32 d = q.Distance(train[j]);
+        Offer(d, static_cast<u32>(j), best, second, index);
+        if (d < trainBest[j]) {
+            trainBest[j] = d;
+            trainIndex[j] = qi;
+        }
+    }
+}
+
+TOOLBOX_FORCE_INLINE void NeighborsBody(std::span<const Descriptor> query,
+    std::span<const Descriptor> train, HammingNeighbors& out) noexcept {
+    for (std::size_t i = 0; i < query.size(); ++i) {
+        u32 best = kNone, second = kNone, index = kNone;
+        ScanRange(query[i], static_cast<u32>(i), train.data(), 0, train.size(), best, second,
+            index, out.trainBest.data(), out.trainIndex.data());
+        out.queryBest[i] = best;
+        out.querySecond[i] = second;
+        out.queryIndex[i] = index;
+    }
+}
+
+void NeighborsScalar(std::span<const Descriptor> query, std::span<const Descriptor> train,
+    HammingNeighbors& out) noexcept {
+    NeighborsBody(query, train, out);
+}
+
+#if defined(TOOLBOX_CPU_DISPATCH)
+
+// NOTE: Same loop, std::popcount lowers to the POPCNT instruction instead of bit tricks
+TOOLBOX_TARGET_SSE42 void NeighborsSse42(std::span<const Descriptor> query,
+    std::span<const Descriptor> train, HammingNeighbors& out) noexcept {
+    NeighborsBody(query, train, out);
+}
+
+// NOTE: Per-lane best / second best / index of one query over train blocks of eight. Lane l sees
+// train indices j = l (mod 8), the lanes are merged once per query.
+struct LaneNeighbors {
+    __m256i best;
+    __m256i second;
+    __m256i index;
+};
+
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE __m256i LoadDescriptor(const Descriptor& d) noexcept {
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(d.words.data()));
+}
+
+// NOTE: Popcount of every byte through a 4-bit lookup table (vpshufb)
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE __m256i ByteCounts(__m256i v) noexcept {
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2,
+        1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, nibble));
+    const __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+    return _mm256_add_epi8(lo, hi);
+}
+
+// NOTE: Distances of q to t[0..3] as four u16 in the low 64 bits. Each 64-bit partial count is at
+// most 64, so four of them share a lane in 16-bit fields and one horizontal sum finishes all four.
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE __m128i Distances4Avx2(__m256i q, const Descriptor* t) noexcept {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i s0 = _mm256_sad_epu8(ByteCounts(_mm256_xor_si256(q, LoadDescriptor(t[0]))), zero);
+    const __m256i s1 = _mm256_sad_epu8(ByteCounts(_mm256_xor_si256(q, LoadDescriptor(t[1]))), zero);
+    const __m256i s2 = _mm256_sad_epu8(ByteCounts(_mm256_xor_si256(q, LoadDescriptor(t[2]))), zero);
+    const __m256i s3 = _mm256_sad_epu8(ByteCounts(_mm256_xor_si256(q, LoadDescriptor(t[3]))), zero);
+    const __m256i s = _mm256_or_si256(_mm256_or_si256(s0, _mm256_slli_epi64(s1, 16)),
+        _mm256_or_si256(_mm256_slli_epi64(s2, 32), _mm256_slli_epi64(s3, 48)));
+    const __m128i h = _mm_add_epi64(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+    return _mm_add_epi64(h, _mm_unpackhi_epi64(h, h));
+}
+
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE __m256i Distances8Avx2(__m256i q, const Descriptor* t) noexcept {
+    const __m128i lo = Distances4Avx2(q, t);
+    const __m128i hi = Distances4Avx2(q, t + 4);
+    return _mm256_cvtepu16_epi32(_mm_unpacklo_epi64(lo, hi));
+}
+
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE LaneNeighbors InitLanes() noexcept {
+    const __m256i none = _mm256_set1_epi32(-1);
+    return {none, none, none};
+}
+
+// NOTE: Branch-free update with the distances of train[j..j+7], query side in registers, train
+// side read-modify-written in place. Strict comparisons keep the first index on ties.
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE void Track(LaneNeighbors& lanes, __m256i d, std::size_t j,
+    __m256i qi, u32* trainBest, u32* trainIndex) noexcept {
+    const __m256i ji = _mm256_add_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+        _mm256_set1_epi32(static_cast<int>(j)));
+
+    const __m256i not_better = _mm256_cmpeq_epi32(_mm256_max_epu32(lanes.best, d), d);
+    lanes.second = _mm256_min_epu32(lanes.second, _mm256_max_epu32(lanes.best, d));
+    lanes.index = _mm256_blendv_epi8(ji, lanes.index, not_better);
+    lanes.best = _mm256_min_epu32(lanes.best, d);
+
+    __m256i* tb = reinterpret_cast<__m256i*>(trainBest + j);
+    __m256i* ti = reinterpret_cast<__m256i*>(trainIndex + j);
+    const __m256i best = _mm256_loadu_si256(tb);
+    const __m256i keep = _mm256_cmpeq_epi32(_mm256_max_epu32(best, d), d);
+    _mm256_storeu_si256(ti, _mm256_blendv_epi8(qi, _mm256_loadu_si256(ti), keep));
+    _mm256_storeu_si256(tb, _mm256_min_epu32(best, d));
+}
+
+// NOTE: Merges the lanes, scans the train tail that does not fill a block and stores the result
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE void Finish(const LaneNeighbors& lanes, std::size_t i,
+    std::span<const Descriptor> query, std::span<const Descriptor> train, std::size_t tail,
+    HammingNeighbors& out) noexcept {
+    alignas(32) u32 best[8];
+    alignas(32) u32 second[8];
+    alignas(32) u32 index[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(best), lanes.best);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(second), lanes.second);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(index), lanes.index);
+
+    u32 b = kNone, s = kNone, k = kNone;
+    for (u32 l = 0; l < 8; ++l) {
+        Offer(best[l], index[l], b, s, k);
+        s = std::min(s, second[l]);
+    }
+    ScanRange(query[i], static_cast<u32>(i), train.data(), tail, train.size(), b, s, k,
+        out.trainBest.data(), out.trainIndex.data());
+
+    out.queryBest[i] = b;
+    out.querySecond[i] = s;
+    out.queryIndex[i] = k;
+}
+
+TOOLBOX_TARGET_AVX2 void NeighborsAvx2(std::span<const Descriptor> query,
+    std::span<const Descriptor> train, HammingNeighbors& out) noexcept {
+    const std::size_t blocks = train.size() & ~std::size_t{7};
+    for (std::size_t i = 0; i < query.size(); ++i) {
+        const __m256i q = LoadDescriptor(query[i]);
+        const __m256i qi = _mm256_set1_epi32(static_cast<int>(i));
+        LaneNeighbors lanes = InitLanes();
+        for (std::size_t j = 0; j < blocks; j += 8) {
+            Track(lanes, Distances8Avx2(q, train.data() + j), j, qi, out.trainBest.data(),
+                out.trainIndex.data());
+        }
+        Finish(lanes, i, query, train, blocks, out);
+    }
+}
+
+// NOTE: GCC 12 flags the _mm512_undefined_* placeholders inside the AVX-512 intrinsic headers
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+// NOTE: Two descriptors per ZMM register, paired as (t[k], t[k + 4]) so that after the 16-bit
+// packing the low half sums to the distances of t[0..3] and the high half to t[4..7]
+TOOLBOX_TARGET_AVX512 TOOLBOX_FORCE_INLINE __m512i LoadPair(const Descriptor* t, std::size_t k) noexcept {
+    return _mm512_inserti64x4(_mm512_castsi256_si512(LoadDescriptor(t[k])), LoadDescriptor(t[k + 4]), 1);
+}
+
+TOOLBOX_TARGET_AVX512 TOOLBOX_FORCE_INLINE __m256i PackDistances8(__m512i p0, __m512i p1, __m512i p2,
+    __m512i p3) noexcept {
+    const __m512i s = _mm512_or_si512(_mm512_or_si512(p0, _mm512_slli_epi64(p1, 16)),
+        _mm512_or_si512(_mm512_slli_epi64(p2, 32), _mm512_slli_epi64(p3, 48)));
+    const __m512i t = _mm512_add_epi64(s, _mm512_shuffle_epi32(s, _MM_PERM_BADC));
+    const __m512i u = _mm512_add_epi64(t, _mm512_shuffle_i64x2(t, t, _MM_SHUFFLE(2, 3, 0, 1)));
+    const __m128i lo = _mm512_castsi512_si128(u);
+    const __m128i hi = _mm512_extracti64x2_epi64(u, 2);
+    return _mm256_cvtepu16_epi32(_mm_unpacklo_epi64(lo, hi));
+}
+
+TOOLBOX_TARGET_AVX512 TOOLBOX_FORCE_INLINE __m512i CountsAvx512(__m512i v) noexcept {
+    const __m512i lut = _mm512_broadcast_i32x4(
+        _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4));
+    const __m512i nibble = _mm512_set1_epi8(0x0f);
+    const __m512i lo = _mm512_shuffle_epi8(lut, _mm512_and_si512(v, nibble));
+    const __m512i hi = _mm512_shuffle_epi8(lut, _mm512_and_si512(_mm512_srli_epi16(v, 4), nibble));
+    return _mm512_sad_epu8(_mm512_add_epi8(lo, hi), _mm512_setzero_si512());
+}
+
+TOOLBOX_TARGET_AVX512 void NeighborsAvx512(std::span<const Descriptor> query,
+    std::span<const Descriptor> train, HammingNeighbors& out) noexcept {
+    const std::size_t blocks = train.size() & ~std::size_t{7};
+    for (std::size_t i = 0; i < query.size(); ++i) {
+        const __m256i q = LoadDescriptor(query[i]);
+        const __m512i q2 = _mm512_broadcast_i64x4(q);
+        const __m256i qi = _mm256_set1_epi32(static_cast<int>(i));
+        LaneNeighbors lanes = InitLanes();
+        for (std::size_t j = 0; j < blocks; j += 8) {
+            const Descriptor* t = train.data() + j;
+            const __m256i d = PackDistances8(CountsAvx512(_mm512_xor_si512(q2, LoadPair(t, 0))),
+                CountsAvx512(_mm512_xor_si512(q2, LoadPair(t, 1))),
+                CountsAvx512(_mm512_xor_si512(q2, LoadPair(t, 2))),
+                CountsAvx512(_mm512_xor_si512(q2, LoadPair(t, 3))));
+            Track(lanes, d, j, qi, out.trainBest.data(), out.trainIndex.data());
+        }
+        Finish(lanes, i, query, train, blocks, out);
+    }
+}
+
+// NOTE: Ice Lake and later count 64-bit words directly (vpopcntq), no lookup table
+TOOLBOX_TARGET_AVX512_VPOPCNT void NeighborsAvx512Vpopcnt(std::span<const Descriptor> query,
+    std::span<const Descriptor> train, HammingNeighbors& out) noexcept {
+    const std::size_t blocks = train.size() & ~std::size_t{7};
+    for (std::size_t i = 0; i < query.size(); ++i) {
+        const __m256i q = LoadDescriptor(query[i]);
+        const __m512i q2 = _mm512_broadcast_i64x4(q);
+        const __m256i qi = _mm256_set1_epi32(static_cast<int>(i));
+        LaneNeighbors lanes = InitLanes();
+        for (std::size_t j = 0; j < blocks; j += 8) {
+            const Descriptor* t = train.data() + j;
+            const __m256i d = PackDistances8(_mm512_popcnt_epi64(_mm512_xor_si512(q2, LoadPair(t, 0))),
+                _mm512_popcnt_epi64(_mm512_xor_si512(q2, LoadPair(t, 1))),
+                _mm512_popcnt_epi64(_mm512_xor_si512(q2, LoadPair(t, 2))),
+                _mm512_popcnt_epi64(_mm512_xor_si512(q2, LoadPair(t, 3))));
+            Track(lanes, d, j, qi, out.trainBest.data(), out.trainIndex.data());
+        }
+        Finish(lanes, i, query, train, blocks, out);
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+constexpr cpu::KernelTable<NeighborKernel> kNeighborKernels{
+    .scalar = NeighborsScalar,
+#if defined(TOOLBOX_CPU_DISPATCH)
+    .sse42 = NeighborsSse42,
+    .avx2 = NeighborsAvx2,
+    .avx512 = NeighborsAvx512,
+#endif
+};
+
+NeighborKernel SelectKernel() noexcept {
+    const cpu::SimdLevel level = cpu::GetLevel();
+#if defined(TOOLBOX_CPU_DISPATCH)
+    if (level == cpu::SimdLevel::AVX512 && cpu::GetFeatures().avx512vpopcntdq) {
+        return NeighborsAvx512Vpopcnt;
+    }
+#endif
+    return kNeighborKernels.Get(level);
+}
+
+} // namespace
+
+void FindNeighbors(std::span<const Descriptor> query, std::span<const Descriptor> train,
+    HammingNeighbors& out) {
+    out.queryBest.resize(query.size());
+    out.querySecond.resize(query.size());
+    out.queryIndex.resize(query.size());
+    out.trainBest.assign(train.size(), kNone);
+    out.trainIndex.assign(train.size(), kNone);
+
+    SelectKernel()(query, train, out);
+}
+
+} // namespace ct
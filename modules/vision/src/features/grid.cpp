@@ -0,0 +1,83 @@
+#include "toolbox/vision/features/grid.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace ct {
+
+void FeatureGrid::Build(const Keypoints& kps, f32 cellSize) {
+    assert(cellSize > 0.0f);
+
+    const std::size_t n = kps.Size();
+    mCellStart.clear();
+    mIndices.resize(n);
+    mCells.resize(n);
+    mX.resize(n);
+    mY.resize(n);
+    mCols = mRows = 0;
+    if (n == 0) return;
+
+    f32 maxX = kps.x[0], maxY = kps.y[0];
+    mMinX = maxX;
+    mMinY = maxY;
+    for (std::size_t i = 0; i < n; ++i) {
+        mMinX = std::min(mMinX, kps.x[i]);
+        mMinY = std::min(mMinY, kps.y[i]);
+        maxX = std::max(maxX, kps.x[i]);
+        maxY = std::max(maxY, kps.y[i]);
+    }
+
+    mInvCell = 1.0f / cellSize;
+    mCols = static_cast<u32>((maxX - mMinX) * mInvCell) + 1;
+    mRows = static_cast<u32>((maxY - mMinY) * mInvCell) + 1;
+
+    // NOTE: Counting sort, histogram -> prefix sum -> scatter
+    mCellStart.assign(static_cast<std::size_t>(mCols) * mRows + 1, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        const u32 cx = std::min(static_cast<u32>((kps.x[i] - mMinX) * mInvCell), mCols - 1);
+        const u32 cy = std::min(static_cast<u32>((kps.y[i] - mMinY) * mInvCell), mRows - 1);
+        mCells[i] = cy * mCols + cx;
+        ++mCellStart[mCells[i] + 1];
+    }
+    for (std::size_t c = 1; c < mCellStart.size(); ++c) mCellStart[c] += mCellStart[c - 1];
+
+    mCursor.assign(mCellStart.begin(), mCellStart.end() - 1);
+    for (u32 i = 0; i < static_cast<u32>(n); ++i) {
+        const u32 k = mCursor[mCells[i]]++;
+        mIndices[k] = i;
+        mX[k] = kps.x[i];
+        mY[k] = kps.y[i];
+    }
+}
+
+void FeatureGrid::Query(f32 x, f32 y, f32 radius, std::vector<u32>& out) const {
+    if (Empty()) return;
+
+    // NOTE: Window in cell units relative to the grid origin, it may extend past either side
+    const f32 x0 = (x - radius - mMinX) * mInvCell;
+    const f32 x1 = (x + radius - mMinX) * mInvCell;
+    const f32 y0 = (y - radius - mMinY) * mInvCell;
+    const f32 y1 = (y + radius - mMinY) * mInvCell;
+    if (x1 < 0.0f || y1 < 0.0f || x0 >= static_cast<f32>(mCols) || y0 >= static_cast<f32>(mRows))
+        return;
+
+    const u32 cx0 = static_cast<u32>(std::max(x0, 0.0f));
+    const u32 cy0 = static_cast<u32>(std::max(y0, 0.0f));
+    const u32 cx1 = std::min(static_cast<u32>(x1), mCols - 1);
+    const u32 cy1 = std::min(static_cast<u32>(y1), mRows - 1);
+    const f32 r2 = radius * radius;
+
+    for (u32 cy = cy0; cy <= cy1; ++cy) {
+        for (u32 cx = cx0; cx <= cx1; ++cx) {
+            const u32 cell = cy * mCols + cx;
+            for (u32 k = mCellStart[cell]; k < mCellStart[cell + 1]; ++k) {
+                const f32 dx = mX[k] - x;
+                const f32 dy = mY[k] - y;
+                if (dx * dx + dy * dy <= r2) out.push_back(mIndices[k]);
+            }
+        }
+    }
+}
+
+} // namespace ct
@@ -0,0 +1,101 @@
+#include "toolbox/vision/features/matcher.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace ct {
+
+HammingMatcher::HammingMatcher(const HammingMatcherInfo& info) : mInfo(info) {}
+
+void HammingMatcher::Match(
+    std::span<const Descriptor> query, std::span<const Descriptor> train, Matches& out) {
+    out.clear();
+    if (query.empty() || train.empty()) return;
+
+    FindNeighbors(query, train, mNeighbors);
+    const HammingNeighbors& nn = mNeighbors;
+
+    for (std::size_t i = 0; i < query.size(); ++i) {
+        const u32 j = nn.queryIndex[i];
+        if (!Accept(nn.queryBest[i], nn.querySecond[i])) continue;
+        if (mInfo.crossCheck && nn.trainIndex[j] != i) continue;
+        out.emplace_back(static_cast<int>(i), static_cast<int>(j), static_cast<f32>(nn.queryBest[i]));
+    }
+    Select(out);
+}
+
+void HammingMatcher::MatchGuided(std::span<const Descriptor> query, const FeatureGrid& queryGrid,
+    std::span<const Descriptor> train, std::span<const cv::Point2f> predicted, f32 radius,
+    Matches& out) {
+    assert(predicted.size() == train.size());
+
+    out.clear();
+    if (query.empty() || train.empty()) return;
+
+    // NOTE: Roles are swapped, the search runs per train descriptor so its side of mNeighbors
+    // (query*) holds train results and the reverse side (train*) the nearest train per query
+    HammingNeighbors& nn = mNeighbors;
+    nn.queryBest.resize(train.size());
+    nn.querySecond.resize(train.size());
+    nn.queryIndex.resize(train.size());
+    nn.trainBest.assign(query.size(), HammingNeighbors::kNone);
+    nn.trainIndex.assign(query.size(), HammingNeighbors::kNone);
+
+    for (std::size_t t = 0; t < train.size(); ++t) {
+        mCandidates.clear();
+        queryGrid.Query(predicted[t].x, predicted[t].y, radius, mCandidates);
+
+        u32 best = HammingNeighbors::kNone, second = HammingNeighbors::kNone;
+        u32 index = HammingNeighbors::kNone;
+        for (const u32 q : mCandidates) {
+            const u32 d = train[t].Distance(query[q]);
+            if (d < best || (d == best && q < index)) {
+                second = best;
+                best = d;
+                index = q;
+            } else if (d < second) {
+                second = d;
+            }
+            if (d < nn.trainBest[q]) {
+                nn.trainBest[q] = d;
+                nn.trainIndex[q] = static_cast<u32>(t);
+            }
+        }
+        nn.queryBest[t] = best;
+        nn.querySecond[t] = second;
+        nn.queryIndex[t] = index;
+    }
+
+    for (std::size_t t = 0; t < train.size(); ++t) {
+        const u32 q = nn.queryIndex[t];
+        if (q == HammingNeighbors::kNone || !Accept(nn.queryBest[t], nn.querySecond[t])) continue;
+        if (mInfo.crossCheck && nn.trainIndex[q] != t) continue;
+        out.emplace_back(static_cast<int>(q), static_cast<int>(t), static_cast<f32>(nn.queryBest[t]));
+    }
+    Select(out);
+}
+
+bool HammingMatcher::Accept(u32 best, u32 second) const noexcept {
+    if (best > mInfo.maxDistance) return false;
+    if (mInfo.ratio >= 1.0f) return true;
+    // NOTE: A lone candidate (small train set, sparse guided window) is compared against the
+    // distance of unrelated descriptors, half the bits, instead of being dropped
+    const u32 reference = second == HammingNeighbors::kNone ? Descriptor::kBits / 2 : second;
+    return static_cast<f32>(best) < mInfo.ratio * static_cast<f32>(reference);
+}
+
+void HammingMatcher::Select(Matches& out) const {
+    const auto stronger = [](const ct::Match& a, const ct::Match& b) {
+        return a.distance < b.distance || (a.distance == b.distance && a.queryIdx < b.queryIdx);
+    };
+
+    // NOTE: Select the N best in linear time, then sort only those
+    if (mInfo.maxMatches > 0 && out.size() > mInfo.maxMatches) {
+        const auto nth = out.begin() + static_cast<std::ptrdiff_t>(mInfo.maxMatches);
+        std::nth_element(out.begin(), nth, out.end(), stronger);
+        out.erase(nth, out.end());
+    }
+    std::sort(out.begin(), out.end(), stronger);
+}
+
+} // namespace ct
@@ -0,0 +1,420 @@
+#include "toolbox/vision/features/orb.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <span>
+
+namespace ct {
+
+namespace {
+
+constexpr i32 kRadius = OrbExtractor::kPatchRadius;
+constexpr f32 kEmpty = std::numeric_limits<f32>::lowest();
+
+using Pattern = std::array<std::array<i32, 4>, Descriptor::kBits>;
+
+// NOTE: BRIEF pairs drawn isotropic Gaussian around the center (sigma = patch / 5) and kept
+// inside the patch disc so every rotation stays inside the patch. Fixed seed, same on every run.
+const Pattern& BriefPattern() {
+    static const Pattern pattern = [] {
+        u64 state = 0x2545f4914f6cdd1dull;
+        const auto uniform = [&state] {
+            state += 0x9e3779b97f4a7c15ull;
+            u64 z = state;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            z ^= z >> 31;
+            return static_cast<double>(z >> 11) * 0x1.0p-53;
+        };
+        const double sigma = (2.0 * kRadius + 1.0) / 5.0;
+        const auto point = [&](i32& x, i32& y) {
+            do {
+                const double r = sigma * std::sqrt(-2.0 * std::log(1.0 - uniform()));
+                const double a = 2.0 * std::numbers::pi * uniform();
+                x = static_cast<i32>(std::lround(r * std::cos(a)));
+                y = static_cast<i32>(std::lround(r * std::sin(a)));
+            } while (x * x + y * y > kRadius * kRadius);
+        };
+
+        Pattern p{};
+        for (auto& pair : p) {
+            do {
+                point(pair[0], pair[1]);
+                point(pair[2], pair[3]);
+            } while (pair[0] == pair[2] && pair[1] == pair[3]);
+        }
+        return p;
+    }();
+    return pattern;
+}
+
+} // namespace
+
+OrbExtractor::OrbExtractor(const OrbExtractorInfo& info) : mInfo(info) {
+    for (i32 v = 0; v <= kRadius; ++v) {
+        mUMax[static_cast<std::size_t>(v)] =
+            static_cast<i32>(std::floor(std::sqrt(static_cast<double>(kRadius * kRadius - v * v)) + 0.5));
+    }
+}
+
+void OrbExtractor::Extract(GrayView gray, Keypoints& kps, Descriptors& des) {
+    Detect(gray, kps);
+    Describe(gray, kps, des);
+}
+
+// NOTE: Tiles cover [kBorder, size - kBorder) in row-major order. Every tile detects on its own,
+// a tile without any corner is retried with minFastThreshold so flat regions still contribute,
+// then the per-tile lists are concatenated in tile order so the result does not depend on the
+// number of threads.
+void OrbExtractor::Detect(GrayView gray, Keypoints& kps) {
+    kps.Clear();
+    mCandidates.Clear();
+
+    const i32 x0 = kBorder, x1 = gray.width - kBorder;
+    const i32 y0 = kBorder, y1 = gray.height - kBorder;
+    if (x1 <= x0 || y1 <= y0) return;
+
+    const i32 size = std::max(mInfo.tileSize, 16);
+    const i32 cols = (x1 - x0 + size - 1) / size;
+    const i32 rows = (y1 - y0 + size - 1) / size;
+    const std::size_t count = static_cast<std::size_t>(cols) * static_cast<std::size_t>(rows);
+    mTiles.resize(count);
+    mScratch.resize(mInfo.pool ? mInfo.pool->GetConcurrency() : 1);
+
+    // NOTE: Which threads join a call, and so which slots run, changes from call to call. Every
+    // slot is sized for the widest tile up front, a slot running for the first time after warm-up
+    // would allocate otherwise.
+    const std::size_t width = static_cast<std::size_t>(size) + 4;
+    for (TileScratch& scratch : mScratch) {
+        for (std::size_t r = 0; r < 3; ++r) {
+            scratch.rowX[r].reserve(width);
+            scratch.rowScore[r].reserve(width);
+        }
+        scratch.scores.reserve(width);
+    }
+
+    Run(count, 1, [&](std::size_t begin, std::size_t end, u32 slot) {
+        TileScratch& scratch = mScratch[slot];
+        for (std::size_t t = begin; t < end; ++t) {
+            const i32 tx = static_cast<i32>(t % static_cast<std::size_t>(cols));
+            const i32 ty = static_cast<i32>(t / static_cast<std::size_t>(cols));
+            const Tile tile{x0 + tx * size, y0 + ty * size, std::min(x0 + (tx + 1) * size, x1),
+                std::min(y0 + (ty + 1) * size, y1)};
+            DetectTile(gray, tile, mInfo.fastThreshold, scratch, mTiles[t]);
+            if (mTiles[t].Empty() && mInfo.minFastThreshold < mInfo.fastThreshold) {
+                DetectTile(gray, tile, mInfo.minFastThreshold, scratch, mTiles[t]);
+            }
+        }
+    });
+
+    // NOTE: No exact Reserve, the candidate count changes every frame and insert grows the capacity
+    // geometrically, so a new maximum rarely reallocates
+    for (const Keypoints& t : mTiles) {
+        mCandidates.x.insert(mCandidates.x.end(), t.x.begin(), t.x.end());
+        mCandidates.y.insert(mCandidates.y.end(), t.y.begin(), t.y.end());
+        mCandidates.angle.insert(mCandidates.angle.end(), t.angle.begin(), t.angle.end());
+        mCandidates.response.insert(mCandidates.response.end(), t.response.begin(), t.response.end());
+        mCandidates.octave.insert(mCandidates.octave.end(), t.octave.begin(), t.octave.end());
+    }
+
+    if (mInfo.distribute && mCandidates.Size() > mInfo.maxFeatures) {
+        Distribute(gray, kps);
+    } else {
+        SelectStrongest(kps);
+    }
+}
+
+// NOTE: Corners of one tile. Rows and columns one pixel outside the tile (clamped to the detection
+// area) are scored as well so the 3x3 suppression at the tile edge sees the same neighbours as a
+// whole-image pass, but only pixels inside the tile are emitted. Row y is scored while row y - 1 is
+// suppressed against y - 2 and y. Neighbours earlier in raster order must be strictly weaker and
+// later ones not stronger, so a plateau keeps one. The extra iteration only flushes the last row.
+void OrbExtractor::DetectTile(GrayView gray, const Tile& tile, u8 threshold, TileScratch& scratch,
+    Keypoints& out) const {
+    out.Clear();
+
+    const i32 sx0 = std::max(tile.x0 - 1, kBorder), sx1 = std::min(tile.x1 + 1, gray.width - kBorder);
+    const i32 sy0 = std::max(tile.y0 - 1, kBorder), sy1 = std::min(tile.y1 + 1, gray.height - kBorder);
+
+    // NOTE: Dense scores are indexed by x - sx0 + 1, the padding column on each side stays empty
+    const std::size_t width = static_cast<std::size_t>(sx1 - sx0) + 2;
+    for (std::size_t r = 0; r < 3; ++r) {
+        scratch.rowX[r].resize(width);
+        scratch.rowScore[r].assign(width, kEmpty);
+        scratch.rowCount[r] = 0;
+    }
+    scratch.scores.resize(width);
+
+    const auto local = [sx0](i32 x) { return static_cast<std::size_t>(x - sx0 + 1); };
+
+    for (i32 y = sy0; y <= sy1; ++y) {
+        const std::size_t cur = static_cast<std::size_t>(y - sy0) % 3;
+        std::vector<f32>& score = scratch.rowScore[cur];
+        for (u32 k = 0; k < scratch.rowCount[cur]; ++k) score[local(scratch.rowX[cur][k])] = kEmpty;
+        scratch.rowCount[cur] = 0;
+
+        if (y < sy1) {
+            i32* xs = scratch.rowX[cur].data();
+            const u32 found = DetectFastRow(gray, y, sx0, sx1, threshold, xs);
+            ScoreCorners(gray, y, std::span<const i32>(xs, found), mInfo.score, mInfo.harrisK,
+                scratch.scores.data());
+
+            u32 kept = 0;
+            for (u32 k = 0; k < found; ++k) {
+                if (scratch.scores[k] <= 0.0f) continue;
+                xs[kept++] = xs[k];
+                score[local(xs[k])] = scratch.scores[k];
+            }
+            scratch.rowCount[cur] = kept;
+        }
+
+        const i32 ym = y - 1;
+        if (ym < tile.y0 || ym >= tile.y1) continue;
+        const std::size_t mid = static_cast<std::size_t>(ym - sy0) % 3;
+        const f32* up = scratch.rowScore[(mid + 2) % 3].data();
+        const f32* row = scratch.rowScore[mid].data();
+        const f32* down = score.data();
+        for (u32 k = 0; k < scratch.rowCount[mid]; ++k) {
+            const i32 xi = scratch.rowX[mid][k];
+            if (xi < tile.x0 || xi >= tile.x1) continue;
+            const std::size_t x = local(xi);
+            const f32 s = row[x];
+            if (s > up[x - 1] && s > up[x] && s > up[x + 1] && s > row[x - 1] && s >= row[x + 1] &&
+                s >= down[x - 1] && s >= down[x] && s >= down[x + 1]) {
+                out.Push(static_cast<f32>(xi), static_cast<f32>(ym), 0.0f, s);
+            }
+        }
+    }
+}
+
+// NOTE: Strongest first, selection is linear and only the kept ones are sorted
+void OrbExtractor::SelectStrongest(Keypoints& kps) {
+    const std::size_t count = mCandidates.Size();
+    const std::size_t keep = std::min<std::size_t>(count, mInfo.maxFeatures);
+    mOrder.resize(count);
+    for (u32 i = 0; i < static_cast<u32>(count); ++i) mOrder[i] = i;
+    const auto stronger = [&](u32 a, u32 b) {
+        const f32 ra = mCandidates.response[a], rb = mCandidates.response[b];
+        return ra > rb || (ra == rb && a < b);
+    };
+    if (keep < count) {
+        std::nth_element(mOrder.begin(), mOrder.begin() + static_cast<std::ptrdiff_t>(keep), mOrder.end(), stronger);
+    }
+    std::sort(mOrder.begin(), mOrder.begin() + static_cast<std::ptrdiff_t>(keep), stronger);
+
+    kps.Reserve(keep);
+    for (std::size_t i = 0; i < keep; ++i) {
+        const u32 k = mOrder[i];
+        kps.Push(mCandidates.x[k], mCandidates.y[k], 0.0f, mCandidates.response[k], mCandidates.octave[k]);
+    }
+}
+
+// NOTE: Quadtree over the detection area. The most populated node is split into its four quadrants
+// (empty ones dropped) until there are maxFeatures non-empty nodes or every node holds a single
+// corner, then each node contributes its strongest corner. Dense regions end up with small nodes
+// and sparse ones with large nodes, so the result covers the image instead of clustering on the
+// most textured object. Nodes are ranges of mOrder partitioned in place, nothing is allocated once
+// the buffers have grown.
+void OrbExtractor::Distribute(GrayView gray, Keypoints& kps) {
+    const std::size_t target = mInfo.maxFeatures;
+    const std::size_t count = mCandidates.Size();
+    mOrder.resize(count);
+    for (u32 i = 0; i < static_cast<u32>(count); ++i) mOrder[i] = i;
+
+    mNodes.clear();
+    mHeap.clear();
+    mLeaves.clear();
+    mNodes.push_back({static_cast<f32>(kBorder), static_cast<f32>(kBorder), static_cast<f32>(gray.width - kBorder),
+        static_cast<f32>(gray.height - kBorder), 0, static_cast<u32>(count)});
+
+    // NOTE: Largest node first, ties by creation order so the split sequence is deterministic
+    const auto fewer = [&](u32 a, u32 b) {
+        const u32 na = mNodes[a].end - mNodes[a].begin, nb = mNodes[b].end - mNodes[b].begin;
+        return na < nb || (na == nb && a > b);
+    };
+    mHeap.push_back(0);
+
+    std::size_t nodes = 1;
+    while (nodes < target && !mHeap.empty()) {
+        std::pop_heap(mHeap.begin(), mHeap.end(), fewer);
+        const u32 id = mHeap.back();
+        mHeap.pop_back();
+        const Node node = mNodes[id];
+        if (node.end - node.begin < 2) {
+            mLeaves.push_back(id);
+            break;
+        }
+
+        // NOTE: Corners sit on distinct pixels, a node below one pixel cannot separate them further
+        if (node.x1 - node.x0 < 1.0f && node.y1 - node.y0 < 1.0f) {
+            mLeaves.push_back(id);
+            continue;
+        }
+
+        const f32 mx = 0.5f * (node.x0 + node.x1), my = 0.5f * (node.y0 + node.y1);
+        const auto first = mOrder.begin() + node.begin;
+        const auto last = mOrder.begin() + node.end;
+        const auto top = std::partition(first, last, [&](u32 k) { return mCandidates.y[k] < my; });
+        const auto topLeft = std::partition(first, top, [&](u32 k) { return mCandidates.x[k] < mx; });
+        const auto bottomLeft = std::partition(top, last, [&](u32 k) { return mCandidates.x[k] < mx; });
+
+        const auto offset = [&](auto it) { return static_cast<u32>(it - mOrder.begin()); };
+        const std::array<Node, 4> children{{
+            {node.x0, node.y0, mx, my, node.begin, offset(topLeft)},
+            {mx, node.y0, node.x1, my, offset(topLeft), offset(top)},
+            {node.x0, my, mx, node.y1, offset(top), offset(bottomLeft)},
+            {mx, my, node.x1, node.y1, offset(bottomLeft), node.end},
+        }};
+
+        --nodes;
+        for (const Node& child : children) {
+            if (child.begin == child.end) continue;
+            ++nodes;
+            const u32 cid = static_cast<u32>(mNodes.size());
+            mNodes.push_back(child);
+            if (child.end - child.begin == 1) {
+                mLeaves.push_back(cid);
+            } else {
+                mHeap.push_back(cid);
+                std::push_heap(mHeap.begin(), mHeap.end(), fewer);
+            }
+        }
+    }
+    mLeaves.insert(mLeaves.end(), mHeap.begin(), mHeap.end());
+
+    // NOTE: Strongest corner per node, ties to the earlier candidate. The last split can overshoot
+    // the target by up to three nodes, those are trimmed by response like the plain selection.
+    const auto stronger = [&](u32 a, u32 b) {
+        const f32 ra = mCandidates.response[a], rb = mCandidates.response[b];
+        return ra > rb || (ra == rb && a < b);
+    };
+    for (u32& leaf : mLeaves) {
+        const Node& node = mNodes[leaf];
+        leaf = *std::min_element(mOrder.begin() + node.begin, mOrder.begin() + node.end, stronger);
+    }
+    const std::size_t keep = std::min(mLeaves.size(), target);
+    if (keep < mLeaves.size()) {
+        std::nth_element(mLeaves.begin(), mLeaves.begin() + static_cast<std::ptrdiff_t>(keep), mLeaves.end(), stronger);
+    }
+    std::sort(mLeaves.begin(), mLeaves.begin() + static_cast<std::ptrdiff_t>(keep), stronger);
+
+    kps.Reserve(keep);
+    for (std::size_t i = 0; i < keep; ++i) {
+        const u32 k = mLeaves[i];
+        kps.Push(mCandidates.x[k], mCandidates.y[k], 0.0f, mCandidates.response[k], mCandidates.octave[k]);
+    }
+}
+
+void OrbExtractor::Describe(GrayView gray, Keypoints& kps, Descriptors& des) {
+    des.resize(kps.Size());
+    if (kps.Empty()) return;
+
+    Smooth(gray);
+    UpdateOffsets(static_cast<std::ptrdiff_t>(gray.width));
+
+    // NOTE: Keypoints are independent once the blurred image exists, chunks keep the per-task
+    // overhead small against the ~1 us per descriptor
+    Run(kps.Size(), 64, [&](std::size_t begin, std::size_t end, u32) { DescribeRange(gray, kps, des, begin, end); });
+}
+
+void OrbExtractor::DescribeRange(GrayView gray, Keypoints& kps, Descriptors& des, std::size_t begin,
+    std::size_t end) const {
+    constexpr f32 kBinWidth = 2.0f * std::numbers::pi_v<f32> / static_cast<f32>(kAngleBins);
+    constexpr i32 kBins = static_cast<i32>(kAngleBins);
+    const std::size_t stride = static_cast<std::size_t>(gray.width);
+
+    for (std::size_t i = begin; i < end; ++i) {
+        const i32 x = static_cast<i32>(std::lround(kps.x[i]));
+        const i32 y = static_cast<i32>(std::lround(kps.y[i]));
+        assert(x >= kBorder && y >= kBorder && x < gray.width - kBorder && y < gray.height - kBorder);
+
+        const f32 angle = Orientation(gray, x, y);
+        kps.angle[i] = angle;
+
+        const i32 bin = ((static_cast<i32>(std::lround(angle / kBinWidth)) % kBins) + kBins) % kBins;
+        const std::ptrdiff_t* off = mOffsets.data() + static_cast<std::size_t>(bin) * 2 * Descriptor::kBits;
+        const u8* center = mBlurred.data() + static_cast<std::size_t>(y) * stride + static_cast<std::size_t>(x);
+
+        Descriptor& d = des[i];
+        for (std::size_t w = 0; w < d.words.size(); ++w) {
+            u64 word = 0;
+            for (u32 b = 0; b < 64; ++b) {
+                const std::ptrdiff_t* pair = off + 2 * (w * 64 + b);
+                word |= u64{center[pair[0]] < center[pair[1]]} << b;
+            }
+            d.words[w] = word;
+        }
+    }
+}
+
+// NOTE: Serial on the calling thread without a pool or when there is a single chunk of work
+void OrbExtractor::Run(std::size_t count, std::size_t grain, const ThreadPool::RangeFn& fn) {
+    if (mInfo.pool && count > grain) {
+        mInfo.pool->ParallelFor(count, grain, fn);
+    } else if (count > 0) {
+        fn(0, count, 0);
+    }
+}
+
+// NOTE: Angle of the intensity centroid over the patch disc, rows are paired around the center
+f32 OrbExtractor::Orientation(GrayView gray, i32 x, i32 y) const noexcept {
+    const u8* c = &gray(x, y);
+    i32 m10 = 0, m01 = 0;
+    for (i32 u = -kRadius; u <= kRadius; ++u) m10 += u * c[u];
+
+    for (i32 v = 1; v <= kRadius; ++v) {
+        const i32 d = mUMax[static_cast<std::size_t>(v)];
+        const u8* below = c + v * gray.stride;
+        const u8* above = c - v * gray.stride;
+        i32 sum = 0;
+        for (i32 u = -d; u <= d; ++u) {
+            const i32 b = below[u], a = above[u];
+            sum += b - a;
+            m10 += u * (b + a);
+        }
+        m01 += v * sum;
+    }
+    return std::atan2(static_cast<f32>(m01), static_cast<f32>(m10));
+}
+
+// NOTE: 5-tap binomial blur (sigma ~ 1) in row bands, BRIEF tests on raw pixels are noise dominated
+void OrbExtractor::Smooth(GrayView gray) {
+    const std::size_t w = static_cast<std::size_t>(gray.width);
+    const std::size_t h = static_cast<std::size_t>(gray.height);
+    mBlurred.resize(w * h);
+    mScratch.resize(mInfo.pool ? mInfo.pool->GetConcurrency() : 1);
+    for (TileScratch& scratch : mScratch) scratch.blur.reserve(w + kBinomial5.size() - 1);
+
+    const ImageView<u8> blurred{mBlurred.data(), gray.width, gray.height, static_cast<std::ptrdiff_t>(w)};
+    Run(h, 32, [&](std::size_t begin, std::size_t end, u32 slot) {
+        GaussianBlurRows(gray, blurred, kBinomial5, static_cast<i32>(begin), static_cast<i32>(end), mScratch[slot].blur);
+    });
+}
+
+// NOTE: Pattern rotated into every angle bin as pixel offsets, recomputed only when the stride of
+// the blurred image changes
+void OrbExtractor::UpdateOffsets(std::ptrdiff_t stride) {
+    if (stride == mOffsetStride && !mOffsets.empty()) return;
+    mOffsetStride = stride;
+
+    const Pattern& pattern = BriefPattern();
+    mOffsets.resize(static_cast<std::size_t>(kAngleBins) * 2 * Descriptor::kBits);
+    for (u32 bin = 0; bin < kAngleBins; ++bin) {
+        const double a = 2.0 * std::numbers::pi * bin / kAngleBins;
+        const double ca = std::cos(a), sa = std::sin(a);
+        std::ptrdiff_t* off = mOffsets.data() + static_cast<std::size_t>(bin) * 2 * Descriptor::kBits;
+        for (std::size_t k = 0; k < pattern.size(); ++k) {
+            for (std::size_t p = 0; p < 2; ++p) {
+                const double px = pattern[k][2 * p], py = pattern[k][2 * p + 1];
+                const i32 rx = std::clamp(static_cast<i32>(std::lround(ca * px - sa * py)), -kRadius, kRadius);
+                const i32 ry = std::clamp(static_cast<i32>(std::lround(sa * px + ca * py)), -kRadius, kRadius);
+                off[2 * k + p] = ry * stride + rx;
+            }
+        }
+    }
+}
+
+} // namespace ct
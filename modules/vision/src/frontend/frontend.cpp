@@ -4,8 +4,46 @@
 
 namespace ct {
 
+namespace {
+
+// NOTE: An explicit extractor pool wins over the frontend one
+OrbExtractorInfo ExtractorInfo(const FrontendInfo& info) {
+    OrbExtractorInfo extractor = info.extractor;
+    if (!extractor.pool) extractor.pool = info.pool.get();
+    return extractor;
+}
+
+// NOTE: Matching only reads the full resolution image, optical flow needs every level padded by
+// the window so cv::calcOpticalFlowPyrLK accepts the pyramid as prebuilt
+ImagePyramidInfo PyramidInfo(const FrontendInfo& info) {
+    if (info.mode != TrackingMode::OpticalFlow) return {.levels = 1};
+    return {.levels = info.flowLevels + 1, .border = info.flowWindow, .minSize = info.flowWindow};
+}
+
+// NOTE: Optical flow tracks come in no particular order, PROSAC would only favour old tracks. An
+// explicit pool wins here too.
+RelativePoseInfo PoseInfo(const FrontendInfo& info) {
+    RelativePoseInfo pose = info.relativePose;
+    if (!pose.pool) pose.pool = info.pool.get();
+    if (info.mode == TrackingMode::OpticalFlow) pose.prosac = false;
+    return pose;
+}
+
+// NOTE: The frontend pool unless the PnP settings name their own
+PnpInfo PnpEstimatorInfo(const FrontendInfo& info) {
+    PnpInfo pnp = info.pnp;
+    if (!pnp.pool) pnp.pool = info.pool.get();
+    return pnp;
+}
+
+} // namespace
+
 Frontend::Frontend(const FrontendInfo& info)
-    : mInfo(info), mOrb(cv::ORB::create()), mMatcher(cv::NORM_HAMMING) {}
+    : mInfo(info), mPyramid(PyramidInfo(info)), mPrevPyramid(PyramidInfo(info)),
+      mExtractor(ExtractorInfo(info)), mMatcher(info.matcher), mRelativePose(PoseInfo(info)),
+      mKeyframes(info.keyframes), mPnp(PnpEstimatorInfo(info)) {
+    if (mInfo.mapTracking && mInfo.localBA) mBackend = std::make_unique<MappingBackend>(mInfo.backend);
+}
 
 Frontend::~Frontend() = default;
 
@@ -15,113 +53,313 @@ result<Pose> Frontend::Estimate(const cv::Mat& image, Timestamp ts) {
     if (image.type() != CV_8UC3)
         return err(ErrorCode::INVALID_ARGUMENT, "Input image must be CV_8UC3");
 
-    cv::cvtColor(image, mGray, cv::COLOR_BGR2GRAY);
+    mPyramid.Build(ViewOf<const u8, 3>(image));
 
-    Frame frame = DetectFeatures(mGray, ts);
+    if (mInfo.mode == TrackingMode::OpticalFlow) return EstimateFlow();
+    return EstimateMatching(ts);
+}
 
-    if (!frame.valid()) {
-        mPrevFrame = std::move(frame);
+// NOTE: With a local map the frame is tracked against it. Without one, or once map tracking
+// fails, the pose comes from the essential matrix against the previous frame and the map is
+// (re)initialized from that pair.
+result<Pose> Frontend::EstimateMatching(Timestamp ts) {
+    ++mFrameIndex;
+    DetectFeatures(mPyramid.Mat(0), ts, mFrame);
+
+    if (!mFrame.valid()) {
+        mMotion.reset();
+        ResetMap();
+        std::swap(mFrame, mPrevFrame);
         return err(ErrorCode::UNKNOWN_ERROR, "Failed to detect valid features");
     }
 
     if (!mPrevFrame.valid()) {
-        mPrevFrame = std::move(frame);
+        mMotion.reset();
+        ResetMap();
+        std::swap(mFrame, mPrevFrame);
         return err(ErrorCode::UNKNOWN_ERROR, "No previous frame yet");
     }
 
-    Matches matches = MatchFrames(frame, mPrevFrame);
-    log::Info("Detected {} features, matched {}", frame.kps.size(), matches.size());
+    if (mInfo.mapTracking && !mKeyframes.Empty()) {
+        auto pose = TrackMap();
+        if (pose) {
+            mMotion = *pose;
+            mPrevPose = mPose;
+            std::swap(mFrame, mPrevFrame);
+            return pose;
+        }
+
+        log::Warn("Lost the local map, re-initializing");
+        ResetMap();
+    }
+
+    MatchFrames(mFrame, mPrevFrame, mMatches);
+    log::Info("Detected {} features, matched {}", mFrame.kps.Size(), mMatches.size());
+
+    // NOTE: Every failure below is a tracking loss, only a recovered pose re-arms the prior
+    mMotion.reset();
+
+    // NOTE: Matches arrive best first, the order PROSAC samples in
+    mPtsCurr.clear();
+    mPtsPrev.clear();
+    for (const auto& m : mMatches) {
+        const std::size_t q = static_cast<std::size_t>(m.queryIdx);
+        const std::size_t t = static_cast<std::size_t>(m.trainIdx);
+        mPtsCurr.emplace_back(mFrame.kps.x[q], mFrame.kps.y[q]);
+        mPtsPrev.emplace_back(mPrevFrame.kps.x[t], mPrevFrame.kps.y[t]);
+    }
 
+    auto pose = RecoverPose(mPtsCurr, mPtsPrev);
+    if (pose) {
+        mMotion = *pose;
+        if (mInfo.mapTracking) InitializeMap(*pose);
+    }
+
+    mPrevPose = mPose;
+    std::swap(mFrame, mPrevFrame);
+    return pose;
+}
+
+// NOTE: Map points are projected with the constant velocity prediction and matched in a window
+// around their projection, brute force when too few are found. PnP on the matches gives the
+// pose, the keyframe manager decides from the tracked points whether the frame becomes a keyframe.
+result<Pose> Frontend::TrackMap() {
     if (!mInfo.camera) return err(ErrorCode::INVALID_ARGUMENT, "Camera is not set");
+    const auto& intrinsics = mInfo.camera->intrinsics();
+
+    ApplyBackend();
+    const Pose predicted = mMotion ? Compose(Inverse(*mMotion), mPrevPose) : mPrevPose;
+    const GrayView gray = mPyramid.Level(0);
+    MapPointStore& points = mKeyframes.GetPoints();
+    points.Project(predicted, intrinsics, static_cast<f32>(gray.width), static_cast<f32>(gray.height), mPredicted);
+    mGrid.Build(mFrame.kps, mInfo.searchRadius);
+    mMatcher.MatchGuided(mFrame.des, mGrid, points.GetDescriptors(), mPredicted, mInfo.searchRadius, mMatches);
+    if (mMatches.size() < mInfo.minMapInliers) {
+        log::Warn("Guided map matching found {} matches, falling back to brute force", mMatches.size());
+        mMatcher.Match(mFrame.des, points.GetDescriptors(), mMatches);
+    }
+
+    if (mMatches.size() < mInfo.minMapInliers) {
+        log::Warn("Not enough map matches: {}", mMatches.size());
+        return err(ErrorCode::UNKNOWN_ERROR, "Not enough map matches");
+    }
+
+    const std::span<const vec3d> positions = points.GetPositions();
+    mMapPoints.clear();
+    mPtsCurr.clear();
+    for (const auto& m : mMatches) {
+        const std::size_t q = static_cast<std::size_t>(m.queryIdx);
+        mMapPoints.push_back(positions[static_cast<std::size_t>(m.trainIdx)]);
+        mPtsCurr.emplace_back(mFrame.kps.x[q], mFrame.kps.y[q]);
+    }
+
+    auto absolute = mPnp.Estimate(mMapPoints, mPtsCurr, intrinsics, mInliers);
+    if (!absolute) {
+        log::Warn("Failed to find the camera pose");
+        return err(absolute.error());
+    }
+
+    if (absolute->timedOut) {
+        log::Warn("PnP budget ran out after {} samples, confidence {:.3f}", absolute->iterations,
+            absolute->confidence);
+    }
 
-    std::vector<cv::Point2f> ptsCurr, ptsPrev;
-    ptsCurr.reserve(matches.size());
-    ptsPrev.reserve(matches.size());
+    if (absolute->inliers < mInfo.minMapInliers) {
+        log::Warn("Not enough map inliers: {}", absolute->inliers);
+        return err(ErrorCode::UNKNOWN_ERROR, "Not enough map inliers");
+    }
 
-    for (const auto& m : matches) {
-        ptsCurr.push_back(frame.kps[m.queryIdx].pt);
-        ptsPrev.push_back(mPrevFrame.kps[m.trainIdx].pt);
+    mPose = absolute->pose;
+    mTracked.assign(mFrame.kps.Size(), MapPointHandle{});
+    for (std::size_t i = 0; i < mMatches.size(); ++i) {
+        if (!mInliers[i]) continue;
+        const u32 point = static_cast<u32>(mMatches[i].trainIdx);
+        points.MarkFound(point, mFrameIndex);
+        mTracked[static_cast<std::size_t>(mMatches[i].queryIdx)] = points.HandleAt(point);
+    }
+    log::Info("Tracked {} of {} map points", absolute->inliers, points.Size());
+
+    if (mKeyframes.NeedKeyframe(mFrame, mPose, mTracked, absolute->inliers)) {
+        const u32 added = mKeyframes.Insert(mFrame, mPose, mTracked, intrinsics);
+        log::Info("New keyframe triangulated {} points, {} keyframes and {} points in the local map", added,
+            mKeyframes.Size(), mKeyframes.GetPoints().Size());
+
+        if (mBackend) {
+            MapWindow& window = mBackend->Request();
+            mKeyframes.ExportWindow(mInfo.backend.window, mInfo.backend.fixed, window);
+            window.intrinsics = intrinsics;
+            mBackend->Submit();
+        }
     }
 
+    // NOTE: X_prev = T_prev,world T_world,curr X_curr
+    return ok(Compose(mPrevPose, Inverse(mPose)));
+}
+
+// NOTE: The previous camera becomes the world frame and the unit baseline of the pair the map
+// scale. Fails without enough points that pass the parallax and reprojection checks, the next
+// frame pair tries again.
+void Frontend::InitializeMap(const Pose& motion) {
+    mPose = Inverse(motion);
+    const u32 points =
+        mKeyframes.Initialize(mPrevFrame, mFrame, mPose, mMatches, mInliers, mInfo.camera->intrinsics());
+    if (points < mInfo.minMapInliers) {
+        log::Info("Map initialization triangulated {} points, waiting for more parallax", points);
+        ResetMap();
+        return;
+    }
+
+    log::Info("Initialized the local map with {} points", points);
+}
+
+// NOTE: Takes the newest refined window, if any, between two frames. The previous pose was tracked
+// against the map before the update and moves with it, so the motion prior stays valid.
+void Frontend::ApplyBackend() {
+    if (!mBackend || !mBackend->Poll()) return;
+
+    Pose correction;
+    if (!mKeyframes.Apply(mBackend->Latest(), correction)) return;
+    mPrevPose = Compose(mPrevPose, correction);
+    log::Info("Applied local bundle adjustment #{}", mBackend->Latest().version);
+}
+
+void Frontend::ResetMap() {
+    mKeyframes.Reset();
+    mPose = {};
+    mPrevPose = {};
+}
+
+// NOTE: Tracks are followed from the previous pyramid into the current one. Lost tracks and the
+// outliers of the essential matrix are dropped, new corners are only searched once fewer than
+// minTracks survive and only away from the survivors.
+result<Pose> Frontend::EstimateFlow() {
+    const cv::Size window(mInfo.flowWindow, mInfo.flowWindow);
+
+    if (mPrevPyramid.Empty() || mTracks.empty()) {
+        mTracks.clear();
+        RefillTracks();
+        std::swap(mPyramid, mPrevPyramid);
+        return err(ErrorCode::UNKNOWN_ERROR, "No previous frame yet");
+    }
+
+    cv::calcOpticalFlowPyrLK(mPrevPyramid.Mats(), mPyramid.Mats(), mTracks, mFlow, mFlowStatus,
+        mFlowError, window, mInfo.flowLevels);
+
+    const GrayView gray = mPyramid.Level(0);
+    const f32 width = static_cast<f32>(gray.width);
+    const f32 height = static_cast<f32>(gray.height);
+    std::size_t live = 0;
+    for (std::size_t i = 0; i < mTracks.size(); ++i) {
+        const cv::Point2f& p = mFlow[i];
+        if (!mFlowStatus[i] || p.x < 0.0f || p.y < 0.0f || p.x >= width || p.y >= height) continue;
+        mTracks[live] = mTracks[i];
+        mFlow[live] = p;
+        ++live;
+    }
+    mTracks.resize(live);
+    mFlow.resize(live);
+    log::Info("Tracked {} features", live);
+
+    auto pose = RecoverPose(mFlow, mTracks);
+    if (pose) {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < live; ++i) {
+            if (mInliers[i]) mFlow[kept++] = mFlow[i];
+        }
+        mFlow.resize(kept);
+    }
+
+    std::swap(mTracks, mFlow);
+    if (mTracks.size() < mInfo.minTracks) RefillTracks();
+    std::swap(mPyramid, mPrevPyramid);
+    return pose;
+}
+
+result<Pose> Frontend::RecoverPose(
+    const std::vector<cv::Point2f>& ptsCurr, const std::vector<cv::Point2f>& ptsPrev) {
+    if (!mInfo.camera) return err(ErrorCode::INVALID_ARGUMENT, "Camera is not set");
+
     if (ptsCurr.size() < 5) {
         log::Warn("Not enough matches to estimate pose: {}", ptsCurr.size());
-        mPrevFrame = std::move(frame);
         return err(ErrorCode::UNKNOWN_ERROR, "Not enough matches");
     }
 
-    // NOTE: Convert Eigen intrinsics to cv::Mat for OpenCV
-    cv::Mat K = mInfo.camera->intrinsics().cvK();
-
-    cv::Mat mask;
-    cv::Mat E = cv::findEssentialMat(ptsCurr, ptsPrev, K, cv::RANSAC, 0.999, 1.0, mask);
+    auto relative = mRelativePose.Estimate(ptsCurr, ptsPrev, mInfo.camera->intrinsics(), mInliers);
 
-    if (E.empty()) {
+    if (!relative) {
         log::Warn("Failed to find essential matrix");
-        mPrevFrame = std::move(frame);
         return err(ErrorCode::UNKNOWN_ERROR, "Essential matrix computation failed");
     }
 
-    cv::Mat R, t;
-    int inliers = cv::recoverPose(E, ptsCurr, ptsPrev, K, R, t, mask);
+    if (relative->timedOut) {
+        log::Warn("Pose budget ran out after {} samples, confidence {:.3f}", relative->iterations,
+            relative->confidence);
+    }
 
-    if (inliers < 5) {
-        log::Warn("Not enough inliers to recover pose: {}", inliers);
-        mPrevFrame = std::move(frame);
+    if (relative->inliers < 5) {
+        log::Warn("Not enough inliers to recover pose: {}", relative->inliers);
         return err(ErrorCode::UNKNOWN_ERROR, "Not enough inliers");
     }
 
-    mat3d rotation = mat3d(layout::rowm, R.at<double>(0, 0), R.at<double>(0, 1), R.at<double>(0, 2),
-        R.at<double>(1, 0), R.at<double>(1, 1), R.at<double>(1, 2), R.at<double>(2, 0),
-        R.at<double>(2, 1), R.at<double>(2, 2));
-
-    vec3d translation(t.at<double>(0), t.at<double>(1), t.at<double>(2));
-
-    // // NOTE: Convert cv::Mat R,t to Eigen Isometry3d
-    Pose pose;
-    pose.rotation = rotation;
-    pose.translation = translation;
+    return ok(relative->motion);
+}
 
-    mPrevFrame = std::move(frame);
-    return ok(std::move(pose));
+// NOTE: Tops the live tracks up to maxFeatures, live tracks mask a trackSpacing disc so new
+// corners only come from regions that are not covered yet
+void Frontend::RefillTracks() {
+    if (mTracks.size() >= mInfo.extractor.maxFeatures) return;
+
+    const cv::Mat& gray = mPyramid.Mat(0);
+    mDetectMask.create(gray.size(), CV_8UC1);
+    mDetectMask.setTo(cv::Scalar(255));
+    const int radius = static_cast<int>(mInfo.trackSpacing);
+    for (const auto& p : mTracks) cv::circle(mDetectMask, p, radius, cv::Scalar(0), cv::FILLED);
+
+    const int wanted = static_cast<int>(mInfo.extractor.maxFeatures - mTracks.size());
+    cv::goodFeaturesToTrack(
+        gray, mCorners, wanted, 0.01, static_cast<double>(mInfo.trackSpacing), mDetectMask);
+    mTracks.insert(mTracks.end(), mCorners.begin(), mCorners.end());
 }
 
-Frame Frontend::DetectFeatures(const cv::Mat& gray, Timestamp ts) {
+void Frontend::DetectFeatures(const cv::Mat& gray, Timestamp ts, Frame& frame) {
     assert(!gray.empty());
     assert(gray.type() == CV_8UC1);
 
-    std::vector<cv::Point2f> corners;
-    cv::goodFeaturesToTrack(gray, corners, 500, 0.01, 5);
-
-    std::vector<cv::KeyPoint> kps;
-    kps.reserve(corners.size());
-    for (const auto& corner : corners) kps.emplace_back(corner, 5.0f);
-
-    Frame f;
-    f.kps = std::move(kps);
-    f.timestamp = ts;
-    mOrb->compute(gray, f.kps, f.des);
-    return f;
+    frame.timestamp = ts;
+    mExtractor.Extract(ViewOf(gray), frame.kps, frame.des);
 }
 
-Matches Frontend::MatchFrames(const Frame& curr, const Frame& prev) {
-    std::vector<std::vector<cv::DMatch>> knnMatches;
-    mMatcher.knnMatch(curr.des, prev.des, knnMatches, 2);
+void Frontend::MatchFrames(const Frame& curr, const Frame& prev, Matches& matches) {
+    if (mInfo.guidedMatching && mMotion && mInfo.camera) {
+        PredictKeypoints(prev, *mMotion);
+        mGrid.Build(curr.kps, mInfo.searchRadius);
+        mMatcher.MatchGuided(curr.des, mGrid, prev.des, mPredicted, mInfo.searchRadius, matches);
+        if (matches.size() >= mInfo.minGuidedMatches) return;
 
-    Matches good;
-    good.reserve(knnMatches.size());
-    constexpr float kRatioThreshold = 0.75f;
-
-    for (const auto& m : knnMatches) {
-        if (m.size() < 2) continue;
-        if (m[0].distance < kRatioThreshold * m[1].distance) good.push_back(m[0]);
+        log::Warn("Guided matching found {} matches, falling back to brute force", matches.size());
     }
 
-    std::sort(good.begin(), good.end(),
-        [](const cv::DMatch& a, const cv::DMatch& b) { return a.distance < b.distance; });
-
-    if (good.size() > 200) good.resize(200);
+    mMatcher.Match(curr.des, prev.des, matches);
+}
 
-    return good;
+// NOTE: Constant velocity, the next frame pair is assumed to repeat the last relative motion.
+// recoverPose maps current into previous camera coordinates (X_prev = R X_curr + t), so a previous
+// keypoint moves to K R^T K^-1 x in the new image. The translation has no metric scale in a
+// monocular setup and is left to the search radius, as is the parallax of near points.
+void Frontend::PredictKeypoints(const Frame& prev, const Pose& motion) {
+    const mat3d K = mInfo.camera->intrinsics().K();
+    const mat3d H = K * motion.rotation.transpose() * K.inverse();
+
+    mPredicted.resize(prev.kps.Size());
+    for (std::size_t i = 0; i < prev.kps.Size(); ++i) {
+        const vec3d x = H * vec3d(static_cast<double>(prev.kps.x[i]), static_cast<double>(prev.kps.y[i]), 1.0);
+        // NOTE: Points rotating behind the camera get a prediction no grid cell contains
+        if (x.z <= 1e-9) {
+            mPredicted[i] = cv::Point2f(-1e6f, -1e6f);
+            continue;
+        }
+        mPredicted[i] = cv::Point2f(static_cast<f32>(x.x / x.z), static_cast<f32>(x.y / x.z));
+    }
 }
 
 } // namespace ct
@@ -0,0 +1,165 @@
+#include "toolbox/vision/geometry/essential.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#if defined(TOOLBOX_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
+
+namespace ct {
+
+namespace {
+
+// NOTE: e is E row-major, mask may be null. Returns the inlier count of [0, count).
+using SampsonKernel = u32 (*)(const f32* e, const f32* x1, const f32* y1, const f32* x2, const f32* y2,
+    std::size_t count, f32 threshold2, u8* mask) noexcept;
+
+// NOTE: r = x2^T E x1, the gradient of r is (E x1)_0,1 and (E^T x2)_0,1. Inlier when
+// r^2 < threshold2 * |grad|^2, which avoids the division. The AVX2 kernel evaluates the same
+// expressions in the same order without FMA, so both levels agree bit for bit.
+TOOLBOX_FORCE_INLINE bool SampsonInlier(const f32* e, f32 x1, f32 y1, f32 x2, f32 y2, f32 threshold2) noexcept {
+    const f32 a0 = e[0] * x1 + e[1] * y1 + e[2];
+    const f32 a1 = e[3] * x1 + e[4] * y1 + e[5];
+    const f32 a2 = e[6] * x1 + e[7] * y1 + e[8];
+    const f32 b0 = e[0] * x2 + e[3] * y2 + e[6];
+    const f32 b1 = e[1] * x2 + e[4] * y2 + e[7];
+    const f32 r = x2 * a0 + y2 * a1 + a2;
+    return r * r < threshold2 * (a0 * a0 + a1 * a1 + b0 * b0 + b1 * b1);
+}
+
+u32 SampsonScalar(const f32* e, const f32* x1, const f32* y1, const f32* x2, const f32* y2, std::size_t count,
+    f32 threshold2, u8* mask) noexcept {
+    u32 inliers = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const bool inlier = SampsonInlier(e, x1[i], y1[i], x2[i], y2[i], threshold2);
+        if (mask) mask[i] = inlier ? 1 : 0;
+        inliers += inlier ? 1u : 0u;
+    }
+    return inliers;
+}
+
+#if defined(TOOLBOX_CPU_DISPATCH)
+
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE __m256 Affine(__m256 a, __m256 x, __m256 b, __m256 y, __m256 c) noexcept {
+    return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a, x), _mm256_mul_ps(b, y)), c);
+}
+
+// NOTE: Lane bits of the 8 correspondences starting at x1
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE u32 SampsonEight(const __m256 (&e)[9], const f32* x1, const f32* y1,
+    const f32* x2, const f32* y2, __m256 threshold2) noexcept {
+    const __m256 px1 = _mm256_loadu_ps(x1), py1 = _mm256_loadu_ps(y1);
+    const __m256 px2 = _mm256_loadu_ps(x2), py2 = _mm256_loadu_ps(y2);
+    const __m256 a0 = Affine(e[0], px1, e[1], py1, e[2]);
+    const __m256 a1 = Affine(e[3], px1, e[4], py1, e[5]);
+    const __m256 a2 = Affine(e[6], px1, e[7], py1, e[8]);
+    const __m256 b0 = Affine(e[0], px2, e[3], py2, e[6]);
+    const __m256 b1 = Affine(e[1], px2, e[4], py2, e[7]);
+    const __m256 r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px2, a0), _mm256_mul_ps(py2, a1)), a2);
+    const __m256 grad = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a0, a0), _mm256_mul_ps(a1, a1)),
+        _mm256_mul_ps(b0, b0)), _mm256_mul_ps(b1, b1));
+    const __m256 inlier = _mm256_cmp_ps(_mm256_mul_ps(r, r), _mm256_mul_ps(threshold2, grad), _CMP_LT_OQ);
+    return static_cast<u32>(_mm256_movemask_ps(inlier));
+}
+
+TOOLBOX_TARGET_AVX2 u32 SampsonAvx2(const f32* e, const f32* x1, const f32* y1, const f32* x2, const f32* y2,
+    std::size_t count, f32 threshold2, u8* mask) noexcept {
+    __m256 ev[9];
+    for (std::size_t k = 0; k < 9; ++k) ev[k] = _mm256_set1_ps(e[k]);
+    const __m256 t2 = _mm256_set1_ps(threshold2);
+
+    u32 inliers = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const u32 bits = SampsonEight(ev, x1 + i, y1 + i, x2 + i, y2 + i, t2);
+        inliers += static_cast<u32>(_mm_popcnt_u32(bits));
+        if (mask) {
+            for (std::size_t k = 0; k < 8; ++k) mask[i + k] = static_cast<u8>((bits >> k) & 1u);
+        }
+    }
+
+    // NOTE: The tail goes through the vector path too, zero padded, so it rounds like the body
+    if (i < count) {
+        alignas(32) f32 tail[4][8]{};
+        const std::size_t n = count - i;
+        std::memcpy(tail[0], x1 + i, n * sizeof(f32));
+        std::memcpy(tail[1], y1 + i, n * sizeof(f32));
+        std::memcpy(tail[2], x2 + i, n * sizeof(f32));
+        std::memcpy(tail[3], y2 + i, n * sizeof(f32));
+        const u32 bits = SampsonEight(ev, tail[0], tail[1], tail[2], tail[3], t2) & ((1u << n) - 1u);
+        inliers += static_cast<u32>(_mm_popcnt_u32(bits));
+        if (mask) {
+            for (std::size_t k = 0; k < n; ++k) mask[i + k] = static_cast<u8>((bits >> k) & 1u);
+        }
+    }
+    return inliers;
+}
+
+#endif
+
+constexpr cpu::KernelTable<SampsonKernel> kSampsonKernels{
+    .scalar = SampsonScalar,
+#if defined(TOOLBOX_CPU_DISPATCH)
+    .avx2 = SampsonAvx2,
+#endif
+};
+
+void ToFloat(const mat3d& E, f32 (&e)[9]) noexcept {
+    for (std::size_t r = 0; r < 3; ++r) {
+        for (std::size_t c = 0; c < 3; ++c) e[3 * r + c] = static_cast<f32>(E(r, c));
+    }
+}
+
+} // namespace
+
+u32 CountSampsonInliers(const mat3d& E, const Correspondences& c, std::size_t begin, std::size_t end,
+    f32 threshold2) noexcept {
+    assert(begin <= end && end <= c.Size());
+    f32 e[9];
+    ToFloat(E, e);
+    return kSampsonKernels.Get()(e, c.x1.data() + begin, c.y1.data() + begin, c.x2.data() + begin,
+        c.y2.data() + begin, end - begin, threshold2, nullptr);
+}
+
+u32 SampsonInlierMask(const mat3d& E, const Correspondences& c, f32 threshold2, std::span<u8> mask) noexcept {
+    assert(mask.size() >= c.Size());
+    f32 e[9];
+    ToFloat(E, e);
+    return kSampsonKernels.Get()(e, c.x1.data(), c.y1.data(), c.x2.data(), c.y2.data(), c.Size(), threshold2,
+        mask.data());
+}
+
+// NOTE: E = U diag(1, 1, 0) V^T with U, V proper rotations (math svd keeps det = +1), so U W V^T and
+// U W^T V^T are rotations without sign fixes. t is the left null vector of E, the third column of U.
+std::array<Pose, 4> DecomposeEssential(const mat3d& E) noexcept {
+    const svd3_result<f64> d = svd(E);
+    const mat3d W(layout::rowm, 0.0, -1.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0);
+    const mat3d vt = d.v.transpose();
+    const mat3d r1 = d.u * W * vt;
+    const mat3d r2 = d.u * W.transpose() * vt;
+    const vec3d t(d.u(0, 2), d.u(1, 2), d.u(2, 2));
+
+    std::array<Pose, 4> out;
+    out[0] = {r1, t};
+    out[1] = {r1, -t};
+    out[2] = {r2, t};
+    out[3] = {r2, -t};
+    return out;
+}
+
+// NOTE: Least squares d1 R (x1, y1, 1) + t = d2 (x2, y2, 1) over the two depths
+bool TriangulateDepths(const Pose& motion, f64 x1, f64 y1, f64 x2, f64 y2, f64& depth1, f64& depth2) noexcept {
+    const vec3d a = motion.rotation * vec3d(x1, y1, 1.0);
+    const vec3d b(x2, y2, 1.0);
+    const f64 aa = a.dot(a), bb = b.dot(b), ab = a.dot(b);
+    const f64 at = a.dot(motion.translation), bt = b.dot(motion.translation);
+
+    const f64 det = aa * bb - ab * ab;
+    if (det <= 1e-12 * aa * bb) return false;
+    depth1 = (ab * bt - at * bb) / det;
+    depth2 = (aa * bt - ab * at) / det;
+    return true;
+}
+
+} // namespace ct
@@ -0,0 +1,498 @@
+#include "toolbox/vision/geometry/five_point.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace ct {
+
+namespace {
+
+// NOTE: Monomials in x, y, z up to degree 3. The cubics come first so Gauss-Jordan on the 10 x 20
+// constraint matrix expresses each of them in the 10 lower ones, which form the quotient basis
+// [x^2, xy, xz, y^2, yz, z^2, x, y, z, 1]. Quadratics are the tail from kQuadratic on, linear
+// polynomials (x, y, z, 1) the tail from kLinear on.
+struct Monomial {
+    i32 x, y, z;
+};
+
+constexpr std::array<Monomial, 20> kMonomials{{
+    {3, 0, 0}, {2, 1, 0}, {2, 0, 1}, {1, 2, 0}, {1, 1, 1}, {1, 0, 2}, {0, 3, 0}, {0, 2, 1}, {0, 1, 2}, {0, 0, 3},
+    {2, 0, 0}, {1, 1, 0}, {1, 0, 1}, {0, 2, 0}, {0, 1, 1}, {0, 0, 2},
+    {1, 0, 0}, {0, 1, 0}, {0, 0, 1},
+    {0, 0, 0},
+}};
+
+constexpr std::size_t kQuadratic = 10;
+constexpr std::size_t kLinear = 16;
+constexpr std::size_t kBasis = 10;
+
+constexpr std::size_t IndexOf(i32 x, i32 y, i32 z) {
+    for (std::size_t i = 0; i < kMonomials.size(); ++i) {
+        if (kMonomials[i].x == x && kMonomials[i].y == y && kMonomials[i].z == z) return i;
+    }
+    return kMonomials.size();
+}
+
+// NOTE: Product index tables, [i][j] is the monomial of term i times term j
+template<std::size_t A, std::size_t B>
+constexpr auto ProductTable() {
+    std::array<std::array<std::size_t, 20 - B>, 20 - A> table{};
+    for (std::size_t i = A; i < 20; ++i) {
+        for (std::size_t j = B; j < 20; ++j) {
+            const Monomial& a = kMonomials[i];
+            const Monomial& b = kMonomials[j];
+            table[i - A][j - B] = IndexOf(a.x + b.x, a.y + b.y, a.z + b.z);
+        }
+    }
+    return table;
+}
+
+constexpr auto kLinearLinear = ProductTable<kLinear, kLinear>();
+constexpr auto kQuadraticLinear = ProductTable<kQuadratic, kLinear>();
+
+using Linear = std::array<f64, 4>;
+using Quadratic = std::array<f64, 10>;
+using Cubic = std::array<f64, 20>;
+
+Quadratic Mul(const Linear& a, const Linear& b) noexcept {
+    Quadratic out{};
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < 4; ++j) out[kLinearLinear[i][j] - kQuadratic] += a[i] * b[j];
+    }
+    return out;
+}
+
+Cubic Mul(const Quadratic& a, const Linear& b) noexcept {
+    Cubic out{};
+    for (std::size_t i = 0; i < 10; ++i) {
+        for (std::size_t j = 0; j < 4; ++j) out[kQuadraticLinear[i][j]] += a[i] * b[j];
+    }
+    return out;
+}
+
+Quadratic operator+(Quadratic a, const Quadratic& b) noexcept {
+    for (std::size_t i = 0; i < a.size(); ++i) a[i] += b[i];
+    return a;
+}
+
+Quadratic operator-(Quadratic a, const Quadratic& b) noexcept {
+    for (std::size_t i = 0; i < a.size(); ++i) a[i] -= b[i];
+    return a;
+}
+
+void Accumulate(Cubic& acc, const Cubic& c, f64 scale) noexcept {
+    for (std::size_t i = 0; i < acc.size(); ++i) acc[i] += scale * c[i];
+}
+
+// NOTE: Gauss-Jordan with full pivoting on the 5 x 9 epipolar constraints, the four free columns
+// give the null space directly. Fails when the rank is below 5.
+bool NullSpace(f64 (&a)[5][9], std::array<std::array<f64, 9>, 4>& basis) noexcept {
+    std::array<std::size_t, 9> column{0, 1, 2, 3, 4, 5, 6, 7, 8};
+    f64 scale = 0.0;
+    for (const auto& row : a) {
+        for (f64 v : row) scale = std::max(scale, std::abs(v));
+    }
+
+    for (std::size_t k = 0; k < 5; ++k) {
+        std::size_t pr = k, pc = k;
+        for (std::size_t r = k; r < 5; ++r) {
+            for (std::size_t c = k; c < 9; ++c) {
+                if (std::abs(a[r][column[c]]) > std::abs(a[pr][column[pc]])) pr = r, pc = c;
+            }
+        }
+        if (std::abs(a[pr][column[pc]]) <= 1e-12 * scale) return false;
+        std::swap(a[k], a[pr]);
+        std::swap(column[k], column[pc]);
+
+        const f64 inv = 1.0 / a[k][column[k]];
+        for (f64& v : a[k]) v *= inv;
+        for (std::size_t r = 0; r < 5; ++r) {
+            if (r == k) continue;
+            const f64 f = a[r][column[k]];
+            for (std::size_t c = 0; c < 9; ++c) a[r][c] -= f * a[k][c];
+        }
+    }
+
+    for (std::size_t f = 0; f < 4; ++f) {
+        auto& v = basis[f];
+        v.fill(0.0);
+        v[column[5 + f]] = 1.0;
+        for (std::size_t r = 0; r < 5; ++r) v[column[r]] = -a[r][column[5 + f]];
+    }
+    return true;
+}
+
+// NOTE: E = x X + y Y + z Z + W misses every solution without a W component. The pivoted null
+// space puts the unit entries of X, Y, Z, W on entries of E, and structured motions (a pure
+// translation zeroes five of them) land exactly there. The basis is made orthonormal and
+// reflected so that W points along a fixed generic direction of the null space.
+void Condition(std::array<std::array<f64, 9>, 4>& basis) noexcept {
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < i; ++j) {
+            f64 dot = 0.0;
+            for (std::size_t k = 0; k < 9; ++k) dot += basis[i][k] * basis[j][k];
+            for (std::size_t k = 0; k < 9; ++k) basis[i][k] -= dot * basis[j][k];
+        }
+        f64 norm = 0.0;
+        for (f64 v : basis[i]) norm += v * v;
+        const f64 inv = 1.0 / std::sqrt(norm);
+        for (f64& v : basis[i]) v *= inv;
+    }
+
+    // NOTE: Householder H = I - 2 v v^T / v^T v with v = w - e_4 swaps e_4 and the unit vector w
+    constexpr std::array<f64, 4> kW{0.2913, -0.5381, 0.4475, 0.6556};
+    f64 wn = 0.0;
+    for (f64 v : kW) wn += v * v;
+    std::array<f64, 4> v{};
+    for (std::size_t i = 0; i < 4; ++i) v[i] = kW[i] / std::sqrt(wn);
+    v[3] -= 1.0;
+    f64 vv = 0.0;
+    for (f64 c : v) vv += c * c;
+
+    std::array<std::array<f64, 9>, 4> mixed{};
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < 4; ++j) {
+            const f64 h = (i == j ? 1.0 : 0.0) - 2.0 * v[i] * v[j] / vv;
+            for (std::size_t k = 0; k < 9; ++k) mixed[i][k] += h * basis[j][k];
+        }
+    }
+    basis = mixed;
+}
+
+// NOTE: The ten cubic constraints, det(E) = 0 and 2 E E^T E - tr(E E^T) E = 0
+void Constraints(const std::array<std::array<f64, 9>, 4>& basis, f64 (&g)[10][20]) noexcept {
+    Linear e[3][3];
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            const std::size_t k = 3 * i + j;
+            e[i][j] = {basis[0][k], basis[1][k], basis[2][k], basis[3][k]};
+        }
+    }
+
+    Cubic det = Mul(Mul(e[1][1], e[2][2]) - Mul(e[1][2], e[2][1]), e[0][0]);
+    Accumulate(det, Mul(Mul(e[1][0], e[2][2]) - Mul(e[1][2], e[2][0]), e[0][1]), -1.0);
+    Accumulate(det, Mul(Mul(e[1][0], e[2][1]) - Mul(e[1][1], e[2][0]), e[0][2]), 1.0);
+    std::copy(det.begin(), det.end(), g[0]);
+
+    Quadratic eet[3][3];
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = i; j < 3; ++j) {
+            eet[i][j] = Mul(e[i][0], e[j][0]) + Mul(e[i][1], e[j][1]) + Mul(e[i][2], e[j][2]);
+            eet[j][i] = eet[i][j];
+        }
+    }
+    const Quadratic trace = eet[0][0] + eet[1][1] + eet[2][2];
+
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            Cubic c = Mul(trace, e[i][j]);
+            for (f64& v : c) v = -v;
+            for (std::size_t k = 0; k < 3; ++k) Accumulate(c, Mul(eet[i][k], e[k][j]), 2.0);
+            std::copy(c.begin(), c.end(), g[1 + 3 * i + j]);
+        }
+    }
+}
+
+// NOTE: Gauss-Jordan with partial pivoting on the cubic columns, afterwards g = [I | C] and cubic
+// monomial i equals -C_i . basis
+bool Eliminate(f64 (&g)[10][20]) noexcept {
+    f64 scale = 0.0;
+    for (const auto& row : g) {
+        for (f64 v : row) scale = std::max(scale, std::abs(v));
+    }
+
+    for (std::size_t k = 0; k < 10; ++k) {
+        std::size_t pr = k;
+        for (std::size_t r = k + 1; r < 10; ++r) {
+            if (std::abs(g[r][k]) > std::abs(g[pr][k])) pr = r;
+        }
+        if (std::abs(g[pr][k]) <= 1e-14 * scale) return false;
+        std::swap(g[k], g[pr]);
+
+        const f64 inv = 1.0 / g[k][k];
+        for (std::size_t c = k; c < 20; ++c) g[k][c] *= inv;
+        for (std::size_t r = 0; r < 10; ++r) {
+            if (r == k) continue;
+            const f64 f = g[r][k];
+            if (f == 0.0) continue;
+            for (std::size_t c = k; c < 20; ++c) g[r][c] -= f * g[k][c];
+        }
+    }
+    return true;
+}
+
+// NOTE: x times the basis [x^2, xy, xz, y^2, yz, z^2, x, y, z, 1] gives six cubics, read off the
+// eliminated constraints, and x^2, xy, xz, x, which are basis elements. M b = x b, so b evaluated at
+// a solution is a right eigenvector with eigenvalue x.
+void ActionMatrix(const f64 (&g)[10][20], f64 (&m)[kBasis][kBasis]) noexcept {
+    for (auto& row : m) std::fill(std::begin(row), std::end(row), 0.0);
+    constexpr std::array<std::size_t, 6> kCubicRows{IndexOf(3, 0, 0), IndexOf(2, 1, 0), IndexOf(2, 0, 1),
+        IndexOf(1, 2, 0), IndexOf(1, 1, 1), IndexOf(1, 0, 2)};
+    for (std::size_t r = 0; r < kCubicRows.size(); ++r) {
+        for (std::size_t c = 0; c < kBasis; ++c) m[r][c] = -g[kCubicRows[r]][kQuadratic + c];
+    }
+    m[6][IndexOf(2, 0, 0) - kQuadratic] = 1.0;
+    m[7][IndexOf(1, 1, 0) - kQuadratic] = 1.0;
+    m[8][IndexOf(1, 0, 1) - kQuadratic] = 1.0;
+    m[9][IndexOf(1, 0, 0) - kQuadratic] = 1.0;
+}
+
+// NOTE: Eigenvalues of a general real matrix, reduction to Hessenberg form by stabilized
+// elimination and the Francis double shift QR iteration (EISPACK hqr). The arrays are 1-based to
+// stay close to the published algorithm. Returns false when the iteration does not converge.
+constexpr std::size_t kN = kBasis;
+
+void Hessenberg(f64 (&a)[kN + 1][kN + 1]) noexcept {
+    for (std::size_t m = 2; m < kN; ++m) {
+        f64 x = 0.0;
+        std::size_t i = m;
+        for (std::size_t j = m; j <= kN; ++j) {
+            if (std::abs(a[j][m - 1]) > std::abs(x)) {
+                x = a[j][m - 1];
+                i = j;
+            }
+        }
+        if (i != m) {
+            for (std::size_t j = m - 1; j <= kN; ++j) std::swap(a[i][j], a[m][j]);
+            for (std::size_t j = 1; j <= kN; ++j) std::swap(a[j][i], a[j][m]);
+        }
+        if (x == 0.0) continue;
+        for (i = m + 1; i <= kN; ++i) {
+            f64 y = a[i][m - 1];
+            if (y == 0.0) continue;
+            y /= x;
+            a[i][m - 1] = 0.0;
+            for (std::size_t j = m; j <= kN; ++j) a[i][j] -= y * a[m][j];
+            for (std::size_t j = 1; j <= kN; ++j) a[j][m] += y * a[j][i];
+        }
+    }
+}
+
+bool Eigenvalues(f64 (&a)[kN + 1][kN + 1], f64 (&wr)[kN + 1], f64 (&wi)[kN + 1]) noexcept {
+    const auto sign = [](f64 v, f64 s) { return s >= 0.0 ? std::abs(v) : -std::abs(v); };
+
+    f64 anorm = 0.0;
+    for (std::size_t i = 1; i <= kN; ++i) {
+        for (std::size_t j = std::max<std::size_t>(i - 1, 1); j <= kN; ++j) anorm += std::abs(a[i][j]);
+    }
+
+    std::ptrdiff_t nn = static_cast<std::ptrdiff_t>(kN);
+    f64 t = 0.0;
+    f64 p = 0.0, q = 0.0, r = 0.0, s = 0.0, w = 0.0, x = 0.0, y = 0.0, z = 0.0;
+    while (nn >= 1) {
+        i32 its = 0;
+        std::ptrdiff_t l = 0;
+        do {
+            for (l = nn; l >= 2; --l) {
+                s = std::abs(a[l - 1][l - 1]) + std::abs(a[l][l]);
+                if (s == 0.0) s = anorm;
+                if (std::abs(a[l][l - 1]) + s == s) {
+                    a[l][l - 1] = 0.0;
+                    break;
+                }
+            }
+            x = a[nn][nn];
+            if (l == nn) {
+                wr[nn] = x + t;
+                wi[nn--] = 0.0;
+            } else {
+                y = a[nn - 1][nn - 1];
+                w = a[nn][nn - 1] * a[nn - 1][nn];
+                if (l == nn - 1) {
+                    p = 0.5 * (y - x);
+                    q = p * p + w;
+                    z = std::sqrt(std::abs(q));
+                    x += t;
+                    if (q >= 0.0) {
+                        z = p + sign(z, p);
+                        wr[nn - 1] = wr[nn] = x + z;
+                        if (z != 0.0) wr[nn] = x - w / z;
+                        wi[nn - 1] = wi[nn] = 0.0;
+                    } else {
+                        wr[nn - 1] = wr[nn] = x + p;
+                        wi[nn - 1] = -(wi[nn] = z);
+                    }
+                    nn -= 2;
+                } else {
+                    if (its == 30) return false;
+                    if (its == 10 || its == 20) {
+                        t += x;
+                        for (std::ptrdiff_t i = 1; i <= nn; ++i) a[i][i] -= x;
+                        s = std::abs(a[nn][nn - 1]) + std::abs(a[nn - 1][nn - 2]);
+                        y = x = 0.75 * s;
+                        w = -0.4375 * s * s;
+                    }
+                    ++its;
+                    std::ptrdiff_t m = nn - 2;
+                    for (; m >= l; --m) {
+                        z = a[m][m];
+                        r = x - z;
+                        s = y - z;
+                        p = (r * s - w) / a[m + 1][m] + a[m][m + 1];
+                        q = a[m + 1][m + 1] - z - r - s;
+                        r = a[m + 2][m + 1];
+                        s = std::abs(p) + std::abs(q) + std::abs(r);
+                        p /= s;
+                        q /= s;
+                        r /= s;
+                        if (m == l) break;
+                        const f64 u = std::abs(a[m][m - 1]) * (std::abs(q) + std::abs(r));
+                        const f64 v = std::abs(p) * (std::abs(a[m - 1][m - 1]) + std::abs(z) + std::abs(a[m + 1][m + 1]));
+                        if (u + v == v) break;
+                    }
+                    for (std::ptrdiff_t i = m + 2; i <= nn; ++i) {
+                        a[i][i - 2] = 0.0;
+                        if (i != m + 2) a[i][i - 3] = 0.0;
+                    }
+                    for (std::ptrdiff_t k = m; k <= nn - 1; ++k) {
+                        if (k != m) {
+                            p = a[k][k - 1];
+                            q = a[k + 1][k - 1];
+                            r = 0.0;
+                            if (k != nn - 1) r = a[k + 2][k - 1];
+                            if ((x = std::abs(p) + std::abs(q) + std::abs(r)) != 0.0) {
+                                p /= x;
+                                q /= x;
+                                r /= x;
+                            }
+                        }
+                        if ((s = sign(std::sqrt(p * p + q * q + r * r), p)) == 0.0) continue;
+                        if (k == m) {
+                            if (l != m) a[k][k - 1] = -a[k][k - 1];
+                        } else {
+                            a[k][k - 1] = -s * x;
+                        }
+                        p += s;
+                        x = p / s;
+                        y = q / s;
+                        z = r / s;
+                        q /= p;
+                        r /= p;
+                        for (std::ptrdiff_t j = k; j <= nn; ++j) {
+                            p = a[k][j] + q * a[k + 1][j];
+                            if (k != nn - 1) {
+                                p += r * a[k + 2][j];
+                                a[k + 2][j] -= p * z;
+                            }
+                            a[k + 1][j] -= p * y;
+                            a[k][j] -= p * x;
+                        }
+                        const std::ptrdiff_t mmin = std::min(nn, k + 3);
+                        for (std::ptrdiff_t i = l; i <= mmin; ++i) {
+                            p = x * a[i][k] + y * a[i][k + 1];
+                            if (k != nn - 1) {
+                                p += z * a[i][k + 2];
+                                a[i][k + 2] -= p * r;
+                            }
+                            a[i][k + 1] -= p * q;
+                            a[i][k] -= p;
+                        }
+                    }
+                }
+            }
+        } while (l < nn - 1);
+    }
+    return true;
+}
+
+// NOTE: Null vector of M - lambda I by Gaussian elimination with full pivoting, the last pivot is
+// the (numerically) zero one and its unknown is set to 1
+bool Eigenvector(const f64 (&m)[kBasis][kBasis], f64 lambda, f64 (&v)[kBasis]) noexcept {
+    f64 a[kBasis][kBasis];
+    f64 scale = 0.0;
+    for (std::size_t i = 0; i < kBasis; ++i) {
+        for (std::size_t j = 0; j < kBasis; ++j) {
+            a[i][j] = m[i][j] - (i == j ? lambda : 0.0);
+            scale = std::max(scale, std::abs(a[i][j]));
+        }
+    }
+
+    std::array<std::size_t, kBasis> column{};
+    for (std::size_t i = 0; i < kBasis; ++i) column[i] = i;
+    for (std::size_t k = 0; k + 1 < kBasis; ++k) {
+        std::size_t pr = k, pc = k;
+        for (std::size_t r = k; r < kBasis; ++r) {
+            for (std::size_t c = k; c < kBasis; ++c) {
+                if (std::abs(a[r][column[c]]) > std::abs(a[pr][column[pc]])) pr = r, pc = c;
+            }
+        }
+        if (std::abs(a[pr][column[pc]]) <= 1e-14 * scale) return false;
+        std::swap(a[k], a[pr]);
+        std::swap(column[k], column[pc]);
+        for (std::size_t r = k + 1; r < kBasis; ++r) {
+            const f64 f = a[r][column[k]] / a[k][column[k]];
+            for (std::size_t c = k; c < kBasis; ++c) a[r][column[c]] -= f * a[k][column[c]];
+        }
+    }
+
+    v[column[kBasis - 1]] = 1.0;
+    for (std::size_t k = kBasis - 1; k-- > 0;) {
+        f64 sum = 0.0;
+        for (std::size_t c = k + 1; c < kBasis; ++c) sum += a[k][column[c]] * v[column[c]];
+        v[column[k]] = -sum / a[k][column[k]];
+    }
+    return true;
+}
+
+} // namespace
+
+u32 SolveFivePoint(const std::array<vec2d, kFivePointSample>& x1, const std::array<vec2d, kFivePointSample>& x2,
+    std::array<mat3d, kFivePointMaxSolutions>& out) noexcept {
+    // NOTE: Row i is x2_i^T E x1_i = 0 over the row-major entries of E
+    f64 a[5][9];
+    for (std::size_t i = 0; i < kFivePointSample; ++i) {
+        const f64 p1[3] = {x1[i].x, x1[i].y, 1.0};
+        const f64 p2[3] = {x2[i].x, x2[i].y, 1.0};
+        for (std::size_t r = 0; r < 3; ++r) {
+            for (std::size_t c = 0; c < 3; ++c) a[i][3 * r + c] = p2[r] * p1[c];
+        }
+    }
+
+    std::array<std::array<f64, 9>, 4> basis;
+    if (!NullSpace(a, basis)) return 0;
+    Condition(basis);
+
+    f64 g[10][20];
+    Constraints(basis, g);
+    if (!Eliminate(g)) return 0;
+
+    f64 m[kBasis][kBasis];
+    ActionMatrix(g, m);
+
+    f64 h[kN + 1][kN + 1]{};
+    for (std::size_t i = 0; i < kN; ++i) {
+        for (std::size_t j = 0; j < kN; ++j) h[i + 1][j + 1] = m[i][j];
+    }
+    Hessenberg(h);
+    f64 wr[kN + 1], wi[kN + 1];
+    if (!Eigenvalues(h, wr, wi)) return 0;
+
+    constexpr std::size_t kX = IndexOf(1, 0, 0) - kQuadratic;
+    constexpr std::size_t kY = IndexOf(0, 1, 0) - kQuadratic;
+    constexpr std::size_t kZ = IndexOf(0, 0, 1) - kQuadratic;
+    constexpr std::size_t kOne = IndexOf(0, 0, 0) - kQuadratic;
+
+    u32 count = 0;
+    for (std::size_t i = 1; i <= kN; ++i) {
+        if (std::abs(wi[i]) > 1e-10 * (1.0 + std::abs(wr[i]))) continue;
+
+        f64 v[kBasis];
+        if (!Eigenvector(m, wr[i], v) || std::abs(v[kOne]) < 1e-12) continue;
+        const f64 x = v[kX] / v[kOne], y = v[kY] / v[kOne], z = v[kZ] / v[kOne];
+
+        f64 e[9];
+        f64 norm = 0.0;
+        for (std::size_t k = 0; k < 9; ++k) {
+            e[k] = x * basis[0][k] + y * basis[1][k] + z * basis[2][k] + basis[3][k];
+            norm += e[k] * e[k];
+        }
+        if (!(norm > 0.0) || !std::isfinite(norm)) continue;
+        const f64 inv = 1.0 / std::sqrt(norm);
+        out[count++] = mat3d(layout::rowm, e[0] * inv, e[1] * inv, e[2] * inv, e[3] * inv, e[4] * inv,
+            e[5] * inv, e[6] * inv, e[7] * inv, e[8] * inv);
+    }
+    return count;
+}
+
+} // namespace ct
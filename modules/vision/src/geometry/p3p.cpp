@@ -0,0 +1,205 @@
+#include "toolbox/vision/geometry/p3p.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ct {
+
+namespace {
+
+constexpr u32 kMaxDegree = 4;
+
+// NOTE: c[0] + c[1] x + ... + c[degree] x^degree
+using Polynomial = std::array<f64, kMaxDegree + 1>;
+
+f64 Evaluate(const Polynomial& c, u32 degree, f64 x) noexcept {
+    f64 y = c[degree];
+    for (u32 i = degree; i-- > 0;) y = y * x + c[i];
+    return y;
+}
+
+// NOTE: Newton steps kept inside a bracket with a sign change, bisection whenever a step leaves it
+f64 Refine(const Polynomial& c, const Polynomial& d, u32 degree, f64 lo, f64 hi) noexcept {
+    f64 flo = Evaluate(c, degree, lo);
+    f64 x = 0.5 * (lo + hi);
+    for (i32 k = 0; k < 100; ++k) {
+        const f64 fx = Evaluate(c, degree, x);
+        if (fx == 0.0) return x;
+        if ((fx < 0.0) == (flo < 0.0)) {
+            lo = x;
+            flo = fx;
+        } else {
+            hi = x;
+        }
+
+        const f64 dx = Evaluate(d, degree - 1, x);
+        f64 next = dx != 0.0 ? x - fx / dx : lo - 1.0;
+        if (next <= lo || next >= hi) next = 0.5 * (lo + hi);
+        if (std::abs(next - x) <= 1e-15 * std::max(1.0, std::abs(x))) return next;
+        x = next;
+    }
+    return x;
+}
+
+// NOTE: Real roots in ascending order. The roots of the derivative split the line into monotone
+// pieces, each piece holds at most one root and is bracketed by them and Cauchy's bound. A
+// critical point where the polynomial (nearly) vanishes is a double root without a sign change.
+u32 RealRoots(Polynomial c, u32 degree, std::array<f64, kMaxDegree>& roots) noexcept {
+    f64 scale = 0.0;
+    for (u32 i = 0; i <= degree; ++i) scale = std::max(scale, std::abs(c[i]));
+    if (scale == 0.0) return 0;
+    while (degree > 0 && std::abs(c[degree]) <= 1e-12 * scale) --degree;
+    if (degree == 0) return 0;
+    if (degree == 1) {
+        roots[0] = -c[0] / c[1];
+        return 1;
+    }
+
+    Polynomial d{};
+    for (u32 i = 1; i <= degree; ++i) d[i - 1] = static_cast<f64>(i) * c[i];
+    std::array<f64, kMaxDegree> critical{};
+    const u32 criticals = RealRoots(d, degree - 1, critical);
+
+    f64 bound = 0.0;
+    for (u32 i = 0; i < degree; ++i) bound = std::max(bound, std::abs(c[i] / c[degree]));
+    bound += 1.0;
+
+    std::array<f64, kMaxDegree + 1> edges{};
+    u32 edgeCount = 0;
+    edges[edgeCount++] = -bound;
+    for (u32 i = 0; i < criticals; ++i) edges[edgeCount++] = std::clamp(critical[i], -bound, bound);
+    edges[edgeCount++] = bound;
+
+    const f64 tiny = 1e-12 * scale;
+    u32 count = 0;
+    for (u32 i = 0; i + 1 < edgeCount; ++i) {
+        const f64 lo = edges[i], hi = edges[i + 1];
+        const f64 flo = Evaluate(c, degree, lo), fhi = Evaluate(c, degree, hi);
+        if (i > 0 && std::abs(flo) <= tiny) {
+            if (count == 0 || roots[count - 1] != lo) roots[count++] = lo;
+            continue;
+        }
+        if (lo < hi && (flo < 0.0) != (fhi < 0.0) && std::abs(fhi) > tiny) roots[count++] = Refine(c, d, degree, lo, hi);
+    }
+    return count;
+}
+
+// NOTE: a * b for a of degree da, b of degree db
+Polynomial Multiply(const Polynomial& a, u32 da, const Polynomial& b, u32 db) noexcept {
+    Polynomial out{};
+    for (u32 i = 0; i <= da; ++i) {
+        for (u32 j = 0; j <= db; ++j) out[i + j] += a[i] * b[j];
+    }
+    return out;
+}
+
+// NOTE: Newton on the three law of cosines equations in the distances directly, a root found next
+// to a near double root of the quartic loses digits that a couple of steps recover
+void Polish(f64 a2, f64 b2, f64 c2, f64 cosA, f64 cosB, f64 cosC, vec3d& s) noexcept {
+    const auto residual = [&](const vec3d& x) {
+        return vec3d(x.y * x.y + x.z * x.z - 2.0 * x.y * x.z * cosA - a2,
+            x.x * x.x + x.z * x.z - 2.0 * x.x * x.z * cosB - b2,
+            x.x * x.x + x.y * x.y - 2.0 * x.x * x.y * cosC - c2);
+    };
+
+    vec3d r = residual(s);
+    for (i32 k = 0; k < 3; ++k) {
+        const mat3d j(layout::rowm,
+            0.0, 2.0 * (s.y - s.z * cosA), 2.0 * (s.z - s.y * cosA),
+            2.0 * (s.x - s.z * cosB), 0.0, 2.0 * (s.z - s.x * cosB),
+            2.0 * (s.x - s.y * cosC), 2.0 * (s.y - s.x * cosC), 0.0);
+        if (std::abs(j.det()) <= 1e-12 * s.length_squared() * s.length()) return;
+
+        const vec3d next = s - j.inverse() * r;
+        const vec3d rn = residual(next);
+        if (rn.length_squared() >= r.length_squared()) return;
+        s = next;
+        r = rn;
+    }
+}
+
+// NOTE: Rotation and translation with camera = R world + t for two congruent triangles. The
+// covariance is decomposed with rotation factors, so V U^T is the optimal rotation without a
+// reflection check.
+Pose Align(const std::array<vec3d, kP3PSample>& world, const std::array<vec3d, kP3PSample>& camera) noexcept {
+    vec3d pw(0.0, 0.0, 0.0), pc(0.0, 0.0, 0.0);
+    for (std::size_t i = 0; i < kP3PSample; ++i) {
+        pw = pw + world[i];
+        pc = pc + camera[i];
+    }
+    pw = pw * (1.0 / 3.0);
+    pc = pc * (1.0 / 3.0);
+
+    mat3d h{};
+    for (std::size_t i = 0; i < kP3PSample; ++i) {
+        const vec3d a = world[i] - pw, b = camera[i] - pc;
+        for (std::size_t r = 0; r < 3; ++r) {
+            for (std::size_t k = 0; k < 3; ++k) h(r, k) += a[r] * b[k];
+        }
+    }
+
+    const svd3_result<f64> d = svd(h);
+    Pose pose;
+    pose.rotation = d.v * d.u.transpose();
+    pose.translation = pc - pose.rotation * pw;
+    return pose;
+}
+
+} // namespace
+
+// NOTE: With s_i the distances along the rays, u = s2 / s1 and v = s3 / s1, the law of cosines
+// over the three triangle sides gives
+//   s1^2 (u^2 + v^2 - 2 u v cos_a) = a^2,  s1^2 (1 + v^2 - 2 v cos_b) = b^2,  s1^2 (1 + u^2 - 2 u cos_c) = c^2
+// Eliminating s1 leaves u = N(v) / D(v) with N quadratic and D linear, substituted into the third
+// equation this is the quartic N^2 - 2 cos_c N D + Q D^2 = 0. Its coefficients are built by
+// polynomial products instead of expanded by hand.
+u32 SolveP3P(const std::array<vec3d, kP3PSample>& bearings, const std::array<vec3d, kP3PSample>& points,
+    std::array<Pose, kP3PMaxSolutions>& out) noexcept {
+    const f64 a2 = (points[1] - points[2]).length_squared();
+    const f64 b2 = (points[0] - points[2]).length_squared();
+    const f64 c2 = (points[0] - points[1]).length_squared();
+    if (a2 <= 0.0 || b2 <= 0.0 || c2 <= 0.0) return 0;
+
+    // NOTE: Collinear world points leave the pose undetermined
+    if ((points[1] - points[0]).cross(points[2] - points[0]).length_squared() <= 1e-12 * b2 * c2) return 0;
+
+    const f64 cosA = bearings[1].dot(bearings[2]);
+    const f64 cosB = bearings[0].dot(bearings[2]);
+    const f64 cosC = bearings[0].dot(bearings[1]);
+
+    const f64 k = (a2 - c2) / b2;
+    const f64 q = c2 / b2;
+    const Polynomial n{1.0 + k, -2.0 * k * cosB, k - 1.0};
+    const Polynomial d{2.0 * cosC, -2.0 * cosA};
+    const Polynomial r{1.0 - q, 2.0 * q * cosB, -q};
+
+    const Polynomial nn = Multiply(n, 2, n, 2);
+    const Polynomial nd = Multiply(n, 2, d, 1);
+    const Polynomial rdd = Multiply(r, 2, Multiply(d, 1, d, 1), 2);
+    Polynomial quartic{};
+    for (u32 i = 0; i <= kMaxDegree; ++i) quartic[i] = nn[i] - 2.0 * cosC * nd[i] + rdd[i];
+
+    std::array<f64, kMaxDegree> roots{};
+    const u32 count = RealRoots(quartic, kMaxDegree, roots);
+
+    u32 solutions = 0;
+    for (u32 i = 0; i < count; ++i) {
+        const f64 v = roots[i];
+        const f64 dv = d[0] + d[1] * v;
+        const f64 base = 1.0 + v * v - 2.0 * v * cosB;
+        if (std::abs(dv) <= 1e-12 || base <= 0.0 || v <= 0.0) continue;
+
+        const f64 u = (n[0] + (n[1] + n[2] * v) * v) / dv;
+        if (u <= 0.0) continue;
+
+        const f64 s1 = std::sqrt(b2 / base);
+        vec3d distance(s1, u * s1, v * s1);
+        Polish(a2, b2, c2, cosA, cosB, cosC, distance);
+        const std::array<vec3d, kP3PSample> camera{bearings[0] * distance.x, bearings[1] * distance.y,
+            bearings[2] * distance.z};
+        out[solutions++] = Align(points, camera);
+    }
+    return solutions;
+}
+
+} // namespace ct
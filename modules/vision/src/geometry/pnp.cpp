@@ -0,0 +1,189 @@
+#include "toolbox/vision/geometry/pnp.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ct {
+
+namespace {
+
+// NOTE: Points closer to the camera plane than this (in map units) are not scored
+constexpr f64 kMinDepth = 1e-6;
+
+// NOTE: Pixel reprojection residual of one world point, evaluated on jets by the refinement
+struct Reprojection {
+    vec3d point;
+    f64 u, v;
+    f64 fx, fy, cx, cy;
+
+    template<class S>
+    bool operator()(const se3<S>& pose, std::array<S, 2>& r) const {
+        const vec<3, S> pc = pose * vec<3, S>(S(point.x), S(point.y), S(point.z));
+        if (pc.z <= kMinDepth) return false;
+        r[0] = S(fx) * pc.x / pc.z + S(cx) - S(u);
+        r[1] = S(fy) * pc.y / pc.z + S(cy) - S(v);
+        return true;
+    }
+};
+
+} // namespace
+
+PnpEstimator::PnpEstimator(const PnpInfo& info)
+    : mInfo(info), mRefiner({.max_iterations = info.refineIterations}) {}
+
+result<AbsolutePose> PnpEstimator::Estimate(std::span<const vec3d> points, std::span<const cv::Point2f> pixels,
+    const CameraIntrinsics& intrinsics, std::vector<u8>& mask) {
+    if (points.size() != pixels.size())
+        return err(ErrorCode::INVALID_ARGUMENT, "Correspondence lists differ in size");
+    if (points.size() < kP3PSample + 1) return err(ErrorCode::INVALID_ARGUMENT, "Not enough correspondences");
+    if (intrinsics.fx <= 0.0 || intrinsics.fy <= 0.0)
+        return err(ErrorCode::INVALID_ARGUMENT, "Camera intrinsics are not set");
+
+    RansacSchedule schedule(mInfo.maxIterations, mInfo.confidence, mInfo.budget);
+    const std::size_t count = points.size();
+
+    // NOTE: K^-1 applied once, the threshold moves to normalized units with the mean focal length
+    mX.resize(count);
+    mY.resize(count);
+    mZ.resize(count);
+    mU.resize(count);
+    mV.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        mX[i] = points[i].x;
+        mY[i] = points[i].y;
+        mZ[i] = points[i].z;
+        mU[i] = (static_cast<f64>(pixels[i].x) - intrinsics.cx) / intrinsics.fx;
+        mV[i] = (static_cast<f64>(pixels[i].y) - intrinsics.cy) / intrinsics.fy;
+    }
+    const f64 threshold = mInfo.threshold * 2.0 / (intrinsics.fx + intrinsics.fy);
+    mThreshold2 = threshold * threshold;
+
+    const u32 lanes = mInfo.pool ? mInfo.pool->GetConcurrency() : 1;
+    if (mLanes.size() < lanes) mLanes.resize(lanes);
+    for (u32 l = 0; l < lanes; ++l) mLanes[l].random.seed(mInfo.seed + 0x9e3779b97f4a7c15ull * (l + 1));
+
+    Pose best;
+    const auto search = [&](std::size_t begin, std::size_t end, u32) {
+        for (std::size_t l = begin; l < end; ++l) Search(mLanes[l], schedule, best);
+    };
+    if (lanes > 1) {
+        mInfo.pool->ParallelFor(lanes, 1, search);
+    } else {
+        search(0, 1, 0);
+    }
+
+    if (schedule.GetBestScore() <= kP3PSample) {
+        if (schedule.TimedOut()) return err(ErrorCode::UNKNOWN_ERROR, "Time budget ran out before a pose was found");
+        return err(ErrorCode::UNKNOWN_ERROR, "No camera pose found");
+    }
+
+    AbsolutePose out;
+    mask.resize(count);
+    out.inliers = InlierMask(best, mask);
+
+    // NOTE: The refined pose is only kept when it explains at least as many correspondences
+    if (mInfo.refine) {
+        Pose refined = best;
+        if (Refine(refined, mask, intrinsics)) {
+            const u32 before = out.inliers;
+            const u32 after = InlierMask(refined, mask);
+            if (after >= before) {
+                best = refined;
+                out.inliers = after;
+                out.refined = true;
+            } else {
+                out.inliers = InlierMask(best, mask);
+            }
+        }
+    }
+
+    out.pose = best;
+    out.iterations = schedule.GetIterations();
+    out.confidence = schedule.GetConfidence();
+    out.timedOut = schedule.TimedOut();
+    return ok(std::move(out));
+}
+
+// NOTE: Runs until the schedule stops handing out iterations, the model is only copied by the
+// hypothesis that beats the shared best
+void PnpEstimator::Search(Lane& lane, RansacSchedule& schedule, Pose& best) const {
+    const u32 count = static_cast<u32>(mX.size());
+    const f64 ratioScale = 1.0 / static_cast<f64>(count);
+    std::array<u32, kP3PSample> sample{};
+    std::array<vec3d, kP3PSample> bearings, world;
+    std::array<Pose, kP3PMaxSolutions> poses;
+
+    u32 iteration = 0;
+    while (schedule.Claim(iteration)) {
+        DrawDistinct(lane.random, count, sample);
+        for (std::size_t k = 0; k < kP3PSample; ++k) {
+            const u32 i = sample[k];
+            bearings[k] = vec3d(mU[i], mV[i], 1.0).normalized();
+            world[k] = vec3d(mX[i], mY[i], mZ[i]);
+        }
+
+        const u32 solutions = SolveP3P(bearings, world, poses);
+        for (u32 s = 0; s < solutions; ++s) {
+            const u32 score = Score(poses[s]);
+            if (score <= schedule.GetBestScore()) continue;
+
+            const f64 good = std::pow(static_cast<f64>(score) * ratioScale, static_cast<f64>(kP3PSample));
+            schedule.Improve(score, good, [&] { best = poses[s]; });
+        }
+    }
+}
+
+// NOTE: Branch free over the coordinate arrays so the loop vectorizes
+u32 PnpEstimator::Score(const Pose& pose) const noexcept {
+    const mat3d& r = pose.rotation;
+    const vec3d& t = pose.translation;
+    const f64 r00 = r(0, 0), r01 = r(0, 1), r02 = r(0, 2);
+    const f64 r10 = r(1, 0), r11 = r(1, 1), r12 = r(1, 2);
+    const f64 r20 = r(2, 0), r21 = r(2, 1), r22 = r(2, 2);
+
+    u32 inliers = 0;
+    const std::size_t count = mX.size();
+    for (std::size_t i = 0; i < count; ++i) {
+        const f64 x = r00 * mX[i] + r01 * mY[i] + r02 * mZ[i] + t.x;
+        const f64 y = r10 * mX[i] + r11 * mY[i] + r12 * mZ[i] + t.y;
+        const f64 z = r20 * mX[i] + r21 * mY[i] + r22 * mZ[i] + t.z;
+        const f64 du = x - mU[i] * z, dv = y - mV[i] * z;
+        // NOTE: (du / z)^2 + (dv / z)^2 < threshold^2 without the division, z > 0 required
+        inliers += (z > kMinDepth && du * du + dv * dv < mThreshold2 * z * z) ? 1u : 0u;
+    }
+    return inliers;
+}
+
+u32 PnpEstimator::InlierMask(const Pose& pose, std::span<u8> mask) const noexcept {
+    u32 inliers = 0;
+    for (std::size_t i = 0; i < mX.size(); ++i) {
+        const vec3d pc = Transform(pose, vec3d(mX[i], mY[i], mZ[i]));
+        const f64 du = pc.x - mU[i] * pc.z, dv = pc.y - mV[i] * pc.z;
+        const bool inlier = pc.z > kMinDepth && du * du + dv * dv < mThreshold2 * pc.z * pc.z;
+        mask[i] = inlier ? 1 : 0;
+        inliers += inlier ? 1u : 0u;
+    }
+    return inliers;
+}
+
+// NOTE: Pixel residuals under a Huber loss at the inlier threshold, so a correspondence that was
+// only just inside does not drag the pose
+bool PnpEstimator::Refine(Pose& pose, std::span<const u8> mask, const CameraIntrinsics& intrinsics) {
+    mRefiner.clear();
+    for (std::size_t i = 0; i < mX.size(); ++i) {
+        if (!mask[i]) continue;
+        const Reprojection r{vec3d(mX[i], mY[i], mZ[i]), mU[i] * intrinsics.fx + intrinsics.cx,
+            mV[i] * intrinsics.fy + intrinsics.cy, intrinsics.fx, intrinsics.fy, intrinsics.cx, intrinsics.cy};
+        mRefiner.add_residual<2>(r, huber_loss<f64>{mInfo.threshold});
+    }
+
+    se3d x(so3d::from_matrix(pose.rotation), pose.translation);
+    auto summary = mRefiner.solve(x);
+    if (!summary || summary->final_cost > summary->initial_cost) return false;
+
+    pose.rotation = x.rotation().matrix();
+    pose.translation = x.translation();
+    return true;
+}
+
+} // namespace ct
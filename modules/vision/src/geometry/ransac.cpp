@@ -0,0 +1,63 @@
+#include "toolbox/vision/geometry/ransac.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ct {
+
+u32 RansacIterationBound(f64 good, f64 confidence, u32 maxIterations) noexcept {
+    maxIterations = std::max(maxIterations, 1u);
+    if (good <= 0.0) return maxIterations;
+    if (good >= 1.0) return 1;
+
+    const f64 k = std::log(1.0 - confidence) / std::log1p(-good);
+    if (!std::isfinite(k) || k >= static_cast<f64>(maxIterations)) return maxIterations;
+    return std::max(static_cast<u32>(std::ceil(k)), 1u);
+}
+
+f64 RansacConfidence(f64 good, u32 iterations) noexcept {
+    if (good <= 0.0 || iterations == 0) return 0.0;
+    if (good >= 1.0) return 1.0;
+    return -std::expm1(static_cast<f64>(iterations) * std::log1p(-good));
+}
+
+void DrawDistinct(std::mt19937_64& random, u32 range, std::span<u32> out) noexcept {
+    for (std::size_t k = 0; k < out.size(); ++k) {
+        u32 v = 0;
+        bool fresh = false;
+        while (!fresh) {
+            v = static_cast<u32>((static_cast<u64>(static_cast<u32>(random() >> 32)) * range) >> 32);
+            fresh = std::find(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(k), v) ==
+                out.begin() + static_cast<std::ptrdiff_t>(k);
+        }
+        out[k] = v;
+    }
+}
+
+RansacSchedule::RansacSchedule(u32 maxIterations, f64 confidence, f64 budget) noexcept
+    : mMaxIterations(std::max(maxIterations, 1u)), mConfidence(confidence), mHasDeadline(budget > 0.0),
+      mDeadline(Clock::now() + std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<f64, std::milli>(std::max(budget, 0.0)))),
+      mBound(mMaxIterations) {}
+
+// NOTE: The clock is read once per hypothesis, noise next to a minimal solve
+bool RansacSchedule::Claim(u32& iteration) noexcept {
+    if (mHasDeadline && Clock::now() >= mDeadline) {
+        mTimedOut.store(true, std::memory_order_relaxed);
+        return false;
+    }
+
+    const u32 next = mNext.fetch_add(1, std::memory_order_relaxed);
+    if (next >= mBound.load(std::memory_order_relaxed)) return false;
+
+    mClaimed.fetch_add(1, std::memory_order_relaxed);
+    iteration = next;
+    return true;
+}
+
+f64 RansacSchedule::GetConfidence() const noexcept {
+    std::scoped_lock lock(mMutex);
+    return RansacConfidence(mGood, GetIterations());
+}
+
+} // namespace ct
@@ -0,0 +1,277 @@
+#include "toolbox/vision/geometry/relative_pose.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace ct {
+
+namespace {
+
+// NOTE: PROSAC's T_N, the sample count after which it matches uniform sampling (Chum & Matas)
+constexpr f64 kProsacSamples = 200000.0;
+
+// NOTE: SPRT cost model: one hypothesis costs about as much as scoring this many correspondences
+// (five-point solve and cheirality check against the SIMD Sampson kernel), and a sample yields
+// this many real solutions on average
+constexpr f64 kModelCost = 2000.0;
+constexpr f64 kModelsPerSample = 4.5;
+
+// NOTE: Correspondences per SPRT step, a multiple of the kernel width
+constexpr std::size_t kSprtBlock = 32;
+
+} // namespace
+
+RelativePoseEstimator::RelativePoseEstimator(const RelativePoseInfo& info) : mInfo(info), mRandom(info.seed) {}
+
+result<RelativePose> RelativePoseEstimator::Estimate(std::span<const cv::Point2f> points1,
+    std::span<const cv::Point2f> points2, const CameraIntrinsics& intrinsics, std::vector<u8>& mask) {
+    if (points1.size() != points2.size())
+        return err(ErrorCode::INVALID_ARGUMENT, "Correspondence lists differ in size");
+    if (points1.size() < kFivePointSample) return err(ErrorCode::INVALID_ARGUMENT, "Not enough correspondences");
+    if (intrinsics.fx <= 0.0 || intrinsics.fy <= 0.0)
+        return err(ErrorCode::INVALID_ARGUMENT, "Camera intrinsics are not set");
+
+    RansacSchedule schedule(mInfo.maxIterations, mInfo.confidence, mInfo.budget);
+    const u32 count = static_cast<u32>(points1.size());
+    Normalize(points1, points2, intrinsics);
+
+    // NOTE: Same seed every call, a frame gives the same pose however often it is estimated
+    mRandom.seed(mInfo.seed);
+    mOrder.resize(count);
+    std::iota(mOrder.begin(), mOrder.end(), 0u);
+    std::shuffle(mOrder.begin(), mOrder.end(), mRandom);
+    mShuffled.Resize(count);
+    for (u32 i = 0; i < count; ++i) {
+        const u32 k = mOrder[i];
+        mShuffled.x1[i] = mPoints.x1[k];
+        mShuffled.y1[i] = mPoints.y1[k];
+        mShuffled.x2[i] = mPoints.x2[k];
+        mShuffled.y2[i] = mPoints.y2[k];
+    }
+
+    // NOTE: One lane per pool thread, each a chunk of its own so they all search concurrently
+    const u32 lanes = mInfo.pool ? mInfo.pool->GetConcurrency() : 1;
+    if (mLanes.size() < lanes) mLanes.resize(lanes);
+    for (u32 l = 0; l < lanes; ++l) ResetLane(mLanes[l], l);
+
+    mat3d best{};
+    const auto search = [&](std::size_t begin, std::size_t end, u32) {
+        for (std::size_t l = begin; l < end; ++l) Search(mLanes[l], schedule, best);
+    };
+    if (lanes > 1) {
+        mInfo.pool->ParallelFor(lanes, 1, search);
+    } else {
+        search(0, 1, 0);
+    }
+
+    const u32 bestInliers = schedule.GetBestScore();
+    if (bestInliers < kFivePointSample) {
+        if (schedule.TimedOut()) return err(ErrorCode::UNKNOWN_ERROR, "Time budget ran out before a model was found");
+        return err(ErrorCode::UNKNOWN_ERROR, "No essential matrix found");
+    }
+
+    // NOTE: Cheirality of the final model only, each Sampson inlier votes for the motions that put
+    // it in front of both cameras
+    mask.resize(count);
+    SampsonInlierMask(best, mPoints, mThreshold2, mask);
+    const std::array<Pose, 4> motions = DecomposeEssential(best);
+    const auto inFront = [&](const Pose& motion, u32 i) {
+        f64 d1 = 0.0, d2 = 0.0;
+        if (!TriangulateDepths(motion, mPoints.x1[i], mPoints.y1[i], mPoints.x2[i], mPoints.y2[i], d1, d2)) return false;
+        return d1 > 0.0 && d2 > 0.0 && d1 < mInfo.maxDepth && d2 < mInfo.maxDepth;
+    };
+
+    std::array<u32, 4> votes{};
+    for (u32 i = 0; i < count; ++i) {
+        if (!mask[i]) continue;
+        for (std::size_t m = 0; m < motions.size(); ++m) votes[m] += inFront(motions[m], i) ? 1u : 0u;
+    }
+    const std::size_t chosen = static_cast<std::size_t>(std::max_element(votes.begin(), votes.end()) - votes.begin());
+    for (u32 i = 0; i < count; ++i) {
+        if (mask[i] && !inFront(motions[chosen], i)) mask[i] = 0;
+    }
+
+    RelativePose pose;
+    pose.motion = motions[chosen];
+    pose.essential = best;
+    pose.inliers = votes[chosen];
+    pose.iterations = schedule.GetIterations();
+    for (u32 l = 0; l < lanes; ++l) pose.models += mLanes[l].models;
+    pose.confidence = schedule.GetConfidence();
+    pose.timedOut = schedule.TimedOut();
+    return ok(std::move(pose));
+}
+
+// NOTE: K^-1 applied once, the threshold moves to normalized units with the mean focal length
+void RelativePoseEstimator::Normalize(std::span<const cv::Point2f> points1, std::span<const cv::Point2f> points2,
+    const CameraIntrinsics& intrinsics) {
+    const f64 ifx = 1.0 / intrinsics.fx, ify = 1.0 / intrinsics.fy;
+    const auto nx = [&](f32 u) { return static_cast<f32>((static_cast<f64>(u) - intrinsics.cx) * ifx); };
+    const auto ny = [&](f32 v) { return static_cast<f32>((static_cast<f64>(v) - intrinsics.cy) * ify); };
+
+    mPoints.Resize(points1.size());
+    for (std::size_t i = 0; i < points1.size(); ++i) {
+        mPoints.x1[i] = nx(points1[i].x);
+        mPoints.y1[i] = ny(points1[i].y);
+        mPoints.x2[i] = nx(points2[i].x);
+        mPoints.y2[i] = ny(points2[i].y);
+    }
+
+    const f64 threshold = mInfo.threshold * 2.0 / (intrinsics.fx + intrinsics.fy);
+    mThreshold2 = static_cast<f32>(threshold * threshold);
+}
+
+// NOTE: Every lane gets its own random stream, SPRT starts from the same prior everywhere
+void RelativePoseEstimator::ResetLane(Lane& lane, u32 index) const {
+    const u32 count = static_cast<u32>(mPoints.Size());
+    lane.random.seed(mInfo.seed + 0x9e3779b97f4a7c15ull * (index + 1));
+    lane.sprt = {};
+    UpdateSprt(lane.sprt);
+    lane.prosac = {};
+    lane.prosac.n = kFivePointSample;
+    lane.prosac.tn = kProsacSamples;
+    for (u32 i = 0; i < kFivePointSample; ++i) {
+        lane.prosac.tn *= static_cast<f64>(kFivePointSample - i) / static_cast<f64>(count - i);
+    }
+    lane.best = 0;
+    lane.models = 0;
+}
+
+// NOTE: Runs until the schedule stops handing out iterations. A lane retunes its SPRT whenever
+// another one has raised the shared best, the model itself is only copied by the winner.
+void RelativePoseEstimator::Search(Lane& lane, RansacSchedule& schedule, mat3d& best) const {
+    const u32 count = static_cast<u32>(mPoints.Size());
+    std::array<u32, kFivePointSample> sample{};
+    std::array<vec2d, kFivePointSample> x1, x2;
+    std::array<mat3d, kFivePointMaxSolutions> models;
+
+    u32 iteration = 0;
+    while (schedule.Claim(iteration)) {
+        DrawSample(lane, iteration + 1, sample);
+        for (std::size_t k = 0; k < kFivePointSample; ++k) {
+            const u32 i = sample[k];
+            x1[k] = vec2d(mPoints.x1[i], mPoints.y1[i]);
+            x2[k] = vec2d(mPoints.x2[i], mPoints.y2[i]);
+        }
+
+        const u32 solutions = SolveFivePoint(x1, x2, models);
+        for (u32 s = 0; s < solutions; ++s) {
+            if (!SampleInFront(models[s], sample)) continue;
+            ++lane.models;
+
+            const u32 shared = schedule.GetBestScore();
+            if (shared != lane.best) {
+                lane.best = shared;
+                lane.sprt.epsilon = static_cast<f64>(shared) / static_cast<f64>(count);
+                UpdateSprt(lane.sprt);
+            }
+
+            const i64 inliers = Score(lane, models[s]);
+            if (inliers <= static_cast<i64>(lane.best)) continue;
+
+            const u32 score = static_cast<u32>(inliers);
+            lane.sprt.epsilon = static_cast<f64>(score) / static_cast<f64>(count);
+            UpdateSprt(lane.sprt);
+            schedule.Improve(score, GoodSample(lane, score), [&] { best = models[s]; });
+        }
+    }
+}
+
+// NOTE: PROSAC draws from the first n correspondences, forcing the n-th into the sample while the
+// growth schedule T'_n says the prefix was just extended. Without PROSAC it is uniform. A lane
+// sees increasing but not consecutive iterations, so the prefix may grow by several at once.
+void RelativePoseEstimator::DrawSample(Lane& lane, u32 iteration, std::array<u32, kFivePointSample>& sample) const {
+    const u32 count = static_cast<u32>(mPoints.Size());
+    if (!mInfo.prosac) {
+        DrawDistinct(lane.random, count, sample);
+        return;
+    }
+
+    Prosac& p = lane.prosac;
+    while (iteration > p.tnPrime && p.n < count) {
+        const f64 next = p.tn * static_cast<f64>(p.n + 1) / static_cast<f64>(p.n + 1 - kFivePointSample);
+        p.tnPrime += static_cast<u32>(std::ceil(next - p.tn));
+        p.tn = next;
+        ++p.n;
+    }
+
+    if (p.tnPrime < iteration) {
+        DrawDistinct(lane.random, p.n, sample);
+    } else {
+        DrawDistinct(lane.random, p.n - 1, std::span(sample).first(kFivePointSample - 1));
+        sample[kFivePointSample - 1] = p.n - 1;
+    }
+}
+
+// NOTE: Some motion of E has to put every sample point in front of both cameras, a hypothesis
+// without one cannot be the true model. Parallel rays say nothing and are skipped.
+bool RelativePoseEstimator::SampleInFront(const mat3d& E, const std::array<u32, kFivePointSample>& sample) const {
+    const std::array<Pose, 4> motions = DecomposeEssential(E);
+    for (const Pose& motion : motions) {
+        bool front = true;
+        for (u32 i : sample) {
+            f64 d1 = 0.0, d2 = 0.0;
+            if (!TriangulateDepths(motion, mPoints.x1[i], mPoints.y1[i], mPoints.x2[i], mPoints.y2[i], d1, d2)) continue;
+            if (d1 <= 0.0 || d2 <= 0.0) {
+                front = false;
+                break;
+            }
+        }
+        if (front) return true;
+    }
+    return false;
+}
+
+// NOTE: Without SPRT every correspondence is scored. With it the log likelihood ratio of "bad
+// model" over "good model" is accumulated per block and the hypothesis is rejected once it
+// exceeds log A, rejected hypotheses refine the lane's estimate of delta.
+i64 RelativePoseEstimator::Score(Lane& lane, const mat3d& E) const {
+    const std::size_t count = mShuffled.Size();
+    if (!mInfo.sprt) return CountSampsonInliers(E, mShuffled, 0, count, mThreshold2);
+
+    Sprt& sprt = lane.sprt;
+    u32 inliers = 0;
+    f64 ratio = 0.0;
+    for (std::size_t begin = 0; begin < count; begin += kSprtBlock) {
+        const std::size_t end = std::min(count, begin + kSprtBlock);
+        const u32 agreed = CountSampsonInliers(E, mShuffled, begin, end, mThreshold2);
+        inliers += agreed;
+        ratio += agreed * sprt.logAccept + static_cast<f64>(end - begin - agreed) * sprt.logReject;
+        if (ratio > sprt.logThreshold) {
+            sprt.tested += end;
+            sprt.agreed += inliers;
+            sprt.delta = static_cast<f64>(sprt.agreed + 1) / static_cast<f64>(sprt.tested + 100);
+            UpdateSprt(sprt);
+            return -1;
+        }
+    }
+    return inliers;
+}
+
+// NOTE: A solves A = K C / m_S + 1 + ln A (Chum & Matas eq. 17) with C the expected log ratio
+// per correspondence of a bad model, a few fixed point steps converge
+void RelativePoseEstimator::UpdateSprt(Sprt& s) noexcept {
+    const f64 epsilon = std::clamp(s.epsilon, 1e-3, 0.999);
+    const f64 delta = std::clamp(s.delta, 1e-4, 0.99 * epsilon);
+
+    const f64 c = (1.0 - delta) * std::log((1.0 - delta) / (1.0 - epsilon)) + delta * std::log(delta / epsilon);
+    const f64 a0 = kModelCost * c / kModelsPerSample + 1.0;
+    f64 a = a0;
+    for (i32 k = 0; k < 8; ++k) a = a0 + std::log(a);
+
+    s.threshold = a;
+    s.logThreshold = std::log(a);
+    s.logAccept = std::log(delta / epsilon);
+    s.logReject = std::log((1.0 - delta) / (1.0 - epsilon));
+}
+
+// NOTE: With SPRT an all-inlier sample is still rejected with probability about 1 / A
+f64 RelativePoseEstimator::GoodSample(const Lane& lane, u32 inliers) const {
+    const f64 ratio = static_cast<f64>(inliers) / static_cast<f64>(mPoints.Size());
+    f64 good = std::pow(ratio, static_cast<f64>(kFivePointSample));
+    if (mInfo.sprt) good *= 1.0 - 1.0 / lane.sprt.threshold;
+    return good;
+}
+
+} // namespace ct
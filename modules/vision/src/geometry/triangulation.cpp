@@ -0,0 +1,41 @@
+#include "toolbox/vision/geometry/triangulation.hpp"
+#include "toolbox/vision/geometry/essential.hpp"
+
+#include <cmath>
+#include <numbers>
+
+namespace ct {
+
+vec3d Unproject(const CameraIntrinsics& intrinsics, f32 u, f32 v) noexcept {
+    return {(static_cast<f64>(u) - intrinsics.cx) / intrinsics.fx, (static_cast<f64>(v) - intrinsics.cy) / intrinsics.fy,
+        1.0};
+}
+
+f64 ReprojectionError2(const CameraIntrinsics& intrinsics, const vec3d& pc, f32 u, f32 v) noexcept {
+    const f64 du = intrinsics.fx * pc.x / pc.z + intrinsics.cx - static_cast<f64>(u);
+    const f64 dv = intrinsics.fy * pc.y / pc.z + intrinsics.cy - static_cast<f64>(v);
+    return du * du + dv * dv;
+}
+
+f64 ParallaxCosine(f64 degrees) noexcept { return std::cos(degrees * std::numbers::pi / 180.0); }
+
+bool TriangulatePoint(const CameraIntrinsics& intrinsics, const Pose& refFromCurr, const Pose& currFromRef, f32 u1,
+    f32 v1, f32 u2, f32 v2, f64 minCos, f64 maxError, vec3d& out) noexcept {
+    const vec3d x1 = Unproject(intrinsics, u1, v1), x2 = Unproject(intrinsics, u2, v2);
+    if ((refFromCurr.rotation * x1).normalized().dot(x2.normalized()) > minCos) return false;
+
+    f64 d1 = 0.0, d2 = 0.0;
+    if (!TriangulateDepths(refFromCurr, x1.x, x1.y, x2.x, x2.y, d1, d2) || d1 <= 0.0 || d2 <= 0.0) return false;
+
+    const vec3d pc = (x1 * d1 + Transform(currFromRef, x2 * d2)) * 0.5;
+    const vec3d pr = Transform(refFromCurr, pc);
+    if (pc.z <= 0.0 || pr.z <= 0.0) return false;
+
+    const f64 maxError2 = maxError * maxError;
+    if (ReprojectionError2(intrinsics, pc, u1, v1) > maxError2) return false;
+    if (ReprojectionError2(intrinsics, pr, u2, v2) > maxError2) return false;
+    out = pc;
+    return true;
+}
+
+} // namespace ct
@@ -0,0 +1,500 @@
+#include "toolbox/vision/image/kernels.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#if defined(TOOLBOX_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
+
+namespace ct {
+
+namespace {
+
+// NOTE: Row kernels. Pointers address column 0, padded buffers are readable `pad` elements before
+// and after the row.
+using GrayRowKernel = void (*)(const u8* bgr, u8* gray, i32 width) noexcept;
+using VerticalKernel = void (*)(const u8* const* rows, const u16* taps, i32 count, i32 shift, u16* out,
+    i32 width) noexcept;
+using PyrRowKernel = void (*)(const u16* sums, u8* out, i32 width) noexcept;
+using BlurRowKernel = void (*)(const u16* sums, const u16* taps, i32 count, u8* out, i32 width) noexcept;
+using SobelRowKernel = void (*)(const u8* r0, const u8* r1, const u8* r2, i16* smooth, i16* diff, i16* dx,
+    i16* dy, i32 width) noexcept;
+using IntegralRowKernel = void (*)(const u8* src, const u32* prev, u32* out, i32 width) noexcept;
+
+// NOTE: cv::COLOR_BGR2GRAY weights, 14 fractional bits
+constexpr i32 kB2Y = 1868;
+constexpr i32 kG2Y = 9617;
+constexpr i32 kR2Y = 4899;
+constexpr i32 kGrayShift = 14;
+
+constexpr std::array<u16, 5> kPyrTaps{1, 4, 6, 4, 1};
+
+// NOTE: Vertical blur sums are rounded to 4 fractional bits (at most 16 * 255, which the AVX2
+// horizontal pass needs to stay inside i16), the horizontal taps add 8 more
+constexpr i32 kVerticalShift = 4;
+constexpr i32 kHorizontalShift = 12;
+
+// NOTE: Scalar bodies, also the tails of the vector kernels
+
+TOOLBOX_FORCE_INLINE void GrayBody(const u8* bgr, u8* gray, i32 x, i32 width) noexcept {
+    for (; x < width; ++x) {
+        const u8* p = bgr + 3 * x;
+        gray[x] = static_cast<u8>((p[0] * kB2Y + p[1] * kG2Y + p[2] * kR2Y + (1 << (kGrayShift - 1))) >> kGrayShift);
+    }
+}
+
+TOOLBOX_FORCE_INLINE void VerticalBody(const u8* const* rows, const u16* taps, i32 count, i32 shift, u16* out,
+    i32 x, i32 width) noexcept {
+    const u32 round = shift > 0 ? 1u << (shift - 1) : 0u;
+    for (; x < width; ++x) {
+        u32 sum = 0;
+        for (i32 k = 0; k < count; ++k) sum += u32{taps[k]} * rows[k][x];
+        out[x] = static_cast<u16>((sum + round) >> shift);
+    }
+}
+
+TOOLBOX_FORCE_INLINE void PyrRowBody(const u16* s, u8* out, i32 x, i32 width) noexcept {
+    for (; x < width; ++x) {
+        const u16* c = s + 2 * x;
+        const u32 sum = u32{c[-2]} + 4u * (u32{c[-1]} + c[1]) + 6u * c[0] + c[2];
+        out[x] = static_cast<u8>((sum + 128) >> 8);
+    }
+}
+
+TOOLBOX_FORCE_INLINE void BlurRowBody(const u16* s, const u16* taps, i32 count, u8* out, i32 x, i32 width) noexcept {
+    const u16* first = s - count / 2;
+    for (; x < width; ++x) {
+        u32 sum = 0;
+        for (i32 k = 0; k < count; ++k) sum += u32{taps[k]} * first[x + k];
+        out[x] = static_cast<u8>((sum + (1u << (kHorizontalShift - 1))) >> kHorizontalShift);
+    }
+}
+
+TOOLBOX_FORCE_INLINE void SobelVerticalBody(const u8* r0, const u8* r1, const u8* r2, i16* smooth, i16* diff, i32 x,
+    i32 width) noexcept {
+    for (; x < width; ++x) {
+        smooth[x] = static_cast<i16>(r0[x] + 2 * r1[x] + r2[x]);
+        diff[x] = static_cast<i16>(r2[x] - r0[x]);
+    }
+}
+
+TOOLBOX_FORCE_INLINE void SobelHorizontalBody(const i16* smooth, const i16* diff, i16* dx, i16* dy, i32 x,
+    i32 width) noexcept {
+    for (; x < width; ++x) {
+        dx[x] = static_cast<i16>(smooth[x + 1] - smooth[x - 1]);
+        dy[x] = static_cast<i16>(diff[x - 1] + 2 * diff[x] + diff[x + 1]);
+    }
+}
+
+// NOTE: Column -1 and column width of both intermediate rows
+TOOLBOX_FORCE_INLINE void SobelPad(i16* smooth, i16* diff, i32 width) noexcept {
+    const i32 left = Reflect101(-1, width), right = Reflect101(width, width);
+    smooth[-1] = smooth[left];
+    smooth[width] = smooth[right];
+    diff[-1] = diff[left];
+    diff[width] = diff[right];
+}
+
+TOOLBOX_FORCE_INLINE void IntegralBody(const u8* src, const u32* prev, u32* out, u32 run, i32 x, i32 width) noexcept {
+    for (; x < width; ++x) {
+        run += src[x];
+        out[x] = prev[x] + run;
+    }
+}
+
+void GrayRowScalar(const u8* bgr, u8* gray, i32 width) noexcept { GrayBody(bgr, gray, 0, width); }
+
+void VerticalScalar(const u8* const* rows, const u16* taps, i32 count, i32 shift, u16* out, i32 width) noexcept {
+    VerticalBody(rows, taps, count, shift, out, 0, width);
+}
+
+void PyrRowScalar(const u16* sums, u8* out, i32 width) noexcept { PyrRowBody(sums, out, 0, width); }
+
+void BlurRowScalar(const u16* sums, const u16* taps, i32 count, u8* out, i32 width) noexcept {
+    BlurRowBody(sums, taps, count, out, 0, width);
+}
+
+void SobelRowScalar(const u8* r0, const u8* r1, const u8* r2, i16* smooth, i16* diff, i16* dx, i16* dy,
+    i32 width) noexcept {
+    SobelVerticalBody(r0, r1, r2, smooth, diff, 0, width);
+    SobelPad(smooth, diff, width);
+    SobelHorizontalBody(smooth, diff, dx, dy, 0, width);
+}
+
+void IntegralRowScalar(const u8* src, const u32* prev, u32* out, i32 width) noexcept {
+    IntegralBody(src, prev, out, 0, 0, width);
+}
+
+#if defined(TOOLBOX_CPU_DISPATCH)
+
+// NOTE: pshufb masks gathering one channel of 16 BGR pixels from the three 16-byte chunks that hold
+// them, entry [3 * channel + chunk]. Bytes of other chunks are zeroed (0x80) and the three shuffles
+// are or-ed together.
+constexpr auto kBgrMasks = [] {
+    std::array<std::array<i8, 16>, 9> m{};
+    for (i32 c = 0; c < 3; ++c) {
+        for (i32 chunk = 0; chunk < 3; ++chunk) {
+            for (i32 i = 0; i < 16; ++i) {
+                const i32 k = 3 * i + c;
+                m[static_cast<std::size_t>(3 * c + chunk)][static_cast<std::size_t>(i)] =
+                    static_cast<i8>(k / 16 == chunk ? k % 16 : -128);
+            }
+        }
+    }
+    return m;
+}();
+
+// NOTE: Lambdas do not inherit the target attribute, vector helpers are force-inlined functions
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE __m128i Load128(const void* p) noexcept {
+    return _mm_loadu_si128(static_cast<const __m128i*>(p));
+}
+
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE __m256i Load256(const void* p) noexcept {
+    return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+}
+
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE void Store256(void* p, __m256i v) noexcept {
+    _mm256_storeu_si256(static_cast<__m256i*>(p), v);
+}
+
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE __m256i Widen(const u8* p) noexcept {
+    return _mm256_cvtepu8_epi16(Load128(p));
+}
+
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE __m128i Channel(__m128i c0, __m128i c1, __m128i c2, i32 c) noexcept {
+    const std::array<i8, 16>* mask = kBgrMasks.data() + 3 * c;
+    return _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(c0, Load128(mask[0].data())),
+                            _mm_shuffle_epi8(c1, Load128(mask[1].data()))),
+        _mm_shuffle_epi8(c2, Load128(mask[2].data())));
+}
+
+// NOTE: 16 i32 in two registers (natural order) to 16 bytes
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE __m128i Narrow32(__m256i lo, __m256i hi) noexcept {
+    const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xd8);
+    return _mm_packus_epi16(_mm256_castsi256_si128(packed), _mm256_extracti128_si256(packed, 1));
+}
+
+// NOTE: B and G interleaved per pixel against (B2Y, G2Y), R and a constant 1 against (R2Y, rounding)
+TOOLBOX_TARGET_AVX2 void GrayRowAvx2(const u8* bgr, u8* gray, i32 width) noexcept {
+    const __m256i wbg = _mm256_set1_epi32(kB2Y | (kG2Y << 16));
+    const __m256i wr = _mm256_set1_epi32(kR2Y | ((1 << (kGrayShift - 1)) << 16));
+    const __m128i one = _mm_set1_epi8(1);
+
+    i32 x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const u8* p = bgr + 3 * x;
+        const __m128i c0 = Load128(p);
+        const __m128i c1 = Load128(p + 16);
+        const __m128i c2 = Load128(p + 32);
+        const __m128i b = Channel(c0, c1, c2, 0);
+        const __m128i g = Channel(c0, c1, c2, 1);
+        const __m128i r = Channel(c0, c1, c2, 2);
+
+        const __m256i lo = _mm256_srli_epi32(
+            _mm256_add_epi32(_mm256_madd_epi16(_mm256_cvtepu8_epi16(_mm_unpacklo_epi8(b, g)), wbg),
+                _mm256_madd_epi16(_mm256_cvtepu8_epi16(_mm_unpacklo_epi8(r, one)), wr)),
+            kGrayShift);
+        const __m256i hi = _mm256_srli_epi32(
+            _mm256_add_epi32(_mm256_madd_epi16(_mm256_cvtepu8_epi16(_mm_unpackhi_epi8(b, g)), wbg),
+                _mm256_madd_epi16(_mm256_cvtepu8_epi16(_mm_unpackhi_epi8(r, one)), wr)),
+            kGrayShift);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(gray + x), Narrow32(lo, hi));
+    }
+    GrayBody(bgr, gray, x, width);
+}
+
+// NOTE: u16 lanes, taps * 255 summed over the column stays below 2^16 for every tap set we use
+TOOLBOX_TARGET_AVX2 void VerticalAvx2(const u8* const* rows, const u16* taps, i32 count, i32 shift, u16* out,
+    i32 width) noexcept {
+    const __m256i round = _mm256_set1_epi16(static_cast<i16>(shift > 0 ? 1 << (shift - 1) : 0));
+    const __m128i count16 = _mm_cvtsi32_si128(shift);
+
+    i32 x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m256i sum = _mm256_setzero_si256();
+        for (i32 k = 0; k < count; ++k) {
+            const __m256i p = Widen(rows[k] + x);
+            sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(p, _mm256_set1_epi16(static_cast<i16>(taps[k]))));
+        }
+        sum = _mm256_srl_epi16(_mm256_add_epi16(sum, round), count16);
+        Store256(out + x, sum);
+    }
+    VerticalBody(rows, taps, count, shift, out, x, width);
+}
+
+// NOTE: Adjacent u16 sums are already the (even, odd) pairs pmaddwd multiplies, so outputs x..x+7
+// are (1, 4) . s[2x-2..] + (6, 4) . s[2x..] + (1, 0) . s[2x+2..] without any shuffle
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE __m256i PyrEight(const u16* s, i32 x) noexcept {
+    const u16* c = s + 2 * x;
+    const __m256i sum = _mm256_add_epi32(
+        _mm256_add_epi32(_mm256_madd_epi16(Load256(c - 2), _mm256_set1_epi32(1 | (4 << 16))),
+            _mm256_madd_epi16(Load256(c), _mm256_set1_epi32(6 | (4 << 16)))),
+        _mm256_madd_epi16(Load256(c + 2), _mm256_set1_epi32(1)));
+    return _mm256_srli_epi32(_mm256_add_epi32(sum, _mm256_set1_epi32(128)), 8);
+}
+
+TOOLBOX_TARGET_AVX2 void PyrRowAvx2(const u16* sums, u8* out, i32 width) noexcept {
+    // NOTE: A step reads up to sums[2x + 33], the padded sums reach at least index 2 * width
+    i32 x = 0;
+    for (; 2 * x + 34 <= 2 * width; x += 16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), Narrow32(PyrEight(sums, x), PyrEight(sums, x + 8)));
+    }
+    PyrRowBody(sums, out, x, width);
+}
+
+// NOTE: Taps two at a time, the unpacked neighbours of 16 outputs are pmaddwd pairs. Unpack and pack
+// both work within 128-bit lanes, so the outputs come back in order.
+TOOLBOX_TARGET_AVX2 void BlurRowAvx2(const u16* sums, const u16* taps, i32 count, u8* out, i32 width) noexcept {
+    const u16* first = sums - count / 2;
+    const __m256i round = _mm256_set1_epi32(1 << (kHorizontalShift - 1));
+
+    i32 x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m256i lo = round, hi = round;
+        for (i32 k = 0; k < count; k += 2) {
+            const __m256i a = Load256(first + x + k);
+            const bool pair = k + 1 < count;
+            const __m256i b = pair ? Load256(first + x + k + 1) : _mm256_setzero_si256();
+            const __m256i w = _mm256_set1_epi32(i32{taps[k]} | (pair ? i32{taps[k + 1]} << 16 : 0));
+            lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), w));
+            hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), w));
+        }
+        const __m256i packed = _mm256_packus_epi32(
+            _mm256_srli_epi32(lo, kHorizontalShift), _mm256_srli_epi32(hi, kHorizontalShift));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x),
+            _mm_packus_epi16(_mm256_castsi256_si128(packed), _mm256_extracti128_si256(packed, 1)));
+    }
+    BlurRowBody(sums, taps, count, out, x, width);
+}
+
+TOOLBOX_TARGET_AVX2 void SobelRowAvx2(const u8* r0, const u8* r1, const u8* r2, i16* smooth, i16* diff, i16* dx,
+    i16* dy, i32 width) noexcept {
+    i32 x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m256i a = Widen(r0 + x), b = Widen(r1 + x), c = Widen(r2 + x);
+        Store256(smooth + x, _mm256_add_epi16(_mm256_add_epi16(a, c), _mm256_add_epi16(b, b)));
+        Store256(diff + x, _mm256_sub_epi16(c, a));
+    }
+    SobelVerticalBody(r0, r1, r2, smooth, diff, x, width);
+    SobelPad(smooth, diff, width);
+
+    for (x = 0; x + 16 <= width; x += 16) {
+        Store256(dx + x, _mm256_sub_epi16(Load256(smooth + x + 1), Load256(smooth + x - 1)));
+        const __m256i d = Load256(diff + x);
+        Store256(dy + x, _mm256_add_epi16(_mm256_add_epi16(Load256(diff + x - 1), Load256(diff + x + 1)), _mm256_add_epi16(d, d)));
+    }
+    SobelHorizontalBody(smooth, diff, dx, dy, x, width);
+}
+
+// NOTE: Prefix sum of 8 pixels: two in-lane shifted adds, then the low lane total into the high lane
+TOOLBOX_TARGET_AVX2 void IntegralRowAvx2(const u8* src, const u32* prev, u32* out, i32 width) noexcept {
+    const __m256i last = _mm256_set1_epi32(7);
+    const __m256i third = _mm256_set1_epi32(3);
+    __m256i run = _mm256_setzero_si256();
+
+    i32 x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + x)));
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+        v = _mm256_add_epi32(v, _mm256_blend_epi32(_mm256_setzero_si256(), _mm256_permutevar8x32_epi32(v, third), 0xf0));
+        v = _mm256_add_epi32(v, run);
+        run = _mm256_permutevar8x32_epi32(v, last);
+        Store256(out + x, _mm256_add_epi32(v, Load256(prev + x)));
+    }
+    IntegralBody(src, prev, out, static_cast<u32>(_mm_cvtsi128_si32(_mm256_castsi256_si128(run))), x, width);
+}
+
+#endif
+
+constexpr cpu::KernelTable<GrayRowKernel> kGrayKernels{
+    .scalar = GrayRowScalar,
+#if defined(TOOLBOX_CPU_DISPATCH)
+    .avx2 = GrayRowAvx2,
+#endif
+};
+
+constexpr cpu::KernelTable<VerticalKernel> kVerticalKernels{
+    .scalar = VerticalScalar,
+#if defined(TOOLBOX_CPU_DISPATCH)
+    .avx2 = VerticalAvx2,
+#endif
+};
+
+constexpr cpu::KernelTable<PyrRowKernel> kPyrKernels{
+    .scalar = PyrRowScalar,
+#if defined(TOOLBOX_CPU_DISPATCH)
+    .avx2 = PyrRowAvx2,
+#endif
+};
+
+constexpr cpu::KernelTable<BlurRowKernel> kBlurKernels{
+    .scalar = BlurRowScalar,
+#if defined(TOOLBOX_CPU_DISPATCH)
+    .avx2 = BlurRowAvx2,
+#endif
+};
+
+constexpr cpu::KernelTable<SobelRowKernel> kSobelKernels{
+    .scalar = SobelRowScalar,
+#if defined(TOOLBOX_CPU_DISPATCH)
+    .avx2 = SobelRowAvx2,
+#endif
+};
+
+constexpr cpu::KernelTable<IntegralRowKernel> kIntegralKernels{
+    .scalar = IntegralRowScalar,
+#if defined(TOOLBOX_CPU_DISPATCH)
+    .avx2 = IntegralRowAvx2,
+#endif
+};
+
+// NOTE: Kernels are looked up once per image, not per row
+struct PyrDownKernels {
+    VerticalKernel vertical{kVerticalKernels.Get()};
+    PyrRowKernel row{kPyrKernels.Get()};
+};
+
+// NOTE: Row y of PyrDown, s has room for src.width + 4 sums (two pad columns per side)
+void PyrDownRow(GrayView src, i32 y, u8* out, i32 width, u16* s, const PyrDownKernels& kernels) noexcept {
+    const i32 w = src.width, h = src.height;
+    std::array<const u8*, kPyrTaps.size()> rows{};
+    for (i32 k = 0; k < static_cast<i32>(rows.size()); ++k) {
+        rows[static_cast<std::size_t>(k)] = src.Row(Reflect101(2 * y + k - 2, h));
+    }
+
+    u16* c = s + 2;
+    kernels.vertical(rows.data(), kPyrTaps.data(), static_cast<i32>(kPyrTaps.size()), 0, c, w);
+    c[-2] = c[Reflect101(-2, w)];
+    c[-1] = c[Reflect101(-1, w)];
+    c[w] = c[Reflect101(w, w)];
+    c[w + 1] = c[Reflect101(w + 1, w)];
+    kernels.row(c, out, width);
+}
+
+} // namespace
+
+void BgrToGray(ImageView<const u8, 3> src, ImageView<u8> dst) noexcept {
+    assert(src.width == dst.width && src.height == dst.height);
+    const GrayRowKernel kernel = kGrayKernels.Get();
+    for (i32 y = 0; y < src.height; ++y) kernel(src.Row(y), dst.Row(y), src.width);
+}
+
+void PyrDown(GrayView src, ImageView<u8> dst, std::vector<u16>& sums) {
+    assert(src.width >= 3 && src.height >= 3);
+    assert(dst.width == (src.width + 1) / 2 && dst.height == (src.height + 1) / 2);
+
+    sums.resize(static_cast<std::size_t>(src.width) + 4);
+    const PyrDownKernels kernels;
+    for (i32 y = 0; y < dst.height; ++y) PyrDownRow(src, y, dst.Row(y), dst.width, sums.data(), kernels);
+}
+
+void BgrToGrayPyrDown(ImageView<const u8, 3> src, ImageView<u8> gray, ImageView<u8> half, std::vector<u16>& sums) {
+    assert(src.width == gray.width && src.height == gray.height);
+    assert(gray.width >= 3 && gray.height >= 3);
+    assert(half.width == (gray.width + 1) / 2 && half.height == (gray.height + 1) / 2);
+
+    sums.resize(static_cast<std::size_t>(gray.width) + 4);
+    const GrayRowKernel toGray = kGrayKernels.Get();
+    const PyrDownKernels kernels;
+    const i32 h = gray.height;
+
+    // NOTE: Half row y reads gray rows up to 2y + 2 (reflected at the bottom)
+    i32 next = 0;
+    for (i32 y = 0; y < h; ++y) {
+        toGray(src.Row(y), gray.Row(y), gray.width);
+        while (next < half.height && std::min(2 * next + 2, h - 1) <= y) {
+            PyrDownRow(gray, next, half.Row(next), half.width, sums.data(), kernels);
+            ++next;
+        }
+    }
+}
+
+void GaussianTaps(f32 sigma, std::vector<u16>& taps) {
+    if (!(sigma > 0.0f)) {
+        taps.assign(1, 256);
+        return;
+    }
+
+    constexpr i32 kMaxRadius = static_cast<i32>(kMaxBlurTaps / 2);
+    const i32 radius = std::clamp(static_cast<i32>(std::ceil(3.0f * sigma)), 1, kMaxRadius);
+    const std::size_t count = static_cast<std::size_t>(2 * radius + 1);
+
+    f64 total = 0.0;
+    for (i32 i = -radius; i <= radius; ++i) total += std::exp(-0.5 * (i * i) / (static_cast<f64>(sigma) * sigma));
+
+    taps.resize(count);
+    i32 rest = 256;
+    for (i32 i = -radius; i <= radius; ++i) {
+        if (i == 0) continue;
+        const f64 w = std::exp(-0.5 * (i * i) / (static_cast<f64>(sigma) * sigma)) / total;
+        const u16 tap = static_cast<u16>(std::lround(256.0 * w));
+        taps[static_cast<std::size_t>(i + radius)] = tap;
+        rest -= tap;
+    }
+    taps[static_cast<std::size_t>(radius)] = static_cast<u16>(rest);
+}
+
+void GaussianBlur(GrayView src, ImageView<u8> dst, std::span<const u16> taps, std::vector<u16>& sums) {
+    GaussianBlurRows(src, dst, taps, 0, src.height, sums);
+}
+
+void GaussianBlurRows(GrayView src, ImageView<u8> dst, std::span<const u16> taps, i32 y0, i32 y1,
+    std::vector<u16>& sums) {
+    assert(src.width == dst.width && src.height == dst.height);
+    assert(taps.size() % 2 == 1 && taps.size() <= kMaxBlurTaps);
+    assert(y0 >= 0 && y1 <= src.height);
+
+    const i32 w = src.width, h = src.height;
+    const i32 count = static_cast<i32>(taps.size());
+    const i32 radius = count / 2;
+    sums.resize(static_cast<std::size_t>(w + 2 * radius));
+    u16* c = sums.data() + radius;
+
+    const VerticalKernel vertical = kVerticalKernels.Get();
+    const BlurRowKernel horizontal = kBlurKernels.Get();
+    std::array<const u8*, kMaxBlurTaps> rows{};
+
+    for (i32 y = y0; y < y1; ++y) {
+        for (i32 k = 0; k < count; ++k) rows[static_cast<std::size_t>(k)] = src.Row(Reflect101(y + k - radius, h));
+        vertical(rows.data(), taps.data(), count, kVerticalShift, c, w);
+        for (i32 i = 1; i <= radius; ++i) {
+            c[-i] = c[Reflect101(-i, w)];
+            c[w - 1 + i] = c[Reflect101(w - 1 + i, w)];
+        }
+        horizontal(c, taps.data(), count, dst.Row(y), w);
+    }
+}
+
+void Sobel(GrayView src, ImageView<i16> dx, ImageView<i16> dy, std::vector<i16>& sums) {
+    assert(src.width == dx.width && src.height == dx.height);
+    assert(src.width == dy.width && src.height == dy.height);
+
+    const i32 w = src.width, h = src.height;
+    sums.resize(2 * (static_cast<std::size_t>(w) + 2));
+    i16* smooth = sums.data() + 1;
+    i16* diff = smooth + w + 2;
+
+    const SobelRowKernel kernel = kSobelKernels.Get();
+    for (i32 y = 0; y < h; ++y) {
+        kernel(src.Row(Reflect101(y - 1, h)), src.Row(y), src.Row(Reflect101(y + 1, h)), smooth, diff, dx.Row(y),
+            dy.Row(y), w);
+    }
+}
+
+void Integral(GrayView src, ImageView<u32> sum) noexcept {
+    assert(sum.width == src.width + 1 && sum.height == src.height + 1);
+
+    std::fill_n(sum.Row(0), sum.width, 0u);
+    const IntegralRowKernel kernel = kIntegralKernels.Get();
+    for (i32 y = 0; y < src.height; ++y) {
+        u32* out = sum.Row(y + 1);
+        out[0] = 0;
+        kernel(src.Row(y), sum.Row(y) + 1, out + 1, src.width);
+    }
+}
+
+} // namespace ct
@@ -0,0 +1,109 @@
+#include "toolbox/vision/image/pyramid.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace ct {
+
+ImagePyramid::ImagePyramid(const ImagePyramidInfo& info) : mInfo(info) {}
+
+ImageView<u8> ImagePyramid::Prepare(i32 width, i32 height) {
+    assert(width > 0 && height > 0);
+    const i32 border = std::max(mInfo.border, 0);
+    const i32 minSize = std::max(mInfo.minSize, 2);
+    const i32 levels = std::max(mInfo.levels, 1);
+
+    mViews.clear();
+    mMats.clear();
+    i32 w = width, h = height;
+    for (i32 level = 0; level < levels; ++level) {
+        if (level > 0) {
+            const i32 nw = (w + 1) / 2, nh = (h + 1) / 2;
+            if (std::min(nw, nh) < minSize) break;
+            w = nw;
+            h = nh;
+        }
+
+        if (mImages.size() <= static_cast<std::size_t>(level)) mImages.emplace_back();
+        GrayImage& image = mImages[static_cast<std::size_t>(level)];
+        image.Resize(w + 2 * border, h + 2 * border);
+        mViews.push_back(image.Roi(border, border, w, h));
+        mMats.emplace_back(image.Mat(), cv::Rect(border, border, w, h));
+    }
+    return mViews.front();
+}
+
+void ImagePyramid::Build() {
+    assert(!mViews.empty());
+    Downsample(1);
+}
+
+void ImagePyramid::Build(GrayView image) {
+    const ImageView<u8> base = Prepare(image.width, image.height);
+    for (i32 y = 0; y < image.height; ++y) {
+        std::memcpy(base.Row(y), image.Row(y), static_cast<std::size_t>(image.width));
+    }
+    Build();
+}
+
+void ImagePyramid::Build(ImageView<const u8, 3> bgr) {
+    const ImageView<u8> base = Prepare(bgr.width, bgr.height);
+    if (GetLevels() == 1) {
+        BgrToGray(bgr, base);
+        Downsample(1);
+        return;
+    }
+    BgrToGrayPyrDown(bgr, base, mViews[1], mColumnSums);
+    Downsample(2);
+}
+
+GrayView ImagePyramid::Level(i32 level) const noexcept {
+    assert(level >= 0 && level < GetLevels());
+    return mViews[static_cast<std::size_t>(level)];
+}
+
+f32 ImagePyramid::GetScale(i32 level) const noexcept {
+    assert(level >= 0 && level < GetLevels());
+    return std::ldexp(1.0f, level);
+}
+
+const cv::Mat& ImagePyramid::Mat(i32 level) const noexcept {
+    assert(level >= 0 && level < GetLevels());
+    return mMats[static_cast<std::size_t>(level)];
+}
+
+// NOTE: Levels from `first` on are derived from the one before, then every border is filled
+void ImagePyramid::Downsample(i32 first) {
+    for (std::size_t level = static_cast<std::size_t>(first); level < mViews.size(); ++level) {
+        PyrDown(mViews[level - 1], mViews[level], mColumnSums);
+    }
+    if (mInfo.border > 0) {
+        for (i32 level = 0; level < GetLevels(); ++level) FillBorder(level);
+    }
+}
+
+// NOTE: Columns first inside every row, then whole padded rows above and below
+void ImagePyramid::FillBorder(i32 level) {
+    const ImageView<u8> view = mViews[static_cast<std::size_t>(level)];
+    const i32 border = mInfo.border;
+    const i32 w = view.width, h = view.height;
+
+    for (i32 y = 0; y < h; ++y) {
+        u8* row = view.Row(y);
+        for (i32 k = 1; k <= border; ++k) {
+            row[-k] = row[Reflect101(-k, w)];
+            row[w - 1 + k] = row[Reflect101(w - 1 + k, w)];
+        }
+    }
+
+    const std::size_t padded = static_cast<std::size_t>(w + 2 * border);
+    const auto line = [&](i32 y) { return view.data + static_cast<std::ptrdiff_t>(y) * view.stride - border; };
+    for (i32 k = 1; k <= border; ++k) {
+        std::memcpy(line(-k), line(Reflect101(-k, h)), padded);
+        std::memcpy(line(h - 1 + k), line(Reflect101(h - 1 + k, h)), padded);
+    }
+}
+
+} // namespace ct
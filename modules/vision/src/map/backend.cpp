@@ -0,0 +1,92 @@
+#include "toolbox/vision/map/backend.hpp"
+
+#include <algorithm>
+
+namespace ct {
+
+namespace {
+
+// NOTE: Pixel residual of one observation, evaluated on jets over the pose and the point
+struct Reprojection {
+    f64 u, v;
+    f64 fx, fy, cx, cy;
+
+    template<class S>
+    bool operator()(const se3<S>& pose, const vec<3, S>& point, std::array<S, 2>& r) const {
+        const vec<3, S> pc = pose * point;
+        if (pc.z <= 1e-6) return false;
+        r[0] = S(fx) * pc.x / pc.z + S(cx) - S(u);
+        r[1] = S(fy) * pc.y / pc.z + S(cy) - S(v);
+        return true;
+    }
+};
+
+} // namespace
+
+MappingBackend::MappingBackend(const MappingBackendInfo& info)
+    : mInfo(info), mThread([this](std::stop_token stop) { Run(stop); }) {}
+
+// NOTE: The thread may be asleep on mSubmitted, jthread's own stop request would not wake it
+MappingBackend::~MappingBackend() {
+    mThread.request_stop();
+    mSubmitted.fetch_add(1, std::memory_order_release);
+    mSubmitted.notify_one();
+}
+
+void MappingBackend::Submit() noexcept {
+    mRequests.Publish();
+    mSubmitted.fetch_add(1, std::memory_order_release);
+    mSubmitted.notify_one();
+}
+
+void MappingBackend::Run(std::stop_token stop) {
+    u64 seen = 0;
+    while (true) {
+        mSubmitted.wait(seen, std::memory_order_acquire);
+        if (stop.stop_requested()) return;
+        seen = mSubmitted.load(std::memory_order_acquire);
+        if (!mRequests.Acquire()) continue;
+
+        MapWindow& window = mRequests.Front();
+        if (!Optimize(window)) continue;
+
+        // NOTE: Copy assignment keeps the capacity of the result slot
+        window.version = mOptimized.fetch_add(1, std::memory_order_relaxed) + 1;
+        mResults.Back() = window;
+        mResults.Publish();
+    }
+}
+
+// NOTE: The oldest window keyframes are fixed, the rest and every window point move. A result that
+// did not lower the cost is not published.
+bool MappingBackend::Optimize(MapWindow& window) {
+    if (window.fixed >= window.keyframes.size() || window.observations.empty()) return false;
+
+    bundle_adjustment<f64> ba({.max_iterations = mInfo.iterations, .pool = mInfo.pool});
+    const CameraIntrinsics& k = window.intrinsics;
+    for (const WindowObservation& o : window.observations) {
+        ba.add_residual<2>(o.keyframe, o.point, Reprojection{o.u, o.v, k.fx, k.fy, k.cx, k.cy},
+            huber_loss<f64>{mInfo.huber});
+    }
+    for (u32 i = 0; i < window.fixed; ++i) ba.set_pose_fixed(i);
+
+    mPoses.clear();
+    for (const Pose& pose : window.poses) mPoses.emplace_back(so3d::from_matrix(pose.rotation), pose.translation);
+    mPoints.assign(window.points.begin(), window.points.end());
+
+    auto summary = ba.solve(mPoses, mPoints);
+    if (!summary) {
+        log::Warn("Local bundle adjustment failed: {}", summary.error().Message());
+        return false;
+    }
+    if (summary->final_cost >= summary->initial_cost) return false;
+
+    for (std::size_t i = 0; i < mPoses.size(); ++i) {
+        window.poses[i].rotation = mPoses[i].rotation().matrix();
+        window.poses[i].translation = mPoses[i].translation();
+    }
+    std::copy(mPoints.begin(), mPoints.end(), window.points.begin());
+    return true;
+}
+
+} // namespace ct
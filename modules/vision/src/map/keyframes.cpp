@@ -0,0 +1,324 @@
+#include "toolbox/vision/map/keyframes.hpp"
+#include "toolbox/vision/geometry/triangulation.hpp"
+
+#include <algorithm>
+
+namespace ct {
+
+namespace {
+
+vec3d CameraCenter(const Pose& cameraFromWorld) {
+    return -(cameraFromWorld.rotation.transpose() * cameraFromWorld.translation);
+}
+
+} // namespace
+
+KeyframeManager::KeyframeManager(const KeyframeInfo& info)
+    : mInfo(info), mParallaxCos(ParallaxCosine(static_cast<f64>(info.parallax))),
+      mTriangulationCos(ParallaxCosine(static_cast<f64>(info.minParallax))), mMatcher(info.matcher) {
+    // NOTE: Insert holds one keyframe over the limit until it culls, no more ever exist at once
+    mKeyframes.reserve(info.maxKeyframes + 1);
+    mSpare.reserve(info.maxKeyframes + 1);
+}
+
+// NOTE: The keyframes leave the map but stay in the place index, a lost tracker can still find them
+void KeyframeManager::Reset() {
+    for (auto& keyframe : mKeyframes) {
+        Archive(keyframe);
+        mSpare.push_back(std::move(keyframe));
+    }
+    mKeyframes.clear();
+    mPoints.Clear();
+    ++mEpoch;
+}
+
+u32 KeyframeManager::Initialize(const Frame& first, const Frame& second, const Pose& secondPose,
+    const Matches& matches, std::span<const u8> mask, const CameraIntrinsics& intrinsics) {
+    Reset();
+    Push(first, Pose{});
+    Push(second, secondPose);
+    Keyframe& ref = mKeyframes[0];
+    Keyframe& curr = mKeyframes[1];
+    const Pose refFromCurr = Inverse(secondPose);
+
+    for (std::size_t i = 0; i < matches.size(); ++i) {
+        if (!mask[i]) continue;
+        const u32 q = static_cast<u32>(matches[i].queryIdx);
+        const u32 t = static_cast<u32>(matches[i].trainIdx);
+        // NOTE: Without a cross-check several keypoints may pick the same one in the other frame
+        if (curr.points[q].IsSet() || ref.points[t].IsSet()) continue;
+
+        vec3d pc;
+        if (!TriangulatePoint(intrinsics, refFromCurr, secondPose, curr.frame.kps.x[q], curr.frame.kps.y[q],
+                ref.frame.kps.x[t], ref.frame.kps.y[t], mTriangulationCos, mInfo.maxError, pc)) {
+            continue;
+        }
+
+        const MapPointHandle handle = mPoints.Add(Transform(refFromCurr, pc), curr.frame.des[q], curr.id);
+        Link(curr, q, handle);
+        Link(ref, t, handle);
+    }
+
+    ref.tracked = curr.tracked = mPoints.Size();
+    return mPoints.Size();
+}
+
+// NOTE: Losing tracked points always inserts, it is the last chance to triangulate before tracking
+// fails. Parallax is measured at the tracked points themselves, the angle between the rays to them
+// from the last keyframe and from this frame, so pure rotation does not count.
+bool KeyframeManager::NeedKeyframe(
+    const Frame& frame, const Pose& pose, std::span<const MapPointHandle> tracked, u32 trackedCount) {
+    if (mKeyframes.empty()) return false;
+    const Keyframe& last = mKeyframes.back();
+    if (static_cast<f32>(trackedCount) < mInfo.trackedRatio * static_cast<f32>(last.tracked)) return true;
+
+    const f64 elapsed = frame.timestamp - last.frame.timestamp;
+    if (elapsed < mInfo.minInterval) return false;
+    if (elapsed >= mInfo.maxInterval) return true;
+
+    const vec3d from = CameraCenter(last.pose);
+    const vec3d to = CameraCenter(pose);
+    const std::span<const vec3d> positions = mPoints.GetPositions();
+    mCosines.clear();
+    for (const MapPointHandle handle : tracked) {
+        const u32 index = mPoints.IndexOf(handle);
+        if (index == MapPointStore::kNone) continue;
+        const vec3d& p = positions[index];
+        mCosines.push_back((p - from).normalized().dot((p - to).normalized()));
+    }
+    if (mCosines.empty()) return false;
+
+    const auto median = mCosines.begin() + static_cast<std::ptrdiff_t>(mCosines.size() / 2);
+    std::nth_element(mCosines.begin(), median, mCosines.end());
+    return *median <= mParallaxCos;
+}
+
+u32 KeyframeManager::Insert(const Frame& frame, const Pose& pose, std::span<const MapPointHandle> tracked,
+    const CameraIntrinsics& intrinsics) {
+    Keyframe& curr = Push(frame, pose);
+    const std::size_t count = std::min(tracked.size(), curr.points.size());
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!mPoints.Contains(tracked[i])) continue;
+        Link(curr, static_cast<u32>(i), tracked[i]);
+        ++curr.tracked;
+    }
+
+    u32 added = 0;
+    if (mKeyframes.size() > 1) added = Triangulate(curr, mKeyframes[mKeyframes.size() - 2], intrinsics);
+
+    CullPoints(curr.id);
+    CullKeyframes();
+    return added;
+}
+
+void KeyframeManager::ExportWindow(u32 size, u32 fixed, MapWindow& out) {
+    const std::size_t first = mKeyframes.size() > size ? mKeyframes.size() - size : 0;
+    out.epoch = mEpoch;
+    out.fixed = std::min(fixed, static_cast<u32>(mKeyframes.size() - first));
+    out.keyframes.clear();
+    out.poses.clear();
+    out.handles.clear();
+    out.points.clear();
+    out.observations.clear();
+
+    // NOTE: Counts observations per point first, then reuses the counts as window indices
+    mWindowIndex.assign(mPoints.Size(), 0);
+    for (std::size_t k = first; k < mKeyframes.size(); ++k) {
+        for (const MapPointHandle handle : mKeyframes[k].points) {
+            const u32 index = mPoints.IndexOf(handle);
+            if (index != MapPointStore::kNone) ++mWindowIndex[index];
+        }
+    }
+
+    const std::span<const vec3d> positions = mPoints.GetPositions();
+    for (u32 i = 0; i < mPoints.Size(); ++i) {
+        if (mWindowIndex[i] < 2) {
+            mWindowIndex[i] = MapPointStore::kNone;
+            continue;
+        }
+        mWindowIndex[i] = static_cast<u32>(out.points.size());
+        out.handles.push_back(mPoints.HandleAt(i));
+        out.points.push_back(positions[i]);
+    }
+
+    for (std::size_t k = first; k < mKeyframes.size(); ++k) {
+        const Keyframe& keyframe = mKeyframes[k];
+        const u32 slot = static_cast<u32>(out.keyframes.size());
+        out.keyframes.push_back(keyframe.id);
+        out.poses.push_back(keyframe.pose);
+        for (u32 i = 0; i < keyframe.points.size(); ++i) {
+            const u32 index = mPoints.IndexOf(keyframe.points[i]);
+            if (index == MapPointStore::kNone || mWindowIndex[index] == MapPointStore::kNone) continue;
+            out.observations.push_back({slot, mWindowIndex[index], keyframe.frame.kps.x[i], keyframe.frame.kps.y[i]});
+        }
+    }
+}
+
+bool KeyframeManager::Apply(const MapWindow& window, Pose& correction) {
+    correction = {};
+    if (window.epoch != mEpoch || window.keyframes.empty()) return false;
+
+    const u32 newest = window.keyframes.back();
+    for (std::size_t w = 0; w < window.keyframes.size(); ++w) {
+        const auto it = std::find_if(mKeyframes.begin(), mKeyframes.end(),
+            [&](const Keyframe& keyframe) { return keyframe.id == window.keyframes[w]; });
+        if (it == mKeyframes.end()) continue;
+        if (it->id == newest) correction = Compose(Inverse(it->pose), window.poses[w]);
+        it->pose = window.poses[w];
+    }
+
+    const std::span<vec3d> positions = mPoints.GetPositions();
+    for (std::size_t j = 0; j < window.handles.size(); ++j) {
+        const u32 index = mPoints.IndexOf(window.handles[j]);
+        if (index != MapPointStore::kNone) positions[index] = window.points[j];
+    }
+
+    // NOTE: Keyframes and points newer than the window were placed relative to its newest keyframe
+    const Pose after = Inverse(correction);
+    for (Keyframe& keyframe : mKeyframes) {
+        if (keyframe.id > newest) keyframe.pose = Compose(keyframe.pose, correction);
+    }
+    for (u32 i = 0; i < mPoints.Size(); ++i) {
+        if (mPoints.GetCreated(i) > newest) positions[i] = Transform(after, positions[i]);
+    }
+    return true;
+}
+
+void KeyframeManager::QueryPlaces(const Frame& frame, u32 k, std::vector<PlaceCandidate>& out) {
+    out.clear();
+    if (!Indexing()) return;
+    mInfo.vocabulary->Transform(frame.des, mBow);
+    mPlaces.Query(mBow, k, out);
+}
+
+const PlaceRecord* KeyframeManager::FindPlace(u32 id) const noexcept {
+    if (id >= mArchiveSlot.size() || mArchiveSlot[id] == MapPointStore::kNone) return nullptr;
+    return &mArchive[mArchiveSlot[id]];
+}
+
+void KeyframeManager::ClearArchive() {
+    for (const PlaceRecord& record : mArchive) {
+        mPlaces.Remove(record.id);
+        mArchiveSlot[record.id] = MapPointStore::kNone;
+    }
+    mArchive.clear();
+}
+
+Keyframe& KeyframeManager::Push(const Frame& frame, const Pose& pose) {
+    if (mSpare.empty()) {
+        mKeyframes.emplace_back();
+    } else {
+        mKeyframes.push_back(std::move(mSpare.back()));
+        mSpare.pop_back();
+    }
+
+    Keyframe& keyframe = mKeyframes.back();
+    keyframe.id = mNextId++;
+    keyframe.frame = frame;
+    keyframe.pose = pose;
+    keyframe.points.assign(frame.kps.Size(), MapPointHandle{});
+    keyframe.tracked = 0;
+    keyframe.bow.Clear();
+    if (Indexing()) {
+        mInfo.vocabulary->Transform(frame.des, keyframe.bow);
+        mPlaces.Add(keyframe.id, keyframe.bow);
+    }
+    return keyframe;
+}
+
+// NOTE: Only keypoints without a live point in either keyframe are matched, the cross-checked
+// matches that pass the parallax and reprojection tests become points held by both
+u32 KeyframeManager::Triangulate(Keyframe& curr, Keyframe& ref, const CameraIntrinsics& intrinsics) {
+    const auto gather = [&](const Keyframe& keyframe, Descriptors& des, std::vector<u32>& index) {
+        des.clear();
+        index.clear();
+        for (u32 i = 0; i < keyframe.points.size(); ++i) {
+            if (mPoints.Contains(keyframe.points[i])) continue;
+            des.push_back(keyframe.frame.des[i]);
+            index.push_back(i);
+        }
+    };
+    gather(curr, mQuery, mQueryIndex);
+    gather(ref, mTrain, mTrainIndex);
+    if (mQuery.empty() || mTrain.empty()) return 0;
+
+    mMatcher.Match(mQuery, mTrain, mMatches);
+    const Pose refFromCurr = Compose(ref.pose, Inverse(curr.pose));
+    const Pose currFromRef = Inverse(refFromCurr);
+    const Pose worldFromCurr = Inverse(curr.pose);
+
+    u32 added = 0;
+    for (const auto& m : mMatches) {
+        const u32 q = mQueryIndex[static_cast<std::size_t>(m.queryIdx)];
+        const u32 t = mTrainIndex[static_cast<std::size_t>(m.trainIdx)];
+
+        vec3d pc;
+        if (!TriangulatePoint(intrinsics, refFromCurr, currFromRef, curr.frame.kps.x[q], curr.frame.kps.y[q],
+                ref.frame.kps.x[t], ref.frame.kps.y[t], mTriangulationCos, mInfo.maxError, pc)) {
+            continue;
+        }
+
+        const MapPointHandle handle = mPoints.Add(Transform(worldFromCurr, pc), curr.frame.des[q], curr.id);
+        Link(curr, q, handle);
+        Link(ref, t, handle);
+        ++added;
+    }
+    return added;
+}
+
+void KeyframeManager::Link(Keyframe& keyframe, u32 keypoint, MapPointHandle handle) {
+    keyframe.points[keypoint] = handle;
+    mPoints.AddObserver(mPoints.IndexOf(handle));
+}
+
+// NOTE: Points that stop matching where they project are outliers or on moving objects. A new
+// point gets pointGrace keyframes to be picked up by tracking, it is checked once, when the grace
+// runs out, so the points that earned their place are not re-examined at every keyframe.
+void KeyframeManager::CullPoints(u32 keyframe) {
+    for (u32 i = mPoints.Size(); i-- > 0;) {
+        const bool unmatched = mPoints.FoundRatio(i) < mInfo.minFoundRatio;
+        const bool unconfirmed =
+            keyframe - mPoints.GetCreated(i) == mInfo.pointGrace && mPoints.GetObservers(i) < mInfo.minObservers;
+        if (unmatched || unconfirmed) mPoints.Remove(mPoints.HandleAt(i));
+    }
+}
+
+// NOTE: A keyframe whose points are nearly all held by enough other keyframes adds nothing to the
+// map. The newest two are kept, the last one is the triangulation partner of the next.
+void KeyframeManager::CullKeyframes() {
+    for (std::size_t k = mKeyframes.size() > 2 ? mKeyframes.size() - 2 : 0; k-- > 0;) {
+        u32 live = 0, redundant = 0;
+        for (const MapPointHandle handle : mKeyframes[k].points) {
+            const u32 index = mPoints.IndexOf(handle);
+            if (index == MapPointStore::kNone) continue;
+            ++live;
+            redundant += mPoints.GetObservers(index) > mInfo.redundantObservers ? 1u : 0u;
+        }
+        if (static_cast<f32>(redundant) >= mInfo.redundancy * static_cast<f32>(live)) Drop(k);
+    }
+
+    while (mKeyframes.size() > mInfo.maxKeyframes) Drop(0);
+}
+
+// NOTE: Points only the dropped keyframe held leave the map with it
+void KeyframeManager::Drop(std::size_t index) {
+    Keyframe& keyframe = mKeyframes[index];
+    for (const MapPointHandle handle : keyframe.points) {
+        const u32 point = mPoints.IndexOf(handle);
+        if (point != MapPointStore::kNone && mPoints.RemoveObserver(point) == 0) mPoints.Remove(handle);
+    }
+
+    Archive(keyframe);
+    mSpare.push_back(std::move(keyframe));
+    mKeyframes.erase(mKeyframes.begin() + static_cast<std::ptrdiff_t>(index));
+}
+
+// NOTE: The BowVector is copied, the keyframe buffers go back to the spares
+void KeyframeManager::Archive(const Keyframe& keyframe) {
+    if (!Indexing()) return;
+    if (keyframe.id >= mArchiveSlot.size()) mArchiveSlot.resize(keyframe.id + 1, MapPointStore::kNone);
+    mArchiveSlot[keyframe.id] = static_cast<u32>(mArchive.size());
+    mArchive.push_back({keyframe.id, mEpoch, keyframe.pose, keyframe.bow});
+}
+
+} // namespace ct
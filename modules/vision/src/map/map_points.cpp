@@ -0,0 +1,127 @@
+#include "toolbox/vision/map/map_points.hpp"
+
+#include <algorithm>
+
+namespace ct {
+
+void MapPointStore::Clear() noexcept {
+    // NOTE: Every slot is retired so handles from before the clear stay dead
+    mFree = kNone;
+    for (u32 s = static_cast<u32>(mSlots.size()); s-- > 0;) {
+        mSlots[s].index = mFree;
+        ++mSlots[s].generation;
+        mFree = s;
+    }
+
+    mPositions.clear();
+    mDescriptors.clear();
+    mOwners.clear();
+    mVisible.clear();
+    mFound.clear();
+    mObservers.clear();
+    mCreated.clear();
+    mLastSeen.clear();
+}
+
+MapPointHandle MapPointStore::Add(const vec3d& position, const Descriptor& descriptor, u32 keyframe) {
+    u32 slot = mFree;
+    if (slot == kNone) {
+        slot = static_cast<u32>(mSlots.size());
+        mSlots.emplace_back();
+    } else {
+        mFree = mSlots[slot].index;
+    }
+    mSlots[slot].index = Size();
+
+    mPositions.push_back(position);
+    mDescriptors.push_back(descriptor);
+    mOwners.push_back(slot);
+    mVisible.push_back(1);
+    mFound.push_back(1);
+    mObservers.push_back(0);
+    mCreated.push_back(keyframe);
+    mLastSeen.push_back(0);
+    return {slot, mSlots[slot].generation};
+}
+
+bool MapPointStore::Remove(MapPointHandle handle) {
+    const u32 index = IndexOf(handle);
+    if (index == kNone) return false;
+
+    const u32 last = Size() - 1;
+    if (index != last) {
+        mPositions[index] = mPositions[last];
+        mDescriptors[index] = mDescriptors[last];
+        mOwners[index] = mOwners[last];
+        mVisible[index] = mVisible[last];
+        mFound[index] = mFound[last];
+        mObservers[index] = mObservers[last];
+        mCreated[index] = mCreated[last];
+        mLastSeen[index] = mLastSeen[last];
+        mSlots[mOwners[index]].index = index;
+    }
+    mPositions.pop_back();
+    mDescriptors.pop_back();
+    mOwners.pop_back();
+    mVisible.pop_back();
+    mFound.pop_back();
+    mObservers.pop_back();
+    mCreated.pop_back();
+    mLastSeen.pop_back();
+
+    Slot& slot = mSlots[handle.slot];
+    ++slot.generation;
+    slot.index = mFree;
+    mFree = handle.slot;
+    return true;
+}
+
+bool MapPointStore::Contains(MapPointHandle handle) const noexcept { return IndexOf(handle) != kNone; }
+
+// NOTE: A freed slot moved on to the next generation, so the generation check alone rejects both
+// stale handles and free slots
+u32 MapPointStore::IndexOf(MapPointHandle handle) const noexcept {
+    if (handle.slot >= mSlots.size()) return kNone;
+    const Slot& slot = mSlots[handle.slot];
+    return slot.generation == handle.generation ? slot.index : kNone;
+}
+
+MapPointHandle MapPointStore::HandleAt(u32 index) const noexcept {
+    const u32 slot = mOwners[index];
+    return {slot, mSlots[slot].generation};
+}
+
+// NOTE: A point matched by the brute-force fallback was never projected, it still counts as seen so
+// the ratio stays within [0, 1]
+void MapPointStore::MarkFound(u32 index, u32 frame) noexcept {
+    ++mFound[index];
+    mVisible[index] = std::max(mVisible[index], mFound[index]);
+    mLastSeen[index] = frame;
+}
+
+f32 MapPointStore::FoundRatio(u32 index) const noexcept {
+    return static_cast<f32>(mFound[index]) / static_cast<f32>(mVisible[index]);
+}
+
+void MapPointStore::Project(const Pose& cameraFromWorld, const CameraIntrinsics& intrinsics, f32 width, f32 height,
+    std::vector<cv::Point2f>& out) {
+    out.resize(mPositions.size());
+    for (std::size_t i = 0; i < mPositions.size(); ++i) {
+        const vec3d pc = Transform(cameraFromWorld, mPositions[i]);
+        if (pc.z <= 1e-6) {
+            out[i] = kNowhere;
+            continue;
+        }
+
+        const f32 u = static_cast<f32>(intrinsics.fx * pc.x / pc.z + intrinsics.cx);
+        const f32 v = static_cast<f32>(intrinsics.fy * pc.y / pc.z + intrinsics.cy);
+        if (u < 0.0f || v < 0.0f || u >= width || v >= height) {
+            out[i] = kNowhere;
+            continue;
+        }
+        out[i] = cv::Point2f(u, v);
+        ++mVisible[i];
+    }
+}
+
+} // namespace ct
@@ -0,0 +1,83 @@
+#include "toolbox/vision/place/database.hpp"
+
+#include <algorithm>
+
+namespace ct {
+
+void PlaceDatabase::Clear() {
+    for (auto& postings : mPostings) postings.clear();
+    mEntries.clear();
+    mFree.clear();
+    mIds.clear();
+    mScores.clear();
+}
+
+void PlaceDatabase::Add(u32 id, const BowVector& bow) {
+    Remove(id);
+
+    u32 entry;
+    if (mFree.empty()) {
+        entry = static_cast<u32>(mEntries.size());
+        mEntries.emplace_back();
+        mScores.push_back(0.0f);
+    } else {
+        entry = mFree.back();
+        mFree.pop_back();
+    }
+    mEntries[entry].id = id;
+    mEntries[entry].words.assign(bow.words.begin(), bow.words.end());
+    mIds[id] = entry;
+
+    if (!bow.Empty() && bow.words.back() >= mPostings.size()) mPostings.resize(bow.words.back() + 1);
+    for (u32 i = 0; i < bow.Size(); ++i) mPostings[bow.words[i]].push_back({entry, bow.weights[i]});
+}
+
+// NOTE: Swap-removes the entry from the list of each of its words, the lists are unordered
+bool PlaceDatabase::Remove(u32 id) {
+    const auto it = mIds.find(id);
+    if (it == mIds.end()) return false;
+    const u32 entry = it->second;
+    mIds.erase(it);
+
+    for (const u32 word : mEntries[entry].words) {
+        auto& postings = mPostings[word];
+        const auto p = std::find_if(postings.begin(), postings.end(), [&](const Posting& x) { return x.entry == entry; });
+        if (p == postings.end()) continue;
+        *p = postings.back();
+        postings.pop_back();
+    }
+    mEntries[entry].words.clear();
+    mFree.push_back(entry);
+    return true;
+}
+
+// NOTE: Weights are positive, so an entry is met for the first time exactly when its score is zero
+void PlaceDatabase::Query(const BowVector& bow, u32 k, std::vector<PlaceCandidate>& out, f32 minScore) {
+    out.clear();
+    mTouched.clear();
+    for (u32 i = 0; i < bow.Size(); ++i) {
+        if (bow.words[i] >= mPostings.size()) break;
+        const f32 weight = bow.weights[i];
+        for (const Posting& p : mPostings[bow.words[i]]) {
+            if (mScores[p.entry] == 0.0f) mTouched.push_back(p.entry);
+            mScores[p.entry] += std::min(weight, p.weight);
+        }
+    }
+
+    for (const u32 entry : mTouched) {
+        if (mScores[entry] >= minScore) out.push_back({mEntries[entry].id, mScores[entry]});
+        mScores[entry] = 0.0f;
+    }
+
+    const auto better = [](const PlaceCandidate& a, const PlaceCandidate& b) {
+        return a.score > b.score || (a.score == b.score && a.id < b.id);
+    };
+    if (k < out.size()) {
+        std::partial_sort(out.begin(), out.begin() + k, out.end(), better);
+        out.resize(k);
+    } else {
+        std::sort(out.begin(), out.end(), better);
+    }
+}
+
+} // namespace ct
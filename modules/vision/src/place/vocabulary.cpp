@@ -0,0 +1,454 @@
+#include "toolbox/vision/place/vocabulary.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <numeric>
+#include <random>
+
+#if defined(TOOLBOX_CPU_DISPATCH)
+#include <immintrin.h>
+#endif
+
+namespace ct {
+
+namespace {
+
+constexpr u32 kNone = 0xffffffffu;
+constexpr u64 kMagic = 0x314241434f565443ull; // "CTVOCAB1" in little endian
+constexpr u32 kVersion = 1;
+
+struct VocabularyHeader {
+    u64 magic{kMagic};
+    u32 version{kVersion};
+    u32 branching{0};
+    u32 depth{0};
+    u32 nodes{0};
+    u32 words{0};
+    u32 reserved{0};
+};
+
+// NOTE: Keeps the center array that follows the header 32-byte aligned
+static_assert(sizeof(VocabularyHeader) == 32);
+
+struct Layout {
+    std::size_t centers, first, count, weights, size;
+};
+
+Layout FileLayout(u32 nodes, u32 words) noexcept {
+    Layout l{};
+    l.centers = sizeof(VocabularyHeader);
+    l.first = l.centers + std::size_t{nodes} * sizeof(Descriptor);
+    l.count = l.first + std::size_t{nodes} * sizeof(u32);
+    l.weights = l.count + std::size_t{nodes} * sizeof(u32);
+    l.size = l.weights + std::size_t{words} * sizeof(f32);
+    return l;
+}
+
+// NOTE: Flat tree the kernels walk, shared by loaded and trained vocabularies
+struct Tree {
+    const Descriptor* centers;
+    const u32* first;
+    const u32* count;
+};
+
+using QuantizeKernel = void (*)(const Tree& tree, std::span<const Descriptor> descriptors, u32* out) noexcept;
+
+// NOTE: Nearest of centers[begin, end), ties keep the lower index like the matcher kernels
+TOOLBOX_FORCE_INLINE u32 NearestRange(const Descriptor& q, const Descriptor* centers, u32 begin, u32 end,
+    u32& best, u32 index) noexcept {
+    for (u32 j = begin; j < end; ++j) {
+        const u32 d = q.Distance(centers[j]);
+        if (d < best) {
+            best = d;
+            index = j;
+        }
+    }
+    return index;
+}
+
+TOOLBOX_FORCE_INLINE void QuantizeBody(const Tree& tree, std::span<const Descriptor> descriptors, u32* out) noexcept {
+    for (std::size_t i = 0; i < descriptors.size(); ++i) {
+        u32 node = 0;
+        while (tree.count[node] != 0) {
+            u32 best = kNone;
+            node = NearestRange(descriptors[i], tree.centers, tree.first[node], tree.first[node] + tree.count[node],
+                best, kNone);
+        }
+        out[i] = tree.first[node];
+    }
+}
+
+void QuantizeScalar(const Tree& tree, std::span<const Descriptor> descriptors, u32* out) noexcept {
+    QuantizeBody(tree, descriptors, out);
+}
+
+#if defined(TOOLBOX_CPU_DISPATCH)
+
+// NOTE: Same loop, std::popcount lowers to the POPCNT instruction instead of bit tricks
+TOOLBOX_TARGET_SSE42 void QuantizeSse42(const Tree& tree, std::span<const Descriptor> descriptors, u32* out) noexcept {
+    QuantizeBody(tree, descriptors, out);
+}
+
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE __m256i LoadDescriptor(const Descriptor& d) noexcept {
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(d.words.data()));
+}
+
+// NOTE: Popcount of every byte through a 4-bit lookup table (vpshufb)
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE __m256i ByteCounts(__m256i v) noexcept {
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2,
+        1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, nibble));
+    const __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+    return _mm256_add_epi8(lo, hi);
+}
+
+// NOTE: Distances of q to c[0..3] as four u16 packed into one u64, see Distances4Avx2 in descriptor.cpp
+TOOLBOX_TARGET_AVX2 TOOLBOX_FORCE_INLINE u64 Distances4(__m256i q, const Descriptor* c) noexcept {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i s0 = _mm256_sad_epu8(ByteCounts(_mm256_xor_si256(q, LoadDescriptor(c[0]))), zero);
+    const __m256i s1 = _mm256_sad_epu8(ByteCounts(_mm256_xor_si256(q, LoadDescriptor(c[1]))), zero);
+    const __m256i s2 = _mm256_sad_epu8(ByteCounts(_mm256_xor_si256(q, LoadDescriptor(c[2]))), zero);
+    const __m256i s3 = _mm256_sad_epu8(ByteCounts(_mm256_xor_si256(q, LoadDescriptor(c[3]))), zero);
+    const __m256i s = _mm256_or_si256(_mm256_or_si256(s0, _mm256_slli_epi64(s1, 16)),
+        _mm256_or_si256(_mm256_slli_epi64(s2, 32), _mm256_slli_epi64(s3, 48)));
+    const __m128i h = _mm_add_epi64(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+    return static_cast<u64>(_mm_cvtsi128_si64(_mm_add_epi64(h, _mm_unpackhi_epi64(h, h))));
+}
+
+// NOTE: Children in blocks of four, the argmin over the four packed distances stays scalar, a
+// descent step only compares branching of them
+TOOLBOX_TARGET_AVX2 void QuantizeAvx2(const Tree& tree, std::span<const Descriptor> descriptors, u32* out) noexcept {
+    for (std::size_t i = 0; i < descriptors.size(); ++i) {
+        const __m256i q = LoadDescriptor(descriptors[i]);
+        u32 node = 0;
+        while (tree.count[node] != 0) {
+            const u32 begin = tree.first[node];
+            const u32 end = begin + tree.count[node];
+            u32 best = kNone, index = kNone;
+            u32 j = begin;
+            for (; j + 4 <= end; j += 4) {
+                const u64 d = Distances4(q, tree.centers + j);
+                for (u32 l = 0; l < 4; ++l) {
+                    const u32 dl = static_cast<u32>(d >> (16 * l)) & 0xffffu;
+                    if (dl < best) {
+                        best = dl;
+                        index = j + l;
+                    }
+                }
+            }
+            node = NearestRange(descriptors[i], tree.centers, j, end, best, index);
+        }
+        out[i] = tree.first[node];
+    }
+}
+
+#endif
+
+constexpr cpu::KernelTable<QuantizeKernel> kQuantizeKernels{
+    .scalar = QuantizeScalar,
+#if defined(TOOLBOX_CPU_DISPATCH)
+    .sse42 = QuantizeSse42,
+    .avx2 = QuantizeAvx2,
+#endif
+};
+
+// NOTE: k-majority clustering of all[members]. Seeds k-means++ style with probability proportional
+// to the squared Hamming distance, then alternates majority votes per bit and reassignment until
+// no descriptor changes cluster. assignment always belongs to the final centers.
+class Clusterer {
+public:
+    explicit Clusterer(u64 seed) : mRng(seed) {}
+
+    void Run(std::span<const Descriptor> all, std::span<const u32> members, u32 k, u32 iterations,
+        Descriptors& centers, std::vector<u32>& assignment) {
+        Seed(all, members, k, centers);
+        assignment.assign(members.size(), kNone);
+        Assign(all, members, centers, assignment);
+        for (u32 it = 0; it < iterations; ++it) {
+            Vote(all, members, assignment, centers);
+            if (!Assign(all, members, centers, assignment)) break;
+        }
+    }
+
+private:
+    void Seed(std::span<const Descriptor> all, std::span<const u32> members, u32 k, Descriptors& centers) {
+        centers.clear();
+        std::uniform_int_distribution<std::size_t> pick(0, members.size() - 1);
+        centers.push_back(all[members[pick(mRng)]]);
+
+        mDistances.resize(members.size());
+        for (std::size_t i = 0; i < members.size(); ++i) mDistances[i] = all[members[i]].Distance(centers[0]);
+
+        while (centers.size() < k) {
+            f64 total = 0.0;
+            for (const u32 d : mDistances) total += static_cast<f64>(d) * d;
+            if (total == 0.0) break;
+
+            f64 r = std::uniform_real_distribution<f64>(0.0, total)(mRng);
+            std::size_t chosen = members.size() - 1;
+            for (std::size_t i = 0; i < members.size(); ++i) {
+                r -= static_cast<f64>(mDistances[i]) * mDistances[i];
+                if (r < 0.0) {
+                    chosen = i;
+                    break;
+                }
+            }
+            centers.push_back(all[members[chosen]]);
+            for (std::size_t i = 0; i < members.size(); ++i) {
+                mDistances[i] = std::min(mDistances[i], all[members[i]].Distance(centers.back()));
+            }
+        }
+    }
+
+    // NOTE: True when any assignment changed
+    static bool Assign(std::span<const Descriptor> all, std::span<const u32> members, const Descriptors& centers,
+        std::vector<u32>& assignment) {
+        bool changed = false;
+        for (std::size_t i = 0; i < members.size(); ++i) {
+            u32 best = kNone;
+            const u32 c = NearestRange(all[members[i]], centers.data(), 0, static_cast<u32>(centers.size()), best, 0);
+            changed |= c != assignment[i];
+            assignment[i] = c;
+        }
+        return changed;
+    }
+
+    // NOTE: A bit of a center is set when more than half its descriptors have it set, an empty
+    // cluster keeps its center
+    void Vote(std::span<const Descriptor> all, std::span<const u32> members, std::span<const u32> assignment,
+        Descriptors& centers) {
+        mBits.assign(centers.size() * Descriptor::kBits, 0);
+        mSizes.assign(centers.size(), 0);
+        for (std::size_t i = 0; i < members.size(); ++i) {
+            u32* bits = mBits.data() + std::size_t{assignment[i]} * Descriptor::kBits;
+            ++mSizes[assignment[i]];
+            const Descriptor& d = all[members[i]];
+            for (u32 b = 0; b < Descriptor::kBits; ++b) bits[b] += static_cast<u32>(d.words[b / 64] >> (b % 64)) & 1u;
+        }
+        for (std::size_t c = 0; c < centers.size(); ++c) {
+            if (mSizes[c] == 0) continue;
+            const u32* bits = mBits.data() + c * Descriptor::kBits;
+            Descriptor center;
+            for (u32 b = 0; b < Descriptor::kBits; ++b) {
+                if (2 * bits[b] > mSizes[c]) center.words[b / 64] |= u64{1} << (b % 64);
+            }
+            centers[c] = center;
+        }
+    }
+
+    std::mt19937_64 mRng;
+    std::vector<u32> mDistances;
+    std::vector<u32> mBits;
+    std::vector<u32> mSizes;
+};
+
+} // namespace
+
+f32 Score(const BowVector& a, const BowVector& b) noexcept {
+    f32 score = 0.0f;
+    std::size_t i = 0, j = 0;
+    while (i < a.words.size() && j < b.words.size()) {
+        if (a.words[i] < b.words[j]) {
+            ++i;
+        } else if (b.words[j] < a.words[i]) {
+            ++j;
+        } else {
+            score += std::min(a.weights[i++], b.weights[j++]);
+        }
+    }
+    return score;
+}
+
+// NOTE: Breadth first, so the children of every node are appended next to each other. A node
+// becomes a leaf at full depth, when it holds no more descriptors than it would have children, or
+// when all of its descriptors fall into one cluster.
+result<Vocabulary> Vocabulary::Train(std::span<const Descriptors> images, const VocabularyInfo& info) {
+    if (info.branching < 2 || info.depth == 0) {
+        return err(ErrorCode::INVALID_ARGUMENT, "Vocabulary needs a branching of at least 2 and a depth of at least 1");
+    }
+
+    Descriptors all;
+    for (const Descriptors& image : images) all.insert(all.end(), image.begin(), image.end());
+    if (all.empty()) return err(ErrorCode::INVALID_ARGUMENT, "Vocabulary training set has no descriptors");
+
+    Vocabulary voc;
+    voc.mBranching = info.branching;
+    voc.mDepth = info.depth;
+    voc.mOwnedCenters.emplace_back();
+    voc.mOwnedFirst.push_back(0);
+    voc.mOwnedCount.push_back(0);
+
+    struct Pending {
+        u32 node;
+        u32 level;
+        std::vector<u32> members;
+    };
+    std::deque<Pending> queue;
+    queue.push_back({0, 0, std::vector<u32>(all.size())});
+    std::iota(queue.front().members.begin(), queue.front().members.end(), 0u);
+
+    Clusterer clusterer(info.seed);
+    Descriptors centers;
+    std::vector<u32> assignment;
+    std::vector<std::vector<u32>> groups;
+    u32 words = 0;
+
+    while (!queue.empty()) {
+        Pending pending = std::move(queue.front());
+        queue.pop_front();
+
+        bool leaf = pending.level == info.depth || pending.members.size() <= info.branching;
+        if (!leaf) {
+            clusterer.Run(all, pending.members, info.branching, info.iterations, centers, assignment);
+            groups.assign(centers.size(), {});
+            for (std::size_t i = 0; i < pending.members.size(); ++i) groups[assignment[i]].push_back(pending.members[i]);
+            const auto used = std::count_if(groups.begin(), groups.end(), [](const auto& g) { return !g.empty(); });
+            leaf = used < 2;
+        }
+        if (leaf) {
+            voc.mOwnedFirst[pending.node] = words++;
+            continue;
+        }
+
+        voc.mOwnedFirst[pending.node] = static_cast<u32>(voc.mOwnedCenters.size());
+        for (std::size_t c = 0; c < centers.size(); ++c) {
+            if (groups[c].empty()) continue;
+            const u32 child = static_cast<u32>(voc.mOwnedCenters.size());
+            voc.mOwnedCenters.push_back(centers[c]);
+            voc.mOwnedFirst.push_back(0);
+            voc.mOwnedCount.push_back(0);
+            ++voc.mOwnedCount[pending.node];
+            queue.push_back({child, pending.level + 1, std::move(groups[c])});
+        }
+    }
+
+    voc.mCenters = voc.mOwnedCenters;
+    voc.mFirst = voc.mOwnedFirst;
+    voc.mCount = voc.mOwnedCount;
+
+    // NOTE: idf over the images the word occurs in, not over its occurrences
+    std::vector<u32> occurrences(words, 0);
+    std::vector<u32> quantized;
+    u32 nonEmpty = 0;
+    for (const Descriptors& image : images) {
+        if (image.empty()) continue;
+        ++nonEmpty;
+        quantized.resize(image.size());
+        voc.Quantize(image, quantized);
+        std::sort(quantized.begin(), quantized.end());
+        const auto last = std::unique(quantized.begin(), quantized.end());
+        for (auto it = quantized.begin(); it != last; ++it) ++occurrences[*it];
+    }
+
+    voc.mOwnedWeights.resize(words);
+    for (u32 w = 0; w < words; ++w) {
+        voc.mOwnedWeights[w] = occurrences[w] == 0
+            ? 0.0f
+            : static_cast<f32>(std::log(static_cast<f64>(nonEmpty) / static_cast<f64>(occurrences[w])));
+    }
+    voc.mWeights = voc.mOwnedWeights;
+
+    log::Info("Trained a vocabulary of {} words from {} descriptors", words, all.size());
+    return ok(std::move(voc));
+}
+
+result<Vocabulary> Vocabulary::Load(const std::filesystem::path& path) {
+    auto file = memory::MappedFile::Open(path);
+    if (!file) return err(file.error());
+
+    const std::span<const u8> bytes = file->Bytes();
+    VocabularyHeader header;
+    if (bytes.size() < sizeof(header)) return err(ErrorCode::PARSE_INVALID_FORMAT, "Vocabulary file is truncated");
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != kMagic) return err(ErrorCode::PARSE_INVALID_FORMAT, "Not a vocabulary file");
+    if (header.version != kVersion) return err(ErrorCode::PARSE_INVALID_FORMAT, "Unsupported vocabulary version");
+
+    const Layout layout = FileLayout(header.nodes, header.words);
+    if (header.nodes == 0 || bytes.size() != layout.size) {
+        return err(ErrorCode::PARSE_INVALID_FORMAT, "Vocabulary file size does not match its header");
+    }
+
+    Vocabulary voc;
+    voc.mBranching = header.branching;
+    voc.mDepth = header.depth;
+    voc.mCenters = {reinterpret_cast<const Descriptor*>(bytes.data() + layout.centers), header.nodes};
+    voc.mFirst = {reinterpret_cast<const u32*>(bytes.data() + layout.first), header.nodes};
+    voc.mCount = {reinterpret_cast<const u32*>(bytes.data() + layout.count), header.nodes};
+    voc.mWeights = {reinterpret_cast<const f32*>(bytes.data() + layout.weights), header.words};
+
+    // NOTE: Children always come after their parent, so every descent ends at a leaf
+    for (u32 n = 0; n < header.nodes; ++n) {
+        const u32 first = voc.mFirst[n];
+        const u32 count = voc.mCount[n];
+        const bool valid = count == 0 ? first < header.words
+                                      : first > n && first <= header.nodes && count <= header.nodes - first;
+        if (!valid) return err(ErrorCode::PARSE_INVALID_FORMAT, "Vocabulary tree is corrupt");
+    }
+
+    voc.mFile = std::move(*file);
+    return ok(std::move(voc));
+}
+
+result<void> Vocabulary::Save(const std::filesystem::path& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return err(ErrorCode::FILE_ACCESS_DENIED, "Cannot open " + path.string());
+
+    VocabularyHeader header;
+    header.branching = mBranching;
+    header.depth = mDepth;
+    header.nodes = GetNodes();
+    header.words = GetWords();
+
+    const auto write = [&](const auto* data, std::size_t count) {
+        out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(*data)));
+    };
+    write(&header, 1);
+    write(mCenters.data(), mCenters.size());
+    write(mFirst.data(), mFirst.size());
+    write(mCount.data(), mCount.size());
+    write(mWeights.data(), mWeights.size());
+
+    if (!out) return err(ErrorCode::FILE_WRITE_ERROR, "Cannot write " + path.string());
+    return ok();
+}
+
+void Vocabulary::Quantize(std::span<const Descriptor> descriptors, std::span<u32> out) const noexcept {
+    if (mCenters.empty()) return;
+    const Tree tree{mCenters.data(), mFirst.data(), mCount.data()};
+    kQuantizeKernels.Get()(tree, descriptors.first(std::min(descriptors.size(), out.size())), out.data());
+}
+
+void Vocabulary::Transform(std::span<const Descriptor> descriptors, BowVector& out) const {
+    out.Clear();
+    if (Empty()) return;
+    out.words.resize(descriptors.size());
+    Quantize(descriptors, out.words);
+    std::sort(out.words.begin(), out.words.end());
+
+    // NOTE: Sorted in place, equal words are merged from the front so no scratch buffer is needed
+    out.weights.clear();
+    std::size_t size = 0;
+    f32 total = 0.0f;
+    for (const u32 word : out.words) {
+        const f32 idf = mWeights[word];
+        if (idf <= 0.0f) continue;
+        total += idf;
+        if (size > 0 && out.words[size - 1] == word) {
+            out.weights[size - 1] += idf;
+        } else {
+            out.words[size++] = word;
+            out.weights.push_back(idf);
+        }
+    }
+    out.words.resize(size);
+
+    if (total > 0.0f) {
+        for (f32& w : out.weights) w /= total;
+    }
+}
+
+} // namespace ct
@@ -0,0 +1,116 @@
+#include "support.hpp"
+
+#include "toolbox/vision/features/convert.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <numbers>
+#include <vector>
+
+namespace ct {
+namespace {
+
+constexpr f32 kPi = std::numbers::pi_v<f32>;
+
+TEST(Convert, ToKeyPointsMapsRadiansToDegrees) {
+    Keypoints kps;
+    kps.Push(10.0f, 20.0f, 0.0f, 5.0f, 0);
+    kps.Push(30.5f, 40.25f, kPi / 2.0f, 7.0f, 1);
+    kps.Push(1.0f, 2.0f, -kPi / 2.0f, 9.0f, 3);
+    kps.Push(3.0f, 4.0f, kPi, 11.0f, 255);
+
+    std::vector<cv::KeyPoint> out;
+    ToKeyPoints(kps, out, 12.0f);
+    ASSERT_EQ(out.size(), 4u);
+
+    const f32 degrees[] = {0.0f, 90.0f, 270.0f, 180.0f};
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        EXPECT_EQ(out[i].pt.x, kps.x[i]);
+        EXPECT_EQ(out[i].pt.y, kps.y[i]);
+        EXPECT_EQ(out[i].size, 12.0f);
+        EXPECT_NEAR(out[i].angle, degrees[i], 1e-4f) << i;
+        EXPECT_EQ(out[i].response, kps.response[i]);
+        EXPECT_EQ(out[i].octave, static_cast<int>(kps.octave[i]));
+    }
+
+    ToKeyPoints(Keypoints{}, out);
+    EXPECT_TRUE(out.empty());
+}
+
+TEST(Convert, FromKeyPointsMapsDegreesToRadians) {
+    const std::vector<cv::KeyPoint> kps{
+        cv::KeyPoint(cv::Point2f(1.0f, 2.0f), 31.0f, 0.0f, 3.0f, 0),
+        cv::KeyPoint(cv::Point2f(4.0f, 5.0f), 31.0f, 90.0f, 6.0f, 2),
+        cv::KeyPoint(cv::Point2f(7.0f, 8.0f), 31.0f, 270.0f, 9.0f, 4),
+        // NOTE: Unoriented and out of range octaves
+        cv::KeyPoint(cv::Point2f(10.0f, 11.0f), 31.0f, -1.0f, 12.0f, -2),
+        cv::KeyPoint(cv::Point2f(13.0f, 14.0f), 31.0f, 180.0f, 15.0f, 300),
+    };
+
+    Keypoints out;
+    out.Push(99.0f, 99.0f, 0.0f, 0.0f);
+    FromKeyPoints(kps, out);
+    ASSERT_EQ(out.Size(), kps.size());
+    ASSERT_EQ(out.angle.size(), kps.size());
+    ASSERT_EQ(out.octave.size(), kps.size());
+
+    const f32 radians[] = {0.0f, kPi / 2.0f, -kPi / 2.0f, 0.0f, kPi};
+    const u8 octaves[] = {0, 2, 4, 0, 255};
+    for (std::size_t i = 0; i < kps.size(); ++i) {
+        EXPECT_EQ(out.x[i], kps[i].pt.x);
+        EXPECT_EQ(out.y[i], kps[i].pt.y);
+        EXPECT_NEAR(out.angle[i], radians[i], 1e-6f) << i;
+        EXPECT_EQ(out.response[i], kps[i].response);
+        EXPECT_EQ(out.octave[i], octaves[i]);
+    }
+}
+
+TEST(Convert, KeyPointsRoundTrip) {
+    Keypoints kps;
+    for (int i = 0; i < 64; ++i) {
+        const f32 angle = -kPi + 2.0f * kPi * static_cast<f32>(i) / 64.0f;
+        kps.Push(static_cast<f32>(i) * 1.5f, static_cast<f32>(i) * 0.25f, angle, static_cast<f32>(i), static_cast<u8>(i % 8));
+    }
+
+    std::vector<cv::KeyPoint> cvKps;
+    Keypoints back;
+    ToKeyPoints(kps, cvKps);
+    FromKeyPoints(cvKps, back);
+    ASSERT_EQ(back.Size(), kps.Size());
+    EXPECT_EQ(back.x, kps.x);
+    EXPECT_EQ(back.y, kps.y);
+    EXPECT_EQ(back.response, kps.response);
+    EXPECT_EQ(back.octave, kps.octave);
+    for (std::size_t i = 0; i < kps.Size(); ++i) {
+        // NOTE: -pi and pi are the same direction
+        f32 diff = back.angle[i] - kps.angle[i];
+        if (diff > kPi) diff -= 2.0f * kPi;
+        if (diff < -kPi) diff += 2.0f * kPi;
+        EXPECT_NEAR(diff, 0.0f, 1e-5f) << i;
+    }
+}
+
+TEST(Convert, DescriptorsRoundTripThroughMat) {
+    const Descriptors des = test::RandomDescriptors(37, 1);
+
+    cv::Mat mat;
+    ToMat(des, mat);
+    ASSERT_EQ(mat.rows, 37);
+    ASSERT_EQ(mat.cols, static_cast<int>(Descriptor::kBytes));
+    ASSERT_EQ(mat.type(), CV_8UC1);
+    for (int r = 0; r < mat.rows; ++r) {
+        EXPECT_EQ(std::memcmp(mat.ptr<u8>(r), des[static_cast<std::size_t>(r)].words.data(), Descriptor::kBytes), 0);
+    }
+
+    Descriptors back = test::RandomDescriptors(3, 2);
+    PackDescriptors(mat, back);
+    ASSERT_EQ(back.size(), des.size());
+    for (std::size_t i = 0; i < des.size(); ++i) EXPECT_EQ(back[i].words, des[i].words);
+
+    PackDescriptors(cv::Mat(), back);
+    EXPECT_TRUE(back.empty());
+}
+
+} // namespace
+} // namespace ct
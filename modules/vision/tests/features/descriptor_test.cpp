@@ -0,0 +1,83 @@
+#include "support.hpp"
+
+#include "toolbox/vision/features/descriptor.hpp"
+
+#include <gtest/gtest.h>
+
+namespace ct {
+namespace {
+
+constexpr cpu::SimdLevel kLevels[] = {cpu::SimdLevel::SSE42, cpu::SimdLevel::AVX2, cpu::SimdLevel::AVX512};
+
+// NOTE: Straight from the definition, nearest first and the lower index on ties
+HammingNeighbors Reference(const Descriptors& query, const Descriptors& train) {
+    constexpr u32 kNone = HammingNeighbors::kNone;
+    HammingNeighbors out;
+    out.queryBest.assign(query.size(), kNone);
+    out.querySecond.assign(query.size(), kNone);
+    out.queryIndex.assign(query.size(), kNone);
+    out.trainBest.assign(train.size(), kNone);
+    out.trainIndex.assign(train.size(), kNone);
+    for (u32 q = 0; q < query.size(); ++q) {
+        for (u32 t = 0; t < train.size(); ++t) {
+            const u32 d = query[q].Distance(train[t]);
+            if (d < out.queryBest[q]) {
+                out.querySecond[q] = out.queryBest[q];
+                out.queryBest[q] = d;
+                out.queryIndex[q] = t;
+            } else if (d < out.querySecond[q]) {
+                out.querySecond[q] = d;
+            }
+            if (d < out.trainBest[t]) {
+                out.trainBest[t] = d;
+                out.trainIndex[t] = q;
+            }
+        }
+    }
+    return out;
+}
+
+void ExpectSame(const HammingNeighbors& actual, const HammingNeighbors& expected) {
+    EXPECT_EQ(actual.queryBest, expected.queryBest);
+    EXPECT_EQ(actual.querySecond, expected.querySecond);
+    EXPECT_EQ(actual.queryIndex, expected.queryIndex);
+    EXPECT_EQ(actual.trainBest, expected.trainBest);
+    EXPECT_EQ(actual.trainIndex, expected.trainIndex);
+}
+
+TEST(Hamming, EveryLevelMatchesTheDefinition) {
+    // NOTE: Clustered descriptors give many equal distances, sizes leave a SIMD tail on both sides
+    const Descriptors centers = test::RandomDescriptors(40, 1);
+    for (const auto& [queries, trains] : {std::pair{1u, 1u}, {7u, 3u}, {131u, 77u}, {300u, 517u}}) {
+        const Descriptors query = test::PerturbedDescriptors(centers, queries, 6, queries);
+        const Descriptors train = test::PerturbedDescriptors(centers, trains, 6, trains + 1000);
+        const HammingNeighbors expected = Reference(query, train);
+
+        HammingNeighbors actual;
+        {
+            test::ScopedSimdLevel scalar(cpu::SimdLevel::Scalar);
+            FindNeighbors(query, train, actual);
+        }
+        ExpectSame(actual, expected);
+
+        for (const cpu::SimdLevel level : kLevels) {
+            if (level > cpu::GetDetectedLevel()) continue;
+            test::ScopedSimdLevel scoped(level);
+            FindNeighbors(query, train, actual);
+            SCOPED_TRACE(cpu::ToString(level));
+            ExpectSame(actual, expected);
+        }
+    }
+}
+
+TEST(Hamming, EmptyTrainLeavesNoNeighbours) {
+    const Descriptors query = test::RandomDescriptors(5, 2);
+    HammingNeighbors out;
+    FindNeighbors(query, {}, out);
+    ASSERT_EQ(out.queryBest.size(), query.size());
+    for (const u32 d : out.queryBest) EXPECT_EQ(d, HammingNeighbors::kNone);
+    EXPECT_TRUE(out.trainBest.empty());
+}
+
+} // namespace
+} // namespace ct
@@ -0,0 +1,163 @@
+#include "support.hpp"
+
+#include "toolbox/vision/features/grid.hpp"
+#include "toolbox/vision/features/matcher.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace ct {
+namespace {
+
+// NOTE: The bounding box starts far from the origin and reaches below zero, so cells must be
+// offset by its corner rather than counted from (0, 0)
+Keypoints MakeKeypoints(std::size_t count, u32 seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<f32> x(-40.0f, 600.0f), y(150.0f, 470.0f);
+    Keypoints kps;
+    for (std::size_t i = 0; i < count; ++i) {
+        const f32 px = x(rng);
+        kps.Push(px, y(rng), 0.0f, 0.0f);
+    }
+    return kps;
+}
+
+std::vector<u32> InRadius(const Keypoints& kps, f32 x, f32 y, f32 radius) {
+    std::vector<u32> out;
+    for (u32 i = 0; i < static_cast<u32>(kps.Size()); ++i) {
+        const f32 dx = kps.x[i] - x;
+        const f32 dy = kps.y[i] - y;
+        if (dx * dx + dy * dy <= radius * radius) out.push_back(i);
+    }
+    return out;
+}
+
+// NOTE: Every train descriptor against the query descriptors within radius of its prediction,
+// nearest first and the lower index on ties, then the same acceptance rules as the matcher
+Matches ReferenceGuided(const HammingMatcherInfo& info, const Descriptors& query,
+    const Keypoints& kps, const Descriptors& train,
+    const std::vector<cv::Point2f>& predicted, f32 radius) {
+    constexpr u32 kNone = HammingNeighbors::kNone;
+    std::vector<u32> best(train.size(), kNone), second(train.size(), kNone), index(train.size(), kNone);
+    std::vector<u32> reverseBest(query.size(), kNone), reverseIndex(query.size(), kNone);
+
+    for (std::size_t t = 0; t < train.size(); ++t) {
+        for (const u32 q : InRadius(kps, predicted[t].x, predicted[t].y, radius)) {
+            const u32 d = train[t].Distance(query[q]);
+            if (d < best[t]) {
+                second[t] = best[t];
+                best[t] = d;
+                index[t] = q;
+            } else if (d < second[t]) {
+                second[t] = d;
+            }
+            if (d < reverseBest[q]) {
+                reverseBest[q] = d;
+                reverseIndex[q] = static_cast<u32>(t);
+            }
+        }
+    }
+
+    Matches out;
+    for (std::size_t t = 0; t < train.size(); ++t) {
+        if (index[t] == kNone || best[t] > info.maxDistance) continue;
+        const u32 reference = second[t] == kNone ? Descriptor::kBits / 2 : second[t];
+        if (info.ratio < 1.0f && static_cast<f32>(best[t]) >= info.ratio * static_cast<f32>(reference)) continue;
+        if (info.crossCheck && reverseIndex[index[t]] != t) continue;
+        out.emplace_back(static_cast<int>(index[t]), static_cast<int>(t), static_cast<f32>(best[t]));
+    }
+    return out;
+}
+
+void SortMatches(Matches& m) {
+    std::sort(m.begin(), m.end(), [](const Match& a, const Match& b) {
+        return std::tie(a.distance, a.queryIdx, a.trainIdx) < std::tie(b.distance, b.queryIdx, b.trainIdx);
+    });
+}
+
+TEST(FeatureGrid, QueryMatchesBruteForce) {
+    const Keypoints kps = MakeKeypoints(400, 3);
+    FeatureGrid grid;
+    grid.Build(kps, 16.0f);
+    EXPECT_LE(grid.GetCols(), static_cast<u32>(640.0f / 16.0f) + 1);
+    EXPECT_LE(grid.GetRows(), static_cast<u32>(320.0f / 16.0f) + 1);
+
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<f32> x(-80.0f, 680.0f), y(100.0f, 520.0f), r(0.5f, 40.0f);
+    std::vector<u32> found;
+    for (int i = 0; i < 500; ++i) {
+        const f32 qx = x(rng), qy = y(rng), radius = r(rng);
+        found.clear();
+        grid.Query(qx, qy, radius, found);
+        std::sort(found.begin(), found.end());
+        EXPECT_EQ(found, InRadius(kps, qx, qy, radius)) << qx << ", " << qy << " r " << radius;
+    }
+}
+
+TEST(FeatureGrid, RebuildsInPlace) {
+    FeatureGrid grid;
+    grid.Build(MakeKeypoints(300, 5), 10.0f);
+
+    Keypoints single;
+    single.Push(250.0f, 300.0f, 0.0f, 0.0f);
+    grid.Build(single, 10.0f);
+    EXPECT_EQ(grid.GetCols(), 1u);
+    EXPECT_EQ(grid.GetRows(), 1u);
+
+    std::vector<u32> found;
+    grid.Query(255.0f, 300.0f, 6.0f, found);
+    EXPECT_EQ(found, std::vector<u32>{0});
+
+    grid.Build({}, 10.0f);
+    EXPECT_TRUE(grid.Empty());
+    found.clear();
+    grid.Query(255.0f, 300.0f, 6.0f, found);
+    EXPECT_TRUE(found.empty());
+}
+
+TEST(HammingMatcher, GuidedMatchesBruteForceInRadius) {
+    const Keypoints kps = MakeKeypoints(300, 6);
+    const Descriptors centers = test::RandomDescriptors(60, 7);
+    const Descriptors query = test::PerturbedDescriptors(centers, kps.Size(), 12, 8);
+
+    // NOTE: Most train descriptors are noisy copies predicted near their source keypoint, the rest
+    // are clutter, and clustered descriptors leave plenty of ambiguous windows
+    std::mt19937 rng(9);
+    std::uniform_int_distribution<std::size_t> pick(0, kps.Size() - 1);
+    std::uniform_real_distribution<f32> jitter(-6.0f, 6.0f);
+    Descriptors train = test::PerturbedDescriptors(centers, 250, 12, 10);
+    std::vector<cv::Point2f> predicted(train.size());
+    for (std::size_t t = 0; t < train.size(); ++t) {
+        const std::size_t q = pick(rng);
+        if (t % 5 != 0) train[t] = test::PerturbedDescriptors(Descriptors{query[q]}, 1, 8, static_cast<u32>(t))[0];
+        predicted[t] = cv::Point2f(kps.x[q] + jitter(rng), kps.y[q] + jitter(rng));
+    }
+
+    FeatureGrid grid;
+    grid.Build(kps, 12.0f);
+    for (const bool crossCheck : {false, true}) {
+        const HammingMatcherInfo info{.ratio = 0.8f, .crossCheck = crossCheck, .maxMatches = 0};
+        HammingMatcher matcher(info);
+
+        Matches guided;
+        matcher.MatchGuided(query, grid, train, predicted, 12.0f, guided);
+        Matches reference = ReferenceGuided(info, query, kps, train, predicted, 12.0f);
+        ASSERT_FALSE(reference.empty());
+
+        SortMatches(guided);
+        SortMatches(reference);
+        ASSERT_EQ(guided.size(), reference.size()) << "crossCheck " << crossCheck;
+        for (std::size_t i = 0; i < guided.size(); ++i) {
+            EXPECT_EQ(guided[i].queryIdx, reference[i].queryIdx);
+            EXPECT_EQ(guided[i].trainIdx, reference[i].trainIdx);
+            EXPECT_EQ(guided[i].distance, reference[i].distance);
+        }
+    }
+}
+
+} // namespace
+} // namespace ct
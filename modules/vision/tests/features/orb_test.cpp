@@ -0,0 +1,135 @@
+#include "support.hpp"
+
+#include "toolbox/vision/features/corners.hpp"
+#include "toolbox/vision/features/orb.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace ct {
+namespace {
+
+constexpr cpu::SimdLevel kLevels[] = {cpu::SimdLevel::SSE42, cpu::SimdLevel::AVX2, cpu::SimdLevel::AVX512};
+
+std::vector<i32> FastRows(GrayView image, u8 threshold) {
+    std::vector<i32> corners, row(static_cast<std::size_t>(image.width));
+    for (i32 y = 3; y < image.height - 3; ++y) {
+        // NOTE: Odd bounds so the SIMD kernels run both their vector body and the scalar tail
+        const u32 n = DetectFastRow(image, y, 3, image.width - 4, threshold, row.data());
+        for (u32 i = 0; i < n; ++i) {
+            corners.push_back(y);
+            corners.push_back(row[i]);
+        }
+    }
+    return corners;
+}
+
+TEST(Fast, EveryLevelFindsTheScalarCorners) {
+    const GrayImage image = test::MakeScene(333, 121, 7);
+    for (const u8 threshold : {u8{7}, u8{20}, u8{60}}) {
+        std::vector<i32> expected;
+        {
+            test::ScopedSimdLevel scalar(cpu::SimdLevel::Scalar);
+            expected = FastRows(image.GetView(), threshold);
+        }
+        ASSERT_FALSE(expected.empty());
+
+        for (const cpu::SimdLevel level : kLevels) {
+            if (level > cpu::GetDetectedLevel()) continue;
+            test::ScopedSimdLevel scoped(level);
+            EXPECT_EQ(FastRows(image.GetView(), threshold), expected) << cpu::ToString(level) << " " << +threshold;
+        }
+    }
+}
+
+TEST(Fast, EveryLevelScoresLikeScalar) {
+    const GrayImage image = test::MakeScene(200, 64, 11);
+    std::vector<i32> xs;
+    for (i32 x = kCornerMargin; x < image.GetWidth() - kCornerMargin; ++x) xs.push_back(x);
+
+    for (const CornerScore score : {CornerScore::ShiTomasi, CornerScore::Harris}) {
+        std::vector<f32> expected(xs.size()), actual(xs.size());
+        for (i32 y = kCornerMargin; y < image.GetHeight() - kCornerMargin; ++y) {
+            {
+                test::ScopedSimdLevel scalar(cpu::SimdLevel::Scalar);
+                ScoreCorners(image.GetView(), y, xs, score, 0.04f, expected.data());
+            }
+            for (const cpu::SimdLevel level : kLevels) {
+                if (level > cpu::GetDetectedLevel()) continue;
+                test::ScopedSimdLevel scoped(level);
+                ScoreCorners(image.GetView(), y, xs, score, 0.04f, actual.data());
+                ASSERT_EQ(actual, expected) << cpu::ToString(level) << " row " << y;
+            }
+        }
+    }
+}
+
+struct Extraction {
+    Keypoints kps;
+    Descriptors des;
+};
+
+Extraction Extract(GrayView image, cpu::SimdLevel level, ThreadPool* pool = nullptr) {
+    test::ScopedSimdLevel scoped(level);
+    OrbExtractor extractor({.maxFeatures = 800, .pool = pool});
+    Extraction out;
+    extractor.Extract(image, out.kps, out.des);
+    return out;
+}
+
+void ExpectSame(const Extraction& a, const Extraction& b) {
+    ASSERT_EQ(a.kps.Size(), b.kps.Size());
+    EXPECT_EQ(a.kps.x, b.kps.x);
+    EXPECT_EQ(a.kps.y, b.kps.y);
+    EXPECT_EQ(a.kps.angle, b.kps.angle);
+    EXPECT_EQ(a.kps.response, b.kps.response);
+    EXPECT_EQ(a.des, b.des);
+}
+
+TEST(Orb, AvxExtractsTheScalarFeatures) {
+    if (cpu::GetDetectedLevel() < cpu::SimdLevel::AVX2) GTEST_SKIP() << "no AVX2";
+    const GrayImage image = test::MakeScene(640, 480, 3);
+
+    const Extraction scalar = Extract(image.GetView(), cpu::SimdLevel::Scalar);
+    ASSERT_GT(scalar.kps.Size(), 400u);
+    ExpectSame(Extract(image.GetView(), cpu::SimdLevel::AVX2), scalar);
+}
+
+TEST(Orb, PoolExtractsTheSerialFeatures) {
+    const GrayImage image = test::MakeScene(640, 480, 5);
+    auto pool = ThreadPool::Create({.workers = 3});
+    ASSERT_TRUE(pool);
+
+    const Extraction serial = Extract(image.GetView(), cpu::GetDetectedLevel());
+    ExpectSame(Extract(image.GetView(), cpu::GetDetectedLevel(), pool->get()), serial);
+}
+
+// NOTE: Without the quadtree the tiles only split the work, every tile of this scene has corners
+// at the regular threshold so none is retried
+TEST(Orb, TileSizeDoesNotChangeTheGlobalTopN) {
+    const GrayImage image = test::MakeScene(640, 480, 9);
+    Keypoints expected;
+    OrbExtractor({.maxFeatures = 600, .tileSize = 640, .distribute = false}).Detect(image.GetView(), expected);
+    ASSERT_EQ(expected.Size(), 600u);
+
+    for (const i32 tileSize : {37, 64, 200}) {
+        Keypoints kps;
+        OrbExtractor({.maxFeatures = 600, .tileSize = tileSize, .distribute = false}).Detect(image.GetView(), kps);
+        EXPECT_EQ(kps.x, expected.x) << "tile " << tileSize;
+        EXPECT_EQ(kps.y, expected.y) << "tile " << tileSize;
+        EXPECT_EQ(kps.response, expected.response) << "tile " << tileSize;
+    }
+}
+
+TEST(Orb, QuadtreeKeepsAtMostMaxFeatures) {
+    const GrayImage image = test::MakeScene(640, 480, 9);
+    Keypoints kps;
+    OrbExtractor({.maxFeatures = 300}).Detect(image.GetView(), kps);
+    ASSERT_GT(kps.Size(), 250u);
+    EXPECT_LE(kps.Size(), 300u);
+    for (std::size_t i = 1; i < kps.Size(); ++i) EXPECT_GE(kps.response[i - 1], kps.response[i]);
+}
+
+} // namespace
+} // namespace ct
@@ -0,0 +1,121 @@
+#include "support.hpp"
+
+#include "toolbox/vision/frontend/frontend.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <numbers>
+#include <vector>
+
+namespace ct {
+namespace {
+
+const CameraIntrinsics kIntrinsics{.fx = 500.0, .fy = 500.0, .cx = 320.0, .cy = 240.0, .width = 640, .height = 480};
+
+// NOTE: 640 x 480 windows sliding right over one textured scene, consecutive frames overlap
+std::vector<GrayImage> MakeFrames(u32 count) {
+    const GrayImage scene = test::MakeScene(640 + 8 * static_cast<i32>(count), 480, 7);
+    std::vector<GrayImage> frames(count);
+    for (u32 i = 0; i < count; ++i) {
+        frames[i].Resize(640, 480);
+        for (i32 y = 0; y < 480; ++y) std::copy_n(scene.Row(y) + 8 * i, 640, frames[i].Row(y));
+    }
+    return frames;
+}
+
+constexpr i32 kRadius = 80;
+constexpr i32 kSteps = 32;
+
+// NOTE: A 640 x 480 window circling over a textured wall, the camera translates in its image plane
+// and every frame overlaps the last. A circle keeps the motion prior right, a path that reverses
+// would lose the map at each turn.
+cv::Mat Window(const GrayImage& scene, i32 step) {
+    const f64 angle = 2.0 * std::numbers::pi * step / kSteps;
+    const i32 x0 = kRadius + 8 + static_cast<i32>(std::lround(kRadius * std::cos(angle)));
+    const i32 y0 = kRadius + 8 + static_cast<i32>(std::lround(kRadius * std::sin(angle)));
+
+    cv::Mat image(480, 640, CV_8UC3);
+    for (i32 y = 0; y < 480; ++y) {
+        const u8* src = scene.Row(y + y0) + x0;
+        u8* dst = image.ptr(y);
+        for (i32 x = 0; x < 640; ++x) dst[3 * x] = dst[3 * x + 1] = dst[3 * x + 2] = src[x];
+    }
+    return image;
+}
+
+// NOTE: The frontend-owned part of feature matching, detection into a reused Frame and matching
+// into reused Matches. Pose recovery still goes through OpenCV, which allocates internally.
+TEST(Frontend, DetectAndMatchDoNotAllocateOnceWarm) {
+    static_assert(memory::IsCountingAllocations());
+
+    const std::vector<GrayImage> frames = MakeFrames(6);
+    auto pool = ThreadPool::Create({.workers = 2});
+    ASSERT_TRUE(pool);
+    Frontend frontend({
+        .camera = std::make_shared<Camera>(CameraType::Monocular, kIntrinsics, DistortionCoeffs{}),
+        .pool = *pool,
+    });
+
+    Frame curr, prev;
+    Matches matches;
+    const auto step = [&](const GrayImage& image, Timestamp ts) {
+        frontend.DetectFeatures(image.Mat(), ts, curr);
+        if (prev.valid()) frontend.MatchFrames(curr, prev, matches);
+        std::swap(curr, prev);
+    };
+
+    Timestamp ts = 0.0;
+    for (u32 loop = 0; loop < 3; ++loop) {
+        for (const GrayImage& image : frames) step(image, ts += 1.0 / 30.0);
+    }
+
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        const memory::AllocationScope scope;
+        step(frames[i], ts += 1.0 / 30.0);
+        const u64 count = scope.GetCount();
+
+        ASSERT_TRUE(prev.valid());
+        EXPECT_GT(matches.size(), 100u) << "frame " << i;
+        EXPECT_EQ(count, 0u) << "frame " << i;
+    }
+}
+
+// NOTE: Map tracking, keyframe insertion and culling run in the measured loops. Bundle adjustment
+// is off, it allocates on the backend thread and the count covers every thread.
+TEST(Frontend, FeatureMatchingDoesNotAllocateOnceWarm) {
+    static_assert(memory::IsCountingAllocations());
+
+    const GrayImage scene = test::MakeScene(640 + 2 * kRadius + 16, 480 + 2 * kRadius + 16, 7);
+    std::vector<cv::Mat> frames;
+    for (i32 i = 0; i < kSteps; ++i) frames.push_back(Window(scene, i));
+
+    Frontend frontend({
+        .camera = std::make_shared<Camera>(CameraType::Monocular, test::MakeCamera(), DistortionCoeffs{}),
+        .localBA = false,
+    });
+
+    Timestamp ts = 0.0;
+    for (u32 loop = 0; loop < 2; ++loop) {
+        for (const cv::Mat& frame : frames) {
+            (void)frontend.Estimate(frame, ts);
+            ts += 1.0 / 30.0;
+        }
+    }
+
+    for (u32 loop = 0; loop < 2; ++loop) {
+        for (std::size_t i = 0; i < frames.size(); ++i) {
+            const memory::AllocationScope scope;
+            const auto pose = frontend.Estimate(frames[i], ts);
+            const u64 count = scope.GetCount();
+            ts += 1.0 / 30.0;
+
+            ASSERT_TRUE(pose) << "frame " << i << ": " << pose.error().Message();
+            EXPECT_EQ(count, 0u) << "frame " << i;
+        }
+    }
+}
+
+} // namespace
+} // namespace ct
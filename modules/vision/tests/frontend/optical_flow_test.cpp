@@ -0,0 +1,90 @@
+#include "support.hpp"
+
+#include "toolbox/vision/frontend/frontend.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace ct {
+namespace {
+
+const CameraIntrinsics kIntrinsics{.fx = 500.0, .fy = 500.0, .cx = 320.0, .cy = 240.0, .width = 640, .height = 480};
+
+struct Landmark {
+    vec3d position;
+    u8 shade;
+};
+
+// NOTE: Points 2 to 8 units deep that fill the first view, the depth spread gives the parallax an
+// essential matrix needs
+std::vector<Landmark> MakeLandmarks(std::size_t count, u32 seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<f64> u(-0.55, 0.55), v(-0.42, 0.42), z(2.0, 8.0);
+    std::uniform_int_distribution<i32> shade(90, 255);
+    std::vector<Landmark> out(count);
+    for (Landmark& l : out) {
+        const f64 depth = z(rng);
+        l.position = vec3d(u(rng) * depth, v(rng) * depth, depth);
+        l.shade = static_cast<u8>(shade(rng));
+    }
+    // NOTE: Far to near, so nearer squares are painted over farther ones
+    std::sort(out.begin(), out.end(), [](const Landmark& a, const Landmark& b) { return a.position.z > b.position.z; });
+    return out;
+}
+
+// NOTE: Every landmark as a 7 x 7 square on a dark background, seen from a camera at `center` that
+// looks down +z
+cv::Mat Render(const std::vector<Landmark>& landmarks, const vec3d& center) {
+    cv::Mat image(kIntrinsics.height, kIntrinsics.width, CV_8UC3, cv::Scalar(20, 20, 20));
+    for (const Landmark& l : landmarks) {
+        const vec3d p = l.position - center;
+        const i32 u = static_cast<i32>(std::lround(kIntrinsics.fx * p.x / p.z + kIntrinsics.cx));
+        const i32 v = static_cast<i32>(std::lround(kIntrinsics.fy * p.y / p.z + kIntrinsics.cy));
+        for (i32 y = std::max(v - 3, 0); y <= std::min(v + 3, image.rows - 1); ++y) {
+            u8* row = image.ptr(y);
+            for (i32 x = std::max(u - 3, 0); x <= std::min(u + 3, image.cols - 1); ++x) {
+                row[3 * x] = row[3 * x + 1] = row[3 * x + 2] = l.shade;
+            }
+        }
+    }
+    return image;
+}
+
+FrontendInfo FlowInfo() {
+    return {
+        .camera = std::make_shared<Camera>(CameraType::Monocular, kIntrinsics, DistortionCoeffs{}),
+        .mode = TrackingMode::OpticalFlow,
+    };
+}
+
+TEST(Frontend, OpticalFlowNeedsAPreviousFrame) {
+    const std::vector<Landmark> landmarks = MakeLandmarks(250, 1);
+    Frontend frontend(FlowInfo());
+    EXPECT_FALSE(frontend.Estimate(Render(landmarks, vec3d(0.0, 0.0, 0.0)), 0.0));
+}
+
+// NOTE: The camera slides along +x, so X_prev = X_curr + t with t along +x. The translation of a
+// monocular pair is unit length.
+TEST(Frontend, OpticalFlowRecoversSidewaysMotion) {
+    const std::vector<Landmark> landmarks = MakeLandmarks(250, 2);
+    Frontend frontend(FlowInfo());
+
+    constexpr f64 kStep = 0.08;
+    (void)frontend.Estimate(Render(landmarks, vec3d(0.0, 0.0, 0.0)), 0.0);
+    for (i32 i = 1; i <= 5; ++i) {
+        const auto pose = frontend.Estimate(Render(landmarks, vec3d(kStep * i, 0.0, 0.0)), i / 30.0);
+        ASSERT_TRUE(pose) << "frame " << i << ": " << pose.error().Message();
+
+        EXPECT_LT(so3d::from_matrix(pose->rotation).log().length(), 0.02) << "frame " << i;
+        EXPECT_NEAR(pose->translation.length(), 1.0, 1e-6) << "frame " << i;
+        EXPECT_GT(pose->translation.x, 0.97) << "frame " << i;
+    }
+}
+
+} // namespace
+} // namespace ct
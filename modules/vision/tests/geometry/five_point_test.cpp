@@ -0,0 +1,117 @@
+#include "support.hpp"
+
+#include "toolbox/vision/geometry/five_point.hpp"
+#include "toolbox/vision/geometry/relative_pose.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace ct {
+namespace {
+
+// NOTE: X_2 = R X_1 + t, the first camera is the world frame
+const Pose kMotion{so3d::exp(vec3d(0.05, -0.12, 0.03)).matrix(), vec3d(0.8, 0.1, -0.2)};
+
+mat3d Normalized(const mat3d& m) {
+    f64 norm2 = 0.0;
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) norm2 += m(i, j) * m(i, j);
+    }
+    return m * (1.0 / std::sqrt(norm2));
+}
+
+// NOTE: Frobenius distance up to the sign of E
+f64 Distance(const mat3d& a, const mat3d& b) {
+    f64 plus = 0.0, minus = 0.0;
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            plus += (a(i, j) - b(i, j)) * (a(i, j) - b(i, j));
+            minus += (a(i, j) + b(i, j)) * (a(i, j) + b(i, j));
+        }
+    }
+    return std::sqrt(std::min(plus, minus));
+}
+
+// NOTE: Twenty exact samples of `motion`, every solution satisfies the constraints and one of
+// them is [t]x R
+void ExpectTrueSolution(const Pose& motion, u32 seed) {
+    const mat3d expected = Normalized(so3d::hat(motion.translation) * motion.rotation);
+    const std::vector<vec3d> points = test::MakePoints(5 * 20, seed);
+
+    for (std::size_t s = 0; s < points.size(); s += kFivePointSample) {
+        std::array<vec2d, kFivePointSample> x1, x2;
+        for (std::size_t k = 0; k < kFivePointSample; ++k) {
+            const vec3d p1 = points[s + k];
+            const vec3d p2 = Transform(motion, p1);
+            x1[k] = vec2d(p1.x / p1.z, p1.y / p1.z);
+            x2[k] = vec2d(p2.x / p2.z, p2.y / p2.z);
+        }
+
+        std::array<mat3d, kFivePointMaxSolutions> solutions;
+        const u32 count = SolveFivePoint(x1, x2, solutions);
+        ASSERT_GT(count, 0u) << "sample " << s;
+
+        f64 best = 1.0;
+        for (u32 i = 0; i < count; ++i) {
+            best = std::min(best, Distance(Normalized(solutions[i]), expected));
+            for (std::size_t k = 0; k < kFivePointSample; ++k) {
+                const vec3d a(x1[k].x, x1[k].y, 1.0), b(x2[k].x, x2[k].y, 1.0);
+                EXPECT_NEAR(b.dot(solutions[i] * a), 0.0, 1e-9);
+            }
+        }
+        EXPECT_LT(best, 1e-6) << "sample " << s;
+    }
+}
+
+TEST(FivePoint, OneSolutionIsTheTrueEssentialMatrix) {
+    ExpectTrueSolution(kMotion, 1);
+}
+
+// NOTE: [t]x of an axis aligned t has five zero entries, the solver must not depend on any of them
+TEST(FivePoint, FindsPureTranslations) {
+    ExpectTrueSolution(Pose{mat3d::identity(), vec3d(1.0, 0.0, 0.0)}, 4);
+    ExpectTrueSolution(Pose{mat3d::identity(), vec3d(0.0, 1.0, 0.0)}, 5);
+    ExpectTrueSolution(Pose{mat3d::identity(), vec3d(0.0, 0.0, 1.0)}, 6);
+}
+
+TEST(RelativePose, RecoversTheMotionDespiteOutliers) {
+    const CameraIntrinsics camera = test::MakeCamera();
+    const std::vector<vec3d> points = test::MakePoints(300, 2);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<f32> u(0.0f, 640.0f), v(0.0f, 480.0f);
+    std::normal_distribution<f32> noise(0.0f, 0.3f);
+
+    // NOTE: Every third correspondence is a random pair of pixels
+    std::vector<cv::Point2f> pixels1, pixels2;
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        if (i % 3 == 0) {
+            pixels1.emplace_back(u(rng), v(rng));
+            pixels2.emplace_back(u(rng), v(rng));
+            continue;
+        }
+        const cv::Point2f p1 = test::Project(camera, points[i]);
+        const cv::Point2f p2 = test::Project(camera, Transform(kMotion, points[i]));
+        pixels1.emplace_back(p1.x + noise(rng), p1.y + noise(rng));
+        pixels2.emplace_back(p2.x + noise(rng), p2.y + noise(rng));
+    }
+
+    RelativePoseEstimator estimator({.prosac = false});
+    std::vector<u8> mask;
+    const auto pose = estimator.Estimate(pixels1, pixels2, camera, mask);
+    ASSERT_TRUE(pose) << pose.error().Message();
+
+    // NOTE: The model comes from one minimal sample of noisy points, nothing refines it
+    EXPECT_LT(test::RotationError(pose->motion.rotation, kMotion.rotation), 1e-2);
+    EXPECT_GT(pose->motion.translation.dot(kMotion.translation.normalized()), 0.99);
+    EXPECT_GE(pose->inliers, 170u);
+
+    u32 outliersKept = 0;
+    for (std::size_t i = 0; i < mask.size(); i += 3) outliersKept += mask[i];
+    EXPECT_LT(outliersKept, 5u);
+}
+
+} // namespace
+} // namespace ct
@@ -0,0 +1,98 @@
+#include "support.hpp"
+
+#include "toolbox/vision/geometry/p3p.hpp"
+#include "toolbox/vision/geometry/pnp.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+namespace ct {
+namespace {
+
+// NOTE: Camera from world
+const Pose kPose{so3d::exp(vec3d(-0.1, 0.2, 0.05)).matrix(), vec3d(0.3, -0.2, 0.5)};
+
+TEST(P3P, OneSolutionIsTheTruePose) {
+    const std::vector<vec3d> points = test::MakePoints(3 * 20, 1);
+    for (std::size_t s = 0; s < points.size(); s += kP3PSample) {
+        std::array<vec3d, kP3PSample> bearings, world;
+        for (std::size_t k = 0; k < kP3PSample; ++k) {
+            world[k] = points[s + k];
+            bearings[k] = Transform(kPose, world[k]).normalized();
+        }
+
+        std::array<Pose, kP3PMaxSolutions> solutions;
+        const u32 count = SolveP3P(bearings, world, solutions);
+        ASSERT_GT(count, 0u) << "sample " << s;
+
+        f64 best = 1.0;
+        for (u32 i = 0; i < count; ++i) {
+            const f64 t = (solutions[i].translation - kPose.translation).length();
+            best = std::min(best, test::RotationError(solutions[i].rotation, kPose.rotation) + t);
+        }
+        EXPECT_LT(best, 1e-6) << "sample " << s;
+    }
+}
+
+// NOTE: Every second correspondence points at a random pixel
+std::vector<cv::Point2f> MakePixels(const std::vector<vec3d>& points, u32 seed) {
+    const CameraIntrinsics camera = test::MakeCamera();
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<f32> u(0.0f, 640.0f), v(0.0f, 480.0f);
+    std::normal_distribution<f32> noise(0.0f, 0.5f);
+
+    std::vector<cv::Point2f> pixels;
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        if (i % 2 == 0) {
+            pixels.emplace_back(u(rng), v(rng));
+            continue;
+        }
+        const cv::Point2f p = test::Project(camera, Transform(kPose, points[i]));
+        pixels.emplace_back(p.x + noise(rng), p.y + noise(rng));
+    }
+    return pixels;
+}
+
+void ExpectTruePose(const AbsolutePose& pose, const std::vector<u8>& mask) {
+    EXPECT_TRUE(pose.refined);
+    EXPECT_LT(test::RotationError(pose.pose.rotation, kPose.rotation), 2e-3);
+    EXPECT_LT((pose.pose.translation - kPose.translation).length(), 2e-2);
+    EXPECT_GE(pose.inliers, 190u);
+
+    u32 outliersKept = 0;
+    for (std::size_t i = 0; i < mask.size(); i += 2) outliersKept += mask[i];
+    EXPECT_LT(outliersKept, 5u);
+}
+
+TEST(Pnp, SurvivesHalfOutliers) {
+    const std::vector<vec3d> points = test::MakePoints(400, 2);
+    const std::vector<cv::Point2f> pixels = MakePixels(points, 3);
+
+    PnpEstimator estimator;
+    std::vector<u8> mask;
+    const auto pose = estimator.Estimate(points, pixels, test::MakeCamera(), mask);
+    ASSERT_TRUE(pose) << pose.error().Message();
+    ExpectTruePose(*pose, mask);
+}
+
+TEST(Pnp, PoolRecoversThePose) {
+    const std::vector<vec3d> points = test::MakePoints(400, 4);
+    const std::vector<cv::Point2f> pixels = MakePixels(points, 5);
+    auto pool = ThreadPool::Create({.workers = 3});
+    ASSERT_TRUE(pool);
+
+    PnpEstimator estimator({.pool = pool->get()});
+    std::vector<u8> mask;
+    for (i32 run = 0; run < 5; ++run) {
+        const auto pose = estimator.Estimate(points, pixels, test::MakeCamera(), mask);
+        ASSERT_TRUE(pose) << pose.error().Message();
+        ExpectTruePose(*pose, mask);
+        EXPECT_FALSE(pose->timedOut);
+        EXPECT_GE(pose->confidence, 0.999);
+    }
+}
+
+} // namespace
+} // namespace ct
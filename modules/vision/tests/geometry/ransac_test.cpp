@@ -0,0 +1,138 @@
+#include "support.hpp"
+
+#include "toolbox/vision/geometry/ransac.hpp"
+#include "toolbox/vision/geometry/relative_pose.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace ct {
+namespace {
+
+const Pose kMotion{so3d::exp(vec3d(0.05, -0.12, 0.03)).matrix(), vec3d(0.8, 0.1, -0.2)};
+
+struct Pairs {
+    std::vector<cv::Point2f> pixels1;
+    std::vector<cv::Point2f> pixels2;
+};
+
+// NOTE: Projections of kMotion with 0.3 px noise, a share of `outliers` pairs are random pixels
+Pairs MakePairs(std::size_t count, f64 outliers, u32 seed) {
+    const CameraIntrinsics camera = test::MakeCamera();
+    const std::vector<vec3d> points = test::MakePoints(count, seed);
+    std::mt19937 rng(seed + 1);
+    std::uniform_real_distribution<f32> u(0.0f, 640.0f), v(0.0f, 480.0f);
+    std::normal_distribution<f32> noise(0.0f, 0.3f);
+    std::bernoulli_distribution outlier(outliers);
+
+    Pairs out;
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        if (outlier(rng)) {
+            out.pixels1.emplace_back(u(rng), v(rng));
+            out.pixels2.emplace_back(u(rng), v(rng));
+            continue;
+        }
+        const cv::Point2f p1 = test::Project(camera, points[i]);
+        const cv::Point2f p2 = test::Project(camera, Transform(kMotion, points[i]));
+        out.pixels1.emplace_back(p1.x + noise(rng), p1.y + noise(rng));
+        out.pixels2.emplace_back(p2.x + noise(rng), p2.y + noise(rng));
+    }
+    return out;
+}
+
+TEST(Ransac, IterationBoundMatchesClosedForm) {
+    // NOTE: ceil(log(1 - confidence) / log(1 - good))
+    EXPECT_EQ(RansacIterationBound(std::pow(0.5, 5), 0.99, 10000), 146u);
+    EXPECT_EQ(RansacIterationBound(0.1, 0.999, 10000), 66u);
+    EXPECT_EQ(RansacIterationBound(std::pow(0.6, 5), 0.999, 10000), 86u);
+
+    EXPECT_EQ(RansacIterationBound(1e-6, 0.99, 500), 500u);
+    EXPECT_EQ(RansacIterationBound(0.0, 0.99, 500), 500u);
+    EXPECT_EQ(RansacIterationBound(1.0, 0.99, 500), 1u);
+    EXPECT_EQ(RansacIterationBound(0.5, 0.99, 0), 1u);
+}
+
+TEST(Ransac, ConfidenceMatchesClosedForm) {
+    // NOTE: 1 - (1 - good)^iterations
+    EXPECT_NEAR(RansacConfidence(0.1, 10), 0.6513215599, 1e-10);
+    EXPECT_NEAR(RansacConfidence(std::pow(0.6, 5), 100), 0.9996949328254264, 1e-12);
+    EXPECT_NEAR(RansacConfidence(1e-9, 1000), 1e-6, 1e-12);
+
+    EXPECT_EQ(RansacConfidence(0.0, 100), 0.0);
+    EXPECT_EQ(RansacConfidence(0.3, 0), 0.0);
+    EXPECT_EQ(RansacConfidence(1.0, 1), 1.0);
+
+    // NOTE: The bound is the first iteration count that reaches the confidence
+    const f64 good = std::pow(0.5, 5);
+    EXPECT_GE(RansacConfidence(good, 146), 0.99);
+    EXPECT_LT(RansacConfidence(good, 145), 0.99);
+}
+
+TEST(Ransac, ScheduleStopsAtTheLoweredBound) {
+    RansacSchedule schedule(1000, 0.99, 0.0);
+
+    u32 iteration = 0;
+    for (u32 i = 0; i < 10; ++i) {
+        ASSERT_TRUE(schedule.Claim(iteration));
+        EXPECT_EQ(iteration, i);
+    }
+
+    bool stored = false;
+    EXPECT_TRUE(schedule.Improve(40, 0.1, [&] { stored = true; }));
+    EXPECT_TRUE(stored);
+    EXPECT_EQ(schedule.GetBestScore(), 40u);
+    EXPECT_FALSE(schedule.Improve(40, 0.2, [&] { FAIL() << "Not an improvement"; }));
+
+    // NOTE: 0.1 at 99% needs 44 samples, 10 are already out
+    u32 claimed = 10;
+    while (schedule.Claim(iteration)) ++claimed;
+    EXPECT_EQ(claimed, 44u);
+    EXPECT_EQ(schedule.GetIterations(), 44u);
+    EXPECT_FALSE(schedule.TimedOut());
+    EXPECT_NEAR(schedule.GetConfidence(), RansacConfidence(0.1, 44), 1e-12);
+}
+
+TEST(RelativePose, PoolRecoversTheMotion) {
+    const Pairs pairs = MakePairs(400, 1.0 / 3.0, 11);
+    auto pool = ThreadPool::Create({.workers = 3});
+    ASSERT_TRUE(pool);
+
+    RelativePoseEstimator estimator({.prosac = false, .pool = pool->get()});
+    std::vector<u8> mask;
+    for (i32 run = 0; run < 5; ++run) {
+        const auto pose = estimator.Estimate(pairs.pixels1, pairs.pixels2, test::MakeCamera(), mask);
+        ASSERT_TRUE(pose) << pose.error().Message();
+
+        EXPECT_LT(test::RotationError(pose->motion.rotation, kMotion.rotation), 1e-2) << "run " << run;
+        EXPECT_GT(pose->motion.translation.dot(kMotion.translation.normalized()), 0.99) << "run " << run;
+        EXPECT_GE(pose->inliers, 200u) << "run " << run;
+        EXPECT_FALSE(pose->timedOut);
+        EXPECT_GE(pose->confidence, 0.999);
+    }
+}
+
+// NOTE: 80% outliers over many pairs put the bound (about 21600 samples) far beyond what 20 ms allow
+TEST(RelativePose, BudgetEndsTheSearchEarly) {
+    const Pairs pairs = MakePairs(4000, 0.8, 12);
+    auto pool = ThreadPool::Create({.workers = 2});
+    ASSERT_TRUE(pool);
+
+    for (ThreadPool* lanes : {static_cast<ThreadPool*>(nullptr), pool->get()}) {
+        const RelativePoseInfo info{.maxIterations = 1000000, .prosac = false, .sprt = false, .pool = lanes, .budget = 20.0};
+        RelativePoseEstimator estimator(info);
+        std::vector<u8> mask;
+        const auto pose = estimator.Estimate(pairs.pixels1, pairs.pixels2, test::MakeCamera(), mask);
+        ASSERT_TRUE(pose) << pose.error().Message();
+
+        EXPECT_TRUE(pose->timedOut);
+        EXPECT_GT(pose->iterations, 0u);
+        EXPECT_LT(pose->iterations, info.maxIterations);
+        EXPECT_LT(pose->confidence, info.confidence);
+    }
+}
+
+} // namespace
+} // namespace ct
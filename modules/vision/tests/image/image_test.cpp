@@ -0,0 +1,181 @@
+#include "support.hpp"
+
+#include "toolbox/vision/image/image.hpp"
+#include "toolbox/vision/image/pyramid.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace ct {
+namespace {
+
+bool IsAligned(const void* p) {
+    return reinterpret_cast<std::uintptr_t>(p) % 64 == 0;
+}
+
+// NOTE: Straight from the definition, 5x5 binomial with BORDER_REFLECT_101 at even pixels
+i32 Reflect101(i32 i, i32 n) {
+    while (i < 0 || i >= n) i = i < 0 ? -i : 2 * (n - 1) - i;
+    return i;
+}
+
+u8 ReferencePyrDown(GrayView src, i32 x, i32 y) {
+    constexpr i32 kTaps[5] = {1, 4, 6, 4, 1};
+    i32 sum = 0;
+    for (i32 dy = -2; dy <= 2; ++dy) {
+        for (i32 dx = -2; dx <= 2; ++dx) {
+            const i32 sx = Reflect101(2 * x + dx, src.width), sy = Reflect101(2 * y + dy, src.height);
+            sum += kTaps[dx + 2] * kTaps[dy + 2] * src(sx, sy);
+        }
+    }
+    return static_cast<u8>((sum + 128) >> 8);
+}
+
+TEST(Image, RowsStartOnCacheLines) {
+    for (const i32 width : {1, 13, 64, 65, 333}) {
+        GrayImage gray(width, 7);
+        Image<f32, 3> color(width, 5);
+        EXPECT_EQ(gray.GetStride() % 64, 0);
+        EXPECT_GE(gray.GetStride(), width);
+        EXPECT_GE(color.GetStride(), 3 * width);
+        for (i32 y = 0; y < 7; ++y) EXPECT_TRUE(IsAligned(gray.Row(y))) << width << " row " << y;
+        for (i32 y = 0; y < 5; ++y) EXPECT_TRUE(IsAligned(color.Row(y))) << width << " row " << y;
+    }
+}
+
+TEST(Image, StrideIsRoundedUp) {
+    const GrayImage image(10, 4, 100);
+    EXPECT_EQ(image.GetStride(), 128);
+    const Image<u16> wide(10, 4, 40);
+    EXPECT_EQ(wide.GetStride(), 64);
+}
+
+TEST(Image, ResizeReusesStorage) {
+    GrayImage image(320, 240);
+    const u8* data = image.Data();
+    image.Resize(100, 50);
+    EXPECT_EQ(image.Data(), data);
+    image.Resize(320, 240);
+    EXPECT_EQ(image.Data(), data);
+    EXPECT_EQ(image.GetWidth(), 320);
+    EXPECT_EQ(image.GetHeight(), 240);
+
+    image.Clear();
+    EXPECT_TRUE(image.Empty());
+}
+
+TEST(ImageView, IndexesInterleavedChannels) {
+    Image<u8, 3> image(5, 4);
+    for (i32 y = 0; y < 4; ++y) {
+        for (i32 x = 0; x < 5; ++x) {
+            for (i32 c = 0; c < 3; ++c) image.GetView()(x, y, c) = static_cast<u8>(100 * c + 10 * y + x);
+        }
+    }
+    EXPECT_EQ(image.Row(2)[3 * 4 + 1], 124);
+
+    const ImageView<const u8, 3> roi = image.Roi(1, 2, 3, 2);
+    EXPECT_EQ(roi.width, 3);
+    EXPECT_EQ(roi.height, 2);
+    EXPECT_EQ(roi.stride, image.GetStride());
+    EXPECT_EQ(&roi(0, 0, 0), &image.GetView()(1, 2, 0));
+    EXPECT_EQ(roi(2, 1, 2), 200 + 30 + 3);
+}
+
+TEST(ImageView, MatWrappersShareThePixels) {
+    Image<f32, 3> image(7, 6);
+    image.GetView()(4, 3, 2) = 2.5f;
+
+    const cv::Mat mat = image.Mat();
+    EXPECT_EQ(mat.type(), CV_32FC3);
+    EXPECT_EQ(mat.cols, 7);
+    EXPECT_EQ(mat.rows, 6);
+    EXPECT_EQ(static_cast<std::ptrdiff_t>(mat.step[0]), image.GetStride() * static_cast<std::ptrdiff_t>(sizeof(f32)));
+    EXPECT_EQ(mat.ptr<f32>(3)[3 * 4 + 2], 2.5f);
+
+    const ImageView<f32, 3> view = ViewOf<f32, 3>(mat);
+    EXPECT_EQ(view.data, image.Data());
+    EXPECT_EQ(view.stride, image.GetStride());
+    view(0, 5, 1) = -1.0f;
+    EXPECT_EQ(image.GetView()(0, 5, 1), -1.0f);
+
+    cv::Mat gray(4, 9, CV_8UC1, cv::Scalar(3));
+    const GrayView grayView = ViewOf(gray);
+    EXPECT_EQ(grayView.data, gray.ptr<u8>());
+    EXPECT_EQ(grayView.width, 9);
+    EXPECT_TRUE(MatOf(GrayView{}).empty());
+}
+
+TEST(ImagePyramid, LevelsHalveUntilMinSize) {
+    const GrayImage image = test::MakeScene(101, 67, 1);
+    ImagePyramid pyramid({.levels = 6, .minSize = 10});
+    pyramid.Build(image.GetView());
+
+    ASSERT_EQ(pyramid.GetLevels(), 3);
+    EXPECT_EQ(pyramid.Level(1).width, 51);
+    EXPECT_EQ(pyramid.Level(1).height, 34);
+    EXPECT_EQ(pyramid.Level(2).width, 26);
+    EXPECT_EQ(pyramid.Level(2).height, 17);
+    EXPECT_EQ(pyramid.GetScale(2), 4.0f);
+}
+
+TEST(ImagePyramid, MatchesPyrDownDefinition) {
+    const GrayImage image = test::MakeScene(97, 58, 2);
+    ImagePyramid pyramid({.levels = 4});
+    pyramid.Build(image.GetView());
+
+    for (i32 level = 1; level < pyramid.GetLevels(); ++level) {
+        const GrayView src = pyramid.Level(level - 1), dst = pyramid.Level(level);
+        for (i32 y = 0; y < dst.height; ++y) {
+            for (i32 x = 0; x < dst.width; ++x) {
+                ASSERT_EQ(dst(x, y), ReferencePyrDown(src, x, y)) << "level " << level << " at " << x << ", " << y;
+            }
+        }
+    }
+}
+
+TEST(ImagePyramid, BorderIsReflect101) {
+    constexpr i32 kBorder = 5;
+    const GrayImage image = test::MakeScene(40, 30, 3);
+    ImagePyramid pyramid({.levels = 3, .border = kBorder});
+    pyramid.Build(image.GetView());
+
+    for (i32 level = 0; level < pyramid.GetLevels(); ++level) {
+        const GrayView view = pyramid.Level(level);
+        for (i32 y = -kBorder; y < view.height + kBorder; ++y) {
+            const u8* row = view.data + static_cast<std::ptrdiff_t>(y) * view.stride;
+            for (i32 x = -kBorder; x < view.width + kBorder; ++x) {
+                ASSERT_EQ(row[x], view(Reflect101(x, view.width), Reflect101(y, view.height)))
+                    << "level " << level << " at " << x << ", " << y;
+            }
+        }
+
+        // NOTE: OpenCV sees the level itself, the border is outside the ROI
+        const cv::Mat& mat = pyramid.Mat(level);
+        EXPECT_EQ(mat.ptr<u8>(), view.data);
+        EXPECT_EQ(mat.cols, view.width);
+        EXPECT_EQ(mat.rows, view.height);
+    }
+}
+
+TEST(ImagePyramid, PrepareThenBuildMatchesBuild) {
+    const GrayImage image = test::MakeScene(64, 48, 4);
+    ImagePyramid copied, prepared;
+    copied.Build(image.GetView());
+
+    const ImageView<u8> base = prepared.Prepare(64, 48);
+    for (i32 y = 0; y < 48; ++y) std::copy_n(image.Row(y), 64, base.Row(y));
+    prepared.Build();
+
+    ASSERT_EQ(prepared.GetLevels(), copied.GetLevels());
+    for (i32 level = 0; level < copied.GetLevels(); ++level) {
+        const GrayView a = copied.Level(level), b = prepared.Level(level);
+        for (i32 y = 0; y < a.height; ++y) {
+            EXPECT_TRUE(std::equal(a.Row(y), a.Row(y) + a.width, b.Row(y))) << "level " << level << " row " << y;
+        }
+    }
+}
+
+} // namespace
+} // namespace ct
@@ -0,0 +1,124 @@
+#include "support.hpp"
+
+#include "toolbox/vision/image/kernels.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace ct {
+namespace {
+
+constexpr cpu::SimdLevel kLevels[] = {cpu::SimdLevel::SSE42, cpu::SimdLevel::AVX2, cpu::SimdLevel::AVX512};
+
+// NOTE: Odd sizes so every kernel runs its vector body and its scalar tail
+constexpr i32 kWidth = 203;
+constexpr i32 kHeight = 77;
+
+Image<u8, 3> MakeBgr(u32 seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<i32> value(0, 255);
+    Image<u8, 3> image(kWidth, kHeight);
+    for (i32 y = 0; y < kHeight; ++y) {
+        for (i32 x = 0; x < 3 * kWidth; ++x) image.Row(y)[x] = static_cast<u8>(value(rng));
+    }
+    return image;
+}
+
+template<typename T, i32 Channels>
+std::vector<T> Pixels(const Image<T, Channels>& image) {
+    std::vector<T> out;
+    for (i32 y = 0; y < image.GetHeight(); ++y) {
+        out.insert(out.end(), image.Row(y), image.Row(y) + image.GetWidth() * Channels);
+    }
+    return out;
+}
+
+// NOTE: run(level) returns the pixels the kernel produced at that level
+template<typename Run>
+void ExpectLevelsMatchScalar(Run run) {
+    const auto expected = [&] {
+        test::ScopedSimdLevel scalar(cpu::SimdLevel::Scalar);
+        return run();
+    }();
+    for (const cpu::SimdLevel level : kLevels) {
+        if (level > cpu::GetDetectedLevel()) continue;
+        test::ScopedSimdLevel scoped(level);
+        EXPECT_EQ(run(), expected) << cpu::ToString(level);
+    }
+}
+
+TEST(ImageKernels, GrayMatchesScalar) {
+    const Image<u8, 3> bgr = MakeBgr(1);
+    ExpectLevelsMatchScalar([&] {
+        GrayImage gray(kWidth, kHeight);
+        BgrToGray(bgr.GetView(), gray.GetView());
+        return Pixels(gray);
+    });
+}
+
+TEST(ImageKernels, PyrDownMatchesScalar) {
+    const GrayImage src = test::MakeScene(kWidth, kHeight, 2);
+    ExpectLevelsMatchScalar([&] {
+        GrayImage half((kWidth + 1) / 2, (kHeight + 1) / 2);
+        std::vector<u16> sums;
+        PyrDown(src.GetView(), half.GetView(), sums);
+        return Pixels(half);
+    });
+}
+
+TEST(ImageKernels, FusedGrayPyrDownMatchesTwoPasses) {
+    const Image<u8, 3> bgr = MakeBgr(3);
+    GrayImage gray(kWidth, kHeight), half((kWidth + 1) / 2, (kHeight + 1) / 2);
+    std::vector<u16> sums;
+    BgrToGray(bgr.GetView(), gray.GetView());
+    PyrDown(gray.GetView(), half.GetView(), sums);
+
+    ExpectLevelsMatchScalar([&] {
+        GrayImage fusedGray(kWidth, kHeight), fusedHalf((kWidth + 1) / 2, (kHeight + 1) / 2);
+        BgrToGrayPyrDown(bgr.GetView(), fusedGray.GetView(), fusedHalf.GetView(), sums);
+        EXPECT_EQ(Pixels(fusedGray), Pixels(gray));
+        EXPECT_EQ(Pixels(fusedHalf), Pixels(half));
+        return Pixels(fusedHalf);
+    });
+}
+
+TEST(ImageKernels, BlurMatchesScalar) {
+    const GrayImage src = test::MakeScene(kWidth, kHeight, 4);
+    for (const f32 sigma : {1.0f, 2.0f}) {
+        std::vector<u16> taps;
+        GaussianTaps(sigma, taps);
+        ExpectLevelsMatchScalar([&] {
+            GrayImage dst(kWidth, kHeight);
+            std::vector<u16> sums;
+            GaussianBlur(src.GetView(), dst.GetView(), taps, sums);
+            return Pixels(dst);
+        });
+    }
+}
+
+TEST(ImageKernels, SobelMatchesScalar) {
+    const GrayImage src = test::MakeScene(kWidth, kHeight, 5);
+    ExpectLevelsMatchScalar([&] {
+        Image<i16> dx(kWidth, kHeight), dy(kWidth, kHeight);
+        std::vector<i16> sums;
+        Sobel(src.GetView(), dx.GetView(), dy.GetView(), sums);
+        std::vector<i16> out = Pixels(dx);
+        const std::vector<i16> y = Pixels(dy);
+        out.insert(out.end(), y.begin(), y.end());
+        return out;
+    });
+}
+
+TEST(ImageKernels, IntegralMatchesScalar) {
+    const GrayImage src = test::MakeScene(kWidth, kHeight, 6);
+    ExpectLevelsMatchScalar([&] {
+        Image<u32> sum(kWidth + 1, kHeight + 1);
+        Integral(src.GetView(), sum.GetView());
+        return Pixels(sum);
+    });
+}
+
+} // namespace
+} // namespace ct
@@ -0,0 +1,129 @@
+#include "support.hpp"
+
+#include "toolbox/vision/map/backend.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <random>
+#include <thread>
+
+namespace ct {
+namespace {
+
+using namespace std::chrono_literals;
+
+// NOTE: Keyframes stepping sideways past the scene, every point seen by all of them. The exact
+// observations are taken before poses (but the fixed ones) and points are disturbed.
+MapWindow MakeWindow(u64 epoch, u32 seed) {
+    const CameraIntrinsics camera = test::MakeCamera();
+    const std::vector<vec3d> truth = test::MakePoints(80, seed);
+    std::mt19937 rng(seed);
+    std::normal_distribution<f64> jitter(0.0, 0.05);
+
+    MapWindow window;
+    window.epoch = epoch;
+    window.intrinsics = camera;
+    window.fixed = 2;
+    for (u32 k = 0; k < 5; ++k) {
+        const Pose pose{so3d::exp(vec3d(0.0, 0.02 * k, 0.0)).matrix(), vec3d(-0.3 * k, 0.0, 0.0)};
+        window.keyframes.push_back(10 + k);
+        window.poses.push_back(pose);
+        for (u32 p = 0; p < truth.size(); ++p) {
+            const cv::Point2f px = test::Project(camera, Transform(pose, truth[p]));
+            window.observations.push_back({k, p, px.x, px.y});
+        }
+        if (k >= window.fixed) window.poses.back().translation += vec3d(jitter(rng), jitter(rng), jitter(rng));
+    }
+    for (u32 p = 0; p < truth.size(); ++p) {
+        window.handles.push_back(MapPointHandle{});
+        window.points.push_back(truth[p] + vec3d(jitter(rng), jitter(rng), jitter(rng)));
+    }
+    return window;
+}
+
+f64 MeanReprojectionError(const MapWindow& window) {
+    const CameraIntrinsics& k = window.intrinsics;
+    f64 sum = 0.0;
+    for (const WindowObservation& o : window.observations) {
+        const cv::Point2f px = test::Project(k, Transform(window.poses[o.keyframe], window.points[o.point]));
+        sum += std::hypot(px.x - o.u, px.y - o.v);
+    }
+    return sum / static_cast<f64>(window.observations.size());
+}
+
+// NOTE: The backend never blocks the tracker, so the test polls like the tracker does
+bool PollFor(MappingBackend& backend, std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (backend.Poll()) return true;
+        std::this_thread::sleep_for(1ms);
+    }
+    return false;
+}
+
+TEST(MappingBackend, ReturnsTheSubmittedWindowRefined) {
+    MappingBackend backend({.iterations = 20});
+    EXPECT_FALSE(backend.Poll());
+
+    const MapWindow submitted = MakeWindow(3, 1);
+    backend.Request() = submitted;
+    backend.Submit();
+    ASSERT_TRUE(PollFor(backend, 5000ms));
+
+    const MapWindow& result = backend.Latest();
+    EXPECT_EQ(result.epoch, submitted.epoch);
+    EXPECT_EQ(result.version, 1u);
+    EXPECT_EQ(result.keyframes, submitted.keyframes);
+    EXPECT_EQ(backend.GetOptimized(), 1u);
+    EXPECT_LT(MeanReprojectionError(result), 0.01 * MeanReprojectionError(submitted));
+
+    // NOTE: Fixed keyframes do not move
+    for (u32 k = 0; k < submitted.fixed; ++k) {
+        EXPECT_EQ(result.poses[k].translation, submitted.poses[k].translation);
+    }
+    EXPECT_FALSE(backend.Poll());
+}
+
+TEST(MappingBackend, SkipsWindowsWithNothingToOptimize) {
+    MappingBackend backend;
+    MapWindow& empty = backend.Request();
+    empty = MakeWindow(1, 2);
+    empty.fixed = static_cast<u32>(empty.keyframes.size());
+    backend.Submit();
+
+    backend.Request() = MakeWindow(2, 3);
+    backend.Submit();
+    ASSERT_TRUE(PollFor(backend, 5000ms));
+    EXPECT_EQ(backend.Latest().epoch, 2u);
+    EXPECT_EQ(backend.GetOptimized(), 1u);
+}
+
+// NOTE: Windows submitted faster than they are solved replace each other, the last one always
+// comes back and versions only grow
+TEST(MappingBackend, TheNewestSubmissionWins) {
+    MappingBackend backend({.iterations = 5});
+    u64 version = 0;
+    for (u64 epoch = 1; epoch <= 20; ++epoch) {
+        backend.Request() = MakeWindow(epoch, static_cast<u32>(epoch));
+        backend.Submit();
+        if (backend.Poll()) {
+            EXPECT_GT(backend.Latest().version, version);
+            version = backend.Latest().version;
+        }
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + 5000ms;
+    while (backend.Latest().epoch != 20 && std::chrono::steady_clock::now() < deadline) {
+        if (backend.Poll()) {
+            EXPECT_GT(backend.Latest().version, version);
+            version = backend.Latest().version;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_EQ(backend.Latest().epoch, 20u);
+    EXPECT_LE(backend.GetOptimized(), 20u);
+}
+
+} // namespace
+} // namespace ct
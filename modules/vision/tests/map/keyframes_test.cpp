@@ -0,0 +1,264 @@
+#include "support.hpp"
+
+#include "toolbox/vision/map/keyframes.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace ct {
+namespace {
+
+const Pose kSecond{so3d::exp(vec3d(0.0, 0.02, 0.0)).matrix(), vec3d(-0.5, 0.0, 0.0)};
+
+// NOTE: The camera with pose cameraFromWorld sees `points`, one keypoint and descriptor each
+Frame MakeFrame(const std::vector<vec3d>& points, const Descriptors& des, const Pose& cameraFromWorld, Timestamp ts) {
+    Frame frame;
+    frame.timestamp = ts;
+    frame.des = des;
+    for (const vec3d& p : points) {
+        const cv::Point2f px = test::Project(test::MakeCamera(), Transform(cameraFromWorld, p));
+        frame.kps.Push(px.x, px.y, 0.0f, 1.0f);
+    }
+    return frame;
+}
+
+// NOTE: Keypoints on a grid for descriptors that only matter for their appearance
+Frame MakeFrame(const Descriptors& des) {
+    Frame frame;
+    frame.des = des;
+    for (u32 i = 0; i < des.size(); ++i) frame.kps.Push(static_cast<f32>(i % 640), static_cast<f32>(i / 640), 0.0f, 1.0f);
+    return frame;
+}
+
+// NOTE: Every keypoint matched to itself, every fifth one left out by the mask
+class KeyframeMap : public testing::Test {
+protected:
+    void SetUp() override {
+        mPoints = test::MakePoints(200, 3);
+        mDes = test::RandomDescriptors(mPoints.size(), 4);
+        mFirst = MakeFrame(mPoints, mDes, Pose{}, 0.0);
+        mSecond = MakeFrame(mPoints, mDes, kSecond, 0.1);
+        for (int i = 0; i < static_cast<int>(mPoints.size()); ++i) {
+            mMatches.emplace_back(i, i, 0.0f);
+            mMask.push_back(i % 5 != 0);
+        }
+    }
+
+    // NOTE: The map point each keypoint of the newest keyframe holds
+    static std::vector<MapPointHandle> Tracked(const KeyframeManager& keyframes) {
+        return keyframes.GetKeyframes().back().points;
+    }
+
+    std::vector<vec3d> mPoints;
+    Descriptors mDes;
+    Frame mFirst, mSecond;
+    Matches mMatches;
+    std::vector<u8> mMask;
+};
+
+TEST(MapPoints, StaleHandlesNeverAlias) {
+    MapPointStore store;
+    const Descriptor des{};
+    const MapPointHandle a = store.Add(vec3d(1.0, 0.0, 0.0), des, 0);
+    const MapPointHandle b = store.Add(vec3d(2.0, 0.0, 0.0), des, 0);
+    const MapPointHandle c = store.Add(vec3d(3.0, 0.0, 0.0), des, 0);
+    ASSERT_EQ(store.Size(), 3u);
+
+    // NOTE: The last point moves into the freed index, its handle follows it
+    EXPECT_TRUE(store.Remove(a));
+    EXPECT_FALSE(store.Remove(a));
+    EXPECT_FALSE(store.Contains(a));
+    EXPECT_EQ(store.IndexOf(a), MapPointStore::kNone);
+    ASSERT_EQ(store.IndexOf(c), 0u);
+    EXPECT_EQ(store.HandleAt(0), c);
+    EXPECT_DOUBLE_EQ(store.GetPositions()[store.IndexOf(c)].x, 3.0);
+    EXPECT_DOUBLE_EQ(store.GetPositions()[store.IndexOf(b)].x, 2.0);
+
+    const MapPointHandle d = store.Add(vec3d(4.0, 0.0, 0.0), des, 1);
+    EXPECT_EQ(d.slot, a.slot);
+    EXPECT_NE(d, a);
+    EXPECT_FALSE(store.Contains(a));
+    EXPECT_DOUBLE_EQ(store.GetPositions()[store.IndexOf(d)].x, 4.0);
+    EXPECT_EQ(store.GetCreated(store.IndexOf(d)), 1u);
+
+    store.Clear();
+    EXPECT_TRUE(store.Empty());
+    for (const MapPointHandle handle : {a, b, c, d}) EXPECT_FALSE(store.Contains(handle));
+    EXPECT_FALSE(store.Contains(MapPointHandle{}));
+}
+
+TEST(MapPoints, FoundRatioStaysWithinOne) {
+    MapPointStore store;
+    const u32 index = store.IndexOf(store.Add(vec3d(0.0, 0.0, 4.0), Descriptor{}, 0));
+    EXPECT_FLOAT_EQ(store.FoundRatio(index), 1.0f);
+
+    // NOTE: Found without being projected, as a brute-force match is
+    for (u32 frame = 1; frame <= 3; ++frame) store.MarkFound(index, frame);
+    EXPECT_FLOAT_EQ(store.FoundRatio(index), 1.0f);
+    EXPECT_EQ(store.GetLastSeen(index), 3u);
+
+    for (u32 i = 0; i < 4; ++i) store.MarkVisible(index);
+    EXPECT_FLOAT_EQ(store.FoundRatio(index), 0.5f);
+}
+
+// NOTE: A new point starts seen and found once, the projection counts one more sighting
+TEST(MapPoints, ProjectMarksOnlyPointsInView) {
+    MapPointStore store;
+    store.Add(vec3d(0.0, 0.0, 4.0), Descriptor{}, 0);
+    store.Add(vec3d(0.0, 0.0, -4.0), Descriptor{}, 0);
+    store.Add(vec3d(40.0, 0.0, 4.0), Descriptor{}, 0);
+
+    std::vector<cv::Point2f> out;
+    store.Project(Pose{}, test::MakeCamera(), 640.0f, 480.0f, out);
+    ASSERT_EQ(out.size(), 3u);
+    EXPECT_EQ(out[0], cv::Point2f(320.0f, 240.0f));
+    EXPECT_EQ(out[1], MapPointStore::kNowhere);
+    EXPECT_EQ(out[2], MapPointStore::kNowhere);
+
+    EXPECT_FLOAT_EQ(store.FoundRatio(0), 0.5f);
+    EXPECT_FLOAT_EQ(store.FoundRatio(1), 1.0f);
+    EXPECT_FLOAT_EQ(store.FoundRatio(2), 1.0f);
+}
+
+TEST_F(KeyframeMap, InitializeTriangulatesTheMaskedMatches) {
+    KeyframeManager keyframes;
+    const u32 created = keyframes.Initialize(mFirst, mSecond, kSecond, mMatches, mMask, test::MakeCamera());
+    EXPECT_EQ(created, 160u);
+    ASSERT_EQ(keyframes.Size(), 2u);
+
+    const MapPointStore& store = keyframes.GetPoints();
+    EXPECT_EQ(store.Size(), created);
+    const Keyframe& first = keyframes.GetKeyframes()[0];
+    const Keyframe& second = keyframes.GetKeyframes()[1];
+    for (std::size_t i = 0; i < mPoints.size(); ++i) {
+        EXPECT_EQ(first.points[i], second.points[i]) << i;
+        const u32 index = store.IndexOf(second.points[i]);
+        if (!mMask[i]) {
+            EXPECT_EQ(index, MapPointStore::kNone) << i;
+            continue;
+        }
+        ASSERT_NE(index, MapPointStore::kNone) << i;
+        EXPECT_LT((store.GetPositions()[index] - mPoints[i]).length(), 1e-3) << i;
+        EXPECT_EQ(store.GetObservers(index), 2u);
+    }
+}
+
+TEST_F(KeyframeMap, NeedKeyframeWantsLostPointsTimeOrParallax) {
+    KeyframeManager keyframes;
+    keyframes.Initialize(mFirst, mSecond, kSecond, mMatches, mMask, test::MakeCamera());
+    const std::vector<MapPointHandle> tracked = Tracked(keyframes);
+
+    // NOTE: Standing still, the tracked points keep their rays
+    Frame frame = MakeFrame(mPoints, mDes, kSecond, 0.2);
+    EXPECT_FALSE(keyframes.NeedKeyframe(frame, kSecond, tracked, 160));
+    EXPECT_TRUE(keyframes.NeedKeyframe(frame, kSecond, tracked, 80));
+    frame.timestamp = 1.1;
+    EXPECT_TRUE(keyframes.NeedKeyframe(frame, kSecond, tracked, 160));
+
+    const Pose moved{kSecond.rotation, kSecond.translation + vec3d(-0.5, 0.0, 0.0)};
+    frame = MakeFrame(mPoints, mDes, moved, 0.2);
+    EXPECT_TRUE(keyframes.NeedKeyframe(frame, moved, tracked, 160));
+}
+
+TEST_F(KeyframeMap, OldestKeyframesLeaveBeyondTheLimit) {
+    // NOTE: No keyframe is redundant, only the limit drops them
+    KeyframeManager keyframes({.maxKeyframes = 3, .redundancy = 2.0f});
+    keyframes.Initialize(mFirst, mSecond, kSecond, mMatches, mMask, test::MakeCamera());
+
+    for (u32 step = 1; step <= 4; ++step) {
+        const Pose pose{kSecond.rotation, kSecond.translation + vec3d(-0.3 * step, 0.0, 0.0)};
+        const std::vector<MapPointHandle> tracked = Tracked(keyframes);
+        keyframes.Insert(MakeFrame(mPoints, mDes, pose, 0.1 + step), pose, tracked, test::MakeCamera());
+        EXPECT_LE(keyframes.Size(), 3u);
+    }
+
+    const std::span<const Keyframe> kept = keyframes.GetKeyframes();
+    ASSERT_EQ(kept.size(), 3u);
+    for (u32 k = 0; k < 3; ++k) EXPECT_EQ(kept[k].id, 3 + k);
+
+    // NOTE: The points the dropped keyframes held live on in the kept ones
+    const MapPointStore& store = keyframes.GetPoints();
+    EXPECT_GE(store.Size(), 160u);
+    for (const MapPointHandle handle : kept.back().points) {
+        const u32 index = store.IndexOf(handle);
+        if (index == MapPointStore::kNone) continue;
+        EXPECT_EQ(store.GetObservers(index), 3u);
+    }
+
+    keyframes.Reset();
+    EXPECT_TRUE(keyframes.Empty());
+    EXPECT_TRUE(keyframes.GetPoints().Empty());
+}
+
+// NOTE: Two places, each its own appearance cluster; a frame of one should find its keyframes
+class KeyframePlaces : public testing::Test {
+protected:
+    void SetUp() override {
+        const Descriptors a = test::RandomDescriptors(300, 1), b = test::RandomDescriptors(300, 2);
+        std::vector<Descriptors> images;
+        for (u32 i = 0; i < 8; ++i) images.push_back(test::PerturbedDescriptors(i % 2 ? b : a, 300, 12, 10 + i));
+        auto vocabulary = Vocabulary::Train(images, {.branching = 8, .depth = 3});
+        ASSERT_TRUE(vocabulary) << vocabulary.error().Message();
+        mVocabulary = std::move(*vocabulary);
+
+        mFirst = MakeFrame(test::PerturbedDescriptors(a, 300, 12, 20));
+        mSecond = MakeFrame(test::PerturbedDescriptors(b, 300, 12, 21));
+        mQuery = MakeFrame(test::PerturbedDescriptors(a, 300, 12, 22));
+    }
+
+    Vocabulary mVocabulary;
+    Frame mFirst, mSecond, mQuery;
+};
+
+TEST_F(KeyframePlaces, ArchivedKeyframesStayQueryable) {
+    KeyframeManager keyframes({.vocabulary = &mVocabulary});
+    const Pose second{mat3d::identity(), vec3d(-0.2, 0.0, 0.0)};
+    keyframes.Initialize(mFirst, mSecond, second, {}, {}, test::MakeCamera());
+    ASSERT_EQ(keyframes.Size(), 2u);
+    const u32 first = keyframes.GetKeyframes()[0].id;
+    const u64 epoch = keyframes.GetEpoch();
+
+    std::vector<PlaceCandidate> out;
+    keyframes.QueryPlaces(mQuery, 2, out);
+    ASSERT_FALSE(out.empty());
+    EXPECT_EQ(out[0].id, first);
+    EXPECT_EQ(keyframes.FindPlace(first), nullptr);
+
+    keyframes.Reset();
+    EXPECT_TRUE(keyframes.Empty());
+    keyframes.QueryPlaces(mQuery, 2, out);
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(out[0].id, first);
+
+    const PlaceRecord* record = keyframes.FindPlace(first);
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(record->id, first);
+    EXPECT_EQ(record->epoch, epoch);
+    EXPECT_FALSE(record->bow.Empty());
+    ASSERT_NE(keyframes.FindPlace(first + 1), nullptr);
+    EXPECT_DOUBLE_EQ(keyframes.FindPlace(first + 1)->pose.translation[0], second.translation[0]);
+    EXPECT_EQ(keyframes.GetArchive().size(), 2u);
+
+    keyframes.ClearArchive();
+    EXPECT_EQ(keyframes.FindPlace(first), nullptr);
+    keyframes.QueryPlaces(mQuery, 2, out);
+    EXPECT_TRUE(out.empty());
+}
+
+TEST_F(KeyframePlaces, NothingIsIndexedWithoutAVocabulary) {
+    const Vocabulary empty;
+    for (const Vocabulary* vocabulary : {static_cast<const Vocabulary*>(nullptr), &empty}) {
+        KeyframeManager keyframes({.vocabulary = vocabulary});
+        keyframes.Initialize(mFirst, mSecond, Pose{}, {}, {}, test::MakeCamera());
+        keyframes.Reset();
+
+        std::vector<PlaceCandidate> out;
+        keyframes.QueryPlaces(mQuery, 2, out);
+        EXPECT_TRUE(out.empty());
+        EXPECT_TRUE(keyframes.GetArchive().empty());
+    }
+}
+
+} // namespace
+} // namespace ct
@@ -0,0 +1,110 @@
+#include "support.hpp"
+
+#include "toolbox/vision/place/database.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace ct {
+namespace {
+
+// NOTE: size distinct random words with random weights summing to one
+BowVector RandomBow(u32 words, u32 size, std::mt19937& rng) {
+    std::uniform_int_distribution<u32> word(0, words - 1);
+    std::uniform_real_distribution<f32> weight(0.1f, 1.0f);
+    BowVector bow;
+    while (bow.words.size() < size) bow.words.push_back(word(rng));
+    std::sort(bow.words.begin(), bow.words.end());
+    bow.words.erase(std::unique(bow.words.begin(), bow.words.end()), bow.words.end());
+
+    f32 total = 0.0f;
+    for (std::size_t i = 0; i < bow.words.size(); ++i) total += bow.weights.emplace_back(weight(rng));
+    for (f32& w : bow.weights) w /= total;
+    return bow;
+}
+
+TEST(PlaceDatabase, QueryRanksByScore) {
+    std::mt19937 rng(1);
+    std::vector<BowVector> bows;
+    PlaceDatabase database;
+    for (u32 id = 0; id < 50; ++id) {
+        bows.push_back(RandomBow(2000, 100, rng));
+        database.Add(100 + id, bows.back());
+    }
+    EXPECT_EQ(database.Size(), 50u);
+
+    std::vector<PlaceCandidate> out;
+    database.Query(bows[7], 5, out);
+    ASSERT_EQ(out.size(), 5u);
+    EXPECT_EQ(out[0].id, 107u);
+    EXPECT_NEAR(out[0].score, 1.0f, 1e-5f);
+    for (std::size_t i = 1; i < out.size(); ++i) {
+        EXPECT_GE(out[i - 1].score, out[i].score);
+        const u32 index = out[i].id - 100;
+        EXPECT_NEAR(out[i].score, Score(bows[7], bows[index]), 1e-5f);
+    }
+
+    database.Query(bows[7], 5, out, 0.5f);
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0].id, 107u);
+}
+
+TEST(PlaceDatabase, RemoveAndReplace) {
+    std::mt19937 rng(2);
+    const BowVector a = RandomBow(500, 50, rng), b = RandomBow(500, 50, rng);
+    PlaceDatabase database;
+    database.Add(1, a);
+    database.Add(2, b);
+
+    std::vector<PlaceCandidate> out;
+    EXPECT_TRUE(database.Remove(1));
+    EXPECT_FALSE(database.Remove(1));
+    database.Query(a, 10, out, 0.99f);
+    EXPECT_TRUE(out.empty());
+
+    // NOTE: Adding an id again replaces its entry
+    database.Add(2, a);
+    EXPECT_EQ(database.Size(), 1u);
+    database.Query(a, 10, out);
+    ASSERT_FALSE(out.empty());
+    EXPECT_EQ(out[0].id, 2u);
+    EXPECT_NEAR(out[0].score, 1.0f, 1e-5f);
+
+    database.Clear();
+    EXPECT_TRUE(database.Empty());
+    database.Query(a, 10, out);
+    EXPECT_TRUE(out.empty());
+}
+
+// NOTE: A long run: 10k keyframes of 300 words over a 10^5 word vocabulary (branching 10, depth 5).
+// The top-10 query has to stay below a millisecond, timings are only meaningful optimized.
+TEST(PlaceDatabase, QueryTakesLessThanAMillisecond) {
+#if !defined(NDEBUG)
+    GTEST_SKIP() << "timing needs an optimized build";
+#endif
+    constexpr u32 kWords = 100000;
+    std::mt19937 rng(3);
+    PlaceDatabase database;
+    for (u32 id = 0; id < 10000; ++id) database.Add(id, RandomBow(kWords, 300, rng));
+
+    std::vector<BowVector> queries;
+    for (u32 i = 0; i < 51; ++i) queries.push_back(RandomBow(kWords, 300, rng));
+
+    std::vector<PlaceCandidate> out;
+    database.Query(queries.back(), 10, out);
+    std::vector<f64> times;
+    for (const BowVector& query : queries) {
+        const auto start = std::chrono::steady_clock::now();
+        database.Query(query, 10, out);
+        times.push_back(std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::nth_element(times.begin(), times.begin() + 25, times.end());
+    EXPECT_LT(times[25], 1.0);
+}
+
+} // namespace
+} // namespace ct
@@ -0,0 +1,140 @@
+#include "support.hpp"
+
+#include "toolbox/vision/place/vocabulary.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ct {
+namespace {
+
+constexpr cpu::SimdLevel kLevels[] = {cpu::SimdLevel::SSE42, cpu::SimdLevel::AVX2, cpu::SimdLevel::AVX512};
+
+// NOTE: Images drawn from a shared pool of appearance clusters, like frames of one environment
+std::vector<Descriptors> MakeImages(u32 count, u32 seed) {
+    const Descriptors centers = test::RandomDescriptors(400, seed);
+    std::vector<Descriptors> images;
+    for (u32 i = 0; i < count; ++i) images.push_back(test::PerturbedDescriptors(centers, 300, 12, seed + 1 + i));
+    return images;
+}
+
+// NOTE: A name of its own per call, test processes running side by side never share a file
+std::filesystem::path TempPath(const char* name) {
+    std::random_device device;
+    return std::filesystem::path(testing::TempDir()) / (std::string(name) + "_" + std::to_string(device()) + ".bin");
+}
+
+Vocabulary Train() {
+    const std::vector<Descriptors> images = MakeImages(20, 1);
+    auto vocabulary = Vocabulary::Train(images, {.branching = 8, .depth = 3});
+    EXPECT_TRUE(vocabulary) << vocabulary.error().Message();
+    return std::move(*vocabulary);
+}
+
+std::vector<u32> Words(const Vocabulary& vocabulary, const Descriptors& descriptors) {
+    std::vector<u32> words(descriptors.size());
+    vocabulary.Quantize(descriptors, words);
+    return words;
+}
+
+TEST(Vocabulary, TrainsAFullTree) {
+    const Vocabulary vocabulary = Train();
+    ASSERT_FALSE(vocabulary.Empty());
+    EXPECT_EQ(vocabulary.GetBranching(), 8u);
+    EXPECT_EQ(vocabulary.GetDepth(), 3u);
+    EXPECT_LE(vocabulary.GetWords(), 8u * 8u * 8u);
+    EXPECT_GT(vocabulary.GetWords(), 100u);
+
+    for (const u32 word : Words(vocabulary, test::RandomDescriptors(200, 9))) EXPECT_LT(word, vocabulary.GetWords());
+}
+
+TEST(Vocabulary, SaveLoadRoundTripQuantizesTheSame) {
+    const Vocabulary trained = Train();
+    const std::filesystem::path path = TempPath("toolbox_vocabulary_test");
+    ASSERT_TRUE(trained.Save(path));
+
+    auto loaded = Vocabulary::Load(path);
+    ASSERT_TRUE(loaded) << loaded.error().Message();
+    EXPECT_EQ(loaded->GetWords(), trained.GetWords());
+    EXPECT_EQ(loaded->GetNodes(), trained.GetNodes());
+    EXPECT_EQ(loaded->GetBranching(), trained.GetBranching());
+    EXPECT_EQ(loaded->GetDepth(), trained.GetDepth());
+    for (u32 w = 0; w < trained.GetWords(); ++w) EXPECT_EQ(loaded->GetWeight(w), trained.GetWeight(w));
+
+    for (const Descriptors& image : MakeImages(5, 100)) EXPECT_EQ(Words(*loaded, image), Words(trained, image));
+
+    BowVector a, b;
+    const Descriptors image = MakeImages(1, 200).front();
+    trained.Transform(image, a);
+    loaded->Transform(image, b);
+    EXPECT_EQ(a.words, b.words);
+    EXPECT_EQ(a.weights, b.weights);
+
+    loaded = Vocabulary{};
+    std::filesystem::remove(path);
+}
+
+TEST(Vocabulary, LoadRejectsWhatItDidNotWrite) {
+    EXPECT_FALSE(Vocabulary::Load(TempPath("toolbox_no_such_vocabulary")));
+
+    const std::filesystem::path path = TempPath("toolbox_not_a_vocabulary");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "definitely not a vocabulary, but long enough to hold a header";
+    }
+    EXPECT_FALSE(Vocabulary::Load(path));
+    std::filesystem::remove(path);
+}
+
+TEST(Vocabulary, EveryLevelQuantizesLikeScalar) {
+    const Vocabulary vocabulary = Train();
+    const Descriptors descriptors = MakeImages(1, 300).front();
+
+    std::vector<u32> expected;
+    {
+        test::ScopedSimdLevel scalar(cpu::SimdLevel::Scalar);
+        expected = Words(vocabulary, descriptors);
+    }
+    for (const cpu::SimdLevel level : kLevels) {
+        if (level > cpu::GetDetectedLevel()) continue;
+        test::ScopedSimdLevel scoped(level);
+        EXPECT_EQ(Words(vocabulary, descriptors), expected) << cpu::ToString(level);
+    }
+}
+
+TEST(Vocabulary, TransformIsNormalizedAndSorted) {
+    const Vocabulary vocabulary = Train();
+    BowVector bow;
+    vocabulary.Transform(MakeImages(1, 400).front(), bow);
+    ASSERT_FALSE(bow.Empty());
+    ASSERT_EQ(bow.words.size(), bow.weights.size());
+
+    f32 total = 0.0f;
+    for (u32 i = 0; i < bow.Size(); ++i) {
+        if (i > 0) {
+            EXPECT_LT(bow.words[i - 1], bow.words[i]);
+        }
+        EXPECT_GT(bow.weights[i], 0.0f);
+        total += bow.weights[i];
+    }
+    EXPECT_NEAR(total, 1.0f, 1e-5f);
+    EXPECT_NEAR(Score(bow, bow), 1.0f, 1e-5f);
+}
+
+TEST(Vocabulary, EmptyVocabularyGivesEmptyVectors) {
+    const Vocabulary vocabulary;
+    BowVector bow;
+    bow.words = {1, 2, 3};
+    bow.weights = {0.2f, 0.3f, 0.5f};
+    vocabulary.Transform(test::RandomDescriptors(50, 5), bow);
+    EXPECT_TRUE(bow.Empty());
+    EXPECT_TRUE(bow.weights.empty());
+}
+
+} // namespace
+} // namespace ct
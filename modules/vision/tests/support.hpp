@@ -0,0 +1,99 @@
+#pragma once
+
+#include "toolbox/base/base.hpp"
+#include "toolbox/vision/features/descriptor.hpp"
+#include "toolbox/vision/image/image.hpp"
+#include "toolbox/vision/sensors/camera.hpp"
+#include "toolbox/vision/types.hpp"
+
+#include <algorithm>
+#include <random>
+
+namespace ct::test {
+
+// NOTE: Switches the dispatch level for one scope, tests compare every level against scalar
+class ScopedSimdLevel {
+public:
+    explicit ScopedSimdLevel(cpu::SimdLevel level) noexcept : mPrevious(cpu::GetLevel()) { cpu::SetLevel(level); }
+    ~ScopedSimdLevel() { cpu::SetLevel(mPrevious); }
+    ScopedSimdLevel(const ScopedSimdLevel&) = delete;
+    ScopedSimdLevel& operator=(const ScopedSimdLevel&) = delete;
+
+private:
+    cpu::SimdLevel mPrevious;
+};
+
+// NOTE: Deterministic clutter of overlapping boxes over a gradient with pixel noise, it has corners
+// everywhere at the thresholds the extractor uses
+inline GrayImage MakeScene(i32 width, i32 height, u32 seed) {
+    std::mt19937 rng(seed);
+    GrayImage image(width, height);
+    for (i32 y = 0; y < height; ++y) {
+        for (i32 x = 0; x < width; ++x) image.Row(y)[x] = static_cast<u8>((x + 2 * y) & 0x7f);
+    }
+
+    std::uniform_int_distribution<i32> px(0, width - 1), py(0, height - 1), side(4, 40), shade(0, 255);
+    for (i32 i = 0; i < width * height / 400; ++i) {
+        const i32 x0 = px(rng), y0 = py(rng);
+        const i32 x1 = std::min(width, x0 + side(rng)), y1 = std::min(height, y0 + side(rng));
+        const u8 value = static_cast<u8>(shade(rng));
+        for (i32 y = y0; y < y1; ++y) std::fill(image.Row(y) + x0, image.Row(y) + x1, value);
+    }
+
+    std::uniform_int_distribution<i32> noise(-3, 3);
+    for (i32 y = 0; y < height; ++y) {
+        u8* row = image.Row(y);
+        for (i32 x = 0; x < width; ++x) row[x] = static_cast<u8>(std::clamp(row[x] + noise(rng), 0, 255));
+    }
+    return image;
+}
+
+// NOTE: Uniformly random bits
+inline Descriptors RandomDescriptors(std::size_t count, u32 seed) {
+    std::mt19937_64 rng(seed);
+    Descriptors out(count);
+    for (Descriptor& d : out) {
+        for (u64& word : d.words) word = rng();
+    }
+    return out;
+}
+
+// NOTE: Copies of the centers with a few bits flipped each, so every center has a cluster around it
+inline Descriptors PerturbedDescriptors(const Descriptors& centers, std::size_t count, u32 maxFlips, u32 seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> pick(0, centers.size() - 1);
+    std::uniform_int_distribution<u32> flips(0, maxFlips), bit(0, Descriptor::kBits - 1);
+    Descriptors out(count);
+    for (Descriptor& d : out) {
+        d = centers[pick(rng)];
+        for (u32 n = flips(rng); n > 0; --n) {
+            const u32 b = bit(rng);
+            d.words[b / 64] ^= u64{1} << (b % 64);
+        }
+    }
+    return out;
+}
+
+// NOTE: 640 x 480 pinhole, the geometry tests work in its pixels
+inline CameraIntrinsics MakeCamera() {
+    return {.fx = 500.0, .fy = 510.0, .cx = 320.0, .cy = 240.0, .width = 640, .height = 480};
+}
+
+[[nodiscard]] inline cv::Point2f Project(const CameraIntrinsics& k, const vec3d& pc) {
+    return {static_cast<f32>(k.fx * pc.x / pc.z + k.cx), static_cast<f32>(k.fy * pc.y / pc.z + k.cy)};
+}
+
+// NOTE: Points in a box in front of the world camera, 2 to 8 units deep
+inline std::vector<vec3d> MakePoints(std::size_t count, u32 seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<f64> xy(-3.0, 3.0), z(2.0, 8.0);
+    std::vector<vec3d> out(count);
+    for (vec3d& p : out) p = vec3d(xy(rng), xy(rng), z(rng));
+    return out;
+}
+
+[[nodiscard]] inline f64 RotationError(const mat3d& a, const mat3d& b) {
+    return so3d::from_matrix(a.transpose() * b).log().length();
+}
+
+} // namespace ct::test